@@ -0,0 +1,77 @@
+// ============================================================================
+// AllocationCounter.cpp - Process-Wide Heap Allocation Counters
+// ============================================================================
+
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace KVC {
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{ 0 };
+std::atomic<uint64_t> g_allocatedBytes{ 0 };
+
+void* CountedAllocate(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* CountedAllocateAligned(std::size_t size, std::align_val_t alignment) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+    void* p = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    void* p = std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void ReleaseAligned(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+} // namespace
+
+AllocationSnapshot CurrentAllocations() {
+    return { g_allocations.load(std::memory_order_relaxed), g_allocatedBytes.load(std::memory_order_relaxed) };
+}
+
+} // namespace KVC
+
+// ============================================================================
+// Global Replacements
+// ============================================================================
+
+void* operator new(std::size_t size) { return KVC::CountedAllocate(size); }
+void* operator new[](std::size_t size) { return KVC::CountedAllocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return KVC::CountedAllocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return KVC::CountedAllocateAligned(size, alignment); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return KVC::CountedAllocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return KVC::CountedAllocate(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { KVC::ReleaseAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { KVC::ReleaseAligned(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { KVC::ReleaseAligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { KVC::ReleaseAligned(p); }
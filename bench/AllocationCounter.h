@@ -0,0 +1,22 @@
+// ============================================================================
+// AllocationCounter.h - Process-Wide Heap Allocation Counters
+// ============================================================================
+// AllocationCounter.cpp replaces the global operator new/delete of the
+// benchmark executable, so every C++ heap allocation is counted. Counters
+// are relaxed atomics; take a snapshot before and after a stage and diff.
+// ============================================================================
+
+#pragma once
+
+#include <cstdint>
+
+namespace KVC {
+
+struct AllocationSnapshot {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+AllocationSnapshot CurrentAllocations();
+
+} // namespace KVC
@@ -0,0 +1,288 @@
+// ============================================================================
+// BenchMain.cpp - kvc_bench Command-Line Entry Point
+// ============================================================================
+// "generate" writes a synthetic volume image; "run" benchmarks scan and
+// recovery stages against any image and prints one JSON line per stage
+// and iteration (to stdout, or appended to --output); "verify" checks that
+// carving finds the same files whatever the worker count.
+// ============================================================================
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Windows.h>
+#include "BenchRunner.h"
+#include "SyntheticImage.h"
+#include <algorithm>
+#include <cstdio>
+#include <cwctype>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace KVC;
+
+namespace {
+
+void PrintHelp() {
+    wprintf(L"\n");
+    wprintf(L"KVC Recovery Benchmark\n");
+    wprintf(L"======================\n\n");
+    wprintf(L"USAGE:\n");
+    wprintf(L"  kvc_bench.exe generate --fs <ntfs|fat32|exfat> --out <IMAGE> [OPTIONS]\n");
+    wprintf(L"  kvc_bench.exe run --image <IMAGE> [OPTIONS]\n");
+    wprintf(L"  kvc_bench.exe verify --image <IMAGE> [--threads <N>] [--batch-clusters <N>]\n\n");
+    wprintf(L"GENERATE OPTIONS:\n");
+    wprintf(L"  --size-mb <N>        Image size (default 256)\n");
+    wprintf(L"  --cluster <BYTES>    Cluster size (default 4096)\n");
+    wprintf(L"  --files <N>          Files to place (default 2000)\n");
+    wprintf(L"  --dirs <N>           Directories the files are spread over (default 8)\n");
+    wprintf(L"  --deleted <0..1>     Share of deleted files (default 0.5)\n");
+    wprintf(L"  --fragmented <0..1>  Share of fragmented files (default 0.1)\n");
+    wprintf(L"  --max-fragments <N>  Runs per fragmented file (default 4)\n");
+    wprintf(L"  --min-kb <N>         Smallest file (default 4)\n");
+    wprintf(L"  --max-kb <N>         Largest file (default 512)\n");
+    wprintf(L"  --mix <LIST>         Formats, e.g. jpg,pdf,zip,gif (default all)\n");
+    wprintf(L"  --random-run <N>     Free high-entropy clusters after the files, each\n");
+    wprintf(L"                       opening with a BMP header (default 0)\n");
+    wprintf(L"  --seed <N>           Generator seed (default 1)\n\n");
+    wprintf(L"RUN OPTIONS:\n");
+    wprintf(L"  --stages <LIST>      carve,ntfs,fat32,exfat,recover (default: carve + image filesystem)\n");
+    wprintf(L"  --threads <N>        Worker threads for carving and scans (default 4)\n");
+    wprintf(L"  --iterations <N>     Repetitions per stage (default 1)\n");
+    wprintf(L"  --unbuffered         Bypass the file cache\n");
+    wprintf(L"  --recover-dir <DIR>  Recovery output (default: temp folder, removed afterwards)\n");
+    wprintf(L"  --output <FILE>      Append JSON lines to FILE instead of stdout\n");
+    wprintf(L"  --label <TEXT>       Tag copied into every result (build, commit, machine)\n");
+    wprintf(L"  --batch-clusters <N> Carving batch size (default: carver default)\n\n");
+    wprintf(L"VERIFY:\n");
+    wprintf(L"  Carves the image with 1 thread and with --threads workers (default 4) and\n");
+    wprintf(L"  exits 1 unless both find the same files. --batch-clusters defaults to 256\n");
+    wprintf(L"  so slice boundaries fall inside the data; for a prescreen check use\n");
+    wprintf(L"    kvc_bench.exe generate --fs ntfs --out v.img --random-run 2048\n");
+    wprintf(L"    kvc_bench.exe verify --image v.img --threads 8\n\n");
+    wprintf(L"peak_rss_bytes is the process peak so far; run one stage per invocation\n");
+    wprintf(L"for a per-stage peak.\n\n");
+}
+
+std::vector<std::wstring> SplitList(const std::wstring& text) {
+    std::vector<std::wstring> items;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = text.find(L',', start);
+        if (comma == std::wstring::npos) comma = text.size();
+        if (comma > start) items.push_back(text.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return items;
+}
+
+bool ParseFormat(const std::wstring& name, SyntheticFormat& format) {
+    if (name == L"jpg" || name == L"jpeg") format = SyntheticFormat::JPEG;
+    else if (name == L"pdf") format = SyntheticFormat::PDF;
+    else if (name == L"zip") format = SyntheticFormat::ZIP;
+    else if (name == L"gif") format = SyntheticFormat::GIF;
+    else return false;
+    return true;
+}
+
+int Generate(int argc, wchar_t** argv) {
+    SyntheticImageSpec spec;
+    std::wstring outPath;
+    bool hasFilesystem = false;
+
+    for (int i = 2; i < argc; i++) {
+        std::wstring arg = argv[i];
+        std::transform(arg.begin(), arg.end(), arg.begin(), ::towlower);
+        bool hasValue = i + 1 < argc;
+
+        if (arg == L"--fs" && hasValue) {
+            std::wstring fs = argv[++i];
+            std::transform(fs.begin(), fs.end(), fs.begin(), ::towlower);
+            if (fs == L"ntfs") spec.filesystem = FilesystemType::NTFS;
+            else if (fs == L"fat32") spec.filesystem = FilesystemType::FAT32;
+            else if (fs == L"exfat") spec.filesystem = FilesystemType::ExFAT;
+            else {
+                fwprintf(stderr, L"[ERROR] Unknown filesystem: %ls\n", argv[i]);
+                return 2;
+            }
+            hasFilesystem = true;
+        }
+        else if (arg == L"--out" && hasValue) outPath = argv[++i];
+        else if (arg == L"--size-mb" && hasValue) spec.imageBytes = _wcstoui64(argv[++i], nullptr, 10) * 1024 * 1024;
+        else if (arg == L"--cluster" && hasValue) spec.bytesPerCluster = _wcstoui64(argv[++i], nullptr, 10);
+        else if (arg == L"--files" && hasValue) spec.fileCount = _wcstoui64(argv[++i], nullptr, 10);
+        else if (arg == L"--dirs" && hasValue) spec.directoryCount = _wcstoui64(argv[++i], nullptr, 10);
+        else if (arg == L"--deleted" && hasValue) spec.deletedRatio = wcstod(argv[++i], nullptr);
+        else if (arg == L"--fragmented" && hasValue) spec.fragmentedRatio = wcstod(argv[++i], nullptr);
+        else if (arg == L"--max-fragments" && hasValue) spec.maxFragments = _wcstoui64(argv[++i], nullptr, 10);
+        else if (arg == L"--min-kb" && hasValue) spec.minFileBytes = _wcstoui64(argv[++i], nullptr, 10) * 1024;
+        else if (arg == L"--max-kb" && hasValue) spec.maxFileBytes = _wcstoui64(argv[++i], nullptr, 10) * 1024;
+        else if (arg == L"--seed" && hasValue) spec.seed = _wcstoui64(argv[++i], nullptr, 10);
+        else if (arg == L"--random-run" && hasValue) spec.randomRunClusters = _wcstoui64(argv[++i], nullptr, 10);
+        else if (arg == L"--mix" && hasValue) {
+            spec.formats.clear();
+            for (auto name : SplitList(argv[++i])) {
+                std::transform(name.begin(), name.end(), name.begin(), ::towlower);
+                SyntheticFormat format;
+                if (!ParseFormat(name, format)) {
+                    fwprintf(stderr, L"[ERROR] Unknown format: %ls\n", name.c_str());
+                    return 2;
+                }
+                spec.formats.push_back(format);
+            }
+        }
+        else {
+            fwprintf(stderr, L"[ERROR] Unknown argument: %ls\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if (!hasFilesystem || outPath.empty()) {
+        fwprintf(stderr, L"[ERROR] generate needs --fs and --out\n");
+        return 2;
+    }
+
+    try {
+        SyntheticImageInfo info = WriteSyntheticImage(outPath, spec);
+        wprintf(L"[INFO] %ls: %llu files (%llu deleted, %llu fragmented), %llu data bytes\n",
+                outPath.c_str(), info.filesWritten, info.deletedFiles, info.fragmentedFiles, info.dataBytes);
+    }
+    catch (const std::exception& e) {
+        fprintf(stderr, "[ERROR] %s\n", e.what());
+        return 3;
+    }
+    return 0;
+}
+
+int Run(int argc, wchar_t** argv) {
+    BenchOptions options;
+    std::wstring outputPath;
+
+    for (int i = 2; i < argc; i++) {
+        std::wstring arg = argv[i];
+        std::transform(arg.begin(), arg.end(), arg.begin(), ::towlower);
+        bool hasValue = i + 1 < argc;
+
+        if (arg == L"--image" && hasValue) options.imagePath = argv[++i];
+        else if (arg == L"--threads" && hasValue) options.threads = static_cast<size_t>(_wcstoui64(argv[++i], nullptr, 10));
+        else if (arg == L"--iterations" && hasValue) options.iterations = _wcstoui64(argv[++i], nullptr, 10);
+        else if (arg == L"--unbuffered") options.unbuffered = true;
+        else if (arg == L"--recover-dir" && hasValue) options.recoverFolder = argv[++i];
+        else if (arg == L"--output" && hasValue) outputPath = argv[++i];
+        else if (arg == L"--label" && hasValue) options.label = argv[++i];
+        else if (arg == L"--batch-clusters" && hasValue) options.batchClusters = _wcstoui64(argv[++i], nullptr, 10);
+        else if (arg == L"--stages" && hasValue) {
+            for (const auto& name : SplitList(argv[++i])) {
+                BenchStage stage;
+                if (!ParseStage(name, stage)) {
+                    fwprintf(stderr, L"[ERROR] Unknown stage: %ls\n", name.c_str());
+                    return 2;
+                }
+                options.stages.push_back(stage);
+            }
+        }
+        else {
+            fwprintf(stderr, L"[ERROR] Unknown argument: %ls\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if (options.imagePath.empty()) {
+        fwprintf(stderr, L"[ERROR] run needs --image\n");
+        return 2;
+    }
+
+    BenchRunner runner(options);
+    if (!runner.Prepare()) {
+        fwprintf(stderr, L"[ERROR] Cannot open image: %ls\n", options.imagePath.c_str());
+        return 3;
+    }
+
+    std::ofstream output;
+    if (!outputPath.empty()) {
+        output.open(std::filesystem::path(outputPath), std::ios::app);
+        if (!output.is_open()) {
+            fwprintf(stderr, L"[ERROR] Cannot open output: %ls\n", outputPath.c_str());
+            return 3;
+        }
+    }
+
+    bool allSucceeded = true;
+    for (BenchStage stage : runner.Stages()) {
+        for (uint64_t iteration = 0; iteration < std::max<uint64_t>(1, options.iterations); iteration++) {
+            StageMeasurement result = runner.Run(stage, iteration);
+            allSucceeded = allSucceeded && result.succeeded;
+
+            std::string line = runner.FormatResult(result);
+            if (output.is_open()) {
+                output << line << "\n";
+                output.flush();
+            } else {
+                printf("%s\n", line.c_str());
+                fflush(stdout);
+            }
+        }
+    }
+    return allSucceeded ? 0 : 4;
+}
+
+int Verify(int argc, wchar_t** argv) {
+    BenchOptions options;
+    options.batchClusters = 256;
+
+    for (int i = 2; i < argc; i++) {
+        std::wstring arg = argv[i];
+        std::transform(arg.begin(), arg.end(), arg.begin(), ::towlower);
+        bool hasValue = i + 1 < argc;
+
+        if (arg == L"--image" && hasValue) options.imagePath = argv[++i];
+        else if (arg == L"--threads" && hasValue) options.threads = static_cast<size_t>(_wcstoui64(argv[++i], nullptr, 10));
+        else if (arg == L"--batch-clusters" && hasValue) options.batchClusters = _wcstoui64(argv[++i], nullptr, 10);
+        else if (arg == L"--unbuffered") options.unbuffered = true;
+        else {
+            fwprintf(stderr, L"[ERROR] Unknown argument: %ls\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if (options.imagePath.empty() || options.threads < 2) {
+        fwprintf(stderr, L"[ERROR] verify needs --image and at least 2 --threads\n");
+        return 2;
+    }
+
+    BenchRunner runner(options);
+    if (!runner.Prepare()) {
+        fwprintf(stderr, L"[ERROR] Cannot open image: %ls\n", options.imagePath.c_str());
+        return 3;
+    }
+
+    std::string mismatch;
+    if (!runner.VerifyCarveDeterminism(mismatch)) {
+        printf("[FAIL] carve: %s\n", mismatch.c_str());
+        return 1;
+    }
+    printf("[PASS] carve: 1 and %zu threads found the same files\n", options.threads);
+    return 0;
+}
+
+} // namespace
+
+int wmain(int argc, wchar_t** argv) {
+    if (argc < 2) {
+        PrintHelp();
+        return 2;
+    }
+
+    std::wstring command = argv[1];
+    std::transform(command.begin(), command.end(), command.begin(), ::towlower);
+
+    if (command == L"generate") return Generate(argc, argv);
+    if (command == L"run") return Run(argc, argv);
+    if (command == L"verify") return Verify(argc, argv);
+
+    PrintHelp();
+    return (command == L"--help" || command == L"-h" || command == L"/?") ? 0 : 2;
+}
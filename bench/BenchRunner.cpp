@@ -0,0 +1,464 @@
+// ============================================================================
+// BenchRunner.cpp - Stage Benchmarks over Volume Images
+// ============================================================================
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "BenchRunner.h"
+#include "DiskHandle.h"
+#include "VolumeReader.h"
+#include "FileCarver.h"
+#include "FileSignatures.h"
+#include "NTFSScanner.h"
+#include "FAT32Scanner.h"
+#include "ExFATScanner.h"
+#include "RecoveryEngine.h"
+#include "ScanConfiguration.h"
+#include <psapi.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace KVC {
+
+namespace {
+
+struct StageInfo {
+    BenchStage stage;
+    const char* name;
+};
+
+constexpr StageInfo STAGES[] = {
+    { BenchStage::Carve,   "carve" },
+    { BenchStage::NTFS,    "ntfs" },
+    { BenchStage::FAT32,   "fat32" },
+    { BenchStage::ExFAT,   "exfat" },
+    { BenchStage::Recover, "recover" },
+};
+
+uint64_t PeakWorkingSet() {
+    PROCESS_MEMORY_COUNTERS counters = {};
+    counters.cb = sizeof(counters);
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+}
+
+std::string Utf8(const std::wstring& text) {
+    int length = WideCharToMultiByte(CP_UTF8, 0, text.c_str(), static_cast<int>(text.size()),
+                                     nullptr, 0, nullptr, nullptr);
+    std::string result(static_cast<size_t>(std::max(length, 0)), '\0');
+    if (length > 0) {
+        WideCharToMultiByte(CP_UTF8, 0, text.c_str(), static_cast<int>(text.size()),
+                            &result[0], length, nullptr, nullptr);
+    }
+    return result;
+}
+
+std::string JsonString(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+double PerSecond(uint64_t count, double seconds) {
+    return seconds > 0.0 ? count / seconds : 0.0;
+}
+
+ScanConfiguration BenchConfiguration(const BenchOptions& options) {
+    ScanConfiguration config;
+    config.parallelThreads = std::max<size_t>(1, options.threads);
+    config.unbufferedStreaming = options.unbuffered;
+    return config;
+}
+
+// Times body and records heap activity in between
+template <typename Body>
+void Measure(StageMeasurement& result, Body&& body) {
+    AllocationSnapshot before = CurrentAllocations();
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto end = std::chrono::steady_clock::now();
+    AllocationSnapshot after = CurrentAllocations();
+
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.allocations.allocations = after.allocations - before.allocations;
+    result.allocations.bytes = after.bytes - before.bytes;
+}
+
+} // namespace
+
+const char* StageName(BenchStage stage) {
+    for (const auto& info : STAGES) {
+        if (info.stage == stage) return info.name;
+    }
+    return "unknown";
+}
+
+bool ParseStage(const std::wstring& name, BenchStage& stage) {
+    std::string narrow = Utf8(name);
+    std::transform(narrow.begin(), narrow.end(), narrow.begin(), ::tolower);
+    for (const auto& info : STAGES) {
+        if (narrow == info.name) {
+            stage = info.stage;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// BenchRunner
+// ============================================================================
+
+BenchRunner::BenchRunner(const BenchOptions& options)
+    : m_options(options)
+{}
+
+bool BenchRunner::Prepare() {
+    DiskHandle disk(m_options.imagePath);
+    if (!disk.Open()) {
+        return false;
+    }
+
+    m_layout = {};
+    m_layout.sectorSize = disk.GetSectorSize();
+    m_layout.imageBytes = disk.GetDiskSize();
+    if (m_layout.imageBytes == 0) {
+        return false;
+    }
+
+    auto sector = disk.ReadSectors(0, 1, m_layout.sectorSize);
+    if (sector.size() < 512) {
+        return false;
+    }
+
+    if (std::memcmp(sector.data() + 3, "NTFS    ", 8) == 0) {
+        NTFSBootSector boot = {};
+        std::memcpy(&boot, sector.data(), sizeof(boot));
+        m_layout.filesystem = FilesystemType::NTFS;
+        m_layout.bytesPerCluster = static_cast<uint64_t>(boot.bytesPerSector) * boot.sectorsPerCluster;
+    } else if (std::memcmp(sector.data() + 3, "EXFAT   ", 8) == 0) {
+        ExFatBootSector boot = {};
+        std::memcpy(&boot, sector.data(), sizeof(boot));
+        m_layout.filesystem = FilesystemType::ExFAT;
+        m_layout.bytesPerCluster = 1ULL << (boot.bytesPerSectorShift + boot.sectorsPerClusterShift);
+        m_layout.dataOffset = static_cast<uint64_t>(boot.clusterHeapOffset) << boot.bytesPerSectorShift;
+    } else if (std::memcmp(sector.data() + 0x52, "FAT32   ", 8) == 0) {
+        FAT32BootSector boot = {};
+        std::memcpy(&boot, sector.data(), sizeof(boot));
+        m_layout.filesystem = FilesystemType::FAT32;
+        m_layout.bytesPerCluster = static_cast<uint64_t>(boot.bytesPerSector) * boot.sectorsPerCluster;
+        m_layout.dataOffset = (boot.reservedSectors + static_cast<uint64_t>(boot.numberOfFATs) * boot.fatSize32) *
+                              boot.bytesPerSector;
+    }
+
+    // Captured images of unknown layout are carved in default-sized clusters
+    if (m_layout.bytesPerCluster == 0) {
+        m_layout.bytesPerCluster = 4096;
+    }
+    return true;
+}
+
+std::vector<BenchStage> BenchRunner::Stages() const {
+    if (!m_options.stages.empty()) {
+        return m_options.stages;
+    }
+
+    std::vector<BenchStage> stages = { BenchStage::Carve };
+    switch (m_layout.filesystem) {
+        case FilesystemType::NTFS:  stages.push_back(BenchStage::NTFS); break;
+        case FilesystemType::FAT32: stages.push_back(BenchStage::FAT32); break;
+        case FilesystemType::ExFAT: stages.push_back(BenchStage::ExFAT); break;
+        default: break;
+    }
+    return stages;
+}
+
+StageMeasurement BenchRunner::Run(BenchStage stage, uint64_t iteration) {
+    StageMeasurement result;
+    result.stage = stage;
+    result.iteration = iteration;
+
+    // Each stage opens its own handle, so window caches never carry over
+    try {
+        switch (stage) {
+            case BenchStage::Carve:   result.succeeded = RunCarve(result); break;
+            case BenchStage::Recover: result.succeeded = RunRecover(result); break;
+            default:                  result.succeeded = RunFilesystemScan(stage, result, nullptr); break;
+        }
+    }
+    catch (const std::exception&) {
+        result.succeeded = false;
+    }
+
+    result.peakRssBytes = PeakWorkingSet();
+    return result;
+}
+
+VolumeGeometry BenchRunner::CarveGeometry() const {
+    VolumeGeometry geom;
+    geom.sectorSize = m_layout.sectorSize;
+    geom.bytesPerCluster = m_layout.bytesPerCluster;
+    geom.totalClusters = (m_layout.imageBytes - m_layout.dataOffset) / geom.bytesPerCluster;
+    geom.volumeStartOffset = m_layout.dataOffset;
+    geom.fsType = m_layout.filesystem;
+    return geom;
+}
+
+bool BenchRunner::CarveImage(size_t threads, std::vector<CarvedFile>& files) {
+    DiskHandle disk(m_options.imagePath);
+    if (!disk.Open()) {
+        return false;
+    }
+
+    VolumeGeometry geom = CarveGeometry();
+    VolumeReader reader(disk, geom);
+
+    CarvingOptions options;
+    options.signatures = FileSignatures::GetAllSignatures();
+    options.workerThreads = std::max<size_t>(1, threads);
+    options.unbufferedIO = m_options.unbuffered;
+    options.retainFiles = false;
+    if (m_options.batchClusters > 0) {
+        options.batchClusters = m_options.batchClusters;
+    }
+
+    FileCarver carver;
+    std::atomic<bool> shouldStop(false);
+    carver.CarveVolume(reader, options,
+        [&files](const CarvedFile& file) { files.push_back(file); },
+        [](const std::wstring&, float) {},
+        shouldStop);
+    return true;
+}
+
+bool BenchRunner::VerifyCarveDeterminism(std::string& mismatch) {
+    std::vector<CarvedFile> single;
+    std::vector<CarvedFile> parallel;
+    if (!CarveImage(1, single) || !CarveImage(m_options.threads, parallel)) {
+        mismatch = "image cannot be opened";
+        return false;
+    }
+
+    char text[256];
+    for (size_t i = 0; i < std::min(single.size(), parallel.size()); i++) {
+        const CarvedFile& a = single[i];
+        const CarvedFile& b = parallel[i];
+        bool same = a.startLCN == b.startLCN && a.startOffset == b.startOffset &&
+                    a.fileSize == b.fileSize &&
+                    std::strcmp(a.signature.extension, b.signature.extension) == 0 &&
+                    a.fragments.GetRuns().size() == b.fragments.GetRuns().size();
+        for (size_t r = 0; same && r < a.fragments.GetRuns().size(); r++) {
+            same = a.fragments.GetRuns()[r].startCluster == b.fragments.GetRuns()[r].startCluster &&
+                   a.fragments.GetRuns()[r].clusterCount == b.fragments.GetRuns()[r].clusterCount;
+        }
+        if (!same) {
+            snprintf(text, sizeof(text), "file %zu: %s at LCN %llu (1 thread) vs %s at LCN %llu (%zu threads)",
+                     i, a.signature.extension, a.startLCN, b.signature.extension, b.startLCN,
+                     m_options.threads);
+            mismatch = text;
+            return false;
+        }
+    }
+
+    if (single.size() != parallel.size()) {
+        snprintf(text, sizeof(text), "%zu files with 1 thread, %zu with %zu threads",
+                 single.size(), parallel.size(), m_options.threads);
+        mismatch = text;
+        return false;
+    }
+    return true;
+}
+
+bool BenchRunner::RunCarve(StageMeasurement& result) {
+    DiskHandle disk(m_options.imagePath);
+    if (!disk.Open()) {
+        return false;
+    }
+
+    VolumeGeometry geom = CarveGeometry();
+    VolumeReader reader(disk, geom);
+
+    CarvingOptions options;
+    options.signatures = FileSignatures::GetAllSignatures();
+    options.workerThreads = std::max<size_t>(1, m_options.threads);
+    options.unbufferedIO = m_options.unbuffered;
+    if (m_options.batchClusters > 0) {
+        options.batchClusters = m_options.batchClusters;
+    }
+
+    FileCarver carver;
+    std::atomic<bool> shouldStop(false);
+    uint64_t found = 0;
+    CarvingResult carved;
+
+    Measure(result, [&]() {
+        carved = carver.CarveVolume(reader, options,
+            [&found](const CarvedFile&) { found++; },
+            [](const std::wstring&, float) {},
+            shouldStop);
+    });
+
+    result.items = found;
+    result.bytes = carved.stats.clustersScanned * geom.bytesPerCluster;
+    return true;
+}
+
+bool BenchRunner::RunFilesystemScan(BenchStage stage, StageMeasurement& result,
+                                    std::vector<RecoveryCandidate>* candidates) {
+    DiskHandle disk(m_options.imagePath);
+    if (!disk.Open()) {
+        return false;
+    }
+
+    ScanConfiguration config = BenchConfiguration(m_options);
+    bool shouldStop = false;
+    uint64_t found = 0;
+    auto onFound = [&](const RecoveryCandidate& candidate) {
+        found++;
+        if (candidates) candidates->push_back(candidate);
+    };
+    auto onProgress = [](const std::wstring&, float) {};
+    bool ok = false;
+
+    switch (stage) {
+        case BenchStage::NTFS: {
+            NTFSScanner scanner;
+            Measure(result, [&]() {
+                ok = scanner.ScanVolume(disk, L"", L"", onFound, onProgress, shouldStop, config);
+            });
+            uint64_t recordSize = NTFSScanner::MftRecordSize(scanner.ReadBootSector(disk));
+            result.records = std::min(scanner.MftRecordCount(), config.ntfsMftSpareDriveLimit);
+            result.bytes = result.records * recordSize;
+            break;
+        }
+        case BenchStage::FAT32: {
+            FAT32Scanner scanner;
+            Measure(result, [&]() {
+                ok = scanner.ScanVolume(disk, L"", L"", onFound, onProgress, shouldStop, config);
+            });
+            break;
+        }
+        case BenchStage::ExFAT: {
+            ExFATScanner scanner;
+            Measure(result, [&]() {
+                ok = scanner.ScanVolume(disk, L"", L"", onFound, onProgress, shouldStop, config);
+            });
+            break;
+        }
+        default:
+            return false;
+    }
+
+    result.items = found;
+    return ok;
+}
+
+bool BenchRunner::RunRecover(StageMeasurement& result) {
+    BenchStage scanStage;
+    switch (m_layout.filesystem) {
+        case FilesystemType::NTFS:  scanStage = BenchStage::NTFS; break;
+        case FilesystemType::FAT32: scanStage = BenchStage::FAT32; break;
+        case FilesystemType::ExFAT: scanStage = BenchStage::ExFAT; break;
+        default: return false;
+    }
+
+    // Only the recovery itself is measured
+    std::vector<RecoveryCandidate> candidates;
+    StageMeasurement scan;
+    if (!RunFilesystemScan(scanStage, scan, &candidates)) {
+        return false;
+    }
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+        [](const RecoveryCandidate& c) { return c.quality == RecoveryQuality::Unrecoverable; }),
+        candidates.end());
+
+    std::filesystem::path folder = m_options.recoverFolder.empty()
+        ? std::filesystem::temp_directory_path() / L"kvc_bench_recover"
+        : std::filesystem::path(m_options.recoverFolder);
+    std::error_code ec;
+    std::filesystem::remove_all(folder, ec);
+    std::filesystem::create_directories(folder, ec);
+
+    DiskHandle disk(m_options.imagePath);
+    if (!disk.Open()) {
+        return false;
+    }
+
+    RecoveryEngine engine;
+    int recovered = 0;
+    Measure(result, [&]() {
+        recovered = engine.RecoverMultipleFiles(candidates, disk, folder.wstring(),
+                                                [](const std::wstring&, float) {});
+    });
+
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(folder, ec)) {
+        if (entry.is_regular_file(ec)) result.bytes += entry.file_size(ec);
+    }
+    result.items = static_cast<uint64_t>(std::max(recovered, 0));
+
+    // Only a folder this runner chose is cleaned up
+    if (m_options.recoverFolder.empty()) {
+        std::filesystem::remove_all(folder, ec);
+    }
+    return true;
+}
+
+std::string BenchRunner::FormatResult(const StageMeasurement& result) const {
+    const double megabytes = result.bytes / (1024.0 * 1024.0);
+    char numbers[768];
+    snprintf(numbers, sizeof(numbers),
+        "\"iteration\":%llu,\"ok\":%s,\"threads\":%llu,\"unbuffered\":%s,\"seconds\":%.6f,"
+        "\"bytes\":%llu,\"mb_per_s\":%.3f,\"items\":%llu,\"items_per_s\":%.1f,"
+        "\"records\":%llu,\"records_per_s\":%.1f,\"allocations\":%llu,\"allocated_bytes\":%llu,"
+        "\"peak_rss_bytes\":%llu",
+        static_cast<unsigned long long>(result.iteration),
+        result.succeeded ? "true" : "false",
+        static_cast<unsigned long long>(m_options.threads),
+        m_options.unbuffered ? "true" : "false",
+        result.seconds,
+        static_cast<unsigned long long>(result.bytes),
+        result.seconds > 0.0 ? megabytes / result.seconds : 0.0,
+        static_cast<unsigned long long>(result.items),
+        PerSecond(result.items, result.seconds),
+        static_cast<unsigned long long>(result.records),
+        PerSecond(result.records, result.seconds),
+        static_cast<unsigned long long>(result.allocations.allocations),
+        static_cast<unsigned long long>(result.allocations.bytes),
+        static_cast<unsigned long long>(result.peakRssBytes));
+
+    std::string line = "{\"stage\":" + JsonString(StageName(result.stage));
+    line += ",\"image\":" + JsonString(Utf8(m_options.imagePath));
+    line += ",\"image_bytes\":" + std::to_string(m_layout.imageBytes);
+    line += ",";
+    line += numbers;
+    if (!m_options.label.empty()) {
+        line += ",\"label\":" + JsonString(Utf8(m_options.label));
+    }
+    return line + "}";
+}
+
+} // namespace KVC
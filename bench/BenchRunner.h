@@ -0,0 +1,101 @@
+// ============================================================================
+// BenchRunner.h - Stage Benchmarks over Volume Images
+// ============================================================================
+// Runs one scan or recovery stage against an image file and measures wall
+// time, throughput, heap allocations and peak working set. Results are
+// emitted as JSON Lines so they can be collected and compared over releases.
+// ============================================================================
+
+#pragma once
+
+#include "AllocationCounter.h"
+#include "VolumeGeometry.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace KVC {
+
+struct RecoveryCandidate;
+struct CarvedFile;
+
+enum class BenchStage {
+    Carve,      // FileCarver::CarveVolume over the whole image
+    NTFS,       // NTFSScanner::ScanVolume (MFT stage)
+    FAT32,      // FAT32Scanner::ScanVolume
+    ExFAT,      // ExFATScanner::ScanVolume
+    Recover     // Filesystem scan, then RecoverMultipleFiles for every candidate
+};
+
+const char* StageName(BenchStage stage);
+bool ParseStage(const std::wstring& name, BenchStage& stage);
+
+struct BenchOptions {
+    std::wstring imagePath;
+    std::vector<BenchStage> stages;     // Empty = carve plus the image's filesystem scan
+    size_t threads = 4;
+    uint64_t iterations = 1;
+    bool unbuffered = false;            // Bypass the file cache (cold-read numbers)
+    uint64_t batchClusters = 0;         // Carving batch size, 0 = the carver's default
+    std::wstring recoverFolder;         // Empty = a folder under the temp directory
+    std::wstring label;                 // Free text copied into every result
+};
+
+struct StageMeasurement {
+    BenchStage stage = BenchStage::Carve;
+    uint64_t iteration = 0;
+    bool succeeded = false;
+    double seconds = 0.0;
+    uint64_t bytes = 0;                 // Carve: clusters scanned; NTFS: $MFT bytes; Recover: bytes written
+    uint64_t items = 0;                 // Candidates reported (carved files, deleted entries, recovered files)
+    uint64_t records = 0;               // NTFS: MFT records in the stream
+    AllocationSnapshot allocations;     // Heap activity during the stage only
+    uint64_t peakRssBytes = 0;          // Process peak working set after the stage
+};
+
+// Layout read from the image's boot sector
+struct ImageLayout {
+    FilesystemType filesystem = FilesystemType::Unknown;
+    uint64_t sectorSize = 512;
+    uint64_t bytesPerCluster = 4096;
+    uint64_t dataOffset = 0;            // Byte offset of LCN 0 (FAT/exFAT cluster heap)
+    uint64_t imageBytes = 0;
+};
+
+class BenchRunner {
+public:
+    explicit BenchRunner(const BenchOptions& options);
+
+    // Opens the image and reads its layout; false if it cannot be read
+    bool Prepare();
+
+    const ImageLayout& Layout() const { return m_layout; }
+
+    // Stages actually run: the requested list or the default for the image
+    std::vector<BenchStage> Stages() const;
+
+    StageMeasurement Run(BenchStage stage, uint64_t iteration);
+
+    // One JSON object, no trailing newline
+    std::string FormatResult(const StageMeasurement& result) const;
+
+    // Carve with one worker and with options.threads workers; true if both
+    // publish the same files in the same order, else mismatch says where
+    // they first differ
+    bool VerifyCarveDeterminism(std::string& mismatch);
+
+private:
+    VolumeGeometry CarveGeometry() const;
+
+    // Whole-image carve with the given worker count; false if the image cannot be opened
+    bool CarveImage(size_t threads, std::vector<CarvedFile>& files);
+
+    bool RunCarve(StageMeasurement& result);
+    bool RunFilesystemScan(BenchStage stage, StageMeasurement& result, std::vector<RecoveryCandidate>* candidates);
+    bool RunRecover(StageMeasurement& result);
+
+    BenchOptions m_options;
+    ImageLayout m_layout;
+};
+
+} // namespace KVC
@@ -0,0 +1,920 @@
+// ============================================================================
+// SyntheticImage.cpp - Synthetic Volume Image Generator
+// ============================================================================
+// Images carry exactly the structures the scanners read (boot sector, MFT
+// or FAT, allocation bitmaps, directory entries); journals, upcase tables
+// and security descriptors are omitted, so they are not meant to be mounted.
+// ============================================================================
+
+#include "SyntheticImage.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <stdexcept>
+
+namespace KVC {
+
+namespace {
+
+constexpr uint64_t SECTOR = 512;
+constexpr uint64_t NTFS_RECORD_SIZE = 1024;
+constexpr uint64_t NTFS_FIRST_USER_RECORD = 24;
+constexpr uint64_t MAX_GAP_CLUSTERS = 16;   // Noise between two runs of a fragmented file
+
+struct Extent {
+    uint64_t cluster;   // Filesystem-native cluster number
+    uint64_t count;
+};
+
+struct PlannedFile {
+    uint64_t index;
+    uint64_t directory;
+    SyntheticFormat format;
+    uint64_t size;
+    bool deleted;
+    std::vector<Extent> extents;
+
+    uint64_t FirstCluster() const { return extents.empty() ? 0 : extents.front().cluster; }
+    bool Contiguous() const { return extents.size() <= 1; }
+};
+
+// ============================================================================
+// Deterministic Randomness
+// ============================================================================
+// std::mt19937_64 output is fixed by the standard; distributions are not,
+// so values are derived from raw draws to stay identical across toolchains.
+
+class Random {
+public:
+    explicit Random(uint64_t seed) : m_engine(seed) {}
+
+    uint64_t Next() { return m_engine(); }
+    uint64_t Below(uint64_t bound) { return bound == 0 ? 0 : m_engine() % bound; }
+    uint64_t Between(uint64_t low, uint64_t high) { return low + Below(high - low + 1); }
+    double Unit() { return static_cast<double>(m_engine() >> 11) * (1.0 / 9007199254740992.0); }
+
+    void Fill(uint8_t* data, size_t size) {
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t value = m_engine();
+            std::memcpy(data + i, &value, 8);
+        }
+        uint64_t tail = m_engine();
+        for (; i < size; i++, tail >>= 8) {
+            data[i] = static_cast<uint8_t>(tail);
+        }
+    }
+
+private:
+    std::mt19937_64 m_engine;
+};
+
+// ============================================================================
+// Output File
+// ============================================================================
+
+class ImageWriter {
+public:
+    ImageWriter(const std::wstring& path, uint64_t size)
+        : m_path(path)
+        , m_size(size)
+        , m_out(m_path, std::ios::binary | std::ios::trunc)
+    {
+        if (!m_out.is_open()) {
+            throw std::runtime_error("Cannot create image file");
+        }
+    }
+
+    void Write(uint64_t offset, const void* data, size_t size) {
+        if (size == 0) return;
+        if (offset + size > m_size) {
+            throw std::runtime_error("Synthetic layout exceeds the image size");
+        }
+        m_out.seekp(static_cast<std::streamoff>(offset));
+        m_out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        if (!m_out) {
+            throw std::runtime_error("Image write failed");
+        }
+    }
+
+    void Write(uint64_t offset, const std::vector<uint8_t>& data) {
+        Write(offset, data.data(), data.size());
+    }
+
+    // Unwritten ranges stay holes where the filesystem supports sparse files
+    void Finish() {
+        m_out.close();
+        std::error_code ec;
+        std::filesystem::resize_file(m_path, m_size, ec);
+        if (ec) {
+            throw std::runtime_error("Cannot size image file");
+        }
+    }
+
+private:
+    std::filesystem::path m_path;
+    uint64_t m_size;
+    std::ofstream m_out;
+};
+
+template <typename T>
+void Put(std::vector<uint8_t>& buffer, size_t offset, T value) {
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+void PutUtf16(std::vector<uint8_t>& buffer, size_t offset, const std::string& text) {
+    for (size_t i = 0; i < text.size(); i++) {
+        Put<uint16_t>(buffer, offset + i * 2, static_cast<uint8_t>(text[i]));
+    }
+}
+
+uint64_t CeilDiv(uint64_t value, uint64_t divisor) {
+    return (value + divisor - 1) / divisor;
+}
+
+// ============================================================================
+// File Content
+// ============================================================================
+
+const char* Extension(SyntheticFormat format) {
+    switch (format) {
+        case SyntheticFormat::JPEG: return "jpg";
+        case SyntheticFormat::PDF:  return "pdf";
+        case SyntheticFormat::ZIP:  return "zip";
+        case SyntheticFormat::GIF:  return "gif";
+    }
+    return "bin";
+}
+
+// Random filler that never contains the byte the format's end parser looks for
+void FillWithout(Random& rng, uint8_t* data, size_t size, uint8_t excluded) {
+    rng.Fill(data, size);
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] == excluded) data[i] = 0x41;
+    }
+}
+
+// Exactly size bytes with a valid header and a trailer the carver can find
+std::vector<uint8_t> BuildContent(Random& rng, SyntheticFormat format, uint64_t size) {
+    std::vector<uint8_t> data(static_cast<size_t>(size));
+    auto place = [&](size_t offset, const void* bytes, size_t count) {
+        std::memcpy(data.data() + offset, bytes, count);
+    };
+
+    switch (format) {
+        case SyntheticFormat::JPEG: {
+            static const uint8_t header[] = {
+                0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 'J', 'F', 'I', 'F', 0x00, 0x01, 0x01, 0x00,
+                0x00, 0x01, 0x00, 0x01, 0x00, 0x00,
+                0xFF, 0xDA, 0x00, 0x08, 0x01, 0x01, 0x00, 0x00, 0x3F, 0x00 };
+            place(0, header, sizeof(header));
+            size_t end = data.size() - 2;
+            rng.Fill(data.data() + sizeof(header), end - sizeof(header));
+            // Entropy-coded data: every 0xFF is byte-stuffed, so FFD9 only ends the image
+            for (size_t i = sizeof(header); i < end; i++) {
+                if (data[i] == 0xFF) {
+                    if (i + 1 < end) data[++i] = 0x00;
+                    else data[i] = 0x00;
+                }
+            }
+            data[end] = 0xFF;
+            data[end + 1] = 0xD9;
+            break;
+        }
+        case SyntheticFormat::PDF: {
+            static const char header[] = "%PDF-1.4\n";
+            static const char trailer[] = "\n%%EOF";
+            size_t headerSize = sizeof(header) - 1;
+            size_t trailerSize = sizeof(trailer) - 1;
+            place(0, header, headerSize);
+            FillWithout(rng, data.data() + headerSize, data.size() - headerSize - trailerSize, '%');
+            place(data.size() - trailerSize, trailer, trailerSize);
+            break;
+        }
+        case SyntheticFormat::ZIP: {
+            static const uint8_t header[] = { 'P', 'K', 0x03, 0x04 };
+            uint8_t trailer[22] = { 'P', 'K', 0x05, 0x06 };
+            place(0, header, sizeof(header));
+            FillWithout(rng, data.data() + sizeof(header), data.size() - sizeof(header) - sizeof(trailer), 'P');
+            place(data.size() - sizeof(trailer), trailer, sizeof(trailer));
+            break;
+        }
+        case SyntheticFormat::GIF: {
+            static const char header[] = "GIF89a";
+            place(0, header, 6);
+            FillWithout(rng, data.data() + 6, data.size() - 7, ';');
+            data.back() = ';';
+            break;
+        }
+    }
+    return data;
+}
+
+// Random cluster opening with a valid BMP header: "BM" is a two-byte magic,
+// so the carver keeps it at the start of a random run and drops it inside one
+void FillWeakMagicCluster(Random& rng, uint8_t* data, size_t size) {
+    rng.Fill(data, size);
+    std::vector<uint8_t> header(54, 0);
+    header[0] = 'B';
+    header[1] = 'M';
+    Put<uint32_t>(header, 2, static_cast<uint32_t>(size));     // File size
+    Put<uint32_t>(header, 10, 54);                              // Pixel data offset
+    Put<uint32_t>(header, 14, 40);                              // BITMAPINFOHEADER
+    Put<int32_t>(header, 18, 16);                               // Width
+    Put<int32_t>(header, 22, 16);                               // Height
+    Put<uint16_t>(header, 26, 1);                               // Planes
+    Put<uint16_t>(header, 28, 24);                              // Bits per pixel
+    std::memcpy(data, header.data(), header.size());
+}
+
+// ============================================================================
+// Layout Planning
+// ============================================================================
+
+struct Plan {
+    std::vector<PlannedFile> files;
+    std::vector<Extent> noise;      // Gaps between fragments, filled with random bytes
+    Extent randomRun = { 0, 0 };    // Weak-magic clusters after the files
+    uint64_t nextCluster = 0;
+};
+
+// Places files front to back from firstCluster; fragmented files are split
+// into in-order runs separated by short noise gaps
+Plan PlanFiles(const SyntheticImageSpec& spec, Random& rng, uint64_t firstCluster, uint64_t endCluster) {
+    Plan plan;
+    plan.nextCluster = firstCluster;
+    uint64_t bpc = spec.bytesPerCluster;
+
+    for (uint64_t i = 0; i < spec.fileCount; i++) {
+        PlannedFile file;
+        file.index = i;
+        file.directory = i % spec.directoryCount;
+        file.format = spec.formats[static_cast<size_t>(rng.Below(spec.formats.size()))];
+        file.size = rng.Between(spec.minFileBytes, spec.maxFileBytes);
+        file.deleted = rng.Unit() < spec.deletedRatio;
+
+        uint64_t clusters = CeilDiv(file.size, bpc);
+        uint64_t pieces = 1;
+        if (clusters >= 2 && rng.Unit() < spec.fragmentedRatio) {
+            pieces = std::min(clusters, rng.Between(2, spec.maxFragments));
+        }
+
+        uint64_t remaining = clusters;
+        for (uint64_t p = 0; p < pieces; p++) {
+            if (p > 0) {
+                uint64_t gap = rng.Between(1, MAX_GAP_CLUSTERS);
+                plan.noise.push_back({ plan.nextCluster, gap });
+                plan.nextCluster += gap;
+            }
+            uint64_t count = (p + 1 == pieces) ? remaining : clusters / pieces;
+            file.extents.push_back({ plan.nextCluster, count });
+            plan.nextCluster += count;
+            remaining -= count;
+        }
+
+        if (plan.nextCluster > endCluster) {
+            throw std::runtime_error("Files do not fit in the image; raise --size-mb or lower --files");
+        }
+        plan.files.push_back(std::move(file));
+    }
+
+    if (spec.randomRunClusters > 0) {
+        plan.randomRun = { plan.nextCluster, spec.randomRunClusters };
+        plan.nextCluster += spec.randomRunClusters;
+        if (plan.nextCluster > endCluster) {
+            throw std::runtime_error("Random run does not fit in the image; raise --size-mb or lower --random-run");
+        }
+    }
+    return plan;
+}
+
+void WriteContents(ImageWriter& writer, Random& rng, const Plan& plan, uint64_t bytesPerCluster,
+                   const std::function<uint64_t(uint64_t)>& clusterOffset, SyntheticImageInfo& info) {
+    std::vector<uint8_t> noise;
+    for (const auto& gap : plan.noise) {
+        noise.resize(static_cast<size_t>(gap.count * bytesPerCluster));
+        rng.Fill(noise.data(), noise.size());
+        writer.Write(clusterOffset(gap.cluster), noise);
+    }
+
+    for (const auto& file : plan.files) {
+        auto content = BuildContent(rng, file.format, file.size);
+        uint64_t written = 0;
+        for (const auto& extent : file.extents) {
+            uint64_t length = std::min(extent.count * bytesPerCluster, file.size - written);
+            writer.Write(clusterOffset(extent.cluster), content.data() + written, static_cast<size_t>(length));
+            written += length;
+        }
+
+        info.filesWritten++;
+        info.dataBytes += file.size;
+        if (file.deleted) info.deletedFiles++;
+        if (!file.Contiguous()) info.fragmentedFiles++;
+    }
+
+    // Drawn last, so images without a run keep their exact bytes
+    if (plan.randomRun.count > 0) {
+        std::vector<uint8_t> run(static_cast<size_t>(plan.randomRun.count * bytesPerCluster));
+        for (size_t offset = 0; offset < run.size(); offset += static_cast<size_t>(bytesPerCluster)) {
+            FillWeakMagicCluster(rng, run.data() + offset, static_cast<size_t>(bytesPerCluster));
+        }
+        writer.Write(clusterOffset(plan.randomRun.cluster), run);
+    }
+}
+
+std::string FileName(const PlannedFile& file) {
+    char name[32];
+    snprintf(name, sizeof(name), "f%07llu.%s", static_cast<unsigned long long>(file.index), Extension(file.format));
+    return name;
+}
+
+std::string DirectoryName(uint64_t directory) {
+    char name[16];
+    snprintf(name, sizeof(name), "dir%03llu", static_cast<unsigned long long>(directory));
+    return name;
+}
+
+void SetBits(std::vector<uint8_t>& bitmap, uint64_t first, uint64_t count) {
+    for (uint64_t bit = first; bit < first + count; bit++) {
+        bitmap[static_cast<size_t>(bit / 8)] |= static_cast<uint8_t>(1u << (bit % 8));
+    }
+}
+
+// ============================================================================
+// NTFS
+// ============================================================================
+
+class MftRecordBuilder {
+public:
+    MftRecordBuilder(uint64_t recordNumber, uint16_t flags)
+        : m_data(NTFS_RECORD_SIZE, 0)
+        , m_offset(0x38)
+    {
+        std::memcpy(m_data.data(), "FILE", 4);
+        Put<uint16_t>(m_data, 0x04, 0x30);     // Update sequence array offset
+        Put<uint16_t>(m_data, 0x06, 3);        // USN + one entry per sector
+        Put<uint16_t>(m_data, 0x10, 1);        // Sequence number
+        Put<uint16_t>(m_data, 0x12, 1);        // Hard links
+        Put<uint16_t>(m_data, 0x14, 0x38);     // First attribute
+        Put<uint16_t>(m_data, 0x16, flags);
+        Put<uint32_t>(m_data, 0x1C, static_cast<uint32_t>(NTFS_RECORD_SIZE));
+        Put<uint32_t>(m_data, 0x2C, static_cast<uint32_t>(recordNumber));
+    }
+
+    void AddFileName(uint64_t parentRecord, const std::string& name, uint64_t size, bool directory) {
+        std::vector<uint8_t> value(66 + name.size() * 2, 0);
+        Put<uint64_t>(value, 0x00, parentRecord | (1ULL << 48));
+        Put<uint64_t>(value, 0x28, size);
+        Put<uint64_t>(value, 0x30, size);
+        Put<uint32_t>(value, 0x38, directory ? 0x10000000u : 0x20u);
+        value[0x40] = static_cast<uint8_t>(name.size());
+        value[0x41] = 1;                       // Win32 namespace
+        PutUtf16(value, 0x42, name);
+        AddResident(0x30, value);
+    }
+
+    void AddResident(uint32_t type, const std::vector<uint8_t>& value) {
+        size_t length = (24 + value.size() + 7) & ~size_t(7);
+        size_t at = Reserve(length);
+        Put<uint32_t>(m_data, at + 0x00, type);
+        Put<uint32_t>(m_data, at + 0x04, static_cast<uint32_t>(length));
+        Put<uint16_t>(m_data, at + 0x0E, m_nextId++);
+        Put<uint32_t>(m_data, at + 0x10, static_cast<uint32_t>(value.size()));
+        Put<uint16_t>(m_data, at + 0x14, 24);
+        std::memcpy(m_data.data() + at + 24, value.data(), value.size());
+    }
+
+    void AddNonResident(uint32_t type, const std::vector<Extent>& extents, uint64_t realSize,
+                        uint64_t bytesPerCluster) {
+        auto runs = EncodeRuns(extents);
+        uint64_t clusters = 0;
+        for (const auto& extent : extents) clusters += extent.count;
+
+        size_t length = (64 + runs.size() + 7) & ~size_t(7);
+        size_t at = Reserve(length);
+        Put<uint32_t>(m_data, at + 0x00, type);
+        Put<uint32_t>(m_data, at + 0x04, static_cast<uint32_t>(length));
+        m_data[at + 0x08] = 1;
+        Put<uint16_t>(m_data, at + 0x0A, 0x40);
+        Put<uint16_t>(m_data, at + 0x0E, m_nextId++);
+        Put<uint64_t>(m_data, at + 0x18, clusters > 0 ? clusters - 1 : 0);
+        Put<uint16_t>(m_data, at + 0x20, 0x40);
+        Put<uint64_t>(m_data, at + 0x28, clusters * bytesPerCluster);
+        Put<uint64_t>(m_data, at + 0x30, realSize);
+        Put<uint64_t>(m_data, at + 0x38, realSize);
+        std::memcpy(m_data.data() + at + 64, runs.data(), runs.size());
+    }
+
+    // End marker, used size and the per-sector fixups
+    std::vector<uint8_t> Finish() {
+        size_t at = Reserve(8);
+        Put<uint32_t>(m_data, at, 0xFFFFFFFFu);
+        Put<uint32_t>(m_data, 0x18, static_cast<uint32_t>(m_offset));
+        Put<uint16_t>(m_data, 0x28, m_nextId);
+
+        const uint16_t usn = 1;
+        Put<uint16_t>(m_data, 0x30, usn);
+        for (size_t sector = 1; sector <= NTFS_RECORD_SIZE / SECTOR; sector++) {
+            size_t tail = sector * SECTOR - 2;
+            std::memcpy(m_data.data() + 0x30 + sector * 2, m_data.data() + tail, 2);
+            Put<uint16_t>(m_data, tail, usn);
+        }
+        return m_data;
+    }
+
+private:
+    size_t Reserve(size_t length) {
+        // Keep room for the end marker
+        if (m_offset + length + 8 > NTFS_RECORD_SIZE) {
+            throw std::runtime_error("MFT record overflow; lower --max-fragments");
+        }
+        size_t at = m_offset;
+        m_offset += length;
+        return at;
+    }
+
+    static std::vector<uint8_t> EncodeRuns(const std::vector<Extent>& extents) {
+        std::vector<uint8_t> runs;
+        int64_t previous = 0;
+        for (const auto& extent : extents) {
+            uint8_t lengthBytes = 0;
+            for (uint64_t v = extent.count; v != 0; v >>= 8) lengthBytes++;
+
+            // Signed delta in the fewest bytes that keep its sign bit
+            int64_t delta = static_cast<int64_t>(extent.cluster) - previous;
+            uint8_t offsetBytes = 1;
+            while (offsetBytes < 8) {
+                int64_t limit = 1LL << (offsetBytes * 8 - 1);
+                if (delta >= -limit && delta < limit) break;
+                offsetBytes++;
+            }
+
+            runs.push_back(static_cast<uint8_t>((offsetBytes << 4) | lengthBytes));
+            for (uint8_t b = 0; b < lengthBytes; b++) runs.push_back(static_cast<uint8_t>(extent.count >> (b * 8)));
+            for (uint8_t b = 0; b < offsetBytes; b++) runs.push_back(static_cast<uint8_t>(static_cast<uint64_t>(delta) >> (b * 8)));
+            previous = static_cast<int64_t>(extent.cluster);
+        }
+        runs.push_back(0);
+        return runs;
+    }
+
+    std::vector<uint8_t> m_data;
+    size_t m_offset;
+    uint16_t m_nextId = 0;
+};
+
+SyntheticImageInfo WriteNtfs(const SyntheticImageSpec& spec, const std::wstring& path) {
+    const uint64_t bpc = spec.bytesPerCluster;
+    const uint64_t totalClusters = spec.imageBytes / bpc;
+    Random rng(spec.seed);
+
+    // Metadata sits at the volume start: $MFT, then both bitmaps, then file data
+    uint64_t recordCount = NTFS_FIRST_USER_RECORD + spec.directoryCount + spec.fileCount;
+    uint64_t mftCluster = std::max<uint64_t>(1, CeilDiv(8192, bpc));
+    uint64_t mftClusters = CeilDiv(recordCount * NTFS_RECORD_SIZE, bpc);
+    recordCount = mftClusters * bpc / NTFS_RECORD_SIZE;
+
+    uint64_t volumeBitmapBytes = (CeilDiv(totalClusters, 8) + 7) & ~7ULL;
+    uint64_t volumeBitmapCluster = mftCluster + mftClusters;
+    uint64_t volumeBitmapClusters = CeilDiv(volumeBitmapBytes, bpc);
+    uint64_t mftBitmapBytes = (CeilDiv(recordCount, 8) + 7) & ~7ULL;
+    uint64_t mftBitmapCluster = volumeBitmapCluster + volumeBitmapClusters;
+    uint64_t mftBitmapClusters = CeilDiv(mftBitmapBytes, bpc);
+    uint64_t dataStart = mftBitmapCluster + mftBitmapClusters;
+
+    // The last sector holds the backup boot sector
+    Plan plan = PlanFiles(spec, rng, dataStart, totalClusters - 1);
+
+    ImageWriter writer(path, spec.imageBytes);
+    SyntheticImageInfo info;
+
+    // Boot sector
+    std::vector<uint8_t> boot(SECTOR, 0);
+    boot[0] = 0xEB; boot[1] = 0x52; boot[2] = 0x90;
+    std::memcpy(boot.data() + 3, "NTFS    ", 8);
+    Put<uint16_t>(boot, 0x0B, static_cast<uint16_t>(SECTOR));
+    boot[0x0D] = static_cast<uint8_t>(bpc / SECTOR);
+    boot[0x15] = 0xF8;
+    Put<uint64_t>(boot, 0x28, spec.imageBytes / SECTOR - 1);
+    Put<uint64_t>(boot, 0x30, mftCluster);
+    Put<uint64_t>(boot, 0x38, mftCluster);
+    boot[0x40] = static_cast<uint8_t>(-10);   // 2^10 = 1024-byte records
+    boot[0x44] = 1;
+    Put<uint64_t>(boot, 0x48, spec.seed * 0x9E3779B97F4A7C15ULL);
+    Put<uint16_t>(boot, 0x1FE, 0xAA55);
+    writer.Write(0, boot);
+    writer.Write((spec.imageBytes / SECTOR - 1) * SECTOR, boot);
+
+    std::vector<uint8_t> mft(static_cast<size_t>(recordCount * NTFS_RECORD_SIZE), 0);
+    std::vector<uint8_t> mftBitmap(static_cast<size_t>(mftBitmapBytes), 0);
+    std::vector<uint8_t> volumeBitmap(static_cast<size_t>(volumeBitmapBytes), 0);
+    auto store = [&](uint64_t record, const std::vector<uint8_t>& data) {
+        std::memcpy(mft.data() + record * NTFS_RECORD_SIZE, data.data(), data.size());
+    };
+
+    // System records 0-23 are always in use; only the ones the scanner reads carry data
+    static const char* const systemNames[] = {
+        "$MFT", "$MFTMirr", "$LogFile", "$Volume", "$AttrDef", ".", "$Bitmap", "$Boot",
+        "$BadClus", "$Secure", "$UpCase", "$Extend" };
+    const uint64_t rootRecord = 5;
+    for (uint64_t record = 0; record < 12; record++) {
+        bool directory = record == rootRecord || record == 11;
+        MftRecordBuilder builder(record, directory ? 0x0003 : 0x0001);
+        builder.AddFileName(rootRecord, systemNames[record], 0, directory);
+        if (record == 0) {
+            builder.AddNonResident(0x80, { { mftCluster, mftClusters } }, mftClusters * bpc, bpc);
+            builder.AddNonResident(0xB0, { { mftBitmapCluster, mftBitmapClusters } }, mftBitmapBytes, bpc);
+        } else if (record == 6) {
+            builder.AddNonResident(0x80, { { volumeBitmapCluster, volumeBitmapClusters } }, volumeBitmapBytes, bpc);
+        }
+        store(record, builder.Finish());
+    }
+    SetBits(mftBitmap, 0, NTFS_FIRST_USER_RECORD);
+
+    for (uint64_t d = 0; d < spec.directoryCount; d++) {
+        uint64_t record = NTFS_FIRST_USER_RECORD + d;
+        MftRecordBuilder builder(record, 0x0003);
+        builder.AddFileName(rootRecord, DirectoryName(d), 0, true);
+        store(record, builder.Finish());
+        SetBits(mftBitmap, record, 1);
+    }
+
+    uint64_t firstFileRecord = NTFS_FIRST_USER_RECORD + spec.directoryCount;
+    for (const auto& file : plan.files) {
+        uint64_t record = firstFileRecord + file.index;
+        MftRecordBuilder builder(record, file.deleted ? 0x0000 : 0x0001);
+        builder.AddFileName(NTFS_FIRST_USER_RECORD + file.directory, FileName(file), file.size, false);
+        builder.AddNonResident(0x80, file.extents, file.size, bpc);
+        store(record, builder.Finish());
+
+        if (!file.deleted) {
+            SetBits(mftBitmap, record, 1);
+            for (const auto& extent : file.extents) SetBits(volumeBitmap, extent.cluster, extent.count);
+        }
+    }
+
+    SetBits(volumeBitmap, 0, dataStart);
+    SetBits(volumeBitmap, totalClusters - 1, 1);
+
+    writer.Write(mftCluster * bpc, mft);
+    writer.Write(volumeBitmapCluster * bpc, volumeBitmap);
+    writer.Write(mftBitmapCluster * bpc, mftBitmap);
+    WriteContents(writer, rng, plan, bpc, [bpc](uint64_t lcn) { return lcn * bpc; }, info);
+    writer.Finish();
+    return info;
+}
+
+// ============================================================================
+// FAT32
+// ============================================================================
+
+uint8_t ShortNameChecksum(const uint8_t* shortName) {
+    uint8_t sum = 0;
+    for (int i = 0; i < 11; i++) {
+        sum = static_cast<uint8_t>(((sum & 1) << 7) + (sum >> 1) + shortName[i]);
+    }
+    return sum;
+}
+
+// One LFN slot (up to 13 characters) followed by its 8.3 entry
+void AppendFatEntry(std::vector<uint8_t>& dir, const std::string& longName, const char* shortName,
+                    uint8_t attributes, uint32_t cluster, uint32_t size, bool deleted) {
+    uint8_t shortEntry[32] = {};
+    std::memcpy(shortEntry, shortName, 11);
+    shortEntry[11] = attributes;
+    std::memcpy(shortEntry + 20, reinterpret_cast<const uint8_t*>(&cluster) + 2, 2);
+    std::memcpy(shortEntry + 26, &cluster, 2);
+    std::memcpy(shortEntry + 28, &size, 4);
+
+    if (!longName.empty()) {
+        uint8_t lfn[32] = {};
+        lfn[0] = 0x41;                         // Last (and only) slot, sequence 1
+        lfn[11] = 0x0F;
+        lfn[13] = ShortNameChecksum(shortEntry);
+        static const size_t charOffsets[13] = { 1, 3, 5, 7, 9, 14, 16, 18, 20, 22, 24, 28, 30 };
+        for (size_t i = 0; i < 13; i++) {
+            uint16_t ch = i < longName.size() ? static_cast<uint8_t>(longName[i])
+                        : (i == longName.size() ? 0x0000 : 0xFFFF);
+            std::memcpy(lfn + charOffsets[i], &ch, 2);
+        }
+        if (deleted) lfn[0] = 0xE5;
+        dir.insert(dir.end(), lfn, lfn + 32);
+    }
+
+    if (deleted) shortEntry[0] = 0xE5;
+    dir.insert(dir.end(), shortEntry, shortEntry + 32);
+}
+
+SyntheticImageInfo WriteFat32(const SyntheticImageSpec& spec, const std::wstring& path) {
+    const uint64_t bpc = spec.bytesPerCluster;
+    const uint64_t sectorsPerCluster = bpc / SECTOR;
+    const uint64_t totalSectors = spec.imageBytes / SECTOR;
+    const uint64_t reservedSectors = 32;
+    Random rng(spec.seed);
+
+    // Sizing the FAT for every cluster the image could hold is a slight overestimate
+    uint64_t fatSectors = CeilDiv((CeilDiv(totalSectors - reservedSectors, sectorsPerCluster) + 2) * 4, SECTOR);
+    uint64_t dataStartSector = reservedSectors + 2 * fatSectors;
+    uint64_t clusterCount = (totalSectors - dataStartSector) / sectorsPerCluster;
+    if (totalSectors > UINT32_MAX || totalSectors <= dataStartSector) {
+        throw std::runtime_error("Image size out of range for FAT32");
+    }
+    auto clusterOffset = [=](uint64_t cluster) { return (dataStartSector + (cluster - 2) * sectorsPerCluster) * SECTOR; };
+
+    // Directory clusters come first, then file data
+    std::vector<uint64_t> filesPerDirectory(static_cast<size_t>(spec.directoryCount), 0);
+    for (uint64_t i = 0; i < spec.fileCount; i++) filesPerDirectory[static_cast<size_t>(i % spec.directoryCount)]++;
+
+    uint64_t rootClusters = CeilDiv((spec.directoryCount * 2 + 1) * 32, bpc);
+    std::vector<Extent> directoryExtents;
+    uint64_t cursor = 2 + rootClusters;
+    for (uint64_t d = 0; d < spec.directoryCount; d++) {
+        uint64_t clusters = CeilDiv((filesPerDirectory[static_cast<size_t>(d)] * 2 + 3) * 32, bpc);
+        directoryExtents.push_back({ cursor, clusters });
+        cursor += clusters;
+    }
+
+    Plan plan = PlanFiles(spec, rng, cursor, clusterCount + 2);
+
+    std::vector<uint32_t> fat(static_cast<size_t>(clusterCount + 2), 0);
+    fat[0] = 0x0FFFFFF8;
+    fat[1] = 0x0FFFFFFF;
+    auto chain = [&](const std::vector<Extent>& extents) {
+        uint64_t previous = 0;
+        for (const auto& extent : extents) {
+            for (uint64_t c = extent.cluster; c < extent.cluster + extent.count; c++) {
+                if (previous != 0) fat[static_cast<size_t>(previous)] = static_cast<uint32_t>(c);
+                previous = c;
+            }
+        }
+        if (previous != 0) fat[static_cast<size_t>(previous)] = 0x0FFFFFFF;
+    };
+
+    ImageWriter writer(path, spec.imageBytes);
+    SyntheticImageInfo info;
+
+    // Root: one entry per subdirectory
+    std::vector<uint8_t> root;
+    AppendFatEntry(root, "", "SYNTHETIC  ", 0x08, 0, 0, false);
+    for (uint64_t d = 0; d < spec.directoryCount; d++) {
+        char shortName[12];
+        snprintf(shortName, sizeof(shortName), "DIR%03llu     ", static_cast<unsigned long long>(d));
+        AppendFatEntry(root, DirectoryName(d), shortName, 0x10,
+                       static_cast<uint32_t>(directoryExtents[static_cast<size_t>(d)].cluster), 0, false);
+    }
+    chain({ { 2, rootClusters } });
+    writer.Write(clusterOffset(2), root);
+
+    std::vector<std::vector<uint8_t>> directories(static_cast<size_t>(spec.directoryCount));
+    for (uint64_t d = 0; d < spec.directoryCount; d++) {
+        auto& dir = directories[static_cast<size_t>(d)];
+        AppendFatEntry(dir, "", ".          ", 0x10, static_cast<uint32_t>(directoryExtents[static_cast<size_t>(d)].cluster), 0, false);
+        AppendFatEntry(dir, "", "..         ", 0x10, 0, 0, false);
+        chain({ directoryExtents[static_cast<size_t>(d)] });
+    }
+
+    for (const auto& file : plan.files) {
+        char shortName[12];
+        std::string ext = Extension(file.format);
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::toupper);
+        snprintf(shortName, sizeof(shortName), "F%07llu%s", static_cast<unsigned long long>(file.index), ext.c_str());
+        AppendFatEntry(directories[static_cast<size_t>(file.directory)], FileName(file), shortName, 0x20,
+                       static_cast<uint32_t>(file.FirstCluster()), static_cast<uint32_t>(file.size), file.deleted);
+
+        // Deleting a file frees its chain; the directory entry keeps the first cluster
+        if (!file.deleted) chain(file.extents);
+    }
+
+    for (uint64_t d = 0; d < spec.directoryCount; d++) {
+        writer.Write(clusterOffset(directoryExtents[static_cast<size_t>(d)].cluster), directories[static_cast<size_t>(d)]);
+    }
+
+    std::vector<uint8_t> boot(SECTOR, 0);
+    boot[0] = 0xEB; boot[1] = 0x58; boot[2] = 0x90;
+    std::memcpy(boot.data() + 3, "MSWIN4.1", 8);
+    Put<uint16_t>(boot, 0x0B, static_cast<uint16_t>(SECTOR));
+    boot[0x0D] = static_cast<uint8_t>(sectorsPerCluster);
+    Put<uint16_t>(boot, 0x0E, static_cast<uint16_t>(reservedSectors));
+    boot[0x10] = 2;
+    boot[0x15] = 0xF8;
+    Put<uint32_t>(boot, 0x20, static_cast<uint32_t>(totalSectors));
+    Put<uint32_t>(boot, 0x24, static_cast<uint32_t>(fatSectors));
+    Put<uint32_t>(boot, 0x2C, 2);              // Root cluster
+    Put<uint16_t>(boot, 0x30, 1);              // FSInfo sector
+    Put<uint16_t>(boot, 0x32, 6);              // Backup boot sector
+    boot[0x40] = 0x80;
+    boot[0x42] = 0x29;
+    Put<uint32_t>(boot, 0x43, static_cast<uint32_t>(spec.seed * 0x9E3779B9u));
+    std::memcpy(boot.data() + 0x47, "NO NAME    FAT32   ", 19);
+    Put<uint16_t>(boot, 0x1FE, 0xAA55);
+    writer.Write(0, boot);
+    writer.Write(6 * SECTOR, boot);
+
+    for (uint64_t copy = 0; copy < 2; copy++) {
+        writer.Write((reservedSectors + copy * fatSectors) * SECTOR, fat.data(), fat.size() * sizeof(uint32_t));
+    }
+    WriteContents(writer, rng, plan, bpc, clusterOffset, info);
+    writer.Finish();
+    return info;
+}
+
+// ============================================================================
+// exFAT
+// ============================================================================
+
+uint16_t ExFatNameHash(const std::string& name) {
+    uint16_t hash = 0;
+    for (char c : name) {
+        uint16_t ch = static_cast<uint8_t>(::toupper(static_cast<unsigned char>(c)));
+        for (int b = 0; b < 2; b++) {
+            hash = static_cast<uint16_t>(((hash & 1) ? 0x8000 : 0) + (hash >> 1) + ((ch >> (b * 8)) & 0xFF));
+        }
+    }
+    return hash;
+}
+
+// File + stream + name entries; a deleted set has the in-use bit cleared on every entry
+void AppendExFatEntrySet(std::vector<uint8_t>& dir, const std::string& name, uint16_t attributes,
+                         uint32_t firstCluster, uint64_t size, bool contiguous, bool deleted) {
+    size_t nameEntries = CeilDiv(name.size(), 15);
+    std::vector<uint8_t> set((2 + nameEntries) * 32, 0);
+
+    set[0] = 0x85;
+    set[1] = static_cast<uint8_t>(1 + nameEntries);
+    Put<uint16_t>(set, 4, attributes);
+
+    set[32] = 0xC0;
+    set[33] = static_cast<uint8_t>(0x01 | (contiguous ? 0x02 : 0x00));   // Allocation possible, no FAT chain
+    set[35] = static_cast<uint8_t>(name.size());
+    Put<uint16_t>(set, 36, ExFatNameHash(name));
+    Put<uint64_t>(set, 40, size);
+    Put<uint32_t>(set, 52, firstCluster);
+    Put<uint64_t>(set, 56, size);
+
+    for (size_t n = 0; n < nameEntries; n++) {
+        size_t at = (2 + n) * 32;
+        set[at] = 0xC1;
+        std::string part = name.substr(n * 15, 15);
+        PutUtf16(set, at + 2, part);
+    }
+
+    uint16_t checksum = 0;
+    for (size_t i = 0; i < set.size(); i++) {
+        if (i == 2 || i == 3) continue;
+        checksum = static_cast<uint16_t>(((checksum & 1) ? 0x8000 : 0) + (checksum >> 1) + set[i]);
+    }
+    Put<uint16_t>(set, 2, checksum);
+
+    if (deleted) {
+        for (size_t at = 0; at < set.size(); at += 32) set[at] &= 0x7F;
+    }
+    dir.insert(dir.end(), set.begin(), set.end());
+}
+
+SyntheticImageInfo WriteExFat(const SyntheticImageSpec& spec, const std::wstring& path) {
+    const uint64_t bpc = spec.bytesPerCluster;
+    const uint64_t sectorsPerCluster = bpc / SECTOR;
+    const uint64_t totalSectors = spec.imageBytes / SECTOR;
+    Random rng(spec.seed);
+
+    uint8_t clusterShift = 0;
+    while ((1ULL << clusterShift) < sectorsPerCluster) clusterShift++;
+
+    // Boot region (main + backup) takes 24 sectors; FAT and heap are cluster-aligned
+    const uint64_t fatOffset = std::max<uint64_t>(32, sectorsPerCluster);
+    uint64_t fatLength = CeilDiv((CeilDiv(totalSectors, sectorsPerCluster) + 2) * 4, SECTOR);
+    uint64_t heapOffset = CeilDiv(fatOffset + fatLength, sectorsPerCluster) * sectorsPerCluster;
+    if (totalSectors <= heapOffset) {
+        throw std::runtime_error("Image size out of range for exFAT");
+    }
+    uint64_t clusterCount = std::min<uint64_t>((totalSectors - heapOffset) / sectorsPerCluster, 0xFFFFFFF5);
+    auto clusterOffset = [=](uint64_t cluster) { return (heapOffset + (cluster - 2) * sectorsPerCluster) * SECTOR; };
+
+    std::vector<uint64_t> filesPerDirectory(static_cast<size_t>(spec.directoryCount), 0);
+    for (uint64_t i = 0; i < spec.fileCount; i++) filesPerDirectory[static_cast<size_t>(i % spec.directoryCount)]++;
+
+    // Allocation bitmap, root directory, subdirectories, then file data
+    uint64_t bitmapBytes = CeilDiv(clusterCount, 8);
+    Extent bitmapExtent = { 2, CeilDiv(bitmapBytes, bpc) };
+    uint64_t rootEntries = 2 + spec.directoryCount * 3;
+    Extent rootExtent = { bitmapExtent.cluster + bitmapExtent.count, CeilDiv(rootEntries * 32, bpc) };
+    std::vector<Extent> directoryExtents;
+    uint64_t cursor = rootExtent.cluster + rootExtent.count;
+    for (uint64_t d = 0; d < spec.directoryCount; d++) {
+        uint64_t clusters = CeilDiv((filesPerDirectory[static_cast<size_t>(d)] * 3 + 1) * 32, bpc);
+        directoryExtents.push_back({ cursor, clusters });
+        cursor += clusters;
+    }
+
+    Plan plan = PlanFiles(spec, rng, cursor, clusterCount + 2);
+
+    std::vector<uint32_t> fat(static_cast<size_t>(clusterCount + 2), 0);
+    fat[0] = 0xFFFFFFF8;
+    fat[1] = 0xFFFFFFFF;
+    std::vector<uint8_t> bitmap(static_cast<size_t>(bitmapBytes), 0);
+    auto markAllocated = [&](const std::vector<Extent>& extents) {
+        for (const auto& extent : extents) SetBits(bitmap, extent.cluster - 2, extent.count);
+    };
+    auto chain = [&](const std::vector<Extent>& extents) {
+        uint64_t previous = 0;
+        for (const auto& extent : extents) {
+            for (uint64_t c = extent.cluster; c < extent.cluster + extent.count; c++) {
+                if (previous != 0) fat[static_cast<size_t>(previous)] = static_cast<uint32_t>(c);
+                previous = c;
+            }
+        }
+        if (previous != 0) fat[static_cast<size_t>(previous)] = 0xFFFFFFFF;
+    };
+
+    ImageWriter writer(path, spec.imageBytes);
+    SyntheticImageInfo info;
+
+    for (const auto& extent : { bitmapExtent, rootExtent }) {
+        markAllocated({ extent });
+        chain({ extent });
+    }
+
+    std::vector<uint8_t> root(32, 0);
+    root[0] = 0x81;                            // Allocation bitmap entry
+    Put<uint32_t>(root, 20, static_cast<uint32_t>(bitmapExtent.cluster));
+    Put<uint64_t>(root, 24, bitmapBytes);
+    for (uint64_t d = 0; d < spec.directoryCount; d++) {
+        const auto& extent = directoryExtents[static_cast<size_t>(d)];
+        AppendExFatEntrySet(root, DirectoryName(d), 0x10, static_cast<uint32_t>(extent.cluster),
+                            extent.count * bpc, false, false);
+        markAllocated({ extent });
+        chain({ extent });
+    }
+    writer.Write(clusterOffset(rootExtent.cluster), root);
+
+    std::vector<std::vector<uint8_t>> directories(static_cast<size_t>(spec.directoryCount));
+    for (const auto& file : plan.files) {
+        AppendExFatEntrySet(directories[static_cast<size_t>(file.directory)], FileName(file), 0x20,
+                            static_cast<uint32_t>(file.FirstCluster()), file.size, file.Contiguous(), file.deleted);
+
+        // Deletion clears the bitmap bits only; a fragmented file's chain stays behind
+        if (!file.deleted) markAllocated(file.extents);
+        if (!file.Contiguous()) chain(file.extents);
+    }
+    for (uint64_t d = 0; d < spec.directoryCount; d++) {
+        writer.Write(clusterOffset(directoryExtents[static_cast<size_t>(d)].cluster), directories[static_cast<size_t>(d)]);
+    }
+
+    std::vector<uint8_t> boot(SECTOR, 0);
+    boot[0] = 0xEB; boot[1] = 0x76; boot[2] = 0x90;
+    std::memcpy(boot.data() + 3, "EXFAT   ", 8);
+    Put<uint64_t>(boot, 0x48, totalSectors);
+    Put<uint32_t>(boot, 0x50, static_cast<uint32_t>(fatOffset));
+    Put<uint32_t>(boot, 0x54, static_cast<uint32_t>(fatLength));
+    Put<uint32_t>(boot, 0x58, static_cast<uint32_t>(heapOffset));
+    Put<uint32_t>(boot, 0x5C, static_cast<uint32_t>(clusterCount));
+    Put<uint32_t>(boot, 0x60, static_cast<uint32_t>(rootExtent.cluster));
+    Put<uint32_t>(boot, 0x64, static_cast<uint32_t>(spec.seed * 0x9E3779B9u));
+    Put<uint16_t>(boot, 0x68, 0x0100);
+    boot[0x6C] = 9;
+    boot[0x6D] = clusterShift;
+    boot[0x6E] = 1;
+    boot[0x6F] = 0x80;
+    Put<uint16_t>(boot, 0x1FE, 0xAA55);
+    writer.Write(0, boot);
+    writer.Write(12 * SECTOR, boot);
+
+    writer.Write(fatOffset * SECTOR, fat.data(), fat.size() * sizeof(uint32_t));
+    writer.Write(clusterOffset(bitmapExtent.cluster), bitmap);
+    WriteContents(writer, rng, plan, bpc, clusterOffset, info);
+    writer.Finish();
+    return info;
+}
+
+} // namespace
+
+SyntheticImageInfo WriteSyntheticImage(const std::wstring& path, const SyntheticImageSpec& spec) {
+    uint64_t bpc = spec.bytesPerCluster;
+    if (bpc < SECTOR || bpc > 64 * 1024 || (bpc & (bpc - 1)) != 0) {
+        throw std::runtime_error("Cluster size must be a power of two between 512 and 65536");
+    }
+    if (spec.formats.empty() || spec.directoryCount == 0 || spec.maxFragments < 2) {
+        throw std::runtime_error("Invalid synthetic image spec");
+    }
+    if (spec.minFileBytes < 64 || spec.minFileBytes > spec.maxFileBytes) {
+        throw std::runtime_error("File sizes must be at least 64 bytes and min <= max");
+    }
+    if (spec.imageBytes < 16 * bpc) {
+        throw std::runtime_error("Image too small");
+    }
+
+    switch (spec.filesystem) {
+        case FilesystemType::NTFS:  return WriteNtfs(spec, path);
+        case FilesystemType::FAT32: return WriteFat32(spec, path);
+        case FilesystemType::ExFAT: return WriteExFat(spec, path);
+        default: break;
+    }
+    throw std::runtime_error("Unsupported filesystem for synthetic images");
+}
+
+} // namespace KVC
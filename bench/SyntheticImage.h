@@ -0,0 +1,54 @@
+// ============================================================================
+// SyntheticImage.h - Synthetic Volume Image Generator
+// ============================================================================
+// Writes small, valid NTFS / FAT32 / exFAT volume images with a controlled
+// number of files, deleted-file density, fragmentation and signature mix.
+// The same spec and seed always produce a byte-identical image.
+// ============================================================================
+
+#pragma once
+
+#include "VolumeGeometry.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace KVC {
+
+// Content formats the generator can emit; each one is recognised by the carver
+enum class SyntheticFormat {
+    JPEG,
+    PDF,
+    ZIP,
+    GIF
+};
+
+struct SyntheticImageSpec {
+    FilesystemType filesystem = FilesystemType::NTFS;
+    uint64_t imageBytes = 256ULL * 1024 * 1024;
+    uint64_t bytesPerCluster = 4096;
+    uint64_t fileCount = 2000;
+    double deletedRatio = 0.5;          // Share of files left as deleted entries
+    double fragmentedRatio = 0.1;       // Share of files split into several runs
+    uint64_t maxFragments = 4;          // Runs per fragmented file (at least 2)
+    uint64_t minFileBytes = 4 * 1024;
+    uint64_t maxFileBytes = 512 * 1024;
+    uint64_t directoryCount = 8;        // Files are spread over root subdirectories
+    uint64_t randomRunClusters = 0;     // Free high-entropy run after the files, a BMP header on every cluster
+    std::vector<SyntheticFormat> formats = { SyntheticFormat::JPEG, SyntheticFormat::PDF,
+                                             SyntheticFormat::ZIP, SyntheticFormat::GIF };
+    uint64_t seed = 1;
+};
+
+struct SyntheticImageInfo {
+    uint64_t filesWritten = 0;
+    uint64_t deletedFiles = 0;
+    uint64_t fragmentedFiles = 0;
+    uint64_t dataBytes = 0;             // File content bytes, excluding metadata
+};
+
+// Writes the image to path; throws std::runtime_error when the layout does
+// not fit or the file cannot be written
+SyntheticImageInfo WriteSyntheticImage(const std::wstring& path, const SyntheticImageSpec& spec);
+
+} // namespace KVC
@@ -0,0 +1,165 @@
+// ============================================================================
+// AlignedBufferPool.cpp - Reusable Sector-Aligned I/O Buffers
+// ============================================================================
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "AlignedBufferPool.h"
+#include "Constants.h"
+
+#include <Windows.h>
+#include <algorithm>
+#include <utility>
+
+namespace KVC {
+
+// ============================================================================
+// AlignedBuffer
+// ============================================================================
+
+AlignedBuffer::AlignedBuffer(size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    // VirtualAlloc returns page-aligned, already-zeroed memory
+    void* memory = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (memory != nullptr) {
+        m_data = static_cast<uint8_t*>(memory);
+        m_size = size;
+    }
+}
+
+AlignedBuffer::~AlignedBuffer() {
+    Release();
+}
+
+AlignedBuffer::AlignedBuffer(AlignedBuffer&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+{
+}
+
+AlignedBuffer& AlignedBuffer::operator=(AlignedBuffer&& other) noexcept {
+    if (this != &other) {
+        Release();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+void AlignedBuffer::Release() {
+    if (m_data != nullptr) {
+        VirtualFree(m_data, 0, MEM_RELEASE);
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
+
+// ============================================================================
+// AlignedBufferPool::Lease
+// ============================================================================
+
+AlignedBufferPool::Lease::Lease(AlignedBufferPool* pool, AlignedBuffer&& buffer)
+    : m_pool(pool)
+    , m_buffer(std::move(buffer))
+{
+}
+
+AlignedBufferPool::Lease::~Lease() {
+    Return();
+}
+
+AlignedBufferPool::Lease::Lease(Lease&& other) noexcept
+    : m_pool(std::exchange(other.m_pool, nullptr))
+    , m_buffer(std::move(other.m_buffer))
+{
+}
+
+AlignedBufferPool::Lease& AlignedBufferPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        Return();
+        m_pool = std::exchange(other.m_pool, nullptr);
+        m_buffer = std::move(other.m_buffer);
+    }
+    return *this;
+}
+
+void AlignedBufferPool::Lease::Return() {
+    if (m_pool != nullptr && m_buffer.IsValid()) {
+        m_pool->Release(std::move(m_buffer));
+    }
+    m_pool = nullptr;
+}
+
+// ============================================================================
+// AlignedBufferPool
+// ============================================================================
+
+AlignedBufferPool::AlignedBufferPool(uint64_t maxCachedBytes)
+    : m_maxCachedBytes(maxCachedBytes)
+{
+}
+
+AlignedBufferPool::Lease AlignedBufferPool::Acquire(size_t minSize) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Best fit: smallest cached buffer that is large enough
+        auto best = m_free.end();
+        for (auto it = m_free.begin(); it != m_free.end(); ++it) {
+            if (it->Size() >= minSize && (best == m_free.end() || it->Size() < best->Size())) {
+                best = it;
+            }
+        }
+
+        if (best != m_free.end()) {
+            AlignedBuffer buffer = std::move(*best);
+            m_free.erase(best);
+            m_cachedBytes -= buffer.Size();
+            return Lease(this, std::move(buffer));
+        }
+    }
+
+    // Round up so slightly different request sizes share buffers
+    const size_t granularity = static_cast<size_t>(Constants::ALLOCATION_GRANULARITY);
+    size_t allocSize = ((std::max<size_t>(minSize, 1) + granularity - 1) / granularity) * granularity;
+
+    AlignedBuffer buffer(allocSize);
+    if (!buffer.IsValid()) {
+        return Lease();
+    }
+    return Lease(this, std::move(buffer));
+}
+
+void AlignedBufferPool::Release(AlignedBuffer&& buffer) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_cachedBytes + buffer.Size() > m_maxCachedBytes) {
+        return;  // Over budget: buffer is freed as it goes out of scope
+    }
+
+    m_cachedBytes += buffer.Size();
+    m_free.push_back(std::move(buffer));
+}
+
+void AlignedBufferPool::Trim() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free.clear();
+    m_cachedBytes = 0;
+}
+
+uint64_t AlignedBufferPool::CachedBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_cachedBytes;
+}
+
+AlignedBufferPool& AlignedBufferPool::Shared() {
+    static AlignedBufferPool pool(Constants::SHARED_BUFFER_POOL_BYTES);
+    return pool;
+}
+
+} // namespace KVC
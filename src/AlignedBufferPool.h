@@ -0,0 +1,100 @@
+// ============================================================================
+// AlignedBufferPool.h - Reusable Sector-Aligned I/O Buffers
+// ============================================================================
+// Page-aligned buffers (valid for any sector size up to 4KB) that are
+// recycled across reads instead of allocating and zero-filling a fresh
+// std::vector per call. Required for unbuffered and overlapped disk I/O.
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace KVC {
+
+// ============================================================================
+// AlignedBuffer - Owning, move-only, page-aligned allocation
+// ============================================================================
+class AlignedBuffer {
+public:
+    AlignedBuffer() = default;
+    explicit AlignedBuffer(size_t size);
+    ~AlignedBuffer();
+
+    AlignedBuffer(AlignedBuffer&& other) noexcept;
+    AlignedBuffer& operator=(AlignedBuffer&& other) noexcept;
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    uint8_t* Data() { return m_data; }
+    const uint8_t* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+    bool IsValid() const { return m_data != nullptr; }
+
+private:
+    void Release();
+
+    uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+// ============================================================================
+// AlignedBufferPool - Thread-safe free list of AlignedBuffers
+// ============================================================================
+class AlignedBufferPool {
+public:
+    // Buffer on loan from a pool; returned automatically on destruction
+    class Lease {
+    public:
+        Lease() = default;
+        ~Lease();
+
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        uint8_t* Data() { return m_buffer.Data(); }
+        const uint8_t* Data() const { return m_buffer.Data(); }
+        size_t Size() const { return m_buffer.Size(); }
+        bool IsValid() const { return m_buffer.IsValid(); }
+
+    private:
+        friend class AlignedBufferPool;
+        Lease(AlignedBufferPool* pool, AlignedBuffer&& buffer);
+        void Return();
+
+        AlignedBufferPool* m_pool = nullptr;
+        AlignedBuffer m_buffer;
+    };
+
+    explicit AlignedBufferPool(uint64_t maxCachedBytes);
+    ~AlignedBufferPool() = default;
+
+    AlignedBufferPool(const AlignedBufferPool&) = delete;
+    AlignedBufferPool& operator=(const AlignedBufferPool&) = delete;
+
+    // Returns a buffer of at least minSize bytes (invalid lease on OOM)
+    Lease Acquire(size_t minSize);
+
+    // Drop every cached buffer
+    void Trim();
+
+    uint64_t CachedBytes() const;
+
+    // Process-wide pool for small, frequently recycled buffers
+    static AlignedBufferPool& Shared();
+
+private:
+    void Release(AlignedBuffer&& buffer);
+
+    mutable std::mutex m_mutex;
+    std::vector<AlignedBuffer> m_free;
+    uint64_t m_cachedBytes = 0;
+    uint64_t m_maxCachedBytes;
+};
+
+} // namespace KVC
@@ -0,0 +1,39 @@
+// ============================================================================
+// BandwidthLimiter.cpp - Shared Read Bandwidth Budget
+// ============================================================================
+
+#include "BandwidthLimiter.h"
+#include "Constants.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <thread>
+
+namespace KVC {
+
+void BandwidthLimiter::Acquire(uint64_t bytes) {
+    if (m_bytesPerSecond == 0 || bytes == 0) {
+        return;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto cost = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(bytes) / m_bytesPerSecond));
+
+    // Readers are served in booking order; each one's start is where the
+    // previous booking ends, so the wait never depends on the lock
+    Clock::time_point start;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const Clock::time_point earliest =
+            Clock::now() - std::chrono::milliseconds(Constants::Bandwidth::BURST_MILLISECONDS);
+        start = std::max(m_nextFree, earliest);
+        m_nextFree = start + cost;
+    }
+
+    if (start > Clock::now()) {
+        Perf::ScopedTimer timer(Perf::Timer::BandwidthWait);
+        std::this_thread::sleep_until(start);
+    }
+}
+
+} // namespace KVC
@@ -0,0 +1,37 @@
+// ============================================================================
+// BandwidthLimiter.h - Shared Read Bandwidth Budget
+// ============================================================================
+// Token bucket shared by every DiskHandle of a scan, so concurrent volume
+// scans together never read faster than the configured total. A read books
+// its bytes up front and sleeps until the budget reaches it; a short idle
+// allowance lets small metadata reads through without queuing.
+// ============================================================================
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace KVC {
+
+class BandwidthLimiter {
+public:
+    // 0 = unlimited
+    explicit BandwidthLimiter(uint64_t bytesPerSecond) : m_bytesPerSecond(bytesPerSecond) {}
+
+    BandwidthLimiter(const BandwidthLimiter&) = delete;
+    BandwidthLimiter& operator=(const BandwidthLimiter&) = delete;
+
+    // Block until bytes fit into the budget; safe from any thread
+    void Acquire(uint64_t bytes);
+
+    uint64_t BytesPerSecond() const { return m_bytesPerSecond; }
+
+private:
+    const uint64_t m_bytesPerSecond;
+    std::mutex m_mutex;
+    std::chrono::steady_clock::time_point m_nextFree;   // End of the budget booked so far
+};
+
+} // namespace KVC
@@ -0,0 +1,590 @@
+// ============================================================================
+// BifragmentCarver.cpp - Second-Pass Gap Carving for Two-Fragment Files
+// ============================================================================
+
+#include "BifragmentCarver.h"
+#include "Constants.h"
+#include <algorithm>
+#include <cstring>
+
+namespace KVC {
+
+namespace {
+
+inline uint16_t ReadLE16(const uint8_t* data) {
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+inline uint32_t ReadLE32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) |
+           (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) |
+           (static_cast<uint32_t>(data[3]) << 24);
+}
+
+inline uint64_t ReadLE64(const uint8_t* data) {
+    return static_cast<uint64_t>(ReadLE32(data)) | (static_cast<uint64_t>(ReadLE32(data + 4)) << 32);
+}
+
+const uint8_t ZIP_LOCAL_SIG[] = { 0x50, 0x4B, 0x03, 0x04 };
+const uint8_t ZIP_CENTRAL_SIG[] = { 0x50, 0x4B, 0x01, 0x02 };
+const uint8_t ZIP_EOCD_SIG[] = { 0x50, 0x4B, 0x05, 0x06 };
+const uint8_t ZIP64_EOCD_SIG[] = { 0x50, 0x4B, 0x06, 0x06 };
+const uint8_t ZIP64_LOCATOR_SIG[] = { 0x50, 0x4B, 0x06, 0x07 };
+const uint8_t ZIP_DESCRIPTOR_SIG[] = { 0x50, 0x4B, 0x07, 0x08 };
+
+constexpr uint8_t JPEG_RST0 = 0xD0;
+constexpr uint8_t JPEG_RST7 = 0xD7;
+constexpr uint8_t JPEG_SOI = 0xD8;
+constexpr uint8_t JPEG_EOI = 0xD9;
+constexpr uint8_t JPEG_SOS = 0xDA;
+constexpr uint8_t JPEG_DRI = 0xDD;
+
+bool IsJpeg(const FileSignature& sig) {
+    return std::strcmp(sig.extension, "jpg") == 0;
+}
+
+bool IsZip(const FileSignature& sig) {
+    return std::strcmp(sig.extension, "zip") == 0 ||
+           std::strcmp(sig.extension, "docx") == 0 ||
+           std::strcmp(sig.extension, "xlsx") == 0 ||
+           std::strcmp(sig.extension, "pptx") == 0;
+}
+
+// Entropy-coded data continuing a scan: the first marker must be the restart
+// marker due next (or the end of image); anything else is another stream
+bool ProbeJpegContinuation(const uint8_t* data, size_t size, uint8_t expectedRestart) {
+    for (size_t i = 0; i + 1 < size; i++) {
+        if (data[i] != 0xFF) {
+            continue;
+        }
+
+        size_t next = i + 1;
+        while (next < size && data[next] == 0xFF) {
+            next++;
+        }
+        if (next >= size) {
+            return false;
+        }
+
+        uint8_t marker = data[next];
+        if (marker == 0x00) {
+            i = next;
+            continue;
+        }
+        return marker == JPEG_RST0 + expectedRestart || marker == JPEG_EOI;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Validation
+// ============================================================================
+
+bool BifragmentCarver::Supports(const FileSignature& sig) {
+    return IsJpeg(sig) || IsZip(sig);
+}
+
+BifragmentCarver::Validation BifragmentCarver::Validate(const FileSignature& sig, SequentialReader& reader) {
+    if (IsJpeg(sig)) {
+        return ValidateJpeg(reader);
+    }
+    if (IsZip(sig)) {
+        return ValidateZip(reader);
+    }
+    return {};
+}
+
+BifragmentCarver::Validation BifragmentCarver::ValidateJpeg(SequentialReader& reader) {
+    Validation result;
+    auto broken = [&result](uint64_t at) {
+        result.outcome = Outcome::Broken;
+        result.breakByte = at;
+        return result;
+    };
+    auto complete = [&result, &reader]() {
+        result.outcome = Outcome::Complete;
+        result.endByte = reader.Position();
+        return result;
+    };
+    auto exhausted = [&result]() {
+        result.outcome = Outcome::Unknown;
+        return result;
+    };
+
+    uint8_t tmp[2];
+    if (reader.Read(tmp, 2) != 2 || tmp[0] != 0xFF || tmp[1] != JPEG_SOI) {
+        return broken(0);
+    }
+
+    bool inScan = false;
+    while (true) {
+        if (!inScan) {
+            // Between scans only marker segments may appear
+            uint64_t at = reader.Position();
+            if (reader.Read(tmp, 2) != 2) {
+                return exhausted();
+            }
+            if (tmp[0] != 0xFF) {
+                return broken(at);
+            }
+
+            uint8_t marker = tmp[1];
+            while (marker == 0xFF) {
+                if (!reader.ReadByte(marker)) {
+                    return exhausted();
+                }
+            }
+
+            if (marker == JPEG_EOI) {
+                return complete();
+            }
+            if (marker < 0xC0 || marker == JPEG_SOI || (marker >= JPEG_RST0 && marker <= JPEG_RST7)) {
+                return broken(at);
+            }
+
+            if (reader.Read(tmp, 2) != 2) {
+                return exhausted();
+            }
+            uint16_t length = static_cast<uint16_t>((tmp[0] << 8) | tmp[1]);
+            if (length < 2) {
+                return broken(at);
+            }
+
+            if (marker == JPEG_DRI && length >= 4) {
+                if (reader.Read(tmp, 2) != 2) {
+                    return exhausted();
+                }
+                result.restartMarkers = ((tmp[0] << 8) | tmp[1]) != 0;
+                length -= 2;
+            }
+
+            if (!reader.Skip(length - 2u)) {
+                return exhausted();
+            }
+
+            if (marker == JPEG_SOS) {
+                inScan = true;
+                result.nextRestart = 0;
+                result.checkpoint = reader.Position();
+            }
+            continue;
+        }
+
+        // Entropy-coded data: only 0xFF can introduce a marker
+        if (!reader.SkipTo(0xFF)) {
+            return exhausted();
+        }
+        uint64_t at = reader.Position();
+        uint8_t marker = 0xFF;
+        while (marker == 0xFF) {
+            if (!reader.Skip(1) || !reader.Peek(marker)) {
+                return exhausted();
+            }
+        }
+        reader.Skip(1);
+
+        if (marker == 0x00) {
+            continue;
+        }
+
+        if (marker >= JPEG_RST0 && marker <= JPEG_RST7) {
+            if (result.restartMarkers && marker != JPEG_RST0 + result.nextRestart) {
+                return broken(at);
+            }
+            result.nextRestart = static_cast<uint8_t>((marker - JPEG_RST0 + 1) & 7);
+            result.checkpoint = at;
+            continue;
+        }
+
+        if (marker == JPEG_EOI) {
+            return complete();
+        }
+
+        // Tables or another scan follow (progressive and multi-scan files)
+        if (marker >= 0xC0 && marker != JPEG_SOI) {
+            reader.Seek(at);
+            inScan = false;
+            continue;
+        }
+
+        return broken(at);
+    }
+}
+
+BifragmentCarver::Validation BifragmentCarver::ValidateZip(SequentialReader& reader) {
+    Validation result;
+    uint64_t pos = 0;
+    uint64_t centralStart = UINT64_MAX;
+    uint8_t header[46];
+
+    auto broken = [&result](uint64_t at) {
+        result.outcome = Outcome::Broken;
+        result.breakByte = at;
+        return result;
+    };
+    auto exhausted = [&result]() {
+        result.outcome = Outcome::Unknown;
+        return result;
+    };
+
+    // Each record must start exactly where the previous one ends
+    while (true) {
+        if (!reader.Seek(pos) || reader.Read(header, 4) != 4) {
+            return exhausted();
+        }
+
+        if (std::memcmp(header, ZIP_LOCAL_SIG, 4) == 0) {
+            if (reader.Read(header + 4, 26) != 26) {
+                return exhausted();
+            }
+            uint16_t flags = ReadLE16(header + 6);
+            uint64_t compressed = ReadLE32(header + 18);
+            uint64_t dataStart = pos + 30 + ReadLE16(header + 26) + ReadLE16(header + 28);
+            result.checkpoint = pos;
+
+            if (compressed == 0xFFFFFFFF) {
+                return exhausted();     // ZIP64 sizes live in the extra field
+            }
+
+            if ((flags & 0x0008) != 0 && compressed == 0) {
+                // Sizes follow the data in a descriptor; its signature is
+                // optional, so without one the entry end is unknowable
+                if (!reader.Seek(dataStart) ||
+                    !reader.FindNext(ZIP_DESCRIPTOR_SIG, sizeof(ZIP_DESCRIPTOR_SIG),
+                                     dataStart + Constants::Bifragment::MAX_ZIP_SIZE)) {
+                    return exhausted();
+                }
+                pos = reader.Position() + 16;
+                continue;
+            }
+
+            pos = dataStart + compressed;
+            if ((flags & 0x0008) != 0) {
+                uint8_t descriptor[4];
+                if (reader.Seek(pos) && reader.Read(descriptor, 4) == 4 &&
+                    std::memcmp(descriptor, ZIP_DESCRIPTOR_SIG, 4) == 0) {
+                    pos += 16;
+                } else {
+                    pos += 12;
+                }
+            }
+            continue;
+        }
+
+        if (std::memcmp(header, ZIP_CENTRAL_SIG, 4) == 0) {
+            if (reader.Read(header + 4, 42) != 42) {
+                return exhausted();
+            }
+            if (centralStart == UINT64_MAX) {
+                centralStart = pos;
+            }
+            result.checkpoint = pos;
+            pos += 46 + ReadLE16(header + 28) + ReadLE16(header + 30) + ReadLE16(header + 32);
+            continue;
+        }
+
+        if (std::memcmp(header, ZIP64_EOCD_SIG, 4) == 0) {
+            if (reader.Read(header + 4, 8) != 8) {
+                return exhausted();
+            }
+            pos += 12 + ReadLE64(header + 4);
+            continue;
+        }
+
+        if (std::memcmp(header, ZIP64_LOCATOR_SIG, 4) == 0) {
+            pos += 20;
+            continue;
+        }
+
+        if (std::memcmp(header, ZIP_EOCD_SIG, 4) == 0) {
+            if (reader.Read(header + 4, 18) != 18) {
+                return exhausted();
+            }
+            uint32_t centralOffset = ReadLE32(header + 16);
+            if (centralOffset != 0xFFFFFFFF && centralStart != UINT64_MAX && centralOffset != centralStart) {
+                return broken(pos);
+            }
+            result.outcome = Outcome::Complete;
+            result.endByte = pos + 22 + ReadLE16(header + 20);
+            return result;
+        }
+
+        return broken(pos);
+    }
+}
+
+std::optional<FragmentCandidate> BifragmentCarver::MakeCandidate(
+    const FileSignature& sig,
+    uint64_t startLCN,
+    uint64_t bytesPerCluster,
+    const Validation& validation,
+    std::optional<uint64_t> contiguousSize)
+{
+    if (validation.outcome != Outcome::Broken) {
+        return std::nullopt;
+    }
+
+    // The cluster holding the bad byte is foreign; the one holding the last
+    // good structure is not
+    uint64_t maxSplit = validation.breakByte / bytesPerCluster;
+    if (maxSplit == 0) {
+        return std::nullopt;
+    }
+
+    FragmentCandidate candidate;
+    candidate.signature = sig;
+    candidate.startLCN = startLCN;
+    candidate.maxSplit = maxSplit;
+    candidate.minSplit = std::min(maxSplit, validation.checkpoint / bytesPerCluster + 1);
+    candidate.breakByte = validation.breakByte;
+    candidate.restartMarkers = validation.restartMarkers;
+    candidate.nextRestart = validation.nextRestart;
+    candidate.contiguousSize = contiguousSize;
+    return candidate;
+}
+
+// ============================================================================
+// Continuation Search
+// ============================================================================
+
+BifragmentCarver::BifragmentCarver(VolumeReader& reader, const ClusterBitmap& claimed,
+                                   const ClusterBitmap* allocated, uint64_t maxLCN)
+    : m_reader(reader)
+    , m_claimed(claimed)
+    , m_allocated(allocated)
+    , m_maxLCN(maxLCN)
+{
+}
+
+std::optional<CarvedFile> BifragmentCarver::Resolve(const FragmentCandidate& candidate) const {
+    if (IsJpeg(candidate.signature)) {
+        return ResolveJpeg(candidate);
+    }
+    if (IsZip(candidate.signature)) {
+        return ResolveZip(candidate);
+    }
+    return std::nullopt;
+}
+
+std::optional<CarvedFile> BifragmentCarver::ResolveJpeg(const FragmentCandidate& candidate) const {
+    // Without restart markers any compressed data continues a scan equally well
+    if (!candidate.restartMarkers) {
+        return std::nullopt;
+    }
+
+    const auto& geom = m_reader.Geometry();
+    const uint64_t bytesPerCluster = geom.bytesPerCluster;
+    const std::vector<uint64_t> splits = SplitOrder(candidate);
+
+    const uint64_t firstLCN = candidate.startLCN + candidate.minSplit + 1;
+    const uint64_t lastLCN = std::min(m_maxLCN,
+        candidate.startLCN + candidate.maxSplit + Constants::Bifragment::MAX_GAP_CLUSTERS + 1);
+    const uint64_t probeClusters =
+        (Constants::Bifragment::RESTART_PROBE_BYTES + bytesPerCluster - 1) / bytesPerCluster;
+
+    std::vector<uint8_t> buffer;
+    size_t validations = 0;
+
+    for (uint64_t chunkStart = firstLCN; chunkStart < lastLCN;
+         chunkStart += Constants::Bifragment::SEARCH_CHUNK_CLUSTERS) {
+        uint64_t chunkCount = std::min(Constants::Bifragment::SEARCH_CHUNK_CLUSTERS, lastLCN - chunkStart);
+        uint64_t readCount = std::min(chunkCount + probeClusters, m_maxLCN - chunkStart);
+
+        // Owned clusters cannot hold the continuation; skip all-owned chunks unread
+        if (m_claimed.NextClear(chunkStart, chunkStart + chunkCount) >= chunkStart + chunkCount) {
+            continue;
+        }
+
+        buffer.resize(static_cast<size_t>(readCount * bytesPerCluster));
+        size_t bytesRead = 0;
+        try {
+            bytesRead = m_reader.ReadClustersInto(chunkStart, readCount, buffer.data(), buffer.size());
+        } catch (const DiskReadError&) {
+            continue;
+        }
+
+        for (uint64_t i = 0; i < chunkCount; i++) {
+            uint64_t secondLCN = chunkStart + i;
+            uint64_t offset = i * bytesPerCluster;
+            if (offset >= bytesRead || !IsFree(secondLCN, 1)) {
+                continue;
+            }
+
+            size_t available = static_cast<size_t>(std::min<uint64_t>(
+                Constants::Bifragment::RESTART_PROBE_BYTES, bytesRead - offset));
+            if (!ProbeJpegContinuation(buffer.data() + offset, available, candidate.nextRestart)) {
+                continue;
+            }
+
+            for (uint64_t split : splits) {
+                if (secondLCN <= candidate.startLCN + split) {
+                    continue;
+                }
+                if (validations++ >= Constants::Bifragment::MAX_VALIDATIONS) {
+                    return std::nullopt;
+                }
+
+                auto carved = TrySplit(candidate, split, secondLCN, Constants::MAX_FILE_SCAN_SIZE);
+                if (carved.has_value()) {
+                    return carved;
+                }
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<CarvedFile> BifragmentCarver::ResolveZip(const FragmentCandidate& candidate) const {
+    const auto& geom = m_reader.Geometry();
+    const uint64_t bytesPerCluster = geom.bytesPerCluster;
+    const uint64_t fileStart = candidate.startLCN * bytesPerCluster;
+    const uint64_t volumeBytes = m_maxLCN * bytesPerCluster;
+
+    // The end record lies past the break, in the second fragment
+    const uint64_t searchFrom = fileStart + candidate.breakByte;
+    if (searchFrom >= volumeBytes) {
+        return std::nullopt;
+    }
+    const uint64_t searchBytes = std::min(volumeBytes - searchFrom,
+        Constants::Bifragment::MAX_ZIP_SIZE + Constants::Bifragment::MAX_GAP_CLUSTERS * bytesPerCluster);
+
+    SequentialReader search(m_reader.GetDiskHandle(), geom.volumeStartOffset + searchFrom,
+                            searchBytes, geom.sectorSize);
+    const std::vector<uint64_t> splits = SplitOrder(candidate);
+    size_t records = 0;
+    size_t validations = 0;
+
+    while (records++ < Constants::Bifragment::MAX_EOCD_CANDIDATES &&
+           search.FindNext(ZIP_EOCD_SIG, sizeof(ZIP_EOCD_SIG))) {
+        uint64_t recordByte = searchFrom + search.Position();
+        uint8_t record[22];
+        if (search.Read(record, sizeof(record)) != sizeof(record)) {
+            break;
+        }
+
+        uint64_t centralSize = ReadLE32(record + 12);
+        uint64_t centralOffset = ReadLE32(record + 16);
+        if (centralOffset == 0xFFFFFFFF) {
+            continue;
+        }
+
+        // The record states its own file offset; its disk position then
+        // fixes how far the second fragment was displaced
+        uint64_t recordOffset = centralOffset + centralSize;
+        if (recordByte <= fileStart + recordOffset) {
+            continue;
+        }
+        uint64_t displacement = recordByte - fileStart - recordOffset;
+        if (displacement % bytesPerCluster != 0) {
+            continue;
+        }
+        uint64_t gapClusters = displacement / bytesPerCluster;
+        uint64_t fileEnd = recordOffset + 22 + ReadLE16(record + 20);
+
+        for (uint64_t split : splits) {
+            if (split * bytesPerCluster > recordOffset) {
+                continue;
+            }
+            if (validations++ >= Constants::Bifragment::MAX_VALIDATIONS) {
+                return std::nullopt;
+            }
+
+            auto carved = TrySplit(candidate, split, candidate.startLCN + split + gapClusters, fileEnd);
+            if (carved.has_value() && carved->fileSize == fileEnd) {
+                return carved;
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::vector<uint64_t> BifragmentCarver::SplitOrder(const FragmentCandidate& candidate) const {
+    std::vector<uint64_t> order;
+
+    uint64_t from = candidate.startLCN + candidate.minSplit;
+    uint64_t to = std::min(candidate.startLCN + candidate.maxSplit + 1, m_maxLCN);
+    uint64_t owned = m_claimed.NextSet(from, to);
+    if (m_allocated != nullptr) {
+        owned = std::min(owned, m_allocated->NextSet(from, to));
+    }
+
+    uint64_t boundary = owned < to ? owned - candidate.startLCN : 0;
+    if (boundary != 0) {
+        order.push_back(boundary);
+    }
+
+    for (uint64_t split = candidate.maxSplit;
+         split >= candidate.minSplit && split > 0 &&
+         order.size() < Constants::Bifragment::MAX_SPLIT_CANDIDATES;
+         split--) {
+        if (split != boundary) {
+            order.push_back(split);
+        }
+    }
+    return order;
+}
+
+bool BifragmentCarver::IsFree(uint64_t lcn, uint64_t count) const {
+    if (lcn >= m_maxLCN || count > m_maxLCN - lcn) {
+        return false;
+    }
+    if (m_claimed.NextSet(lcn, lcn + count) < lcn + count) {
+        return false;
+    }
+    return m_allocated == nullptr || m_allocated->NextSet(lcn, lcn + count) >= lcn + count;
+}
+
+std::optional<CarvedFile> BifragmentCarver::TrySplit(
+    const FragmentCandidate& candidate,
+    uint64_t split,
+    uint64_t secondLCN,
+    uint64_t maxBytes) const
+{
+    const auto& geom = m_reader.Geometry();
+    const uint64_t bytesPerCluster = geom.bytesPerCluster;
+    const uint64_t firstBytes = split * bytesPerCluster;
+
+    if (maxBytes <= firstBytes || secondLCN >= m_maxLCN || !IsFree(secondLCN, 1)) {
+        return std::nullopt;
+    }
+
+    uint64_t secondClusters = std::min((maxBytes - firstBytes + bytesPerCluster - 1) / bytesPerCluster,
+                                       m_maxLCN - secondLCN);
+
+    FragmentMap joined(bytesPerCluster);
+    joined.AddRun(candidate.startLCN, split);
+    joined.AddRun(secondLCN, secondClusters);
+    joined.SetTotalSize(std::min(joined.TotalSize(), maxBytes));
+
+    SequentialReader reader(m_reader.GetDiskHandle(), std::move(joined), geom.sectorSize,
+                            geom.volumeStartOffset);
+    Validation validation = Validate(candidate.signature, reader);
+
+    // A file that ends inside the first fragment never needed the second
+    if (validation.outcome != Outcome::Complete || validation.endByte <= firstBytes) {
+        return std::nullopt;
+    }
+
+    uint64_t secondNeeded = (validation.endByte - firstBytes + bytesPerCluster - 1) / bytesPerCluster;
+    if (!IsFree(secondLCN, secondNeeded)) {
+        return std::nullopt;
+    }
+
+    CarvedFile carved;
+    carved.signature = candidate.signature;
+    carved.startLCN = candidate.startLCN;
+    carved.startOffset = 0;
+    carved.fileSize = validation.endByte;
+    carved.fragments = FragmentMap(bytesPerCluster);
+    carved.fragments.AddRun(candidate.startLCN, split);
+    carved.fragments.AddRun(secondLCN, secondNeeded);
+    carved.fragments.SetTotalSize(validation.endByte);
+    return carved;
+}
+
+} // namespace KVC
@@ -0,0 +1,86 @@
+// ============================================================================
+// BifragmentCarver.h - Second-Pass Gap Carving for Two-Fragment Files
+// ============================================================================
+// The contiguous carver assumes a file occupies one run. JPEG and ZIP carry
+// enough structure to notice when that is false: restart markers cycle
+// RST0..RST7, local headers sit exactly where the previous entry ends, and
+// the end-of-central-directory record states where the directory begins.
+// Files that break are deferred as FragmentCandidates; this engine then looks
+// for the second fragment in unclaimed clusters after the first one and keeps
+// the split that validates end to end.
+// ============================================================================
+
+#pragma once
+
+#include "FileCarver.h"
+#include <optional>
+#include <vector>
+
+namespace KVC {
+
+class BifragmentCarver {
+public:
+    enum class Outcome {
+        Complete,       // Reached a consistent end marker
+        Broken,         // Structure failed at Validation::breakByte
+        Unknown         // Ran out of data or hit a form that cannot be checked
+    };
+
+    struct Validation {
+        Outcome outcome = Outcome::Unknown;
+        uint64_t endByte = 0;           // File size when Complete
+        uint64_t breakByte = 0;         // First inconsistent byte when Broken
+        uint64_t checkpoint = 0;        // Start of the last structure that validated
+        bool restartMarkers = false;    // JPEG: DRI set a restart interval
+        uint8_t nextRestart = 0;        // JPEG: RSTn expected next
+    };
+
+    // Formats this engine can validate (JPEG and the ZIP family)
+    static bool Supports(const FileSignature& sig);
+
+    // Walk a file from its header; the reader bounds how far
+    static Validation Validate(const FileSignature& sig, SequentialReader& reader);
+
+    // Candidate for the second pass, or nullopt if the break leaves no
+    // whole first cluster to build on
+    static std::optional<FragmentCandidate> MakeCandidate(
+        const FileSignature& sig,
+        uint64_t startLCN,
+        uint64_t bytesPerCluster,
+        const Validation& validation,
+        std::optional<uint64_t> contiguousSize);
+
+    // claimed and allocated must not change while Resolve runs
+    BifragmentCarver(VolumeReader& reader, const ClusterBitmap& claimed,
+                     const ClusterBitmap* allocated, uint64_t maxLCN);
+
+    // Two-run file for the candidate, or nullopt if no continuation
+    // validates. Only reads; safe to call for several candidates at once.
+    std::optional<CarvedFile> Resolve(const FragmentCandidate& candidate) const;
+
+private:
+    static Validation ValidateJpeg(SequentialReader& reader);
+    static Validation ValidateZip(SequentialReader& reader);
+
+    std::optional<CarvedFile> ResolveJpeg(const FragmentCandidate& candidate) const;
+    std::optional<CarvedFile> ResolveZip(const FragmentCandidate& candidate) const;
+
+    // First-fragment lengths to try, most likely first: a cluster owned by
+    // something else is where the writer had to jump, then longest to shortest
+    std::vector<uint64_t> SplitOrder(const FragmentCandidate& candidate) const;
+
+    // Nothing else owns [lcn, lcn + count) and it lies inside the volume
+    bool IsFree(uint64_t lcn, uint64_t count) const;
+
+    // Validate fragment 1 = [start, start + split) joined to fragment 2 at
+    // secondLCN, reading at most maxBytes; the file on success
+    std::optional<CarvedFile> TrySplit(const FragmentCandidate& candidate, uint64_t split,
+                                       uint64_t secondLCN, uint64_t maxBytes) const;
+
+    VolumeReader& m_reader;
+    const ClusterBitmap& m_claimed;
+    const ClusterBitmap* m_allocated;
+    uint64_t m_maxLCN;
+};
+
+} // namespace KVC
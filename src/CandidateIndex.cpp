@@ -0,0 +1,134 @@
+// ============================================================================
+// CandidateIndex.cpp - Cross-Stage Deduplication Index
+// ============================================================================
+
+#include "CandidateIndex.h"
+#include <bit>
+
+namespace KVC {
+
+namespace {
+    static_assert(std::has_single_bit(Constants::Dedup::INDEX_SHARDS), "Shard count must be a power of two");
+    constexpr int SHARD_BITS = std::bit_width(Constants::Dedup::INDEX_SHARDS - 1);
+}
+
+CandidateIndex::~CandidateIndex() {
+    FreePages();
+}
+
+void CandidateIndex::FreePages() {
+    for (uint64_t i = 0; i < m_pageCount; i++) {
+        delete m_pages[i].load(std::memory_order_relaxed);
+    }
+    m_pages.reset();
+    m_pageCount = 0;
+}
+
+void CandidateIndex::Reset(uint64_t maxMftRecords) {
+    FreePages();
+
+    const uint64_t pageRecords = Constants::Dedup::MFT_PAGE_RECORDS;
+    m_pageCount = (maxMftRecords + pageRecords - 1) / pageRecords;
+    if (m_pageCount > 0) {
+        m_pages = std::make_unique<std::atomic<Page*>[]>(static_cast<size_t>(m_pageCount));
+    }
+
+    for (auto& shard : m_shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.slots.clear();
+        shard.slots.shrink_to_fit();
+        shard.count = 0;
+    }
+}
+
+void CandidateIndex::MarkRecord(uint64_t record) {
+    uint64_t pageIndex = record / Constants::Dedup::MFT_PAGE_RECORDS;
+    if (pageIndex >= m_pageCount) return;
+
+    // Pages appear on first touch; sparse MFTs stay cheap
+    Page* page = m_pages[pageIndex].load(std::memory_order_acquire);
+    if (!page) {
+        auto fresh = std::make_unique<Page>();
+        if (m_pages[pageIndex].compare_exchange_strong(page, fresh.get(), std::memory_order_acq_rel)) {
+            page = fresh.release();
+        }
+    }
+
+    uint64_t bit = record % Constants::Dedup::MFT_PAGE_RECORDS;
+    page->words[bit >> 6].fetch_or(1ULL << (bit & 63), std::memory_order_relaxed);
+}
+
+bool CandidateIndex::HasRecord(uint64_t record) const {
+    uint64_t pageIndex = record / Constants::Dedup::MFT_PAGE_RECORDS;
+    if (pageIndex >= m_pageCount) return false;
+
+    const Page* page = m_pages[pageIndex].load(std::memory_order_acquire);
+    if (!page) return false;
+
+    uint64_t bit = record % Constants::Dedup::MFT_PAGE_RECORDS;
+    return (page->words[bit >> 6].load(std::memory_order_relaxed) >> (bit & 63)) & 1;
+}
+
+uint64_t CandidateIndex::Hash(uint64_t record, uint64_t startCluster) {
+    uint64_t h = record * 0x9E3779B97F4A7C15ULL ^ startCluster;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+bool CandidateIndex::InsertSlot(std::vector<Key>& slots, const Key& key, uint64_t hash) {
+    size_t mask = slots.size() - 1;
+    for (size_t i = static_cast<size_t>(hash) & mask; ; i = (i + 1) & mask) {
+        if (slots[i].record == EMPTY_RECORD) {
+            slots[i] = key;
+            return true;
+        }
+        if (slots[i].record == key.record && slots[i].startCluster == key.startCluster) {
+            return false;
+        }
+    }
+}
+
+void CandidateIndex::Grow(Shard& shard) {
+    size_t newSize = shard.slots.empty() ? Constants::Dedup::INITIAL_SHARD_SLOTS : shard.slots.size() * 2;
+    std::vector<Key> slots(newSize, Key{ EMPTY_RECORD, 0 });
+
+    for (const Key& key : shard.slots) {
+        if (key.record != EMPTY_RECORD) {
+            InsertSlot(slots, key, Hash(key.record, key.startCluster));
+        }
+    }
+    shard.slots.swap(slots);
+}
+
+bool CandidateIndex::InsertCandidate(uint64_t record, uint64_t startCluster) {
+    uint64_t hash = Hash(record, startCluster);
+    Shard& shard = m_shards[static_cast<size_t>(hash >> (64 - SHARD_BITS))];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Keep load at or below one half so probe runs stay short
+    if ((shard.count + 1) * 2 > shard.slots.size()) {
+        Grow(shard);
+    }
+
+    if (!InsertSlot(shard.slots, Key{ record, startCluster }, hash)) {
+        return false;
+    }
+    shard.count++;
+    return true;
+}
+
+size_t CandidateIndex::CandidateCount() const {
+    size_t total = 0;
+    for (const auto& shard : m_shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.count;
+    }
+    return total;
+}
+
+} // namespace KVC
@@ -0,0 +1,71 @@
+// ============================================================================
+// CandidateIndex.h - Cross-Stage Deduplication Index
+// ============================================================================
+// Flat replacement for the ordered sets the NTFS stages used to share: a
+// paged bitmap of processed MFT records and a sharded open-addressing hash
+// of (MFT record, start cluster) keys. Safe for concurrent insertion.
+// ============================================================================
+
+#pragma once
+
+#include "Constants.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace KVC {
+
+class CandidateIndex {
+public:
+    CandidateIndex() = default;
+    ~CandidateIndex();
+
+    CandidateIndex(const CandidateIndex&) = delete;
+    CandidateIndex& operator=(const CandidateIndex&) = delete;
+
+    // Forget everything; MFT records at or beyond maxMftRecords are not tracked
+    void Reset(uint64_t maxMftRecords);
+
+    void MarkRecord(uint64_t record);
+    bool HasRecord(uint64_t record) const;
+
+    // Returns true if the key was not seen before
+    bool InsertCandidate(uint64_t record, uint64_t startCluster);
+
+    size_t CandidateCount() const;
+
+private:
+    static constexpr uint64_t WORDS_PER_PAGE = Constants::Dedup::MFT_PAGE_RECORDS / 64;
+
+    struct Page {
+        std::atomic<uint64_t> words[WORDS_PER_PAGE] = {};
+    };
+
+    struct Key {
+        uint64_t record;
+        uint64_t startCluster;
+    };
+
+    // Record numbers are 48-bit, so this never collides with a real key
+    static constexpr uint64_t EMPTY_RECORD = UINT64_MAX;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::vector<Key> slots;     // Linear probing, power-of-two size
+        size_t count = 0;
+    };
+
+    static uint64_t Hash(uint64_t record, uint64_t startCluster);
+    static bool InsertSlot(std::vector<Key>& slots, const Key& key, uint64_t hash);
+    static void Grow(Shard& shard);
+    void FreePages();
+
+    std::unique_ptr<std::atomic<Page*>[]> m_pages;
+    uint64_t m_pageCount = 0;
+    std::array<Shard, Constants::Dedup::INDEX_SHARDS> m_shards;
+};
+
+} // namespace KVC
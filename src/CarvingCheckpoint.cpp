@@ -0,0 +1,185 @@
+// ============================================================================
+// CarvingCheckpoint.cpp - Resumable Carving State
+// ============================================================================
+
+#include "CarvingCheckpoint.h"
+#include "Constants.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace KVC {
+
+namespace {
+
+template <typename T>
+void Put(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool Get(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+} // namespace
+
+bool CarvingCheckpoint::Matches(uint64_t serial, const VolumeGeometry& geom) const {
+    return volumeSerial == serial &&
+           totalClusters == geom.totalClusters &&
+           bytesPerCluster == geom.bytesPerCluster &&
+           resumeLCN <= totalClusters;
+}
+
+void CarvingCheckpoint::CaptureClaims(const ClusterBitmap& claimed) {
+    claimedRuns.clear();
+    uint64_t total = claimed.TotalClusters();
+    uint64_t pos = claimed.NextSet(0, total);
+    while (pos < total) {
+        uint64_t end = claimed.NextClear(pos, total);
+        claimedRuns.push_back({ pos, end - pos });
+        pos = claimed.NextSet(end, total);
+    }
+}
+
+void CarvingCheckpoint::RestoreClaims(ClusterBitmap& claimed) const {
+    for (const auto& run : claimedRuns) {
+        claimed.SetRange(run.start, run.count);
+    }
+}
+
+bool CarvingCheckpoint::Save(const std::wstring& path) const {
+    std::wstring tempPath = path + L".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+
+        out.write(Constants::Checkpoint::MAGIC, sizeof(Constants::Checkpoint::MAGIC));
+        Put(out, Constants::Checkpoint::VERSION);
+        Put(out, volumeSerial);
+        Put(out, totalClusters);
+        Put(out, bytesPerCluster);
+        Put(out, resumeLCN);
+
+        Put(out, static_cast<uint64_t>(claimedRuns.size()));
+        for (const auto& run : claimedRuns) {
+            Put(out, run.start);
+            Put(out, run.count);
+        }
+
+        Put(out, static_cast<uint64_t>(files.size()));
+        for (const auto& file : files) {
+            uint8_t extLength = static_cast<uint8_t>(strlen(file.signature.extension));
+            Put(out, extLength);
+            out.write(file.signature.extension, extLength);
+            Put(out, file.startLCN);
+            Put(out, file.startOffset);
+            Put(out, file.fileSize);
+            Put(out, file.fragments.BytesPerCluster());
+
+            const auto& runs = file.fragments.GetRuns();
+            Put(out, static_cast<uint64_t>(runs.size()));
+            for (const auto& run : runs) {
+                Put(out, run.startCluster);
+                Put(out, run.clusterCount);
+                Put(out, run.fileOffset);
+            }
+        }
+
+        out.flush();
+        if (!out) {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    return !ec;
+}
+
+std::optional<CarvingCheckpoint> CarvingCheckpoint::Load(
+    const std::wstring& path,
+    const std::vector<FileSignature>& signatures)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return std::nullopt;
+    }
+
+    char magic[sizeof(Constants::Checkpoint::MAGIC)];
+    uint32_t version = 0;
+    if (!in.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, Constants::Checkpoint::MAGIC, sizeof(magic)) != 0 ||
+        !Get(in, version) || version != Constants::Checkpoint::VERSION) {
+        return std::nullopt;
+    }
+
+    CarvingCheckpoint checkpoint;
+    uint64_t runCount = 0;
+    if (!Get(in, checkpoint.volumeSerial) || !Get(in, checkpoint.totalClusters) ||
+        !Get(in, checkpoint.bytesPerCluster) || !Get(in, checkpoint.resumeLCN) ||
+        !Get(in, runCount)) {
+        return std::nullopt;
+    }
+
+    // Counts are never trusted for allocation; a short file fails the next read
+    for (uint64_t i = 0; i < runCount; i++) {
+        ClusterRange run;
+        if (!Get(in, run.start) || !Get(in, run.count)) {
+            return std::nullopt;
+        }
+        checkpoint.claimedRuns.push_back(run);
+    }
+
+    uint64_t fileCount = 0;
+    if (!Get(in, fileCount)) {
+        return std::nullopt;
+    }
+
+    for (uint64_t i = 0; i < fileCount; i++) {
+        uint8_t extLength = 0;
+        char extension[256] = {};
+        if (!Get(in, extLength) || !in.read(extension, extLength)) {
+            return std::nullopt;
+        }
+
+        // Signatures carry static pointers, so only the extension is stored
+        auto sig = std::find_if(signatures.begin(), signatures.end(),
+            [&extension](const FileSignature& s) { return strcmp(s.extension, extension) == 0; });
+        if (sig == signatures.end()) {
+            return std::nullopt;
+        }
+
+        CarvedFile file;
+        file.signature = *sig;
+        uint64_t fragmentUnit = 0;
+        uint64_t fragmentRuns = 0;
+        if (!Get(in, file.startLCN) || !Get(in, file.startOffset) || !Get(in, file.fileSize) ||
+            !Get(in, fragmentUnit) || !Get(in, fragmentRuns)) {
+            return std::nullopt;
+        }
+
+        file.fragments = FragmentMap(fragmentUnit);
+        for (uint64_t r = 0; r < fragmentRuns; r++) {
+            ClusterRun run;
+            if (!Get(in, run.startCluster) || !Get(in, run.clusterCount) || !Get(in, run.fileOffset)) {
+                return std::nullopt;
+            }
+            file.fragments.AddRun(run);
+        }
+        file.fragments.SetTotalSize(file.fileSize);
+        checkpoint.files.push_back(std::move(file));
+    }
+
+    return checkpoint;
+}
+
+void CarvingCheckpoint::Remove(const std::wstring& path) {
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
+} // namespace KVC
@@ -0,0 +1,45 @@
+// ============================================================================
+// CarvingCheckpoint.h - Resumable Carving State
+// ============================================================================
+// Snapshot of an interrupted carving pass: the first cluster still to carve,
+// the claimed-cluster set as runs, and every file emitted so far. Written to
+// a side file and atomically replaced, so a crash never leaves a torn one.
+// ============================================================================
+
+#pragma once
+
+#include "FileCarver.h"
+#include "FragmentedFile.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace KVC {
+
+struct CarvingCheckpoint {
+    uint64_t volumeSerial = 0;
+    uint64_t totalClusters = 0;
+    uint64_t bytesPerCluster = 0;
+    uint64_t resumeLCN = 0;                  // Every cluster before this was carved
+    std::vector<ClusterRange> claimedRuns;
+    std::vector<CarvedFile> files;
+
+    // True if the checkpoint was taken on this volume
+    bool Matches(uint64_t serial, const VolumeGeometry& geom) const;
+
+    void CaptureClaims(const ClusterBitmap& claimed);
+    void RestoreClaims(ClusterBitmap& claimed) const;
+
+    // Writes path + ".tmp", then renames it over path
+    bool Save(const std::wstring& path) const;
+
+    // Signatures are resolved by extension against the given list; nullopt
+    // if the file is missing, truncated or from another format version
+    static std::optional<CarvingCheckpoint> Load(const std::wstring& path,
+                                                 const std::vector<FileSignature>& signatures);
+
+    static void Remove(const std::wstring& path);
+};
+
+} // namespace KVC
@@ -0,0 +1,132 @@
+// ============================================================================
+// ClusterBitmap.cpp - Volume-Sized Claimed-Cluster Bitmap
+// ============================================================================
+
+#include "ClusterBitmap.h"
+#include <algorithm>
+#include <bit>
+
+namespace KVC {
+
+void ClusterBitmap::Reset(uint64_t totalClusters) {
+    m_totalClusters = totalClusters;
+    m_words.assign(static_cast<size_t>((totalClusters + 63) / 64), 0);
+}
+
+void ClusterBitmap::SetRange(uint64_t start, uint64_t count) {
+    if (start >= m_totalClusters || count == 0) return;
+
+    uint64_t end = std::min(start + count, m_totalClusters);
+    if (end < start) end = m_totalClusters;  // Overflow guard
+
+    uint64_t firstWord = start >> 6;
+    uint64_t lastWord = (end - 1) >> 6;
+    uint64_t headMask = ~0ULL << (start & 63);
+    uint64_t tailMask = ~0ULL >> (63 - ((end - 1) & 63));
+
+    if (firstWord == lastWord) {
+        m_words[firstWord] |= headMask & tailMask;
+        return;
+    }
+
+    m_words[firstWord] |= headMask;
+    std::fill(m_words.begin() + firstWord + 1, m_words.begin() + lastWord, ~0ULL);
+    m_words[lastWord] |= tailMask;
+}
+
+bool ClusterBitmap::AnySet(uint64_t start, uint64_t count) const {
+    if (start >= m_totalClusters || count == 0) return false;
+
+    uint64_t end = std::min(start + count, m_totalClusters);
+    if (end < start) end = m_totalClusters;
+
+    uint64_t firstWord = start >> 6;
+    uint64_t lastWord = (end - 1) >> 6;
+    uint64_t headMask = ~0ULL << (start & 63);
+    uint64_t tailMask = ~0ULL >> (63 - ((end - 1) & 63));
+
+    if (firstWord == lastWord) {
+        return (m_words[firstWord] & headMask & tailMask) != 0;
+    }
+
+    if (m_words[firstWord] & headMask) return true;
+    for (uint64_t w = firstWord + 1; w < lastWord; w++) {
+        if (m_words[w] != 0) return true;
+    }
+    return (m_words[lastWord] & tailMask) != 0;
+}
+
+uint64_t ClusterBitmap::NextClear(uint64_t from, uint64_t limit) const {
+    limit = std::min(limit, m_totalClusters);
+    if (from >= limit) return limit;
+
+    uint64_t word = from >> 6;
+    uint64_t bits = ~m_words[word] & (~0ULL << (from & 63));
+
+    while (true) {
+        if (bits != 0) {
+            return std::min((word << 6) + std::countr_zero(bits), limit);
+        }
+        word++;
+        if ((word << 6) >= limit) return limit;
+        bits = ~m_words[word];
+    }
+}
+
+uint64_t ClusterBitmap::NextSet(uint64_t from, uint64_t limit) const {
+    limit = std::min(limit, m_totalClusters);
+    if (from >= limit) return limit;
+
+    uint64_t word = from >> 6;
+    uint64_t bits = m_words[word] & (~0ULL << (from & 63));
+
+    while (true) {
+        if (bits != 0) {
+            return std::min((word << 6) + std::countr_zero(bits), limit);
+        }
+        word++;
+        if ((word << 6) >= limit) return limit;
+        bits = m_words[word];
+    }
+}
+
+void ClusterBitmap::MergeBytes(uint64_t firstCluster, const uint8_t* bytes, size_t byteCount) {
+    if (firstCluster >= m_totalClusters) return;
+
+    byteCount = static_cast<size_t>(std::min<uint64_t>(byteCount, (m_totalClusters - firstCluster + 7) / 8));
+    for (size_t i = 0; i < byteCount; i++) {
+        uint64_t cluster = firstCluster + i * 8;
+        m_words[cluster >> 6] |= static_cast<uint64_t>(bytes[i]) << (cluster & 63);
+    }
+
+    // Keep bits past the volume clear so counts and scans stay exact
+    if (m_totalClusters & 63) {
+        m_words.back() &= ~0ULL >> (64 - (m_totalClusters & 63));
+    }
+}
+
+void ClusterBitmap::Merge(const ClusterBitmap& other) {
+    size_t count = std::min(m_words.size(), other.m_words.size());
+    for (size_t i = 0; i < count; i++) {
+        m_words[i] |= other.m_words[i];
+    }
+}
+
+void ClusterBitmap::Invert() {
+    for (uint64_t& w : m_words) {
+        w = ~w;
+    }
+    if (m_totalClusters & 63) {
+        m_words.back() &= ~0ULL >> (64 - (m_totalClusters & 63));
+    }
+}
+
+uint64_t ClusterBitmap::CountSet() const {
+    uint64_t total = 0;
+    for (uint64_t w : m_words) {
+        total += std::popcount(w);
+    }
+    return total;
+}
+
+} // namespace KVC
@@ -0,0 +1,68 @@
+// ============================================================================
+// ClusterBitmap.h - Volume-Sized Claimed-Cluster Bitmap
+// ============================================================================
+// One bit per cluster marking clusters already owned by a recovered file.
+// Shared between the MFT, USN and carving stages for O(1) dedup lookups
+// with a fixed footprint (128MB covers 4TB at 4KB clusters). Also holds a
+// volume's allocation map so carving can skip live data.
+// ============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace KVC {
+
+class ClusterBitmap {
+public:
+    ClusterBitmap() = default;
+    explicit ClusterBitmap(uint64_t totalClusters) { Reset(totalClusters); }
+
+    // Resize to cover totalClusters and clear every bit
+    void Reset(uint64_t totalClusters);
+
+    bool Test(uint64_t lcn) const {
+        if (lcn >= m_totalClusters) return false;
+        return (m_words[lcn >> 6] >> (lcn & 63)) & 1ULL;
+    }
+
+    void Set(uint64_t lcn) {
+        if (lcn >= m_totalClusters) return;
+        m_words[lcn >> 6] |= (1ULL << (lcn & 63));
+    }
+
+    // Mark [start, start + count), clipped to the volume
+    void SetRange(uint64_t start, uint64_t count);
+
+    // True if any cluster of [start, start + count) is marked
+    bool AnySet(uint64_t start, uint64_t count) const;
+
+    // First unmarked cluster in [from, limit), or limit if none
+    uint64_t NextClear(uint64_t from, uint64_t limit) const;
+
+    // First marked cluster in [from, limit), or limit if none
+    uint64_t NextSet(uint64_t from, uint64_t limit) const;
+
+    // OR in an on-disk bitmap (bit n of byte k = cluster 8k + n); firstCluster
+    // must be a multiple of 8
+    void MergeBytes(uint64_t firstCluster, const uint8_t* bytes, size_t byteCount);
+
+    // Mark every cluster other marks; other must cover the same volume
+    void Merge(const ClusterBitmap& other);
+
+    // Flip every cluster of the volume
+    void Invert();
+
+    uint64_t CountSet() const;
+    uint64_t TotalClusters() const { return m_totalClusters; }
+    uint64_t ByteSize() const { return m_words.size() * sizeof(uint64_t); }
+    const uint64_t* Words() const { return m_words.data(); }  // Same byte order as MergeBytes
+    bool Empty() const { return m_totalClusters == 0; }
+
+private:
+    std::vector<uint64_t> m_words;
+    uint64_t m_totalClusters = 0;
+};
+
+} // namespace KVC
@@ -0,0 +1,141 @@
+// ============================================================================
+// ClusterClassifier.cpp - Carving Prescreen for Zero, Uniform and Random Data
+// ============================================================================
+
+#include "ClusterClassifier.h"
+#include "Constants.h"
+#include <emmintrin.h>
+#include <algorithm>
+
+namespace KVC {
+
+PrescreenCounts& PrescreenCounts::operator+=(const PrescreenCounts& other) {
+    zeroClusters += other.zeroClusters;
+    uniformClusters += other.uniformClusters;
+    highEntropyClusters += other.highEntropyClusters;
+    weakHitsSuppressed += other.weakHitsSuppressed;
+    return *this;
+}
+
+// ============================================================================
+// ClusterClassifier
+// ============================================================================
+
+ClusterClass ClusterClassifier::Classify(const uint8_t* data, size_t size) {
+    if (size < 64) {
+        return ClusterClass::Structured;
+    }
+
+    // XOR against the first byte; any set bit means the cluster is not
+    // uniform. Checked every 64 bytes, so structured data exits early.
+    const __m128i lead = _mm_set1_epi8(static_cast<char>(data[0]));
+    const __m128i zero = _mm_setzero_si128();
+    bool uniform = true;
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        const __m128i* block = reinterpret_cast<const __m128i*>(data + i);
+        __m128i diff = _mm_or_si128(
+            _mm_or_si128(_mm_xor_si128(_mm_loadu_si128(block), lead),
+                         _mm_xor_si128(_mm_loadu_si128(block + 1), lead)),
+            _mm_or_si128(_mm_xor_si128(_mm_loadu_si128(block + 2), lead),
+                         _mm_xor_si128(_mm_loadu_si128(block + 3), lead)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, zero)) != 0xFFFF) {
+            uniform = false;
+            break;
+        }
+    }
+    for (; uniform && i < size; i++) {
+        uniform = data[i] == data[0];
+    }
+
+    if (uniform) {
+        return data[0] == 0 ? ClusterClass::Zero : ClusterClass::Uniform;
+    }
+
+    // Collision entropy H2 = log2(n^2 / sum(c^2)); compared without logs.
+    // Four interleaved tables keep the increments independent.
+    const size_t sample = std::min(size, Constants::Carving::ENTROPY_SAMPLE_BYTES);
+    uint32_t counts[4][256] = {};
+    size_t j = 0;
+    for (; j + 4 <= sample; j += 4) {
+        counts[0][data[j]]++;
+        counts[1][data[j + 1]]++;
+        counts[2][data[j + 2]]++;
+        counts[3][data[j + 3]]++;
+    }
+    for (; j < sample; j++) {
+        counts[0][data[j]]++;
+    }
+
+    uint64_t sumSquares = 0;
+    for (size_t b = 0; b < 256; b++) {
+        uint64_t c = counts[0][b] + counts[1][b] + counts[2][b] + counts[3][b];
+        sumSquares += c * c;
+    }
+
+    const uint64_t n = sample;
+    if ((sumSquares << Constants::Carving::HIGH_ENTROPY_BITS) < n * n) {
+        return ClusterClass::HighEntropy;
+    }
+    return ClusterClass::Structured;
+}
+
+// ============================================================================
+// ClusterPrescreen
+// ============================================================================
+
+ClusterPrescreen::ClusterPrescreen(const SignatureMatcher& matcher, uint64_t stride, bool enabled)
+    : m_matcher(matcher)
+    , m_enabled(enabled)
+    , m_skipUniform(enabled && !matcher.HasRepeatedByteMagic() && matcher.MaxMagicEnd() <= stride)
+{
+}
+
+bool ClusterPrescreen::Admit(uint64_t lcn, const uint8_t* cluster, size_t size,
+                             const uint8_t* preceding, size_t precedingSize) {
+    m_minMagicSize = 0;
+    if (!m_enabled) {
+        return true;
+    }
+
+    // Only a directly preceding cluster says anything about the region; one
+    // this thread skipped (claimed, inside a carved file, another slice's)
+    // is classified on the spot
+    ClusterClass previous = ClusterClass::Structured;
+    if (preceding != nullptr) {
+        previous = (lcn == m_lastLCN + 1) ? m_previous
+                                          : ClusterClassifier::Classify(preceding, precedingSize);
+    }
+    ClusterClass current = ClusterClassifier::Classify(cluster, size);
+    m_lastLCN = lcn;
+    m_previous = current;
+
+    switch (current) {
+        case ClusterClass::Zero:
+            m_counts.zeroClusters++;
+            return !m_skipUniform;
+        case ClusterClass::Uniform:
+            m_counts.uniformClusters++;
+            return !m_skipUniform;
+        case ClusterClass::HighEntropy:
+            m_counts.highEntropyClusters++;
+            // The first random cluster may be a real file's header (MP3 frames
+            // are high-entropy too); only a continuing run loses weak magics
+            if (previous == ClusterClass::HighEntropy) {
+                m_minMagicSize = Constants::Carving::WEAK_MAGIC_BYTES + 1;
+            }
+            return true;
+        default:
+            return true;
+    }
+}
+
+const FileSignature* ClusterPrescreen::Match(const uint8_t* data, size_t available) {
+    const FileSignature* matched = m_matcher.Match(data, available, m_minMagicSize);
+    if (matched == nullptr && m_minMagicSize > 0 && m_matcher.Match(data, available) != nullptr) {
+        m_counts.weakHitsSuppressed++;
+    }
+    return matched;
+}
+
+} // namespace KVC
@@ -0,0 +1,73 @@
+// ============================================================================
+// ClusterClassifier.h - Carving Prescreen for Zero, Uniform and Random Data
+// ============================================================================
+// Tags each cluster before signature probing. Zero and single-byte clusters
+// cannot hold any magic and are skipped outright; inside runs of high-entropy
+// clusters (encrypted volumes, compressed payloads) two-byte magics such as
+// MP3 frame sync match by chance, so those are not reported there.
+// ============================================================================
+
+#pragma once
+
+#include "SignatureMatcher.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace KVC {
+
+enum class ClusterClass : uint8_t {
+    Structured,
+    Zero,
+    Uniform,            // One repeated non-zero byte
+    HighEntropy
+};
+
+struct PrescreenCounts {
+    uint64_t zeroClusters = 0;
+    uint64_t uniformClusters = 0;
+    uint64_t highEntropyClusters = 0;
+    uint64_t weakHitsSuppressed = 0;
+
+    PrescreenCounts& operator+=(const PrescreenCounts& other);
+};
+
+class ClusterClassifier {
+public:
+    // SSE2 uniformity pass over the whole cluster, then a collision-entropy
+    // estimate over its first ENTROPY_SAMPLE_BYTES
+    static ClusterClass Classify(const uint8_t* data, size_t size);
+};
+
+// Prescreen state for one scan thread walking clusters in ascending order.
+// Whether a run continues is read from the preceding cluster's data, not from
+// which clusters this thread happened to visit, so every split of a batch
+// into slices admits and suppresses exactly the same probes.
+class ClusterPrescreen {
+public:
+    // stride: probe spacing; uniform clusters are only skipped when every
+    // magic fits inside one stride and none is a repeated byte
+    ClusterPrescreen(const SignatureMatcher& matcher, uint64_t stride, bool enabled);
+
+    // Classify the cluster at lcn; false when no probe in it can match.
+    // preceding is the whole cluster before lcn when it is free data in the
+    // same batch, else nullptr (the run starts here); it is only classified
+    // when lcn - 1 was not the cluster admitted last.
+    bool Admit(uint64_t lcn, const uint8_t* cluster, size_t size,
+               const uint8_t* preceding, size_t precedingSize);
+
+    // Match one probe inside the cluster last admitted
+    const FileSignature* Match(const uint8_t* data, size_t available);
+
+    const PrescreenCounts& Counts() const { return m_counts; }
+
+private:
+    const SignatureMatcher& m_matcher;
+    bool m_enabled;
+    bool m_skipUniform;
+    uint64_t m_lastLCN = UINT64_MAX;
+    ClusterClass m_previous = ClusterClass::Structured;
+    size_t m_minMagicSize = 0;      // For probes in the current cluster
+    PrescreenCounts m_counts;
+};
+
+} // namespace KVC
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <climits>
+#include <cstddef>
 #include <cstdint>
 
 namespace KVC {
@@ -36,6 +37,15 @@ constexpr uint64_t ALLOCATION_GRANULARITY = 64 * KILOBYTE;
 // Maximum single ReadFile call size (must fit in DWORD for Windows API)
 constexpr uint64_t MAX_READ_CHUNK = 16 * MEGABYTE;
 
+// Overlapped reads kept in flight by queued (QD > 1) volume reads
+constexpr size_t ASYNC_QUEUE_DEPTH = 4;
+
+// Bulk read piece size while metadata reads on the same volume have priority
+constexpr uint64_t BACKGROUND_READ_CHUNK = 1 * MEGABYTE;
+
+// Bytes the process-wide aligned buffer pool may keep cached
+constexpr uint64_t SHARED_BUFFER_POOL_BYTES = 64 * MEGABYTE;
+
 // Maximum file size to scan during carving (prevents runaway parsing)
 constexpr uint64_t MAX_FILE_SCAN_SIZE = 2ULL * GIGABYTE;
 
@@ -45,6 +55,9 @@ constexpr uint64_t MAX_FILE_SCAN_SIZE = 2ULL * GIGABYTE;
 constexpr uint64_t CLUSTERS_PER_BATCH = 65536;
 constexpr uint64_t DIRECTORY_READ_LIMIT = 2 * MEGABYTE;
 
+// Directories a FAT/exFAT walk expands concurrently before consuming them in order
+constexpr size_t DIRECTORY_WALK_BATCH = 1024;
+
 // Carving batch size in clusters (default ~256MB per batch at 4KB clusters)
 constexpr uint64_t CARVING_BATCH_CLUSTERS = 65536;
 
@@ -52,13 +65,17 @@ constexpr uint64_t CARVING_BATCH_CLUSTERS = 65536;
 // NTFS-Specific Constants
 // ============================================================================
 namespace NTFS {
+    constexpr uint64_t VOLUME_BITMAP_RECORD_NUMBER = 6;
     constexpr uint64_t USNJRNL_RECORD_NUMBER = 38;
+    constexpr uint64_t USN_STREAM_CHUNK_SIZE = 4 * MEGABYTE;   // $J bytes parsed per read
+    constexpr size_t USN_MAX_RECORD_SIZE = 65536;
+    constexpr uint64_t USN_PAGE_SIZE = 4096;                   // $J records never cross one
     constexpr uint64_t RECORDS_PER_BATCH = 1024;
+    constexpr uint64_t MFT_SKIP_MIN_RECORDS = 64;    // In-use run length worth a separate read
+    constexpr uint64_t MFT_RECORD_CACHE_BYTES = 64 * MEGABYTE;  // Stage 1 records kept for later stages
     constexpr uint64_t MAX_FRAGMENTS = 1000000;
     constexpr uint64_t MAX_CLUSTERS_TOTAL = (100ULL * GIGABYTE) / CLUSTER_SIZE_DEFAULT;
-    constexpr uint64_t MAX_CLUSTER_CHAIN_READ = 100000;
     constexpr uint64_t PATH_CACHE_DEPTH_LIMIT = 50;
-    constexpr uint64_t PATH_CACHE_SIZE_LIMIT = 100;
     
     // Data run parsing limits
     constexpr size_t MAX_DATA_RUN_SIZE = 8;
@@ -80,6 +97,39 @@ namespace FAT32 {
     constexpr int MAX_CHAIN_CLUSTERS = 2048;
 } // namespace FAT32
 
+// ============================================================================
+// FAT Table Cache (FAT32 and exFAT)
+// ============================================================================
+namespace FatCache {
+    constexpr uint64_t FULL_LOAD_LIMIT = 64 * MEGABYTE;    // Larger FATs are paged
+    constexpr uint64_t PAGE_SIZE = 1 * MEGABYTE;
+    constexpr size_t MAX_PAGES = 32;
+} // namespace FatCache
+
+// ============================================================================
+// Shared Read Window Cache
+// ============================================================================
+namespace Cache {
+    constexpr uint64_t WINDOW_GRANULARITY = 256 * KILOBYTE;  // Window alignment and minimum size
+    constexpr uint64_t BUDGET = 64 * MEGABYTE;               // Resident bytes per volume handle
+} // namespace Cache
+
+// ============================================================================
+// Shared Read Bandwidth Budget
+// ============================================================================
+namespace Bandwidth {
+    constexpr uint64_t BURST_MILLISECONDS = 100;       // Idle budget a reader may spend at once
+} // namespace Bandwidth
+
+// ============================================================================
+// Cross-Stage Deduplication Index
+// ============================================================================
+namespace Dedup {
+    constexpr size_t INDEX_SHARDS = 16;                // Lock stripes, power of two
+    constexpr size_t INITIAL_SHARD_SLOTS = 1024;
+    constexpr uint64_t MFT_PAGE_RECORDS = 65536;       // Bitmap page = 8KB, allocated on first mark
+} // namespace Dedup
+
 // ============================================================================
 // File Carving Constants
 // ============================================================================
@@ -89,13 +139,86 @@ namespace Carving {
     constexpr uint64_t MAX_SAFE_SKIP = 64 * MEGABYTE;
     constexpr uint64_t MAX_REASONABLE_GAP = 50;
     constexpr uint64_t SIZE_PARSE_TOLERANCE = 10;
+    constexpr uint64_t ALLOCATED_GAP_CLUSTERS = 256;   // Shorter allocated runs are read through
+    constexpr uint64_t MAX_NESTED_PARSES = 16;         // ForensicBounded end parses inside one file
+    constexpr size_t ENTROPY_SAMPLE_BYTES = 1024;      // Cluster bytes histogrammed by the prescreen
+    constexpr unsigned HIGH_ENTROPY_BITS = 7;          // Collision entropy (bits/byte) counted as high
+    constexpr size_t WEAK_MAGIC_BYTES = 2;             // Magic this short is dropped in high-entropy runs
 } // namespace Carving
 
+// ============================================================================
+// Bifragment Gap Carving Constants
+// ============================================================================
+namespace Bifragment {
+    constexpr uint64_t MAX_GAP_CLUSTERS = 8192;        // Furthest second fragment after the break
+    constexpr size_t MAX_SPLIT_CANDIDATES = 64;        // First-fragment lengths tried per continuation
+    constexpr size_t MAX_VALIDATIONS = 256;            // Full two-run walks per candidate
+    constexpr size_t MAX_EOCD_CANDIDATES = 32;         // ZIP end records examined per candidate
+    constexpr uint64_t SEARCH_CHUNK_CLUSTERS = 256;    // Clusters read per continuation search step
+    constexpr size_t RESTART_PROBE_BYTES = 64 * KILOBYTE;  // Entropy data searched for the first marker
+    constexpr uint64_t MAX_ZIP_SIZE = 100 * MEGABYTE;  // Larger archives are not gap carved
+} // namespace Bifragment
+
+// ============================================================================
+// Carving Checkpoint Constants
+// ============================================================================
+namespace Checkpoint {
+    constexpr char MAGIC[8] = { 'K', 'V', 'C', 'C', 'A', 'R', 'V', 'E' };
+    constexpr uint32_t VERSION = 1;
+    constexpr uint64_t INTERVAL_SECONDS = 60;
+} // namespace Checkpoint
+
+// ============================================================================
+// Scan Index Constants
+// ============================================================================
+namespace Index {
+    constexpr char MAGIC[8] = { 'K', 'V', 'C', 'I', 'N', 'D', 'E', 'X' };
+    constexpr uint32_t VERSION = 1;
+} // namespace Index
+
+// ============================================================================
+// Batch Recovery Constants
+// ============================================================================
+namespace Recovery {
+    constexpr size_t WORKER_THREADS = 4;    // Concurrent file recoveries per batch
+} // namespace Recovery
+
+// ============================================================================
+// Recovered File Output Constants
+// ============================================================================
+namespace Output {
+    constexpr size_t BLOCK_SIZE = 4 * MEGABYTE;         // One unbuffered write
+    constexpr size_t ALIGNMENT = 4096;                  // Covers 512e and 4Kn destinations
+    constexpr uint64_t MIN_SPARSE_HOLE = 64 * KILOBYTE; // Shorter zero gaps are written out
+} // namespace Output
+
+// ============================================================================
+// GUI Result Delivery
+// ============================================================================
+namespace Results {
+    constexpr size_t DELIVERY_RING_SLOTS = 16384;  // Candidates in flight to the UI thread
+    constexpr unsigned DRAIN_INTERVAL_MS = 100;    // UI timer period
+    constexpr size_t STORE_CHUNK_ROWS = 4096;
+    constexpr size_t STORE_MAX_CHUNKS = 16384;     // ~67M rows
+    constexpr size_t SORT_THREADS = 4;
+    constexpr size_t PARALLEL_SORT_THRESHOLD = 65536;  // Smaller views sort on one thread
+    constexpr size_t STRING_BLOCK_CHARS = 64 * 1024;   // Name and path arena block
+    constexpr size_t STORE_MAX_GEOMETRIES = 64;        // Distinct volume layouts kept inline
+} // namespace Results
+
+// ============================================================================
+// Streaming Result Output
+// ============================================================================
+namespace ResultStream {
+    constexpr size_t BUFFER_BYTES = 1 * MEGABYTE;  // Pending output before scan threads wait
+} // namespace ResultStream
+
 // ============================================================================
 // Fragmentation Support
 // ============================================================================
 namespace Fragmentation {
     constexpr size_t SEQUENTIAL_READER_BUFFER_SIZE = 65536;
+    constexpr size_t INLINE_RUNS = 4;               // Runs a FragmentMap holds without allocating
     constexpr size_t MAX_FRAGMENTS_PER_FILE = 1000000;
     constexpr size_t PARALLEL_VALIDATION_THRESHOLD = 10;
     constexpr size_t DEFAULT_PARALLEL_THREADS = 4;
@@ -0,0 +1,206 @@
+// ============================================================================
+// DirectoryIndex.cpp - Interned NTFS Parent Directory Table
+// ============================================================================
+
+#include "DirectoryIndex.h"
+#include "Constants.h"
+
+namespace KVC {
+
+void DirectoryIndex::Clear() {
+    m_nodes.clear();
+    m_slots.clear();
+    m_names.clear();
+}
+
+size_t DirectoryIndex::SlotFor(uint64_t record) const {
+    // Fibonacci hashing spreads sequential record numbers across the table
+    return static_cast<size_t>((record * 0x9E3779B97F4A7C15ULL) >> 32) & (m_slots.size() - 1);
+}
+
+uint32_t DirectoryIndex::FindId(uint64_t record) const {
+    if (m_slots.empty()) return INVALID_ID;
+
+    for (size_t slot = SlotFor(record); ; slot = (slot + 1) & (m_slots.size() - 1)) {
+        const Slot& entry = m_slots[slot];
+        if (entry.id == INVALID_ID) return INVALID_ID;
+        if (entry.record == record) return entry.id;
+    }
+}
+
+void DirectoryIndex::InsertSlot(uint64_t record, uint32_t id) {
+    size_t slot = SlotFor(record);
+    while (m_slots[slot].id != INVALID_ID) {
+        slot = (slot + 1) & (m_slots.size() - 1);
+    }
+    m_slots[slot] = { record, id };
+}
+
+void DirectoryIndex::Grow() {
+    size_t capacity = m_slots.empty() ? 1024 : m_slots.size() * 2;
+    m_slots.assign(capacity, { 0, INVALID_ID });
+
+    for (uint32_t id = 0; id < m_nodes.size(); id++) {
+        InsertSlot(m_nodes[id].record, id);
+    }
+}
+
+uint32_t DirectoryIndex::AddNode(uint64_t record, uint64_t parentRecord, const std::wstring& name,
+                                 bool isDirectory) {
+    uint32_t existing = FindId(record);
+    if (existing != INVALID_ID) return existing;
+
+    // Keep the load factor under 70%
+    if ((m_nodes.size() + 1) * 10 > m_slots.size() * 7) {
+        Grow();
+    }
+
+    Node node;
+    node.record = record;
+    node.parentRecord = parentRecord;
+    node.nameOffset = static_cast<uint32_t>(m_names.size());
+    node.nameLength = isDirectory ? static_cast<uint32_t>(name.size()) : NOT_A_DIRECTORY;
+    node.parentId = (IsRoot(parentRecord) || parentRecord == record) ? ROOT_ID : UNRESOLVED_ID;
+    if (isDirectory) {
+        m_names += name;
+    }
+
+    uint32_t id = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(node);
+    InsertSlot(record, id);
+    return id;
+}
+
+void DirectoryIndex::AddDirectory(uint64_t record, uint64_t parentRecord, const std::wstring& name) {
+    AddNode(record, parentRecord, name, true);
+}
+
+void DirectoryIndex::AddNonDirectory(uint64_t record) {
+    AddNode(record, 0, std::wstring(), false);
+}
+
+void DirectoryIndex::ReplaceDirectory(uint64_t record, uint64_t parentRecord, const std::wstring& name) {
+    uint32_t id = FindId(record);
+    if (id == INVALID_ID) {
+        AddNode(record, parentRecord, name, true);
+        return;
+    }
+
+    // Children keep their memoized link to this id; only its own link resets.
+    // The old name stays in the arena, unreferenced.
+    Node& node = m_nodes[id];
+    node.parentRecord = parentRecord;
+    node.nameOffset = static_cast<uint32_t>(m_names.size());
+    node.nameLength = static_cast<uint32_t>(name.size());
+    node.parentId = (IsRoot(parentRecord) || parentRecord == record) ? ROOT_ID : UNRESOLVED_ID;
+    m_names += name;
+}
+
+std::vector<DirectoryIndex::Entry> DirectoryIndex::Export() const {
+    std::vector<Entry> entries;
+    entries.reserve(m_nodes.size());
+    for (const Node& node : m_nodes) {
+        entries.push_back({ node.record, node.parentRecord, node.nameOffset, node.nameLength });
+    }
+    return entries;
+}
+
+void DirectoryIndex::Import(std::span<const Entry> entries, std::wstring_view names) {
+    Clear();
+    m_names.assign(names);
+    m_nodes.reserve(entries.size());
+
+    for (const Entry& entry : entries) {
+        bool isDirectory = entry.nameLength != NOT_A_DIRECTORY;
+        if (isDirectory && (entry.nameOffset > names.size() ||
+                            entry.nameLength > names.size() - entry.nameOffset)) {
+            continue;
+        }
+        if (FindId(entry.record) != INVALID_ID) {
+            continue;
+        }
+        if ((m_nodes.size() + 1) * 10 > m_slots.size() * 7) {
+            Grow();
+        }
+
+        Node node;
+        node.record = entry.record;
+        node.parentRecord = entry.parentRecord;
+        node.nameOffset = isDirectory ? entry.nameOffset : 0;
+        node.nameLength = entry.nameLength;
+        node.parentId = (IsRoot(entry.parentRecord) || entry.parentRecord == entry.record) ? ROOT_ID
+                                                                                        : UNRESOLVED_ID;
+        uint32_t id = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.push_back(node);
+        InsertSlot(entry.record, id);
+    }
+}
+
+uint32_t DirectoryIndex::ParentId(uint32_t id) const {
+    const Node& node = m_nodes[id];
+    if (node.parentId == UNRESOLVED_ID) {
+        // Memoize only hits: a missing parent may still be indexed later
+        uint32_t parent = FindId(node.parentRecord);
+        if (parent != INVALID_ID) {
+            node.parentId = parent;
+        }
+        return parent;
+    }
+    return node.parentId;
+}
+
+uint64_t DirectoryIndex::FindMissingAncestor(uint64_t parentRecord) const {
+    if (IsRoot(parentRecord)) return 0;
+
+    uint32_t id = FindId(parentRecord);
+    if (id == INVALID_ID) return parentRecord;
+
+    // The depth limit doubles as the cycle guard
+    for (uint64_t depth = 0; depth < Constants::NTFS::PATH_CACHE_DEPTH_LIMIT; depth++) {
+        if (m_nodes[id].nameLength == NOT_A_DIRECTORY) return 0;
+
+        uint32_t parent = ParentId(id);
+        if (parent == ROOT_ID) return 0;
+        if (parent == INVALID_ID) return m_nodes[id].parentRecord;
+        id = parent;
+    }
+    return 0;
+}
+
+std::wstring DirectoryIndex::BuildPath(uint64_t parentRecord, const std::wstring& filename) const {
+    uint32_t chain[Constants::NTFS::PATH_CACHE_DEPTH_LIMIT];
+    size_t depth = 0;
+    size_t length = 0;
+
+    uint32_t id = IsRoot(parentRecord) ? INVALID_ID : FindId(parentRecord);
+    while (id != INVALID_ID && id != ROOT_ID && depth < Constants::NTFS::PATH_CACHE_DEPTH_LIMIT) {
+        const Node& node = m_nodes[id];
+        if (node.nameLength == NOT_A_DIRECTORY) break;
+
+        chain[depth++] = id;
+        length += node.nameLength + 1;
+        id = ParentId(id);
+    }
+
+    // Root and unresolvable ancestors both collapse into the <deleted> prefix
+    std::wstring path = L"<deleted>";
+    path.reserve(path.size() + length + 1 + filename.size());
+    while (depth > 0) {
+        const Node& node = m_nodes[chain[--depth]];
+        path += L'\\';
+        path.append(m_names, node.nameOffset, node.nameLength);
+    }
+    if (!filename.empty()) {
+        path += L'\\';
+        path += filename;
+    }
+    return path;
+}
+
+uint64_t DirectoryIndex::MemoryUsage() const {
+    return m_nodes.capacity() * sizeof(Node) +
+           m_slots.capacity() * sizeof(Slot) +
+           m_names.capacity() * sizeof(wchar_t);
+}
+
+} // namespace KVC
@@ -0,0 +1,96 @@
+// ============================================================================
+// DirectoryIndex.h - Interned NTFS Parent Directory Table
+// ============================================================================
+// Dense directory ids holding (parent, name span) pairs, with an
+// open-addressed record -> id map. Each name is stored once in a shared
+// arena; full paths are only materialized when a result is emitted.
+// Not thread-safe: owned by the scanner's consumer thread.
+// ============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace KVC {
+
+class DirectoryIndex {
+public:
+    // Persisted form of one record; names are spans of NameArena()
+    struct Entry {
+        uint64_t record;
+        uint64_t parentRecord;
+        uint32_t nameOffset;
+        uint32_t nameLength;        // UINT32_MAX for a known non-directory
+    };
+
+    DirectoryIndex() = default;
+
+    void Clear();
+
+    // Register a directory record (any allocation state); duplicates are ignored
+    void AddDirectory(uint64_t record, uint64_t parentRecord, const std::wstring& name);
+
+    // Remember a record that cannot be a parent, so it is never fetched again
+    void AddNonDirectory(uint64_t record);
+
+    // Re-point a record that was renamed, moved or reused since it was indexed
+    void ReplaceDirectory(uint64_t record, uint64_t parentRecord, const std::wstring& name);
+
+    // Every record in insertion order, for saving alongside NameArena()
+    std::vector<Entry> Export() const;
+    const std::wstring& NameArena() const { return m_names; }
+
+    // Replace the contents with a saved table; entries naming text outside
+    // names are dropped
+    void Import(std::span<const Entry> entries, std::wstring_view names);
+
+    bool Contains(uint64_t record) const { return FindId(record) != INVALID_ID; }
+
+    // First ancestor on the chain above parentRecord that is not indexed yet,
+    // or 0 when the chain reaches the root or a known dead end
+    uint64_t FindMissingAncestor(uint64_t parentRecord) const;
+
+    // "<deleted>\dir\...\filename"; unresolvable ancestors fold into the prefix
+    std::wstring BuildPath(uint64_t parentRecord, const std::wstring& filename) const;
+
+    size_t DirectoryCount() const { return m_nodes.size(); }
+    uint64_t MemoryUsage() const;
+
+private:
+    static constexpr uint32_t INVALID_ID = UINT32_MAX;
+    static constexpr uint32_t ROOT_ID = UINT32_MAX - 1;       // Parent is the root or itself
+    static constexpr uint32_t UNRESOLVED_ID = UINT32_MAX - 2; // Parent not looked up yet
+    static constexpr uint32_t NOT_A_DIRECTORY = UINT32_MAX;   // nameLength marker
+
+    struct Node {
+        uint64_t record;
+        uint64_t parentRecord;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        mutable uint32_t parentId;  // Memoized link, filled on first successful lookup
+    };
+
+    struct Slot {
+        uint64_t record;
+        uint32_t id;
+    };
+
+    uint32_t FindId(uint64_t record) const;
+    uint32_t ParentId(uint32_t id) const;
+    uint32_t AddNode(uint64_t record, uint64_t parentRecord, const std::wstring& name, bool isDirectory);
+    void InsertSlot(uint64_t record, uint32_t id);
+    void Grow();
+    size_t SlotFor(uint64_t record) const;
+
+    static bool IsRoot(uint64_t record) { return record == 0 || record == 5; }
+
+    std::vector<Node> m_nodes;
+    std::vector<Slot> m_slots;      // Power-of-two capacity, linear probing
+    std::wstring m_names;           // Arena for every directory name
+};
+
+} // namespace KVC
@@ -7,6 +7,9 @@
 #include "ExFATScanner.h"
 #include "FAT32Scanner.h"
 #include "FileCarver.h"
+#include "CarvingCheckpoint.h"
+#include "ScanIndex.h"
+#include "BandwidthLimiter.h"
 #include "UsnJournalScanner.h"
 #include "FileSignatures.h"
 #include "Constants.h"
@@ -14,12 +17,18 @@
 #include "StringUtils.h"
 #include "VolumeReader.h"
 #include "VolumeGeometry.h"
+#include "PerfCounters.h"
 
 #include <climits>
 #include <winioctl.h>
 #include <sstream>
-#include <set>
 #include <algorithm>
+#include <cstring>
+#include <cwctype>
+#include <future>
+#include <map>
+#include <thread>
+#include <unordered_set>
 
 namespace KVC {
 
@@ -27,57 +36,201 @@ namespace KVC {
 // DiskHandle Implementation
 // ============================================================================
 
+namespace {
+    // Handle whose PriorityScope the current thread is inside, if any
+    thread_local const DiskHandle* t_priorityDisk = nullptr;
+
+    // A mapped image that shrinks or sits on a failing disk raises an
+    // in-page error instead of failing a ReadFile. Kept free of C++ objects:
+    // __try cannot share a frame with anything that needs unwinding.
+    size_t CopyFromMapping(uint8_t* dest, const uint8_t* source, size_t size) {
+        __try {
+            std::memcpy(dest, source, size);
+            return size;
+        }
+        __except (GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR ? EXCEPTION_EXECUTE_HANDLER
+                                                                : EXCEPTION_CONTINUE_SEARCH) {
+            return 0;
+        }
+    }
+
+    bool IsDevicePath(const std::wstring& path) {
+        if (path.size() < 4 || path.compare(0, 4, L"\\\\.\\") != 0) {
+            return false;
+        }
+        std::wstring device = path.substr(4);
+        std::transform(device.begin(), device.end(), device.begin(), ::towlower);
+        return device.compare(0, 13, L"physicaldrive") == 0;
+    }
+}
+
 DiskHandle::DiskHandle(wchar_t driveLetter)
     : m_driveLetter(driveLetter)
+    , m_kind(SourceKind::Volume)
+    , m_partitionOffset(0)
     , m_handle(INVALID_HANDLE_VALUE)
-    , m_mappingHandle(nullptr)
+    , m_sectorSize(Limits::DEFAULT_SECTOR_SIZE)
+    , m_unbufferedHandle(INVALID_HANDLE_VALUE)
+    , m_asyncHandle(INVALID_HANDLE_VALUE)
+    , m_asyncUnbufferedHandle(INVALID_HANDLE_VALUE)
+    , m_completionPort(nullptr)
+    , m_asyncPending(0)
+    , m_priorityScopes(0)
+    , m_priorityReads(0)
+    , m_mapping(nullptr)
     , m_mappedView(nullptr)
-    , m_currentMappedOffset(0)
-    , m_currentMappedSize(0)
+    , m_mappedData(nullptr)
+    , m_mappedSize(0)
+    , m_windowCache(*this, Constants::Cache::BUDGET)
+{
+}
+
+DiskHandle::DiskHandle(const std::wstring& path, uint64_t partitionOffset)
+    : DiskHandle(L'\0')
 {
+    m_sourcePath = path;
+    m_kind = IsDevicePath(path) ? SourceKind::PhysicalDisk : SourceKind::ImageFile;
+    m_partitionOffset = partitionOffset;
 }
 
 DiskHandle::~DiskHandle() {
     Close();
 }
 
-bool DiskHandle::Open() {
+std::wstring DiskHandle::VolumePath() const {
+    if (!m_sourcePath.empty()) {
+        return m_sourcePath;
+    }
+
     std::wstring path = L"\\\\.\\";
     path += m_driveLetter;
     path += L":";
-    m_handle = CreateFileW(
+    return path;
+}
+
+HANDLE DiskHandle::OpenVolumeHandle(DWORD flags) const {
+    std::wstring path = VolumePath();
+    return CreateFileW(
         path.c_str(),
         GENERIC_READ,
         FILE_SHARE_READ | FILE_SHARE_WRITE,
         nullptr,
         OPEN_EXISTING,
-        FILE_ATTRIBUTE_NORMAL,
+        flags,
         nullptr
     );
+}
+
+bool DiskHandle::Open() {
+    m_handle = OpenVolumeHandle(FILE_ATTRIBUTE_NORMAL);
+    if (m_handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    // Unbuffered requests are validated against this on every read
+    m_sectorSize = GetSectorSize();
+
+    // Unmappable images (32-bit address space) keep using ReadFile
+    if (m_kind == SourceKind::ImageFile) {
+        MapImage();
+    }
+    return true;
+}
+
+bool DiskHandle::MapImage() {
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(m_handle, &fileSize) ||
+        static_cast<uint64_t>(fileSize.QuadPart) <= m_partitionOffset ||
+        static_cast<uint64_t>(fileSize.QuadPart) > SIZE_MAX) {
+        return false;
+    }
 
-    return m_handle != INVALID_HANDLE_VALUE;
+    HANDLE mapping = CreateFileMappingW(m_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_mapping = mapping;
+    m_mappedView = static_cast<const uint8_t*>(view);
+    m_mappedData = m_mappedView + m_partitionOffset;
+    m_mappedSize = static_cast<uint64_t>(fileSize.QuadPart) - m_partitionOffset;
+    return true;
+}
+
+void DiskHandle::UnmapImage() {
+    if (m_mappedView != nullptr) {
+        UnmapViewOfFile(m_mappedView);
+    }
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+    }
+    m_mapping = nullptr;
+    m_mappedView = nullptr;
+    m_mappedData = nullptr;
+    m_mappedSize = 0;
 }
 
 void DiskHandle::Close() {
+    ShutdownAsyncIO();
+
     auto closeHandle = [](HANDLE& h) {
         if (h != INVALID_HANDLE_VALUE && h != nullptr) {
             CloseHandle(h);
             h = INVALID_HANDLE_VALUE;
         }
     };
-    
-    if (m_mappedView != nullptr) {
-        UnmapViewOfFile(m_mappedView);
-        m_mappedView = nullptr;
-    }
-    
-    m_currentMappedOffset = 0;
-    m_currentMappedSize = 0;
-    
-    closeHandle(m_mappingHandle);
+
+    m_windowCache.Clear();
+    UnmapImage();
+
+    closeHandle(m_unbufferedHandle);
     closeHandle(m_handle);
 }
 
+HANDLE DiskHandle::UnbufferedHandleFor(uint64_t offset, const uint8_t* buffer, size_t size, bool async) {
+    // FILE_FLAG_NO_BUFFERING rejects anything not sector-aligned
+    const uint64_t alignMask = m_sectorSize - 1;
+    if ((offset & alignMask) != 0 || (size & alignMask) != 0 ||
+        (reinterpret_cast<uintptr_t>(buffer) & alignMask) != 0) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_handleInitMutex);
+
+    HANDLE& handle = async ? m_asyncUnbufferedHandle : m_unbufferedHandle;
+    if (handle != INVALID_HANDLE_VALUE) {
+        return handle;
+    }
+    if (async && m_completionPort == nullptr) {
+        return nullptr;
+    }
+
+    DWORD flags = FILE_FLAG_NO_BUFFERING | FILE_FLAG_SEQUENTIAL_SCAN;
+    if (async) {
+        flags |= FILE_FLAG_OVERLAPPED;
+    }
+
+    HANDLE opened = OpenVolumeHandle(flags);
+    if (opened == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+
+    // Both overlapped handles complete on the same port
+    if (async && CreateIoCompletionPort(opened, m_completionPort, 0, 0) == nullptr) {
+        CloseHandle(opened);
+        return nullptr;
+    }
+
+    handle = opened;
+    return handle;
+}
+
 std::vector<uint8_t> DiskHandle::ReadSectors(uint64_t startSector, uint64_t numSectors, uint64_t sectorSize) {
     if (m_handle == INVALID_HANDLE_VALUE || numSectors == 0) {
         return {};
@@ -88,13 +241,6 @@ std::vector<uint8_t> DiskHandle::ReadSectors(uint64_t startSector, uint64_t numS
     }
 
     uint64_t totalBytes = numSectors * sectorSize;
-    
-    LARGE_INTEGER offset;
-    offset.QuadPart = static_cast<LONGLONG>(startSector * sectorSize);
-
-    if (SetFilePointerEx(m_handle, offset, nullptr, FILE_BEGIN) == 0) {
-        return {};
-    }
 
     std::vector<uint8_t> buffer;
     try {
@@ -103,7 +249,50 @@ std::vector<uint8_t> DiskHandle::ReadSectors(uint64_t startSector, uint64_t numS
         return {};
     }
     
-    uint64_t bytesRemaining = totalBytes;
+    size_t bytesRead = ReadInto(startSector * sectorSize, buffer.data(), buffer.size());
+    buffer.resize(bytesRead);
+    return buffer;
+}
+
+size_t DiskHandle::ReadInto(uint64_t offset, uint8_t* buffer, size_t size, ReadMode mode) {
+    if (m_handle == INVALID_HANDLE_VALUE || buffer == nullptr || size == 0) {
+        return 0;
+    }
+
+    if (m_bandwidthLimiter) {
+        m_bandwidthLimiter->Acquire(size);
+    }
+
+    if (m_mappedData != nullptr) {
+        if (offset >= m_mappedSize) {
+            return 0;
+        }
+        size_t available = static_cast<size_t>(std::min<uint64_t>(size, m_mappedSize - offset));
+        Perf::ScopedTimer timer(Perf::Timer::DiskRead);
+        size_t copied = CopyFromMapping(buffer, m_mappedData + offset, available);
+        Perf::Add(Perf::Counter::ReadCalls);
+        Perf::Add(Perf::Counter::BytesRead, copied);
+        Perf::RecordReadLatency(timer.Elapsed());
+        return copied;
+    }
+
+    // Bulk readers waiting in ReadBackground resume once this drains
+    const bool priority = t_priorityDisk == this;
+    if (priority) {
+        std::lock_guard<std::mutex> lock(m_priorityMutex);
+        m_priorityReads++;
+    }
+
+    HANDLE handle = m_handle;
+    if (mode == ReadMode::Unbuffered) {
+        HANDLE unbuffered = UnbufferedHandleFor(m_partitionOffset + offset, buffer, size, false);
+        if (unbuffered != nullptr) {
+            handle = unbuffered;
+        }
+    }
+
+    Perf::ScopedTimer timer(Perf::Timer::DiskRead);
+    uint64_t bytesRemaining = size;
     uint64_t bufferOffset = 0;
     
     while (bytesRemaining > 0) {
@@ -113,30 +302,318 @@ std::vector<uint8_t> DiskHandle::ReadSectors(uint64_t startSector, uint64_t numS
             chunkSize = MAXDWORD;
         }
         
+        // Positional read: the offset travels with the request instead of
+        // through the shared file pointer, so concurrent readers don't race
+        uint64_t chunkOffset = m_partitionOffset + offset + bufferOffset;
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(chunkOffset & 0xFFFFFFFFULL);
+        overlapped.OffsetHigh = static_cast<DWORD>(chunkOffset >> 32);
+
         DWORD bytesRead = 0;
         BOOL success = ReadFile(
-            m_handle,
-            buffer.data() + bufferOffset,
+            handle,
+            buffer + bufferOffset,
             static_cast<DWORD>(chunkSize),
             &bytesRead,
-            nullptr
+            &overlapped
         );
         
         if (!success || bytesRead == 0) {
-            buffer.resize(static_cast<size_t>(bufferOffset));
-            return buffer;
+            // Retry a rejected unbuffered chunk through the cache once
+            if (handle != m_handle) {
+                handle = m_handle;
+                continue;
+            }
+            break;
         }
         
         bufferOffset += bytesRead;
         bytesRemaining -= bytesRead;
         
         if (bytesRead < chunkSize) {
-            buffer.resize(static_cast<size_t>(bufferOffset));
-            return buffer;
+            break;
+        }
+    }
+
+    if (priority) {
+        std::lock_guard<std::mutex> lock(m_priorityMutex);
+        if (--m_priorityReads == 0) {
+            m_priorityIdle.notify_all();
         }
     }
+
+    Perf::Add(Perf::Counter::ReadCalls);
+    Perf::Add(Perf::Counter::BytesRead, bufferOffset);
+    Perf::RecordReadLatency(timer.Elapsed());
     
-    return buffer;
+    return static_cast<size_t>(bufferOffset);
+}
+
+// ============================================================================
+// DiskHandle Overlapped I/O
+// ============================================================================
+
+// OVERLAPPED must stay the first member: completions hand back its address
+struct DiskHandle::AsyncRequest {
+    OVERLAPPED overlapped;
+    uint64_t offset;
+    uint8_t* buffer;
+    size_t size;
+    AsyncReadCompletion completion;
+    std::chrono::steady_clock::time_point issued;   // Set only while Perf is enabled
+};
+
+bool DiskHandle::EnableAsyncIO() {
+    std::lock_guard<std::mutex> lock(m_handleInitMutex);
+
+    if (m_completionPort != nullptr) {
+        return true;
+    }
+    // Mapped images are plain copies; queued reads would only add latency
+    if (m_handle == INVALID_HANDLE_VALUE || m_mappedData != nullptr) {
+        return false;
+    }
+
+    HANDLE asyncHandle = OpenVolumeHandle(FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED);
+    if (asyncHandle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    HANDLE port = CreateIoCompletionPort(asyncHandle, nullptr, 0, 0);
+    if (port == nullptr) {
+        CloseHandle(asyncHandle);
+        return false;
+    }
+
+    m_asyncHandle = asyncHandle;
+    m_completionPort = port;
+    return true;
+}
+
+void DiskHandle::ShutdownAsyncIO() {
+    if (m_completionPort == nullptr) {
+        return;
+    }
+
+    // Requests own caller buffers - never close under them
+    if (m_asyncPending.load() > 0) {
+        CancelIoEx(m_asyncHandle, nullptr);
+        if (m_asyncUnbufferedHandle != INVALID_HANDLE_VALUE) {
+            CancelIoEx(m_asyncUnbufferedHandle, nullptr);
+        }
+        while (m_asyncPending.load() > 0) {
+            if (WaitAsyncCompletions(1, INFINITE) == 0) {
+                break;
+            }
+        }
+    }
+
+    if (m_asyncUnbufferedHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_asyncUnbufferedHandle);
+        m_asyncUnbufferedHandle = INVALID_HANDLE_VALUE;
+    }
+    CloseHandle(m_asyncHandle);
+    CloseHandle(m_completionPort);
+    m_asyncHandle = INVALID_HANDLE_VALUE;
+    m_completionPort = nullptr;
+}
+
+bool DiskHandle::ReadAsync(uint64_t offset, uint8_t* buffer, size_t size, AsyncReadCompletion completion,
+                           ReadMode mode) {
+    if (m_completionPort == nullptr || buffer == nullptr || size == 0 ||
+        size > static_cast<size_t>(MAXDWORD)) {
+        return false;
+    }
+
+    HANDLE handle = m_asyncHandle;
+    if (mode == ReadMode::Unbuffered) {
+        HANDLE unbuffered = UnbufferedHandleFor(m_partitionOffset + offset, buffer, size, true);
+        if (unbuffered != nullptr) {
+            handle = unbuffered;
+        }
+    }
+
+    if (m_bandwidthLimiter) {
+        m_bandwidthLimiter->Acquire(size);
+    }
+
+    const uint64_t position = m_partitionOffset + offset;
+    auto* request = new AsyncRequest{};
+    request->overlapped.Offset = static_cast<DWORD>(position & 0xFFFFFFFFULL);
+    request->overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+    request->offset = offset;
+    request->buffer = buffer;
+    request->size = size;
+    request->completion = std::move(completion);
+    if (Perf::Enabled()) {
+        request->issued = std::chrono::steady_clock::now();
+    }
+
+    m_asyncPending++;
+
+    // Synchronous success still queues a completion packet, so both
+    // TRUE and ERROR_IO_PENDING mean "completion will arrive"
+    BOOL issued = ReadFile(handle, buffer, static_cast<DWORD>(size), nullptr, &request->overlapped);
+    if (!issued && GetLastError() != ERROR_IO_PENDING) {
+        m_asyncPending--;
+        delete request;
+        return false;
+    }
+
+    return true;
+}
+
+size_t DiskHandle::WaitAsyncCompletions(size_t minCompletions, DWORD timeoutMs) {
+    if (m_completionPort == nullptr) {
+        return 0;
+    }
+
+    size_t dispatched = 0;
+
+    while (m_asyncPending.load() > 0) {
+        DWORD waitMs = dispatched < minCompletions ? timeoutMs : 0;
+
+        DWORD bytesTransferred = 0;
+        ULONG_PTR completionKey = 0;
+        LPOVERLAPPED overlapped = nullptr;
+
+        BOOL ok = GetQueuedCompletionStatus(m_completionPort, &bytesTransferred,
+                                            &completionKey, &overlapped, waitMs);
+        if (overlapped == nullptr) {
+            break;  // Timeout or port failure - nothing dequeued
+        }
+
+        std::unique_ptr<AsyncRequest> request(reinterpret_cast<AsyncRequest*>(overlapped));
+
+        AsyncReadResult result;
+        result.offset = request->offset;
+        result.buffer = request->buffer;
+        result.requested = request->size;
+        result.bytesRead = bytesTransferred;
+        result.error = ok ? ERROR_SUCCESS : GetLastError();
+
+        m_asyncPending--;
+        dispatched++;
+
+        if (Perf::Enabled()) {
+            Perf::Add(Perf::Counter::ReadCalls);
+            Perf::Add(Perf::Counter::BytesRead, bytesTransferred);
+            Perf::RecordReadLatency(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - request->issued).count()));
+        }
+
+        if (request->completion) {
+            request->completion(result);
+        }
+    }
+
+    return dispatched;
+}
+
+size_t DiskHandle::ReadQueued(uint64_t offset, uint8_t* buffer, size_t size, size_t queueDepth,
+                              ReadMode mode) {
+    if (m_mappedData != nullptr) {
+        return ReadInto(offset, buffer, size, mode);
+    }
+
+    if (m_priorityScopes.load() > 0) {
+        return ReadBackground(offset, buffer, size, queueDepth, mode);
+    }
+
+    if (queueDepth <= 1 || size <= Constants::MAX_READ_CHUNK || !EnableAsyncIO()) {
+        return ReadInto(offset, buffer, size, mode);
+    }
+
+    std::lock_guard<std::mutex> lock(m_asyncMutex);
+
+    const size_t chunkSize = static_cast<size_t>(Constants::MAX_READ_CHUNK);
+    const size_t chunkCount = (size + chunkSize - 1) / chunkSize;
+
+    // Per-chunk byte counts; the result is the contiguous prefix
+    std::vector<size_t> chunkBytes(chunkCount, 0);
+    size_t nextChunk = 0;
+    size_t inFlight = 0;
+    bool submitFailed = false;
+
+    auto submit = [&](size_t index) {
+        size_t chunkOffset = index * chunkSize;
+        size_t length = std::min(chunkSize, size - chunkOffset);
+        return ReadAsync(offset + chunkOffset, buffer + chunkOffset, length,
+            [&chunkBytes, &inFlight, index](const AsyncReadResult& result) {
+                chunkBytes[index] = result.error == ERROR_SUCCESS ? result.bytesRead : 0;
+                inFlight--;
+            }, mode);
+    };
+
+    while (nextChunk < chunkCount || inFlight > 0) {
+        while (!submitFailed && nextChunk < chunkCount && inFlight < queueDepth) {
+            if (!submit(nextChunk)) {
+                submitFailed = true;
+                break;
+            }
+            inFlight++;
+            nextChunk++;
+        }
+
+        if (inFlight == 0) {
+            break;
+        }
+        WaitAsyncCompletions(1, INFINITE);
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < chunkCount; i++) {
+        size_t expected = std::min(chunkSize, size - i * chunkSize);
+        if (i >= nextChunk) break;
+        total += chunkBytes[i];
+        if (chunkBytes[i] < expected) break;
+    }
+
+    // Chunks never issued (submit failure) are read synchronously
+    if (submitFailed && total == nextChunk * chunkSize && total < size) {
+        total += ReadInto(offset + total, buffer + total, size - total, mode);
+    }
+
+    return total;
+}
+
+size_t DiskHandle::ReadBackground(uint64_t offset, uint8_t* buffer, size_t size, size_t queueDepth,
+                                  ReadMode mode) {
+    size_t total = 0;
+
+    while (total < size) {
+        // Metadata work finished: the rest streams at full queue depth
+        if (m_priorityScopes.load() == 0) {
+            return total + ReadQueued(offset + total, buffer + total, size - total, queueDepth, mode);
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(m_priorityMutex);
+            m_priorityIdle.wait(lock, [this] { return m_priorityReads == 0; });
+        }
+
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(size - total, Constants::BACKGROUND_READ_CHUNK));
+        size_t got = ReadInto(offset + total, buffer + total, chunk, mode);
+        total += got;
+        if (got < chunk) {
+            break;
+        }
+    }
+
+    return total;
+}
+
+DiskHandle::PriorityScope::PriorityScope(DiskHandle& disk)
+    : m_disk(disk)
+    , m_previous(t_priorityDisk)
+{
+    t_priorityDisk = &disk;
+    m_disk.m_priorityScopes++;
+}
+
+DiskHandle::PriorityScope::~PriorityScope() {
+    m_disk.m_priorityScopes--;
+    t_priorityDisk = m_previous;
 }
 
 uint64_t DiskHandle::GetSectorSize() const {
@@ -160,6 +637,27 @@ uint64_t DiskHandle::GetDiskSize() const {
         return 0;
     }
 
+    uint64_t sourceSize = SourceSize();
+    if (m_partitionOffset == 0) {
+        return sourceSize;
+    }
+    if (m_partitionOffset >= sourceSize) {
+        return 0;
+    }
+
+    // On a physical disk the volume ends with its partition, not the disk
+    uint64_t length = m_kind == SourceKind::PhysicalDisk ? PartitionLength() : 0;
+    uint64_t remaining = sourceSize - m_partitionOffset;
+    return length > 0 ? std::min(length, remaining) : remaining;
+}
+
+uint64_t DiskHandle::SourceSize() const {
+    // Disk IOCTLs fail on regular files
+    if (m_kind == SourceKind::ImageFile) {
+        LARGE_INTEGER fileSize = {};
+        return GetFileSizeEx(m_handle, &fileSize) ? static_cast<uint64_t>(fileSize.QuadPart) : 0;
+    }
+
     DWORD bytesReturned = 0;
 
     GET_LENGTH_INFORMATION lengthInfo = {};
@@ -180,217 +678,995 @@ uint64_t DiskHandle::GetDiskSize() const {
     return 0;
 }
 
+uint64_t DiskHandle::PartitionLength() const {
+    // The layout is variable-length; grow until every entry fits
+    std::vector<uint8_t> layout(sizeof(DRIVE_LAYOUT_INFORMATION_EX) + 16 * sizeof(PARTITION_INFORMATION_EX));
+    DWORD bytesReturned = 0;
+
+    while (!DeviceIoControl(m_handle, IOCTL_DISK_GET_DRIVE_LAYOUT_EX, nullptr, 0,
+                            layout.data(), static_cast<DWORD>(layout.size()), &bytesReturned, nullptr)) {
+        if (GetLastError() != ERROR_INSUFFICIENT_BUFFER || layout.size() > 1024 * 1024) {
+            return 0;
+        }
+        layout.resize(layout.size() * 2);
+    }
+
+    const auto* info = reinterpret_cast<const DRIVE_LAYOUT_INFORMATION_EX*>(layout.data());
+    for (DWORD i = 0; i < info->PartitionCount; i++) {
+        const PARTITION_INFORMATION_EX& partition = info->PartitionEntry[i];
+        if (static_cast<uint64_t>(partition.StartingOffset.QuadPart) == m_partitionOffset) {
+            return static_cast<uint64_t>(partition.PartitionLength.QuadPart);
+        }
+    }
+    return 0;
+}
+
+uint32_t DiskHandle::PhysicalDiskNumber(wchar_t driveLetter) {
+    std::wstring path = L"\\\\.\\";
+    path += driveLetter;
+    path += L":";
+
+    // The extents query needs no read access, so this works without elevation
+    HANDLE volume = CreateFileW(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                OPEN_EXISTING, 0, nullptr);
+    if (volume == INVALID_HANDLE_VALUE) {
+        return UINT32_MAX;
+    }
+
+    // A spanned volume overflows the buffer, but its first extent is filled in
+    std::vector<uint8_t> buffer(sizeof(VOLUME_DISK_EXTENTS) + 7 * sizeof(DISK_EXTENT));
+    DWORD bytesReturned = 0;
+    BOOL ok = DeviceIoControl(volume, IOCTL_VOLUME_GET_VOLUME_DISK_EXTENTS, nullptr, 0,
+                              buffer.data(), static_cast<DWORD>(buffer.size()), &bytesReturned, nullptr);
+    if (!ok && GetLastError() == ERROR_MORE_DATA) {
+        ok = TRUE;
+    }
+    CloseHandle(volume);
+
+    const auto* extents = reinterpret_cast<const VOLUME_DISK_EXTENTS*>(buffer.data());
+    if (!ok || extents->NumberOfDiskExtents == 0) {
+        return UINT32_MAX;
+    }
+    return extents->Extents[0].DiskNumber;
+}
+
 DiskHandle::MappedRegion DiskHandle::MapDiskRegion(uint64_t offset, uint64_t size) {
     MappedRegion region;
-    
-    if (m_handle == INVALID_HANDLE_VALUE) {
+
+    if (m_handle == INVALID_HANDLE_VALUE || size == 0) {
         return region;
     }
-    
-    if (m_mappedView != nullptr && 
-        offset >= m_currentMappedOffset &&
-        offset + size <= m_currentMappedOffset + m_currentMappedSize) {
-        
-        uint64_t offsetInMapping = offset - m_currentMappedOffset;
-        region.data = static_cast<const uint8_t*>(m_mappedView) + offsetInMapping;
-        region.size = size;
+
+    // Images are mapped whole: hand out the mapping itself
+    if (m_mappedData != nullptr) {
+        if (offset >= m_mappedSize) {
+            return region;
+        }
+        region.data = m_mappedData + offset;
+        region.size = std::min(size, m_mappedSize - offset);
         region.diskOffset = offset;
         return region;
     }
-    
-    SYSTEM_INFO sysInfo;
-    GetSystemInfo(&sysInfo);
-    uint64_t granularity = sysInfo.dwAllocationGranularity;
-    
-    uint64_t alignedOffset = (offset / granularity) * granularity;
-    uint64_t extraBytes = offset - alignedOffset;
-    uint64_t adjustedSize = size + extraBytes;
-    
-    if (adjustedSize > Limits::MAX_MAPPING_SIZE) {
-        adjustedSize = Limits::MAX_MAPPING_SIZE;
-    }
-    
-    // FIX: Create mapping for entire disk (pass 0,0)
-    HANDLE hMapping = CreateFileMappingW(
-        m_handle,
-        nullptr,
-        PAGE_READONLY,
-        0,  // High part of max size (0 = entire file)
-        0,  // Low part of max size (0 = entire file)
-        nullptr
-    );
-    
-    if (hMapping == nullptr) {
+
+    // Windows will not create a section over a raw volume handle, so views
+    // are cached reads; the pinned window survives eviction while in use.
+    // Regions larger than the cache are left to the caller's own buffers.
+    if (size > Constants::Cache::BUDGET) {
         return region;
     }
-    
-    LARGE_INTEGER fileOffset;
-    fileOffset.QuadPart = alignedOffset;
-    
-    void* pView = MapViewOfFile(
-        hMapping,
-        FILE_MAP_READ,
-        fileOffset.HighPart,
-        fileOffset.LowPart,
-        static_cast<SIZE_T>(adjustedSize)
-    );
-    
-    if (pView == nullptr) {
-        CloseHandle(hMapping);
+
+    WindowCache::Pin window = m_windowCache.Acquire(offset, size);
+    if (!window) {
         return region;
     }
-    
-    if (m_mappingHandle != nullptr) {
-        CloseHandle(m_mappingHandle);
+
+    region.data = window->Data() + (offset - window->offset);
+    region.size = size;
+    region.diskOffset = offset;
+    region.window = std::move(window);
+
+    return region;
+}
+
+void DiskHandle::UnmapRegion(MappedRegion& region) {
+    region.window.reset();
+    region.data = nullptr;
+    region.size = 0;
+    region.diskOffset = 0;
+}
+
+// ============================================================================
+// ScanConfiguration Implementation
+// ============================================================================
+
+ScanConfiguration ScanConfiguration::Load() {
+    return ScanConfiguration();
+}
+
+bool ScanConfiguration::Save() const {
+    return true;
+}
+
+// ============================================================================
+// DiskForensicsCore Implementation
+// ============================================================================
+
+namespace {
+    // FNV-1a over every setting a saved result set depends on, so an index
+    // is only reused by a scan that would have produced the same results
+    class SettingsHash {
+    public:
+        void Add(const void* data, size_t size) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; i++) {
+                m_hash = (m_hash ^ bytes[i]) * 0x100000001B3ULL;
+            }
+        }
+        template <typename T>
+        void Add(const T& value) { Add(&value, sizeof(T)); }
+        void Add(const std::wstring& text) {
+            Add(text.size());
+            Add(text.data(), text.size() * sizeof(wchar_t));
+        }
+        uint64_t Value() const { return m_hash; }
+
+    private:
+        uint64_t m_hash = 0xCBF29CE484222325ULL;
+    };
+
+    // A checkpoint folder on the volume being scanned would overwrite the
+    // very clusters carving is looking for
+    bool IsOnDrive(const std::wstring& path, wchar_t driveLetter) {
+        wchar_t fullPath[MAX_PATH] = {};
+        DWORD length = GetFullPathNameW(path.c_str(), MAX_PATH, fullPath, nullptr);
+        if (length < 2 || length >= MAX_PATH || fullPath[1] != L':') {
+            return false;
+        }
+        return std::towupper(fullPath[0]) == std::towupper(driveLetter);
+    }
+}
+
+DiskForensicsCore::DiskForensicsCore()
+    : m_config(ScanConfiguration::Load())
+{
+    m_ntfsScanner = std::make_unique<NTFSScanner>();
+    m_exfatScanner = std::make_unique<ExFATScanner>();
+    m_fat32Scanner = std::make_unique<FAT32Scanner>();
+    m_fileCarver = std::make_unique<FileCarver>();
+    m_usnJournalScanner = std::make_unique<UsnJournalScanner>();
+}
+
+DiskForensicsCore::~DiskForensicsCore() = default;
+
+CarvingStatistics DiskForensicsCore::LastCarvingStatistics() const {
+    return m_carvingStats ? *m_carvingStats : CreateCarvingDiagnostics();
+}
+
+bool DiskForensicsCore::ShouldSkipDuplicate(const RecoveryCandidate& candidate) {
+    uint64_t startCluster = candidate.file.GetFragments().IsEmpty() ? 0 :
+                            candidate.file.GetFragments().GetRuns()[0].startCluster;
+
+    return !m_candidateIndex.InsertCandidate(candidate.mftRecord.value_or(0), startCluster);
+}
+
+void DiskForensicsCore::ClaimClusters(const RecoveryCandidate& candidate) {
+    if (!candidate.IsRecoverable() || m_claimedClusters.Empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_claimMutex);
+    for (const auto& run : candidate.file.GetFragments().GetRuns()) {
+        // A running carver owns the map; it takes these before its next batch
+        if (m_deferClaims) {
+            m_pendingClaims.push_back({ run.startCluster, run.clusterCount });
+        } else {
+            m_claimedClusters.SetRange(run.startCluster, run.clusterCount);
+        }
+    }
+}
+
+FilesystemType DiskForensicsCore::DetectFilesystem(wchar_t driveLetter) {
+    std::wstring rootPath;
+    rootPath += driveLetter;
+    rootPath += L":\\";
+    wchar_t fsName[MAX_PATH + 1] = {};
+
+    if (GetVolumeInformationW(rootPath.c_str(), nullptr, 0, nullptr, nullptr, nullptr,
+                             fsName, MAX_PATH)) {
+        std::wstring fs(fsName);
+        if (fs == L"NTFS") return FilesystemType::NTFS;
+        if (fs == L"exFAT") return FilesystemType::ExFAT;
+        if (fs == L"FAT32") return FilesystemType::FAT32;
+    }
+
+    return FilesystemType::Unknown;
+}
+
+FilesystemType DiskForensicsCore::DetectFilesystem(DiskHandle& disk) {
+    auto sector = disk.ReadSectors(0, 1, disk.GetSectorSize());
+    if (sector.size() < 512) {
+        return FilesystemType::Unknown;
+    }
+
+    // OEM names at 0x03, FAT32's type label at 0x52
+    if (std::memcmp(sector.data() + 3, "NTFS    ", 8) == 0) return FilesystemType::NTFS;
+    if (std::memcmp(sector.data() + 3, "EXFAT   ", 8) == 0) return FilesystemType::ExFAT;
+    if (std::memcmp(sector.data() + 0x52, "FAT32   ", 8) == 0) return FilesystemType::FAT32;
+
+    return FilesystemType::Unknown;
+}
+
+bool DiskForensicsCore::StartScan(
+    wchar_t driveLetter,
+    const std::wstring& folderFilter,
+    const std::wstring& filenameFilter,
+    FileFoundCallback onFileFound,
+    ProgressCallback onProgress,
+    bool& shouldStop,
+    bool enableMft,
+    bool enableUsn,
+    bool enableCarving)
+{
+    FilesystemType fsType = DetectFilesystem(driveLetter);
+    
+    DiskHandle disk(driveLetter);
+    if (!disk.Open()) {
+        onProgress(L"Failed to open disk drive", 0.0f);
+        return false;
+    }
+
+    return ScanSource(disk, fsType, std::wstring(1, driveLetter), folderFilter, filenameFilter,
+                      onFileFound, onProgress, shouldStop, enableMft, enableUsn, enableCarving);
+}
+
+bool DiskForensicsCore::StartImageScan(
+    const std::wstring& imagePath,
+    uint64_t partitionOffset,
+    const std::wstring& folderFilter,
+    const std::wstring& filenameFilter,
+    FileFoundCallback onFileFound,
+    ProgressCallback onProgress,
+    bool& shouldStop,
+    bool enableMft,
+    bool enableUsn,
+    bool enableCarving)
+{
+    DiskHandle disk(imagePath, partitionOffset);
+    if (!disk.Open()) {
+        onProgress(L"Failed to open image", 0.0f);
+        return false;
+    }
+
+    // Checkpoints are told apart by image name and partition
+    std::wstring tag = imagePath.substr(imagePath.find_last_of(L"\\/:") + 1);
+    if (partitionOffset != 0) {
+        tag += L"_" + std::to_wstring(partitionOffset);
+    }
+
+    return ScanSource(disk, DetectFilesystem(disk), tag, folderFilter, filenameFilter,
+                      onFileFound, onProgress, shouldStop, enableMft, enableUsn, enableCarving);
+}
+
+std::vector<VolumeScanSummary> DiskForensicsCore::StartMultiVolumeScan(
+    const std::vector<wchar_t>& driveLetters,
+    const std::wstring& folderFilter,
+    const std::wstring& filenameFilter,
+    VolumeFileFoundCallback onFileFound,
+    VolumeProgressCallback onProgress,
+    bool& shouldStop,
+    bool enableMft,
+    bool enableUsn,
+    bool enableCarving)
+{
+    std::vector<VolumeScanSummary> summaries;
+    for (wchar_t letter : driveLetters) {
+        letter = static_cast<wchar_t>(std::towupper(letter));
+        bool listed = std::any_of(summaries.begin(), summaries.end(),
+                                  [letter](const VolumeScanSummary& s) { return s.driveLetter == letter; });
+        if (!listed) {
+            VolumeScanSummary summary;
+            summary.driveLetter = letter;
+            summary.physicalDisk = DiskHandle::PhysicalDiskNumber(letter);
+            summary.fsType = DetectFilesystem(letter);
+            summaries.push_back(summary);
+        }
+    }
+    if (summaries.empty()) {
+        return summaries;
+    }
+
+    // One group per physical disk; a volume on an unknown disk gets its own
+    std::vector<std::vector<size_t>> groups;
+    std::map<uint32_t, size_t> groupOfDisk;
+    for (size_t i = 0; i < summaries.size(); i++) {
+        if (summaries[i].physicalDisk == UINT32_MAX) {
+            groups.push_back({ i });
+            continue;
+        }
+        auto [entry, inserted] = groupOfDisk.emplace(summaries[i].physicalDisk, groups.size());
+        if (inserted) {
+            groups.emplace_back();
+        }
+        groups[entry->second].push_back(i);
+    }
+
+    const size_t budget = m_config.totalThreadBudget != 0
+        ? m_config.totalThreadBudget
+        : std::max<size_t>(1, std::thread::hardware_concurrency());
+    const size_t lanes = std::min(groups.size(), budget);
+    const size_t threadsPerVolume = std::max<size_t>(1, budget / lanes);
+
+    if (!m_bandwidthLimiter && m_config.totalBandwidthLimit != 0) {
+        m_bandwidthLimiter = std::make_shared<BandwidthLimiter>(m_config.totalBandwidthLimit);
+    }
+
+    std::mutex callbackMutex;
+
+    auto scanVolume = [&](VolumeScanSummary& summary) {
+        const wchar_t letter = summary.driveLetter;
+        auto onVolumeProgress = [&, letter](const std::wstring& message, float progress) {
+            std::lock_guard<std::mutex> lock(callbackMutex);
+            onProgress(letter, message, progress);
+        };
+        auto onVolumeFile = [&, letter](const RecoveryCandidate& candidate) {
+            std::lock_guard<std::mutex> lock(callbackMutex);
+            summary.filesFound++;
+            onFileFound(letter, candidate);
+        };
+
+        // Each volume gets its own engine; only the limiter is shared
+        DiskForensicsCore core;
+        core.m_config = m_config;
+        core.m_config.parallelThreads = threadsPerVolume;
+        core.m_bandwidthLimiter = m_bandwidthLimiter;
+        if (!m_checkpointFolder.empty() && !IsOnDrive(m_checkpointFolder, letter)) {
+            core.m_checkpointFolder = m_checkpointFolder;
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        try {
+            summary.success = core.StartScan(letter, folderFilter, filenameFilter, onVolumeFile,
+                                             onVolumeProgress, shouldStop, enableMft, enableUsn,
+                                             enableCarving);
+        } catch (const std::exception& e) {
+            wchar_t msg[256];
+            swprintf_s(msg, L"Scan failed: %hs", e.what());
+            onVolumeProgress(msg, 0.0f);
+            summary.success = false;
+        }
+        summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    };
+
+    // Lanes take whole disk groups, so two volumes of one disk never overlap
+    std::atomic<size_t> nextGroup{ 0 };
+    auto runLane = [&]() {
+        for (size_t group = nextGroup++; group < groups.size(); group = nextGroup++) {
+            for (size_t index : groups[group]) {
+                if (shouldStop) return;
+                scanVolume(summaries[index]);
+            }
+        }
+    };
+
+    std::vector<std::future<void>> workers;
+    for (size_t lane = 1; lane < lanes; lane++) {
+        workers.push_back(std::async(std::launch::async, runLane));
+    }
+    runLane();
+    for (auto& worker : workers) {
+        worker.get();
+    }
+
+    return summaries;
+}
+
+std::vector<wchar_t> DiskForensicsCore::ListScannableVolumes() {
+    std::vector<wchar_t> volumes;
+    DWORD drives = GetLogicalDrives();
+
+    for (int i = 0; i < 26; i++) {
+        if (!(drives & (1u << i))) continue;
+
+        wchar_t letter = static_cast<wchar_t>(L'A' + i);
+        wchar_t rootPath[] = { letter, L':', L'\\', L'\0' };
+        if (GetDriveTypeW(rootPath) == DRIVE_FIXED && DetectFilesystem(letter) != FilesystemType::Unknown) {
+            volumes.push_back(letter);
+        }
+    }
+    return volumes;
+}
+
+void DiskForensicsCore::SetBandwidthLimit(uint64_t bytesPerSecond) {
+    m_config.totalBandwidthLimit = bytesPerSecond;
+    m_bandwidthLimiter.reset();
+}
+
+bool DiskForensicsCore::ScanSource(
+    DiskHandle& disk,
+    FilesystemType fsType,
+    const std::wstring& sourceTag,
+    const std::wstring& folderFilter,
+    const std::wstring& filenameFilter,
+    FileFoundCallback onFileFound,
+    ProgressCallback onProgress,
+    bool& shouldStop,
+    bool enableMft,
+    bool enableUsn,
+    bool enableCarving)
+{
+    bool success = false;
+    m_carvingStats.reset();
+    m_carvedFileCounter = 0;
+
+    if (!m_bandwidthLimiter && m_config.totalBandwidthLimit != 0) {
+        m_bandwidthLimiter = std::make_shared<BandwidthLimiter>(m_config.totalBandwidthLimit);
+    }
+    disk.SetBandwidthLimiter(m_bandwidthLimiter);
+
+    m_checkpointPath.clear();
+    m_indexPath.clear();
+    if (!m_checkpointFolder.empty()) {
+        m_checkpointPath = m_checkpointFolder;
+        if (m_checkpointPath.back() != L'\\' && m_checkpointPath.back() != L'/') {
+            m_checkpointPath += L'\\';
+        }
+        m_indexPath = m_checkpointPath + L"kvc_index_" + sourceTag + L".kvci";
+        m_checkpointPath += L"kvc_carving_" + sourceTag + L".ckpt";
+
+        // A checkpoint holds the files carved before it; without retained
+        // files a resume would skip them unreported, so carving starts over
+        if (!m_config.carvingRetainFiles) {
+            m_checkpointPath.clear();
+        }
+    }
+
+    switch (fsType) {
+    case FilesystemType::NTFS:
+        success = StartNTFSMultiStageScan(disk, folderFilter, filenameFilter, 
+                                         onFileFound, onProgress, shouldStop,
+                                         enableMft, enableUsn, enableCarving);
+        break;
+
+    case FilesystemType::ExFAT:
+        onProgress(L"Scanning exFAT filesystem...", 0.0f);
+        m_candidateIndex.Reset(0);
+        {
+            auto dedupCallback = [&](const RecoveryCandidate& candidate) {
+                if (!ShouldSkipDuplicate(candidate)) {
+                    onFileFound(candidate);
+                }
+            };
+            success = m_exfatScanner->ScanVolume(disk, folderFilter, filenameFilter,
+                                                dedupCallback, onProgress, shouldStop, m_config);
+        }
+        break;
+
+    case FilesystemType::FAT32:
+        onProgress(L"Scanning FAT32 filesystem...", 0.0f);
+        m_candidateIndex.Reset(0);
+        {
+            auto dedupCallback = [&](const RecoveryCandidate& candidate) {
+                if (!ShouldSkipDuplicate(candidate)) {
+                    onFileFound(candidate);
+                }
+            };
+            success = m_fat32Scanner->ScanVolume(disk, folderFilter, filenameFilter,
+                                                dedupCallback, onProgress, shouldStop, m_config);
+        }
+        break;
+
+    default:
+        onProgress(L"Unsupported filesystem type", 0.0f);
+        break;
+    }
+
+    return success;
+}
+
+bool DiskForensicsCore::StartNTFSMultiStageScan(
+    DiskHandle& disk,
+    const std::wstring& folderFilter,
+    const std::wstring& filenameFilter,
+    FileFoundCallback onFileFound,
+    ProgressCallback onProgress,
+    bool& shouldStop,
+    bool enableMft,
+    bool enableUsn,
+    bool enableCarving)
+{
+    m_ntfsScanner->ResetSession();
+
+    // Build volume geometry for NTFS
+    auto boot = m_ntfsScanner->ReadBootSector(disk);
+
+    // The MFT can't hold more records than fit on the volume
+    m_candidateIndex.Reset(disk.GetDiskSize() / std::max<uint64_t>(NTFSScanner::MftRecordSize(boot), 1));
+    
+    VolumeGeometry geom;
+    geom.sectorSize = boot.bytesPerSector;
+    geom.bytesPerCluster = boot.bytesPerSector * boot.sectorsPerCluster;
+    geom.totalClusters = disk.GetDiskSize() / geom.bytesPerCluster;
+    geom.volumeStartOffset = 0;  // Raw volume handle starts at partition offset 0
+    geom.fsType = FilesystemType::NTFS;
+
+    m_claimedClusters.Reset(geom.totalClusters);
+
+    // Every result also goes into this scan's index
+    ScanIndexState indexState;
+    std::vector<uint64_t> changedRecords;
+    std::unique_ptr<ScanIndex> previousIndex = PrepareScanIndex(
+        disk, boot, geom, folderFilter, filenameFilter, enableMft, enableUsn, enableCarving,
+        indexState, changedRecords);
+    if (m_indexBuilder) {
+        onFileFound = [this, report = std::move(onFileFound)](const RecoveryCandidate& candidate) {
+            m_indexBuilder->Add(candidate);
+            report(candidate);
+        };
+    }
+
+    m_metadataComplete = false;
+    m_carvingResumeLCN = 0;
+    ClusterBitmap allocatedClusters;
+    const ClusterBitmap* allocated = nullptr;
+    bool anySuccess = false;
+
+    if (previousIndex) {
+        anySuccess = RunIncrementalScan(disk, boot, geom, *previousIndex, std::move(changedRecords),
+                                        folderFilter, filenameFilter,
+                                        onFileFound, onProgress, shouldStop, enableMft, enableUsn,
+                                        enableCarving, allocatedClusters, allocated);
+
+        // The new index is renamed over the mapped file
+        previousIndex.reset();
+
+    } else if (m_config.overlapStages && enableCarving && (enableMft || enableUsn)) {
+        // Carving streams the whole volume while MFT and USN are small metadata
+        // reads, so carving can start at once and pick up their claims as it goes.
+        // The scanner's MFT layout is rebuilt by Stage 1, so read $Bitmap first.
+        allocated = LoadCarvingAllocation(disk, boot, geom, allocatedClusters, onProgress);
+        anySuccess = RunOverlappedStages(disk, boot, geom, allocated, folderFilter, filenameFilter,
+                                         onFileFound, onProgress, shouldStop, enableMft, enableUsn);
+
+    } else {
+        anySuccess = RunMetadataStages(disk, folderFilter, filenameFilter, onFileFound, onProgress,
+                                       shouldStop, enableMft, enableUsn);
+
+        // ====================================================================
+        // Stage 3: File Carving - Slow but Thorough
+        // ====================================================================
+
+        if (enableCarving && !((enableMft || enableUsn) && shouldStop)) {
+            float baseProgress = 0.0f;
+            if (enableMft && enableUsn) baseProgress = 0.66f;
+            else if (enableMft || enableUsn) baseProgress = 0.5f;
+
+            onProgress(L"Stage 3: Carving files from free space...", baseProgress);
+
+            auto carvingProgress = [&](const std::wstring& msg, float progress) {
+                float adjustedProgress = baseProgress + (progress * (1.0f - baseProgress));
+                onProgress(msg, adjustedProgress);
+            };
+
+            allocated = LoadCarvingAllocation(disk, boot, geom, allocatedClusters, carvingProgress);
+
+            bool stage3Success = RunCarvingStage(disk, boot, geom, allocated, onFileFound,
+                                                 carvingProgress, shouldStop, nullptr);
+            anySuccess = anySuccess || stage3Success;
+        }
+    }
+
+    SaveScanIndex(indexState, geom, allocated, enableCarving);
+
+    if (shouldStop) {
+        onProgress(L"Scan stopped by user", 1.0f);
+        return anySuccess;
+    }
+
+    onProgress(L"Scan complete!", 1.0f);
+    return anySuccess;
+}
+
+bool DiskForensicsCore::RunOverlappedStages(
+    DiskHandle& disk,
+    const NTFSBootSector& boot,
+    const VolumeGeometry& geom,
+    const ClusterBitmap* allocated,
+    const std::wstring& folderFilter,
+    const std::wstring& filenameFilter,
+    FileFoundCallback onFileFound,
+    ProgressCallback onProgress,
+    bool& shouldStop,
+    bool enableMft,
+    bool enableUsn)
+{
+    // Callers see one stream of results and progress, as in a sequential scan.
+    // Carving covers the whole run, so its fraction drives the progress bar.
+    std::mutex callbackMutex;
+    std::atomic<float> carvingFraction(0.0f);
+
+    auto deliver = [&](const RecoveryCandidate& candidate) {
+        std::lock_guard<std::mutex> lock(callbackMutex);
+        onFileFound(candidate);
+    };
+    auto metadataProgress = [&](const std::wstring& msg, float) {
+        std::lock_guard<std::mutex> lock(callbackMutex);
+        onProgress(msg, carvingFraction.load());
+    };
+    auto carvingProgress = [&](const std::wstring& msg, float progress) {
+        carvingFraction = progress;
+        std::lock_guard<std::mutex> lock(callbackMutex);
+        onProgress(msg, progress);
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(m_claimMutex);
+        m_pendingClaims.clear();
+        m_deferClaims = true;
+    }
+
+    onProgress(L"Stages 1-3: Scanning metadata while carving free space...", 0.0f);
+
+    std::future<bool> metadata = std::async(std::launch::async, [&]() {
+        DiskHandle::PriorityScope priority(disk);
+        return RunMetadataStages(disk, folderFilter, filenameFilter, deliver, metadataProgress,
+                                 shouldStop, enableMft, enableUsn);
+    });
+
+    // Claims queued by Stage 1 and 2 land in the carver's map between batches
+    auto syncClaims = [this](ClusterBitmap& claimed) {
+        std::lock_guard<std::mutex> lock(m_claimMutex);
+        for (const auto& range : m_pendingClaims) {
+            claimed.SetRange(range.start, range.count);
+        }
+        m_pendingClaims.clear();
+    };
+
+    bool carvingSuccess = false;
+    std::exception_ptr stageError;
+    try {
+        carvingSuccess = RunCarvingStage(disk, boot, geom, allocated, deliver,
+                                         carvingProgress, shouldStop, syncClaims);
+    } catch (...) {
+        stageError = std::current_exception();
+    }
+
+    // Never leave the metadata thread running against the caller's handle
+    bool metadataSuccess = false;
+    try {
+        metadataSuccess = metadata.get();
+    } catch (...) {
+        if (!stageError) stageError = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_claimMutex);
+        m_deferClaims = false;
+        m_pendingClaims.clear();
+    }
+
+    if (stageError) {
+        std::rethrow_exception(stageError);
+    }
+
+    return metadataSuccess || carvingSuccess;
+}
+
+bool DiskForensicsCore::RunMetadataStages(
+    DiskHandle& disk,
+    const std::wstring& folderFilter,
+    const std::wstring& filenameFilter,
+    FileFoundCallback onFileFound,
+    ProgressCallback onProgress,
+    bool& shouldStop,
+    bool enableMft,
+    bool enableUsn)
+{
+    bool anySuccess = false;
+
+    // ========================================================================
+    // Stage 1: MFT (Master File Table) Scan - Ultra Fast
+    // ========================================================================
+    
+    if (enableMft) {
+        onProgress(L"Stage 1: Scanning MFT for deleted files...", 0.0f);
+
+        auto mftCallback = [&](const RecoveryCandidate& candidate) {
+            if (candidate.mftRecord) {
+                m_candidateIndex.MarkRecord(*candidate.mftRecord);
+            }
+            if (!ShouldSkipDuplicate(candidate)) {
+                ClaimClusters(candidate);
+                onFileFound(candidate);
+            }
+        };
+
+        bool stage1Success = m_ntfsScanner->ScanVolume(disk, folderFilter, filenameFilter,
+                                                      mftCallback, onProgress, shouldStop, m_config);
+        anySuccess = anySuccess || stage1Success;
+
+        if (shouldStop) {
+            return anySuccess;
+        }
+    }
+    
+    // ========================================================================
+    // Stage 2: USN Journal Analysis - Medium Speed
+    // ========================================================================
+    
+    if (enableUsn) {
+        float baseProgress = enableMft ? 0.33f : 0.0f;
+        onProgress(L"Stage 2: Analyzing USN Journal...", baseProgress);
+
+        auto usnCallback = [&](const RecoveryCandidate& candidate) {
+            if (!ShouldSkipDuplicate(candidate)) {
+                ClaimClusters(candidate);
+                onFileFound(candidate);
+            }
+        };
+
+        bool stage2Success = ProcessUsnJournal(disk, usnCallback, onProgress, shouldStop);
+        anySuccess = anySuccess || stage2Success;
+    }
+
+    m_metadataComplete = !shouldStop;
+    return anySuccess;
+}
+
+const ClusterBitmap* DiskForensicsCore::LoadCarvingAllocation(
+    DiskHandle& disk,
+    const NTFSBootSector& boot,
+    const VolumeGeometry& geom,
+    ClusterBitmap& allocatedClusters,
+    const ProgressCallback& onProgress)
+{
+    // Live files cannot hold deleted data; on request carve only what $Bitmap
+    // reports free
+    if (!m_config.carvingUnallocatedOnly) {
+        return nullptr;
     }
-    if (m_mappedView != nullptr) {
-        UnmapViewOfFile(m_mappedView);
+
+    allocatedClusters.Reset(geom.totalClusters);
+    if (m_ntfsScanner->LoadVolumeBitmap(disk, boot, allocatedClusters)) {
+        return &allocatedClusters;
     }
-    
-    m_mappingHandle = hMapping;
-    m_mappedView = pView;
-    
-    m_currentMappedOffset = alignedOffset;
-    m_currentMappedSize = adjustedSize;
-    
-    region.data = static_cast<const uint8_t*>(pView) + extraBytes;
-    region.size = adjustedSize - extraBytes;
-    region.diskOffset = offset;
-    
-    return region;
-}
 
-void DiskHandle::UnmapRegion(MappedRegion& region) {
-    region.data = nullptr;
-    region.size = 0;
-    region.diskOffset = 0;
+    onProgress(L"Stage 3: Volume bitmap unreadable, carving every cluster", 0.0f);
+    return nullptr;
 }
 
-// ============================================================================
-// ScanConfiguration Implementation
-// ============================================================================
+bool DiskForensicsCore::RunCarvingStage(
+    DiskHandle& disk,
+    const NTFSBootSector& boot,
+    const VolumeGeometry& geom,
+    const ClusterBitmap* allocatedClusters,
+    FileFoundCallback onFileFound,
+    ProgressCallback onProgress,
+    bool& shouldStop,
+    ClaimSyncCallback syncClaims)
+{
+    bool anySuccess = false;
 
-ScanConfiguration ScanConfiguration::Load() {
-    return ScanConfiguration();
-}
+    // Create VolumeReader for carving
+    VolumeReader reader(disk, geom);
+    
+    // Configure carving options
+    CarvingOptions carvingOpts;
+    carvingOpts.maxFiles = m_config.carvingMaxFiles;
+    carvingOpts.clusterLimit = m_config.carvingClusterLimit;
+    carvingOpts.workerThreads = m_config.parallelThreads;
+    carvingOpts.dedupMode = DedupMode::FastDedup;
+    carvingOpts.signatures = FileSignatures::GetAllSignatures();
+    carvingOpts.startLCN = 0;
+    carvingOpts.claimedClusters = &m_claimedClusters;
+    carvingOpts.allocatedClusters = allocatedClusters;
+    carvingOpts.unbufferedIO = m_config.unbufferedStreaming;
+    carvingOpts.scanStride = m_config.carvingScanStride;
+    carvingOpts.syncClaims = std::move(syncClaims);
+    carvingOpts.retainFiles = m_config.carvingRetainFiles;
+    carvingOpts.prescreenClusters = m_config.carvingPrescreen;
+    carvingOpts.gapCarving = m_config.carvingGapSearch;
+    
+    carvingOpts.checkpointInterval = std::chrono::seconds(Constants::Checkpoint::INTERVAL_SECONDS);
 
-bool ScanConfiguration::Save() const {
-    return true;
-}
+    auto carvingCallback = [&](const CarvedFile& carved) {
+        // Convert CarvedFile → RecoveryCandidate
+        RecoveryCandidate candidate;
 
-// ============================================================================
-// DiskForensicsCore Implementation
-// ============================================================================
+        candidate.name = std::to_wstring(++m_carvedFileCounter) + L"." +
+                     std::wstring(carved.signature.extension,
+                                carved.signature.extension + strlen(carved.signature.extension));
+        candidate.path = L"<carved from free space>";
+        candidate.fileSize = carved.fileSize;
+        candidate.sizeFormatted = StringUtils::FormatFileSize(carved.fileSize);
+        candidate.source = RecoverySource::Carving;
+        candidate.quality = RecoveryQuality::Full;
+        candidate.file = FragmentedFile(0, geom.bytesPerCluster);
+        candidate.file.SetFragmentMap(carved.fragments);
 
-DiskForensicsCore::DiskForensicsCore()
-    : m_config(ScanConfiguration::Load())
-{
-    m_ntfsScanner = std::make_unique<NTFSScanner>();
-    m_exfatScanner = std::make_unique<ExFATScanner>();
-    m_fat32Scanner = std::make_unique<FAT32Scanner>();
-    m_fileCarver = std::make_unique<FileCarver>();
-    m_usnJournalScanner = std::make_unique<UsnJournalScanner>();
-}
+        // Sub-cluster hits use sector-unit runs, which the cluster-keyed dedup cannot compare
+        if (carved.startOffset != 0 || !ShouldSkipDuplicate(candidate)) {
+            onFileFound(candidate);
+        }
+    };
 
-DiskForensicsCore::~DiskForensicsCore() = default;
+    // The carver only sees its own stop flag; progress ticks relay the caller's
+    std::atomic<bool> stopAtomic(shouldStop);
+    auto carvingProgress = [&](const std::wstring& msg, float progress) {
+        if (shouldStop) {
+            stopAtomic = true;
+        }
+        onProgress(msg, progress);
+    };
 
-bool DiskForensicsCore::ShouldSkipDuplicate(const RecoveryCandidate& candidate) {
-    DedupKey key;
-    key.mftRecord = candidate.mftRecord.value_or(0);
-    key.startCluster = candidate.file.GetFragments().IsEmpty() ? 0 :
-                       candidate.file.GetFragments().GetRuns()[0].startCluster;
+    // An interrupted pass over this volume picks up where it stopped
+    std::vector<CarvedFile> restoredFiles;
+    if (!m_checkpointPath.empty()) {
+        auto checkpoint = CarvingCheckpoint::Load(m_checkpointPath, carvingOpts.signatures);
+        if (checkpoint && checkpoint->Matches(boot.volumeSerialNumber, geom)) {
+            checkpoint->RestoreClaims(m_claimedClusters);
+            carvingOpts.startLCN = checkpoint->resumeLCN;
+            restoredFiles = std::move(checkpoint->files);
 
-    if (m_seenCandidates.find(key) != m_seenCandidates.end()) {
-        return true;  // Duplicate
+            wchar_t resumeMsg[256];
+            swprintf_s(resumeMsg, L"Stage 3: Resuming carving at cluster %llu (%zu files restored)",
+                       carvingOpts.startLCN, restoredFiles.size());
+            onProgress(resumeMsg, 0.0f);
+
+            for (const auto& carved : restoredFiles) {
+                carvingCallback(carved);
+            }
+        }
     }
 
-    m_seenCandidates.insert(key);
-    return false;
-}
+    // The scan index records how far carving got even without a checkpoint file
+    m_carvingResumeLCN = carvingOpts.startLCN;
+    carvingOpts.onCheckpoint = [&](uint64_t resumeLCN, const ClusterBitmap& claimed,
+                                   const std::vector<CarvedFile>& files) {
+        m_carvingResumeLCN = resumeLCN;
+        if (m_checkpointPath.empty()) {
+            return;
+        }
 
-FilesystemType DiskForensicsCore::DetectFilesystem(wchar_t driveLetter) {
-    std::wstring rootPath;
-    rootPath += driveLetter;
-    rootPath += L":\\";
-    wchar_t fsName[MAX_PATH + 1] = {};
+        CarvingCheckpoint checkpoint;
+        checkpoint.volumeSerial = boot.volumeSerialNumber;
+        checkpoint.totalClusters = geom.totalClusters;
+        checkpoint.bytesPerCluster = geom.bytesPerCluster;
+        checkpoint.resumeLCN = resumeLCN;
+        checkpoint.CaptureClaims(claimed);
+        checkpoint.files = restoredFiles;
+        checkpoint.files.insert(checkpoint.files.end(), files.begin(), files.end());
+        checkpoint.Save(m_checkpointPath);
+    };
+    
+    try {
+        auto result = m_fileCarver->CarveVolume(
+            reader, 
+            carvingOpts, 
+            carvingCallback, 
+            carvingProgress, 
+            stopAtomic
+        );
+        
+        anySuccess = result.filesFound > 0 || !restoredFiles.empty();
+        m_carvingStats = std::make_unique<CarvingStatistics>(std::move(result.stats));
 
-    if (GetVolumeInformationW(rootPath.c_str(), nullptr, 0, nullptr, nullptr, nullptr,
-                             fsName, MAX_PATH)) {
-        std::wstring fs(fsName);
-        if (fs == L"NTFS") return FilesystemType::NTFS;
-        if (fs == L"exFAT") return FilesystemType::ExFAT;
-        if (fs == L"FAT32") return FilesystemType::FAT32;
+        // A finished pass has nothing left to resume
+        if (!stopAtomic && !m_checkpointPath.empty()) {
+            CarvingCheckpoint::Remove(m_checkpointPath);
+        }
+        if (!stopAtomic && result.filesFound < carvingOpts.maxFiles) {
+            m_carvingResumeLCN = carvingOpts.clusterLimit > 0
+                ? std::min<uint64_t>(carvingOpts.clusterLimit, geom.totalClusters)
+                : geom.totalClusters;
+        }
+        
+    } catch (const std::exception& e) {
+        wchar_t msg[256];
+        swprintf_s(msg, L"Carving error: %hs", e.what());
+        onProgress(msg, 0.99f);
     }
 
-    return FilesystemType::Unknown;
+    return anySuccess;
 }
 
-bool DiskForensicsCore::StartScan(
-    wchar_t driveLetter,
+std::unique_ptr<ScanIndex> DiskForensicsCore::PrepareScanIndex(
+    DiskHandle& disk,
+    const NTFSBootSector& boot,
+    const VolumeGeometry& geom,
     const std::wstring& folderFilter,
     const std::wstring& filenameFilter,
-    FileFoundCallback onFileFound,
-    ProgressCallback onProgress,
-    bool& shouldStop,
     bool enableMft,
     bool enableUsn,
-    bool enableCarving)
+    bool enableCarving,
+    ScanIndexState& state,
+    std::vector<uint64_t>& changedRecords)
 {
-    FilesystemType fsType = DetectFilesystem(driveLetter);
-    
-    DiskHandle disk(driveLetter);
-    if (!disk.Open()) {
-        onProgress(L"Failed to open disk drive", 0.0f);
-        return false;
+    m_indexBuilder.reset();
+    if (m_indexPath.empty()) {
+        return nullptr;
     }
 
-    bool success = false;
+    // Without a journal an index could never be brought up to date. Its
+    // position is taken before any stage runs, so changes made during this
+    // scan are picked up by the next one.
+    auto journal = m_usnJournalScanner->ReadJournalState(disk);
+    if (!journal) {
+        return nullptr;
+    }
 
-    switch (fsType) {
-    case FilesystemType::NTFS:
-        success = StartNTFSMultiStageScan(disk, folderFilter, filenameFilter, 
-                                         onFileFound, onProgress, shouldStop,
-                                         enableMft, enableUsn, enableCarving);
-        break;
+    SettingsHash hash;
+    hash.Add(folderFilter);
+    hash.Add(filenameFilter);
+    hash.Add(enableMft);
+    hash.Add(enableUsn);
+    hash.Add(enableCarving);
+    hash.Add(m_config.ntfsMftMaxRecords);
+    hash.Add(m_config.ntfsMftSystemDriveLimit);
+    hash.Add(m_config.ntfsMftSpareDriveLimit);
+    hash.Add(m_config.usnJournalMaxRecords);
+    hash.Add(m_config.carvingMaxFiles);
+    hash.Add(m_config.carvingClusterLimit);
+    hash.Add(m_config.carvingUnallocatedOnly);
+    hash.Add(m_config.carvingScanStride);
+    hash.Add(m_config.carvingPrescreen);
+    hash.Add(m_config.carvingGapSearch);
 
-    case FilesystemType::ExFAT:
-        onProgress(L"Scanning exFAT filesystem...", 0.0f);
-        m_seenCandidates.clear();
-        {
-            auto dedupCallback = [&](const RecoveryCandidate& candidate) {
-                if (!ShouldSkipDuplicate(candidate)) {
-                    onFileFound(candidate);
-                }
-            };
-            success = m_exfatScanner->ScanVolume(disk, folderFilter, filenameFilter,
-                                                dedupCallback, onProgress, shouldStop, m_config);
-        }
-        break;
+    state.volumeSerial = boot.volumeSerialNumber;
+    state.totalClusters = geom.totalClusters;
+    state.bytesPerCluster = geom.bytesPerCluster;
+    state.settingsHash = hash.Value();
+    state.usnJournalId = journal->journalId;
+    state.usnNext = journal->nextUsn;
+    m_indexBuilder = std::make_unique<ScanIndexBuilder>();
 
-    case FilesystemType::FAT32:
-        onProgress(L"Scanning FAT32 filesystem...", 0.0f);
-        m_seenCandidates.clear();
-        {
-            auto dedupCallback = [&](const RecoveryCandidate& candidate) {
-                if (!ShouldSkipDuplicate(candidate)) {
-                    onFileFound(candidate);
-                }
-            };
-            success = m_fat32Scanner->ScanVolume(disk, folderFilter, filenameFilter,
-                                                dedupCallback, onProgress, shouldStop, m_config);
-        }
-        break;
+    if (!m_config.incrementalRescan) {
+        return nullptr;
+    }
 
-    default:
-        onProgress(L"Unsupported filesystem type", 0.0f);
-        break;
+    auto index = ScanIndex::Open(m_indexPath);
+    if (!index) {
+        return nullptr;
     }
 
-    return success;
+    // Same volume and settings, and nothing since the save purged or lost
+    // to a recreated journal
+    const ScanIndexState& saved = index->State();
+    if (saved.volumeSerial != state.volumeSerial ||
+        saved.totalClusters != state.totalClusters ||
+        saved.bytesPerCluster != state.bytesPerCluster ||
+        saved.settingsHash != state.settingsHash ||
+        saved.usnJournalId != journal->journalId ||
+        saved.usnNext < journal->lowestValidUsn ||
+        saved.usnNext > journal->nextUsn) {
+        return nullptr;
+    }
+
+    // A delta cut off by the record limit would miss changes; scan in full
+    changedRecords.clear();
+    uint64_t visited = m_usnJournalScanner->ScanJournal(disk, m_config.usnJournalMaxRecords,
+        [&](const UsnRecordView& view) {
+            if (view.usn >= saved.usnNext) {
+                changedRecords.push_back(view.MftRecordNumber());
+            }
+            return true;
+        },
+        m_config.unbufferedStreaming ? DiskHandle::ReadMode::Unbuffered : DiskHandle::ReadMode::Cached,
+        saved.usnNext);
+    if (visited >= m_config.usnJournalMaxRecords) {
+        return nullptr;
+    }
+
+    std::sort(changedRecords.begin(), changedRecords.end());
+    changedRecords.erase(std::unique(changedRecords.begin(), changedRecords.end()), changedRecords.end());
+    return index;
 }
 
-bool DiskForensicsCore::StartNTFSMultiStageScan(
+bool DiskForensicsCore::RunIncrementalScan(
     DiskHandle& disk,
+    const NTFSBootSector& boot,
+    const VolumeGeometry& geom,
+    const ScanIndex& index,
+    std::vector<uint64_t> changedRecords,
     const std::wstring& folderFilter,
     const std::wstring& filenameFilter,
     FileFoundCallback onFileFound,
@@ -398,150 +1674,205 @@ bool DiskForensicsCore::StartNTFSMultiStageScan(
     bool& shouldStop,
     bool enableMft,
     bool enableUsn,
-    bool enableCarving)
+    bool enableCarving,
+    ClusterBitmap& allocatedClusters,
+    const ClusterBitmap*& allocated)
 {
-    bool anySuccess = false;
+    const ScanIndexState& saved = index.State();
 
-    m_processedMftRecords.clear();
-    m_seenCandidates.clear();
+    wchar_t msg[256];
+    swprintf_s(msg, L"Index: %zu saved results, %zu records changed since the last scan",
+               index.ResultCount(), changedRecords.size());
+    onProgress(msg, 0.0f);
 
-    // Build volume geometry for NTFS
-    auto boot = m_ntfsScanner->ReadBootSector(disk);
-    
-    VolumeGeometry geom;
-    geom.sectorSize = boot.bytesPerSector;
-    geom.bytesPerCluster = boot.bytesPerSector * boot.sectorsPerCluster;
-    geom.totalClusters = disk.GetDiskSize() / geom.bytesPerCluster;
-    geom.volumeStartOffset = 0;  // Raw volume handle starts at partition offset 0
-    geom.fsType = FilesystemType::NTFS;
+    // Carved data under clusters allocated since then is gone
+    if (enableCarving) {
+        allocated = LoadCarvingAllocation(disk, boot, geom, allocatedClusters, onProgress);
+    }
 
     // ========================================================================
-    // Stage 1: MFT (Master File Table) Scan - Ultra Fast
+    // Replay: saved results whose record and clusters are unchanged
     // ========================================================================
-    
-    if (enableMft) {
-        onProgress(L"Stage 1: Scanning MFT for deleted files...", 0.0f);
+
+    // Claims are rebuilt from what is replayed, so clusters of dropped
+    // results are carved again
+    m_ntfsScanner->Directories().Import(index.Directories(), index.DirectoryNames());
+
+    uint64_t replayed = 0;
+    uint64_t dropped = 0;
+    for (size_t i = 0; i < index.ResultCount(); i++) {
+        RecoveryCandidate candidate;
+        if (!index.GetResult(i, candidate)) {
+            dropped++;
+            continue;
+        }
+
+        // Changed records are parsed again below. Without an allocation map
+        // nothing shows whether a carved file was overwritten since, so
+        // Stage 3 carves its clusters again instead.
+        const FragmentMap& fragments = candidate.file.GetFragments();
+        bool carved = candidate.source == RecoverySource::Carving;
+        bool stale = (carved && !allocated) ||
+                     (candidate.mftRecord &&
+                      std::binary_search(changedRecords.begin(), changedRecords.end(), *candidate.mftRecord));
+
+        // Sub-cluster hits use sector-unit runs
+        std::vector<ClusterRange> carvedClusters;
+        if (!stale && carved) {
+            uint64_t unit = fragments.BytesPerCluster();
+            for (const auto& run : fragments.GetRuns()) {
+                uint64_t first = run.startCluster * unit / geom.bytesPerCluster;
+                uint64_t end = (run.EndCluster() * unit + geom.bytesPerCluster - 1) / geom.bytesPerCluster;
+                if (allocated->AnySet(first, end - first)) {
+                    stale = true;
+                    break;
+                }
+                carvedClusters.push_back({ first, end - first });
+            }
+        }
+        if (stale) {
+            dropped++;
+            continue;
+        }
+
+        if (candidate.mftRecord) m_candidateIndex.MarkRecord(*candidate.mftRecord);
+        if (candidate.fileRecord) m_candidateIndex.MarkRecord(*candidate.fileRecord);
+        if (!fragments.IsEmpty() && fragments.BytesPerCluster() == geom.bytesPerCluster) {
+            m_candidateIndex.InsertCandidate(candidate.mftRecord.value_or(0), fragments.GetRuns()[0].startCluster);
+        }
+
+        if (carved) {
+            for (const ClusterRange& range : carvedClusters) {
+                m_claimedClusters.SetRange(range.start, range.count);
+            }
+        } else {
+            ClaimClusters(candidate);
+        }
+
+        onFileFound(candidate);
+        replayed++;
+    }
+
+    swprintf_s(msg, L"Index: %llu results replayed, %llu dropped as changed", replayed, dropped);
+    onProgress(msg, 0.1f);
+
+    bool anySuccess = replayed > 0;
+
+    // ========================================================================
+    // Stage 1: Changed MFT records only
+    // ========================================================================
+
+    if (enableMft && !changedRecords.empty()) {
+        onProgress(L"Stage 1: Re-reading changed MFT records...", 0.1f);
 
         auto mftCallback = [&](const RecoveryCandidate& candidate) {
             if (candidate.mftRecord) {
-                m_processedMftRecords.insert(*candidate.mftRecord);
+                m_candidateIndex.MarkRecord(*candidate.mftRecord);
             }
             if (!ShouldSkipDuplicate(candidate)) {
+                ClaimClusters(candidate);
                 onFileFound(candidate);
             }
         };
 
-        bool stage1Success = m_ntfsScanner->ScanVolume(disk, folderFilter, filenameFilter,
-                                                      mftCallback, onProgress, shouldStop, m_config);
+        bool stage1Success = m_ntfsScanner->ScanRecords(disk, std::move(changedRecords), folderFilter,
+                                                        filenameFilter, mftCallback, onProgress, shouldStop);
         anySuccess = anySuccess || stage1Success;
 
         if (shouldStop) {
-            onProgress(L"Scan stopped by user", 1.0f);
             return anySuccess;
         }
     }
-    
+
     // ========================================================================
-    // Stage 2: USN Journal Analysis - Medium Speed
+    // Stage 2: Journal entries after the saved USN
     // ========================================================================
-    
+
     if (enableUsn) {
-        float baseProgress = enableMft ? 0.33f : 0.0f;
-        onProgress(L"Stage 2: Analyzing USN Journal...", baseProgress);
+        onProgress(L"Stage 2: Analyzing new USN Journal entries...", 0.33f);
 
         auto usnCallback = [&](const RecoveryCandidate& candidate) {
             if (!ShouldSkipDuplicate(candidate)) {
+                ClaimClusters(candidate);
                 onFileFound(candidate);
             }
         };
 
-        bool stage2Success = ProcessUsnJournal(disk, usnCallback, onProgress, shouldStop);
+        bool stage2Success = ProcessUsnJournal(disk, usnCallback, onProgress, shouldStop, saved.usnNext);
         anySuccess = anySuccess || stage2Success;
+    }
 
-        if (shouldStop) {
-            onProgress(L"Scan stopped by user", 1.0f);
-            return anySuccess;
-        }
+    m_metadataComplete = !shouldStop;
+    if (shouldStop || !enableCarving) {
+        return anySuccess;
     }
-    
+
     // ========================================================================
-    // Stage 3: File Carving - Slow but Thorough
+    // Stage 3: Clusters no earlier pass carved while free
     // ========================================================================
-    
-    if (enableCarving) {
-        float baseProgress = 0.0f;
-        if (enableMft && enableUsn) baseProgress = 0.66f;
-        else if (enableMft || enableUsn) baseProgress = 0.5f;
-        
-        onProgress(L"Stage 3: Carving files from free space...", baseProgress);
-        
-        // Create VolumeReader for carving
-        VolumeReader reader(disk, geom);
-        
-        // Configure carving options
-        CarvingOptions carvingOpts;
-        carvingOpts.maxFiles = m_config.carvingMaxFiles;
-        carvingOpts.clusterLimit = m_config.carvingClusterLimit;
-        carvingOpts.dedupMode = DedupMode::FastDedup;
-        carvingOpts.signatures = FileSignatures::GetAllSignatures();
-        carvingOpts.startLCN = 0;
-        
-        // File counter for naming
-        static uint64_t carvedFileCounter = 0;
-        
-        auto carvingCallback = [&](const CarvedFile& carved) {
-            // Convert CarvedFile → RecoveryCandidate
-            RecoveryCandidate candidate;
-
-            candidate.name = std::to_wstring(++carvedFileCounter) + L"." +
-                         std::wstring(carved.signature.extension,
-                                    carved.signature.extension + strlen(carved.signature.extension));
-            candidate.path = L"<carved from free space>";
-            candidate.fileSize = carved.fileSize;
-            candidate.sizeFormatted = StringUtils::FormatFileSize(carved.fileSize);
-            candidate.source = RecoverySource::Carving;
-            candidate.quality = RecoveryQuality::Full;
-            candidate.file = FragmentedFile(0, geom.bytesPerCluster);
-            candidate.file.SetFragmentMap(carved.fragments);
 
-            if (!ShouldSkipDuplicate(candidate)) {
-                onFileFound(candidate);
-            }
-        };
-        
-        auto carvingProgress = [&](const std::wstring& msg, float progress) {
-            float adjustedProgress = baseProgress + (progress * (1.0f - baseProgress));
-            onProgress(msg, adjustedProgress);
-        };
-        
-        try {
-            std::atomic<bool> stopAtomic(shouldStop);
-            auto result = m_fileCarver->CarveVolume(
-                reader, 
-                carvingOpts, 
-                carvingCallback, 
-                carvingProgress, 
-                stopAtomic
-            );
-            
-            anySuccess = anySuccess || !result.files.empty();
-            
-        } catch (const std::exception& e) {
-            wchar_t msg[256];
-            swprintf_s(msg, L"Carving error: %hs", e.what());
-            onProgress(msg, 0.99f);
-        }
+    // Only a free-space carve knows which clusters are unchanged since
+    onProgress(allocated ? L"Stage 3: Carving clusters freed since the last scan..."
+                         : L"Stage 3: Carving every cluster again...", 0.66f);
+
+    auto carvingProgress = [&](const std::wstring& msg, float progress) {
+        onProgress(msg, 0.66f + progress * 0.34f);
+    };
+
+    // Skip what is allocated now or was carved before; without a saved
+    // coverage map every free cluster is carved again
+    ClusterBitmap skipClusters;
+    const ClusterBitmap* skip = allocated;
+    if (allocated && index.LoadUncarved(skipClusters)) {
+        skipClusters.Invert();
+        skipClusters.Merge(*allocated);
+        skip = &skipClusters;
     }
-    
-    onProgress(L"Scan complete!", 1.0f);
-    return anySuccess;
+
+    // The index already holds what an interrupted pass had carved, and a
+    // checkpoint of this partial pass would misguide a later full scan
+    if (!m_checkpointPath.empty()) {
+        CarvingCheckpoint::Remove(m_checkpointPath);
+        m_checkpointPath.clear();
+    }
+
+    bool stage3Success = RunCarvingStage(disk, boot, geom, skip, onFileFound,
+                                         carvingProgress, shouldStop, nullptr);
+    return anySuccess || stage3Success;
+}
+
+void DiskForensicsCore::SaveScanIndex(
+    ScanIndexState state,
+    const VolumeGeometry& geom,
+    const ClusterBitmap* allocated,
+    bool enableCarving)
+{
+    // Records a cut-short metadata pass never reached would stay missing
+    // from every update built on this index
+    std::unique_ptr<ScanIndexBuilder> builder = std::move(m_indexBuilder);
+    if (!builder || !m_metadataComplete) {
+        return;
+    }
+
+    // Free clusters below the resume point were carved; the rest, and
+    // everything allocated now, waits for a pass that finds it free
+    std::unique_ptr<ClusterBitmap> uncarved;
+    if (enableCarving && allocated) {
+        uint64_t resumeLCN = std::min(m_carvingResumeLCN, geom.totalClusters);
+        uncarved = std::make_unique<ClusterBitmap>(*allocated);
+        uncarved->SetRange(resumeLCN, geom.totalClusters - resumeLCN);
+    }
+
+    state.carvingResumeLCN = m_carvingResumeLCN;
+    builder->Save(m_indexPath, state, m_ntfsScanner->Directories(), m_claimedClusters, uncarved.get());
 }
 
 bool DiskForensicsCore::ProcessUsnJournal(
     DiskHandle& disk,
     FileFoundCallback onFileFound,
     ProgressCallback onProgress,
-    bool& shouldStop)
+    bool& shouldStop,
+    int64_t fromUsn)
 {
     try {
         auto boot = m_ntfsScanner->ReadBootSector(disk);
@@ -551,7 +1882,18 @@ bool DiskForensicsCore::ProcessUsnJournal(
             return false;
         }
 
-        auto recordsByMft = m_usnJournalScanner->ParseJournal(disk, m_config.usnJournalMaxRecords);
+        // Only file deletions are acted on; everything else is dropped as a view
+        std::map<uint64_t, std::vector<UsnRecord>> recordsByMft;
+        m_usnJournalScanner->ScanJournal(disk, m_config.usnJournalMaxRecords,
+            [&](const UsnRecordView& view) {
+                if (view.usn >= fromUsn && view.IsDeletion() && !view.IsDirectory()) {
+                    recordsByMft[view.MftRecordNumber()].push_back(view.ToRecord());
+                }
+                return !shouldStop;
+            },
+            m_config.unbufferedStreaming ? DiskHandle::ReadMode::Unbuffered : DiskHandle::ReadMode::Cached,
+            fromUsn);
+        if (shouldStop) return false;
         
         uint64_t totalRecords = 0;
         for (const auto& pair : recordsByMft) {
@@ -567,36 +1909,46 @@ bool DiskForensicsCore::ProcessUsnJournal(
         uint64_t filesRecovered = 0;
         uint64_t filesOverwritten = 0;
         
+        // Records Stage 1 already reported need no lookup at all
+        std::vector<uint64_t> lookups;
+        lookups.reserve(recordsByMft.size());
         for (const auto& pair : recordsByMft) {
-            if (shouldStop) return false;
-            
-            for (const auto& record : pair.second) {
+            if (m_candidateIndex.HasRecord(pair.first)) {
+                processed += pair.second.size();
+            } else {
+                lookups.push_back(pair.first);
+            }
+        }
+        
+        // One sorted, coalesced pass over the MFT; records Stage 1 already
+        // parsed are served from memory
+        bool completed = m_ntfsScanner->ReadMFTRecords(disk, boot, std::move(lookups),
+            [&](uint64_t lookupIndex, std::span<const uint8_t> mftData) {
+            for (const auto& record : recordsByMft[lookupIndex]) {
                 if (shouldStop) return false;
-                
+            
                 if (record.IsDeletion() && !record.IsDirectory()) {
-                    
+                
                     uint64_t mftIndex = record.MftIndex();
-                    
-                    if (m_processedMftRecords.find(mftIndex) != m_processedMftRecords.end()) {
+                
+                    if (m_candidateIndex.HasRecord(mftIndex)) {
                         processed++;
                         continue;
                     }
-                    
+                
                     DeletedFileEntry usnFile;
                     usnFile.filesystemType = L"NTFS";
                     usnFile.hasDeletedTime = true;
                     usnFile.deletedTime = record.timestamp;
                     usnFile.name = record.filename;
-                    
+                
                     uint16_t usnSequenceNumber = record.SequenceNumber();
-                    
-                    auto mftData = m_ntfsScanner->ReadMFTRecord(disk, boot, mftIndex);
-                    
+                
                     bool mftMatch = false;
-                    
+                
                     if (mftData.size() >= sizeof(MFTFileRecord)) {
                         const MFTFileRecord* mftRec = reinterpret_cast<const MFTFileRecord*>(mftData.data());
-                        
+                    
                         if (std::memcmp(mftRec->signature, "FILE", 4) == 0) {
                             if (mftRec->sequenceNumber == usnSequenceNumber) {
                                 bool parseSuccess = m_ntfsScanner->ParseMFTRecord(
@@ -608,31 +1960,31 @@ bool DiskForensicsCore::ProcessUsnJournal(
                                     L"", 
                                     L""
                                 );
-                                
+                            
                                 if (parseSuccess) {
                                     mftMatch = true;
                                     filesRecovered++;
-                                    m_processedMftRecords.insert(mftIndex);
+                                    m_candidateIndex.MarkRecord(mftIndex);
                                 }
                             }
                         }
                     }
-                    
+                
                     if (!mftMatch) {
                         usnFile.path = L"<USN: MFT Overwritten>";
                         usnFile.fileRecord = mftIndex;
                         usnFile.size = 0;
                         usnFile.sizeFormatted = L"Metadata Only";
                         usnFile.isRecoverable = false;
-                        
+                    
                         onFileFound(usnFile);
                         filesOverwritten++;
-                        m_processedMftRecords.insert(mftIndex);
+                        m_candidateIndex.MarkRecord(mftIndex);
                     }
                 }
-                
+            
                 processed++;
-                
+            
                 if ((processed % Constants::Progress::USN_JOURNAL_INTERVAL) == 0) {
                     float progress = 0.33f + (0.33f * (static_cast<float>(processed) / totalRecords));
                     wchar_t statusMsg[256];
@@ -641,7 +1993,9 @@ bool DiskForensicsCore::ProcessUsnJournal(
                     onProgress(statusMsg, progress);
                 }
             }
-        }
+            return true;
+        });
+        if (!completed) return false;
         
         wchar_t completeMsg[256];
         swprintf_s(completeMsg, L"USN Journal complete: %llu recovered, %llu metadata only", 
@@ -16,14 +16,16 @@
 #include "DiskHandle.h"
 #include "ScanConfiguration.h" // Centralized scan configuration
 #include "RecoveryCandidate.h" // Unified data model
+#include "ClusterBitmap.h"
+#include "CandidateIndex.h"
 #include <string>
 #include <vector>
 #include <memory>
 #include <cstdint>
 #include <functional>
 #include <chrono>
-#include <set>
-#include <unordered_set>
+#include <mutex>
+#include <atomic>
 
 namespace KVC {
 
@@ -35,10 +37,26 @@ class ExFATScanner;
 class FAT32Scanner;
 class FileCarver;
 class UsnJournalScanner;
+class ScanIndex;
+class ScanIndexBuilder;
+class BandwidthLimiter;
+struct ScanIndexState;
 struct RecoveryCandidate;
+struct CarvingStatistics;
+struct NTFSBootSector;
 
 // ScanConfiguration is now defined in ScanConfiguration.h
 
+// Outcome of one volume in a multi-volume scan
+struct VolumeScanSummary {
+    wchar_t driveLetter = L'\0';
+    uint32_t physicalDisk = UINT32_MAX;     // UINT32_MAX if unknown
+    FilesystemType fsType = FilesystemType::Unknown;
+    bool success = false;
+    uint64_t filesFound = 0;
+    double seconds = 0.0;
+};
+
 // ============================================================================
 // DiskForensicsCore - Main orchestrator
 // ============================================================================
@@ -50,8 +68,13 @@ public:
 
     using ProgressCallback = std::function<void(const std::wstring&, float)>;
     using FileFoundCallback = std::function<void(const RecoveryCandidate&)>;
+    using VolumeProgressCallback = std::function<void(wchar_t, const std::wstring&, float)>;
+    using VolumeFileFoundCallback = std::function<void(wchar_t, const RecoveryCandidate&)>;
 
     FilesystemType DetectFilesystem(wchar_t driveLetter);
+
+    // From the boot sector, for sources Windows has not mounted
+    FilesystemType DetectFilesystem(DiskHandle& disk);
     
     bool StartScan(
         wchar_t driveLetter,
@@ -65,7 +88,101 @@ public:
         bool enableCarving
     );
 
+    // Same stages over a raw image file or \\.\PhysicalDriveN, with the
+    // volume starting partitionOffset bytes in
+    bool StartImageScan(
+        const std::wstring& imagePath,
+        uint64_t partitionOffset,
+        const std::wstring& folderFilter,
+        const std::wstring& filenameFilter,
+        FileFoundCallback onFileFound,
+        ProgressCallback onProgress,
+        bool& shouldStop,
+        bool enableMft,
+        bool enableUsn,
+        bool enableCarving
+    );
+
+    // Scan several drive letters at once. Volumes on the same physical disk
+    // run one after another so their heads never compete; separate disks
+    // run side by side, splitting the thread budget between them. Every
+    // read draws on one bandwidth budget. Callbacks are serialized and
+    // name their volume; results come back in driveLetters order.
+    std::vector<VolumeScanSummary> StartMultiVolumeScan(
+        const std::vector<wchar_t>& driveLetters,
+        const std::wstring& folderFilter,
+        const std::wstring& filenameFilter,
+        VolumeFileFoundCallback onFileFound,
+        VolumeProgressCallback onProgress,
+        bool& shouldStop,
+        bool enableMft,
+        bool enableUsn,
+        bool enableCarving
+    );
+
+    // Fixed drive letters holding a filesystem this engine can scan
+    std::vector<wchar_t> ListScannableVolumes();
+
+    // Cap every read of later scans at bytesPerSecond (0 = unlimited)
+    void SetBandwidthLimit(uint64_t bytesPerSecond);
+
+    // Worker threads a multi-volume scan spreads over its volumes (0 = one
+    // per hardware thread)
+    void SetThreadBudget(size_t threads) { m_config.totalThreadBudget = threads; }
+
+    // Folder for carving checkpoints and scan indexes (empty = none). Must
+    // not be on the scanned volume; a checkpoint found there resumes the
+    // carving stage and an NTFS index turns the next scan into an update.
+    void SetCheckpointFolder(const std::wstring& folder) { m_checkpointFolder = folder; }
+
+    // Run the NTFS metadata stages alongside carving instead of before it
+    void SetOverlapStages(bool enabled) { m_config.overlapStages = enabled; }
+
+    // Stop the carver collecting its own copy of every carved file. Callers
+    // that stream results keep memory flat; carving checkpoints are then
+    // not written, so an interrupted carve starts over.
+    void SetRetainCarvedFiles(bool retain) { m_config.carvingRetainFiles = retain; }
+
+    // Classify clusters before probing them (on by default)
+    void SetCarvingPrescreen(bool enabled) { m_config.carvingPrescreen = enabled; }
+
+    // NTFS: carve only clusters $Bitmap reports free (off by default)
+    void SetCarvingUnallocatedOnly(bool enabled) { m_config.carvingUnallocatedOnly = enabled; }
+
+    // Second carving pass for broken JPEG/ZIP files (on by default)
+    void SetCarvingGapSearch(bool enabled) { m_config.carvingGapSearch = enabled; }
+
+    // Read full-volume passes (MFT, carving) around the file cache (off by
+    // default); keeps a large scan from evicting everything else
+    void SetUnbufferedStreaming(bool enabled) { m_config.unbufferedStreaming = enabled; }
+
+    // Replay a saved NTFS index and rescan only what the journal reports
+    // changed since (off by default); a full scan still saves a fresh index
+    // when a checkpoint folder is set
+    void SetIncrementalRescan(bool enabled) { m_config.incrementalRescan = enabled; }
+
+    // Statistics of the last carving pass (all zero if none ran)
+    CarvingStatistics LastCarvingStatistics() const;
+
 private:
+    using ClaimSyncCallback = std::function<void(ClusterBitmap& claimed)>;
+
+    // Shared body of StartScan and StartImageScan; sourceTag names the
+    // checkpoint file
+    bool ScanSource(
+        DiskHandle& disk,
+        FilesystemType fsType,
+        const std::wstring& sourceTag,
+        const std::wstring& folderFilter,
+        const std::wstring& filenameFilter,
+        FileFoundCallback onFileFound,
+        ProgressCallback onProgress,
+        bool& shouldStop,
+        bool enableMft,
+        bool enableUsn,
+        bool enableCarving
+    );
+
     bool StartNTFSMultiStageScan(
         DiskHandle& disk,
         const std::wstring& folderFilter,
@@ -78,34 +195,133 @@ private:
         bool enableCarving
     );
 
+    // Stages 1 and 2 on a metadata-priority thread while this one carves
+    bool RunOverlappedStages(
+        DiskHandle& disk,
+        const NTFSBootSector& boot,
+        const VolumeGeometry& geom,
+        const ClusterBitmap* allocated,
+        const std::wstring& folderFilter,
+        const std::wstring& filenameFilter,
+        FileFoundCallback onFileFound,
+        ProgressCallback onProgress,
+        bool& shouldStop,
+        bool enableMft,
+        bool enableUsn
+    );
+
+    // Stage 1 (MFT) then Stage 2 (USN)
+    bool RunMetadataStages(
+        DiskHandle& disk,
+        const std::wstring& folderFilter,
+        const std::wstring& filenameFilter,
+        FileFoundCallback onFileFound,
+        ProgressCallback onProgress,
+        bool& shouldStop,
+        bool enableMft,
+        bool enableUsn
+    );
+
+    // Volume allocation map for the carver, or nullptr to carve every cluster
+    const ClusterBitmap* LoadCarvingAllocation(
+        DiskHandle& disk,
+        const NTFSBootSector& boot,
+        const VolumeGeometry& geom,
+        ClusterBitmap& allocatedClusters,
+        const ProgressCallback& onProgress
+    );
+
+    // Stage 3; progress runs 0..1 over the pass
+    bool RunCarvingStage(
+        DiskHandle& disk,
+        const NTFSBootSector& boot,
+        const VolumeGeometry& geom,
+        const ClusterBitmap* allocatedClusters,
+        FileFoundCallback onFileFound,
+        ProgressCallback onProgress,
+        bool& shouldStop,
+        ClaimSyncCallback syncClaims
+    );
+
+    // Records below fromUsn are skipped
     bool ProcessUsnJournal(
         DiskHandle& disk,
         FileFoundCallback onFileFound,
         ProgressCallback onProgress,
-        bool& shouldStop
+        bool& shouldStop,
+        int64_t fromUsn = 0
     );
 
-    // Cross-stage deduplication
-    struct DedupKey {
-        uint64_t mftRecord;
-        uint64_t startCluster;
+    // Stamp this scan's index and start collecting its results; returns the
+    // previous index if the journal still holds every change since it was
+    // saved, with the records those changes touched in changedRecords
+    std::unique_ptr<ScanIndex> PrepareScanIndex(
+        DiskHandle& disk,
+        const NTFSBootSector& boot,
+        const VolumeGeometry& geom,
+        const std::wstring& folderFilter,
+        const std::wstring& filenameFilter,
+        bool enableMft,
+        bool enableUsn,
+        bool enableCarving,
+        ScanIndexState& state,
+        std::vector<uint64_t>& changedRecords
+    );
 
-        bool operator<(const DedupKey& other) const {
-            if (mftRecord != other.mftRecord) return mftRecord < other.mftRecord;
-            return startCluster < other.startCluster;
-        }
-    };
+    // Replay index, then run each enabled stage over what changed since it
+    // was saved; allocated receives the carving allocation map, if any
+    bool RunIncrementalScan(
+        DiskHandle& disk,
+        const NTFSBootSector& boot,
+        const VolumeGeometry& geom,
+        const ScanIndex& index,
+        std::vector<uint64_t> changedRecords,
+        const std::wstring& folderFilter,
+        const std::wstring& filenameFilter,
+        FileFoundCallback onFileFound,
+        ProgressCallback onProgress,
+        bool& shouldStop,
+        bool enableMft,
+        bool enableUsn,
+        bool enableCarving,
+        ClusterBitmap& allocatedClusters,
+        const ClusterBitmap*& allocated
+    );
 
+    // Write the collected results once the metadata stages have completed
+    void SaveScanIndex(
+        ScanIndexState state,
+        const VolumeGeometry& geom,
+        const ClusterBitmap* allocated,
+        bool enableCarving
+    );
+
+    // Cross-stage deduplication
     bool ShouldSkipDuplicate(const RecoveryCandidate& candidate);
 
+    // Mark a recovered file's clusters so carving does not re-find it
+    void ClaimClusters(const RecoveryCandidate& candidate);
+
     std::unique_ptr<NTFSScanner> m_ntfsScanner;
     std::unique_ptr<ExFATScanner> m_exfatScanner;
     std::unique_ptr<FAT32Scanner> m_fat32Scanner;
     std::unique_ptr<FileCarver> m_fileCarver;
     std::unique_ptr<UsnJournalScanner> m_usnJournalScanner;
     ScanConfiguration m_config;
-    std::set<uint64_t> m_processedMftRecords;
-    std::set<DedupKey> m_seenCandidates;
+    CandidateIndex m_candidateIndex;
+    ClusterBitmap m_claimedClusters;
+    std::mutex m_claimMutex;
+    std::vector<ClusterRange> m_pendingClaims;  // Claims a running carver has yet to take
+    bool m_deferClaims = false;
+    std::wstring m_checkpointFolder;
+    std::wstring m_checkpointPath;     // This scan's checkpoint file, if any
+    std::wstring m_indexPath;          // This scan's index file, if any
+    std::unique_ptr<ScanIndexBuilder> m_indexBuilder;  // Results of an indexed scan
+    bool m_metadataComplete = false;   // Stages 1 and 2 ran to their end
+    uint64_t m_carvingResumeLCN = 0;   // Carving covered every cluster below this
+    std::unique_ptr<CarvingStatistics> m_carvingStats;
+    std::atomic<uint64_t> m_carvedFileCounter{ 0 };  // Names carved files, per scan
+    std::shared_ptr<BandwidthLimiter> m_bandwidthLimiter;  // Created from the config on first use
 };
 
 std::wstring FormatFileSize(uint64_t bytes);
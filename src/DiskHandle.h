@@ -1,49 +1,215 @@
 // ============================================================================
 // DiskHandle.h - Low-level disk I/O abstraction
 // ============================================================================
-// Provides raw sector reading and memory-mapped file access.
+// Provides raw sector reading and shared, cached read windows.
+// Synchronous reads are positional; an optional overlapped handle bound to
+// an I/O completion port serves queued reads with several requests in flight.
+// Full-volume passes can bypass the system cache with ReadMode::Unbuffered.
+// Threads inside a PriorityScope get their metadata reads ahead of bulk ones.
+// Besides drive-letter volumes, a handle can read a raw image file or a
+// physical disk, starting at a partition offset. Images are mapped whole
+// when the address space allows, and their regions are served zero-copy.
+// Reads can draw on a BandwidthLimiter shared with other handles.
 // ============================================================================
 
 #pragma once
 
 #include <Windows.h>
+#include "WindowCache.h"
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 namespace KVC {
 
+class BandwidthLimiter;
+
 class DiskHandle {
 public:
+    enum class SourceKind {
+        Volume,         // \\.\X: opened by drive letter
+        ImageFile,      // Raw .dd/.img copy of a volume or a whole disk
+        PhysicalDisk    // \\.\PhysicalDriveN
+    };
+
     explicit DiskHandle(wchar_t driveLetter);
+
+    // Image file or \\.\PhysicalDriveN path; partitionOffset is the byte
+    // offset of the volume inside it (0 for a volume image). Every offset
+    // passed to this handle is relative to the partition start.
+    explicit DiskHandle(const std::wstring& path, uint64_t partitionOffset = 0);
     ~DiskHandle();
 
     bool Open();
     void Close();
     bool IsOpen() const { return m_handle != INVALID_HANDLE_VALUE; }
 
+    SourceKind Kind() const { return m_kind; }
+    uint64_t PartitionOffset() const { return m_partitionOffset; }
+
+    // Physical disk holding a drive letter's volume (the first one for a
+    // spanned volume), or UINT32_MAX if Windows does not report it
+    static uint32_t PhysicalDiskNumber(wchar_t driveLetter);
+
+    // Every later read books its bytes here first; null removes the limit.
+    // Zero-copy regions of a mapped image are not counted.
+    void SetBandwidthLimiter(std::shared_ptr<BandwidthLimiter> limiter) { m_bandwidthLimiter = std::move(limiter); }
+
+    // Image mapped whole: reads are copies out of the mapping and
+    // MapDiskRegion returns pointers into it. The image must not change
+    // while it is scanned.
+    bool IsMemoryMapped() const { return m_mappedData != nullptr; }
+
+    enum class ReadMode {
+        Cached,       // Through the system file cache (random metadata lookups)
+        Unbuffered    // FILE_FLAG_NO_BUFFERING streaming; needs sector-aligned
+                      // offset, size and buffer, else falls back to Cached
+    };
+
+    // Positional read; safe to call from several threads at once
     std::vector<uint8_t> ReadSectors(uint64_t startSector, uint64_t numSectors, uint64_t sectorSize);
+
+    // Same as ReadSectors but into caller memory - no allocation, no zero-fill.
+    // offset and size must be sector multiples. Returns bytes read (short on error/EOF).
+    size_t ReadInto(uint64_t offset, uint8_t* buffer, size_t size, ReadMode mode = ReadMode::Cached);
+
     uint64_t GetSectorSize() const;
     uint64_t GetDiskSize() const;
 
+    // ========================================================================
+    // Overlapped I/O
+    // ========================================================================
+
+    struct AsyncReadResult {
+        uint64_t offset;
+        uint8_t* buffer;
+        size_t requested;
+        DWORD bytesRead;
+        DWORD error;        // ERROR_SUCCESS or Win32 error code
+
+        bool Succeeded() const { return error == ERROR_SUCCESS && bytesRead == requested; }
+    };
+
+    using AsyncReadCompletion = std::function<void(const AsyncReadResult&)>;
+
+    // Lazily opens the overlapped handle and its completion port
+    bool EnableAsyncIO();
+    bool IsAsyncEnabled() const { return m_completionPort != nullptr; }
+
+    // Queue a read; completion runs inside WaitAsyncCompletions. Buffer must
+    // stay valid until then. Returns false if the request was not queued.
+    bool ReadAsync(uint64_t offset, uint8_t* buffer, size_t size, AsyncReadCompletion completion,
+                   ReadMode mode = ReadMode::Cached);
+
+    // Dispatch completions on the calling thread: blocks until at least
+    // minCompletions arrived (or timeout), then drains whatever is ready.
+    // Single-consumer: only one thread may pump completions at a time.
+    size_t WaitAsyncCompletions(size_t minCompletions, DWORD timeoutMs);
+
+    size_t PendingAsyncReads() const { return m_asyncPending.load(); }
+
+    // Read [offset, offset + size) keeping up to queueDepth overlapped
+    // requests in flight. Falls back to ReadInto when async is unavailable.
+    // Returns bytes read contiguously from offset.
+    size_t ReadQueued(uint64_t offset, uint8_t* buffer, size_t size, size_t queueDepth,
+                      ReadMode mode = ReadMode::Cached);
+
+    // ========================================================================
+    // Read Priority
+    // ========================================================================
+
+    // Marks the calling thread's reads on this handle as metadata. While any
+    // scope is open, ReadQueued goes out in BACKGROUND_READ_CHUNK pieces and
+    // holds each one back until no metadata read is in flight.
+    class PriorityScope {
+    public:
+        explicit PriorityScope(DiskHandle& disk);
+        ~PriorityScope();
+
+        PriorityScope(const PriorityScope&) = delete;
+        PriorityScope& operator=(const PriorityScope&) = delete;
+
+    private:
+        DiskHandle& m_disk;
+        const DiskHandle* m_previous;
+    };
+
+    // ========================================================================
+    // Windowed Access
+    // ========================================================================
+
     struct MappedRegion {
         const uint8_t* data;
         uint64_t size;
         uint64_t diskOffset;
-        
+        WindowCache::Pin window;    // Keeps data alive until UnmapRegion
+
         MappedRegion() : data(nullptr), size(0), diskOffset(0) {}
         bool IsValid() const { return data != nullptr; }
     };
-    
+
+    // Read-only view served from the window cache, or straight from the
+    // mapping of an image (no size limit, no copy); safe from several threads
     MappedRegion MapDiskRegion(uint64_t offset, uint64_t size);
     void UnmapRegion(MappedRegion& region);
 
+    WindowCache& Cache() { return m_windowCache; }
+
 private:
+    struct AsyncRequest;
+
+    std::wstring VolumePath() const;
+    HANDLE OpenVolumeHandle(DWORD flags) const;
+    void ShutdownAsyncIO();
+
+    // Whole-file read-only view of an image; false leaves reads on ReadFile
+    bool MapImage();
+    void UnmapImage();
+
+    // Bytes in the underlying file or device, ignoring the partition offset
+    uint64_t SourceSize() const;
+    // Length of the physical-disk partition starting at the offset, 0 if none
+    uint64_t PartitionLength() const;
+
+    // Bulk read yielding to metadata reads; see PriorityScope
+    size_t ReadBackground(uint64_t offset, uint8_t* buffer, size_t size, size_t queueDepth, ReadMode mode);
+
+    // Handle serving a request, or nullptr to fall back to cached I/O
+    HANDLE UnbufferedHandleFor(uint64_t offset, const uint8_t* buffer, size_t size, bool async);
+
     wchar_t m_driveLetter;
+    std::wstring m_sourcePath;  // Empty for drive-letter volumes
+    SourceKind m_kind;
+    uint64_t m_partitionOffset;
     HANDLE m_handle;
-    HANDLE m_mappingHandle;
-    void* m_mappedView;
-    uint64_t m_currentMappedOffset;
-    uint64_t m_currentMappedSize;
+    uint64_t m_sectorSize;
+
+    HANDLE m_unbufferedHandle;
+    HANDLE m_asyncHandle;
+    HANDLE m_asyncUnbufferedHandle;
+    HANDLE m_completionPort;
+    std::atomic<size_t> m_asyncPending;
+    std::mutex m_handleInitMutex;
+    std::mutex m_asyncMutex;    // Serializes ReadQueued sessions
+
+    std::atomic<size_t> m_priorityScopes;
+    size_t m_priorityReads;     // Metadata reads in flight, under m_priorityMutex
+    std::mutex m_priorityMutex;
+    std::condition_variable m_priorityIdle;
+
+    HANDLE m_mapping;
+    const uint8_t* m_mappedView;    // Start of the image file
+    const uint8_t* m_mappedData;    // Partition start inside the view
+    uint64_t m_mappedSize;          // Bytes from m_mappedData to end of file
+
+    std::shared_ptr<BandwidthLimiter> m_bandwidthLimiter;
+
+    WindowCache m_windowCache;
 };
 
-} // namespace KVC
\ No newline at end of file
+} // namespace KVC
@@ -79,8 +79,11 @@ bool ExFATScanner::ScanVolume(
     
     VolumeReader reader(disk, geom);
 
-    std::deque<DirectoryWorkItem> dirQueue;
-    dirQueue.push_back({ context.rootDirCluster, L"" });
+    // Chain walks resolve from memory; the second FAT is used when flagged active
+    uint64_t activeFat = (boot.numberOfFats > 1 && (boot.volumeFlags & 0x0001)) ? 1 : 0;
+    uint64_t fatStart = (static_cast<uint64_t>(context.fatOffset) + activeFat * context.fatLength) * context.sectorSize;
+    FatTable fatTable(disk, fatStart, static_cast<uint64_t>(boot.clusterCount) + 2, FatTable::Format::ExFAT);
+    context.fat = &fatTable;
 
     uint64_t directoriesScanned = 0;
     uint64_t filesFound = 0;
@@ -92,28 +95,34 @@ bool ExFATScanner::ScanVolume(
               (boot.fatOffset * context.sectorSize) / (1024.0 * 1024.0));
     onProgress(startMsg, 0.0f);
 
-    while (!dirQueue.empty() && !shouldStop) {
-        DirectoryWorkItem currentDir = dirQueue.front();
-        dirQueue.pop_front();
-
-        ProcessDirectory(reader, currentDir, dirQueue, [&](const DeletedFileEntry& file) {
-            onFileFound(file);
-            filesFound++;
-        }, context, shouldStop);
-
-        directoriesScanned++;
+    // Workers share the reader and FAT cache; candidates are reported here in walk order
+    FatDirectoryWalker walker(fatTable.EntryCount(), config.parallelThreads);
+    walker.Walk({ context.rootDirCluster, L"" },
+        [&](const DirectoryWorkItem& dirItem, FatDirectoryWalker::Batch& batch) {
+            ProcessDirectory(reader, dirItem, batch.subDirs, [&batch](const DeletedFileEntry& file) {
+                batch.candidates.push_back(file);
+            }, context, shouldStop);
+        },
+        [&](const DirectoryWorkItem&, FatDirectoryWalker::Batch& batch) {
+            for (const auto& file : batch.candidates) {
+                onFileFound(file);
+                filesFound++;
+            }
+            directoriesScanned++;
 
-        wchar_t statusMsg[256];
-        swprintf_s(statusMsg, L"exFAT: Dir %llu, Found %llu files", 
-                    directoriesScanned, filesFound);
-        float visualProgress = (directoriesScanned % 100) / 100.0f; 
-        onProgress(statusMsg, visualProgress);
-        
-        if (directoriesScanned > config.exfatDirectoryEntriesLimit) {
-            onProgress(L"Directory limit reached", 0.9f);
-            break;
-        }
-    }
+            wchar_t statusMsg[256];
+            swprintf_s(statusMsg, L"exFAT: Dir %llu, Found %llu files", 
+                        directoriesScanned, filesFound);
+            float visualProgress = (directoriesScanned % 100) / 100.0f; 
+            onProgress(statusMsg, visualProgress);
+            
+            if (directoriesScanned > config.exfatDirectoryEntriesLimit) {
+                onProgress(L"Directory limit reached", 0.9f);
+                return false;
+            }
+            return true;
+        },
+        shouldStop);
 
     if (shouldStop) {
         onProgress(L"Scan stopped by user", 1.0f);
@@ -277,20 +286,29 @@ std::vector<uint8_t> ExFATScanner::ReadClusterChain(
     if (startCluster < 2) return {};
     
     std::vector<uint8_t> buffer;
+    uint64_t clusterSize = context.sectorSize * context.sectorsPerCluster;
+    uint64_t totalClusters = reader.Geometry().totalClusters;
     
-    // Follow FAT chain for active directories
-    auto clusters = FollowFATChain(reader, context, startCluster, 1024);
+    // Follow FAT chain for active directories; contiguous links become one read
+    auto runs = FatTable::CoalesceRuns(FollowFATChain(context, startCluster, 1024));
     
-    for (uint32_t cluster : clusters) {
+    for (const auto& run : runs) {
         if (shouldStop) break;
 
         // Convert exFAT cluster to LCN
         // exFAT cluster 2 = LCN 0
-        if (cluster < 2) break;
-        uint64_t lcn = static_cast<uint64_t>(cluster) - 2;
+        if (run.start < 2) break;
+        uint64_t lcn = run.start - 2;
+        if (lcn >= totalClusters) break;
+
+        uint64_t count = std::min(run.count, totalClusters - lcn);
+        if (limitBytes > 0) {
+            uint64_t remaining = limitBytes > buffer.size() ? limitBytes - buffer.size() : 0;
+            count = std::min(count, std::max<uint64_t>(1, (remaining + clusterSize - 1) / clusterSize));
+        }
         
         try {
-            auto data = reader.ReadClusters(lcn, 1);
+            auto data = reader.ReadClusters(lcn, count);
             if (data.empty()) break;
 
             size_t oldSize = buffer.size();
@@ -316,62 +334,15 @@ std::vector<uint8_t> ExFATScanner::ReadClusterChain(
     return buffer;
 }
 
-std::optional<uint32_t> ExFATScanner::ReadFATEntry(
-    VolumeReader& reader,
-    const ScanContext& context,
-    uint32_t cluster)
-{
-    // FAT entry is 4 bytes per cluster
-    uint64_t fatEntryOffset = static_cast<uint64_t>(cluster) * 4;
-    uint64_t sectorSize = context.sectorSize;
-    
-    uint64_t sectorInFat = fatEntryOffset / sectorSize;
-    size_t offsetInSector = static_cast<size_t>(fatEntryOffset % sectorSize);
-    
-    uint64_t fatSector = context.fatOffset + sectorInFat;
-    
-    // Read FAT sector using raw DiskHandle (FAT is not in cluster heap)
-    auto data = reader.GetDiskHandle().ReadSectors(fatSector, 1, sectorSize);
-    if (data.empty() || offsetInSector + 4 > data.size()) {
-        return std::nullopt;
-    }
-    
-    uint32_t entry = static_cast<uint32_t>(data[offsetInSector]) |
-                    (static_cast<uint32_t>(data[offsetInSector + 1]) << 8) |
-                    (static_cast<uint32_t>(data[offsetInSector + 2]) << 16) |
-                    (static_cast<uint32_t>(data[offsetInSector + 3]) << 24);
-    
-    if (entry >= 0xFFFFFFF8) {
-        return std::nullopt;
-    } else if (entry >= 2 && entry <= 0xFFFFFFF6) {
-        return entry;
-    } else {
-        return std::nullopt;
-    }
-}
-
 std::vector<uint32_t> ExFATScanner::FollowFATChain(
-    VolumeReader& reader,
     const ScanContext& context,
     uint32_t startCluster,
     size_t maxClusters)
 {
-    std::vector<uint32_t> clusters;
-    uint32_t currentCluster = startCluster;
-    
-    clusters.push_back(currentCluster);
-    
-    while (clusters.size() < maxClusters) {
-        auto nextCluster = ReadFATEntry(reader, context, currentCluster);
-        if (!nextCluster.has_value()) {
-            break;
-        }
-        
-        clusters.push_back(nextCluster.value());
-        currentCluster = nextCluster.value();
+    if (!context.fat) {
+        return { startCluster };
     }
-    
-    return clusters;
+    return context.fat->FollowChain(startCluster, maxClusters);
 }
 
 std::wstring ExFATScanner::FormatFileSize(uint64_t bytes) {
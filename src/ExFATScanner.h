@@ -8,6 +8,8 @@
 
 #include "DiskForensicsCore.h"
 #include "VolumeReader.h"
+#include "FatTable.h"
+#include "FatDirectoryWalker.h"
 #include "Constants.h"
 #include <vector>
 #include <cstdint>
@@ -104,12 +106,10 @@ private:
         uint64_t volumeStartOffset;
         std::wstring folderFilter;
         std::wstring filenameFilter;
+        const FatTable* fat = nullptr;   // Active FAT, read once per scan
     };
 
-    struct DirectoryWorkItem {
-        uint32_t firstCluster;
-        std::wstring path;
-    };
+    using DirectoryWorkItem = FatDirectoryItem;
 
     ExFatBootSector ReadBootSector(DiskHandle& disk);
     
@@ -131,14 +131,7 @@ private:
         uint64_t limitBytes = 0
     );
 
-    std::optional<uint32_t> ReadFATEntry(
-        VolumeReader& reader,
-        const ScanContext& context,
-        uint32_t cluster
-    );
-
     std::vector<uint32_t> FollowFATChain(
-        VolumeReader& reader,
         const ScanContext& context,
         uint32_t startCluster,
         size_t maxClusters
@@ -82,36 +82,50 @@ bool FAT32Scanner::ScanVolume(
     
     VolumeReader reader(disk, geom);
 
-    std::deque<DirectoryWorkItem> dirQueue;
-    dirQueue.push_back({ context.rootCluster, L"" });
+    // With mirroring disabled, extFlags names the one active FAT
+    uint64_t activeFat = (boot.extFlags & 0x80) ? (boot.extFlags & 0x0F) : 0;
+    if (activeFat >= boot.numberOfFATs) activeFat = 0;
+    uint64_t fatStart = (boot.reservedSectors + activeFat * boot.fatSize32) * context.sectorSize;
+    uint64_t dataClusters = boot.totalSectors32 > context.dataStartSector
+        ? (boot.totalSectors32 - context.dataStartSector) / context.sectorsPerCluster : 0;
+    uint64_t fatEntries = (static_cast<uint64_t>(boot.fatSize32) * context.sectorSize) / sizeof(uint32_t);
+    FatTable fatTable(disk, fatStart, std::min(fatEntries, dataClusters + 2), FatTable::Format::FAT32);
+    context.fat = &fatTable;
 
     uint64_t directoriesScanned = 0;
     uint64_t filesFound = 0;
 
     onProgress(L"Starting FAT32 structure scan...", 0.0f);
 
-    while (!dirQueue.empty() && !shouldStop) {
-        DirectoryWorkItem current = dirQueue.front();
-        dirQueue.pop_front();
-
-        ProcessDirectory(reader, current, dirQueue, [&](const DeletedFileEntry& file) {
-            onFileFound(file);
-            filesFound++;
-        }, context);
-        directoriesScanned++;
-
-        if ((directoriesScanned % 10) == 0) {
-            wchar_t statusMsg[256];
-            swprintf_s(statusMsg, L"FAT32 Scan: %llu directories, %llu deleted files found", 
-                      directoriesScanned, filesFound);
-            onProgress(statusMsg, 0.5f);
-        }
-        
-        if (directoriesScanned > config.exfatDirectoryEntriesLimit) {
-            onProgress(L"Directory limit reached", 0.9f);
-            break;
-        }
-    }
+    // Workers share the reader and FAT cache; candidates are reported here in walk order
+    FatDirectoryWalker walker(fatTable.EntryCount(), config.parallelThreads);
+    walker.Walk({ context.rootCluster, L"" },
+        [&](const DirectoryWorkItem& dirItem, FatDirectoryWalker::Batch& batch) {
+            ProcessDirectory(reader, dirItem, batch.subDirs, [&batch](const DeletedFileEntry& file) {
+                batch.candidates.push_back(file);
+            }, context);
+        },
+        [&](const DirectoryWorkItem&, FatDirectoryWalker::Batch& batch) {
+            for (const auto& file : batch.candidates) {
+                onFileFound(file);
+                filesFound++;
+            }
+            directoriesScanned++;
+
+            if ((directoriesScanned % 10) == 0) {
+                wchar_t statusMsg[256];
+                swprintf_s(statusMsg, L"FAT32 Scan: %llu directories, %llu deleted files found", 
+                          directoriesScanned, filesFound);
+                onProgress(statusMsg, 0.5f);
+            }
+            
+            if (directoriesScanned > config.exfatDirectoryEntriesLimit) {
+                onProgress(L"Directory limit reached", 0.9f);
+                return false;
+            }
+            return true;
+        },
+        shouldStop);
 
     wchar_t completeMsg[256];
     swprintf_s(completeMsg, L"FAT32 scan complete: %llu files found", filesFound);
@@ -309,32 +323,40 @@ std::vector<uint8_t> FAT32Scanner::ReadClusterChain(
     const ScanContext& context,
     uint64_t limitBytes)
 {
-	(void)context;
     if (startCluster < 2) return {};
     
     std::vector<uint8_t> buffer;
-    uint32_t currentCluster = startCluster;
-    uint64_t bytesRead = 0;
-    int maxClusters = Constants::FAT32::MAX_CHAIN_CLUSTERS;
+    uint64_t maxClusters = Constants::FAT32::MAX_CHAIN_CLUSTERS;
+    uint64_t totalClusters = reader.Geometry().totalClusters;
+
+    // Live chains come from the cached FAT. A deleted directory's chain is
+    // cleared to free, so it is assumed contiguous as before.
+    std::vector<ClusterRange> runs;
+    if (context.fat && context.fat->Entry(startCluster) != 0) {
+        runs = FatTable::CoalesceRuns(context.fat->FollowChain(startCluster, static_cast<size_t>(maxClusters)));
+    } else {
+        runs.push_back({ startCluster, maxClusters });
+    }
 
-    while (currentCluster >= 2 && currentCluster < 0x0FFFFFF7 && maxClusters > 0) {
+    for (const auto& run : runs) {
         // Convert FAT cluster to LCN
         // FAT cluster 2 = LCN 0 (first data cluster)
-        if (currentCluster < 2) break;
-        uint64_t lcn = static_cast<uint64_t>(currentCluster) - 2;
+        if (run.start < 2) break;
+        uint64_t lcn = run.start - 2;
+        if (lcn >= totalClusters) break;
+
+        uint64_t count = std::min(run.count, totalClusters - lcn);
+        if (limitBytes > 0) {
+            uint64_t remaining = limitBytes > buffer.size() ? limitBytes - buffer.size() : 0;
+            count = std::min(count, std::max<uint64_t>(1, (remaining + context.clusterSize - 1) / context.clusterSize));
+        }
         
         try {
-            auto data = reader.ReadClusters(lcn, 1);
+            auto data = reader.ReadClusters(lcn, count);
             if (data.empty()) break;
 
             buffer.insert(buffer.end(), data.begin(), data.end());
-            bytesRead += data.size();
-            if (limitBytes > 0 && bytesRead >= limitBytes) break;
-
-            // For active directories, assume contiguous
-            // For deleted files, FAT chain is cleared
-            currentCluster++;
-            maxClusters--;
+            if (limitBytes > 0 && buffer.size() >= limitBytes) break;
             
         } catch (const std::exception&) {
             break;
@@ -8,6 +8,8 @@
 
 #include "DiskForensicsCore.h"
 #include "VolumeReader.h"
+#include "FatTable.h"
+#include "FatDirectoryWalker.h"
 #include "Constants.h"
 #include <vector>
 #include <deque>
@@ -99,12 +101,10 @@ private:
         uint64_t volumeStartOffset;
         std::wstring folderFilter;
         std::wstring filenameFilter;
+        const FatTable* fat = nullptr;   // Active FAT, read once per scan
     };
 
-    struct DirectoryWorkItem {
-        uint32_t firstCluster;
-        std::wstring path;
-    };
+    using DirectoryWorkItem = FatDirectoryItem;
 
     FAT32BootSector ReadBootSector(DiskHandle& disk);
     
@@ -0,0 +1,78 @@
+// ============================================================================
+// FatDirectoryWalker.cpp - Parallel FAT32 / exFAT Directory Traversal
+// ============================================================================
+
+#include "FatDirectoryWalker.h"
+#include "Constants.h"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+
+namespace KVC {
+
+FatDirectoryWalker::FatDirectoryWalker(uint64_t clusterCount, size_t workerCount)
+    : m_visited(clusterCount)
+    , m_workerCount(std::max<size_t>(1, workerCount))
+{}
+
+bool FatDirectoryWalker::MarkVisited(uint32_t cluster) {
+    // Clusters the bitmap cannot represent are never deduplicated
+    if (cluster >= m_visited.TotalClusters()) return true;
+    if (m_visited.Test(cluster)) return false;
+    m_visited.Set(cluster);
+    return true;
+}
+
+uint64_t FatDirectoryWalker::Walk(const FatDirectoryItem& root, const ExpandFn& expand,
+                                  const ConsumeFn& consume, const bool& shouldStop) {
+    std::deque<FatDirectoryItem> queue;
+    queue.push_back(root);
+    MarkVisited(root.firstCluster);
+
+    uint64_t consumed = 0;
+
+    while (!queue.empty() && !shouldStop) {
+        // The front of the queue is expanded concurrently; subdirectories
+        // join the back, exactly as in a sequential FIFO walk
+        size_t count = std::min<size_t>(queue.size(), Constants::DIRECTORY_WALK_BATCH);
+        std::vector<Batch> results(count);
+        std::atomic<size_t> cursor{ 0 };
+
+        auto work = [&]() {
+            for (size_t i = cursor.fetch_add(1); i < count && !shouldStop; i = cursor.fetch_add(1)) {
+                expand(queue[i], results[i]);
+            }
+        };
+
+        size_t helpers = std::min(m_workerCount, count) - 1;
+        std::vector<std::future<void>> workers;
+        workers.reserve(helpers);
+        for (size_t w = 0; w < helpers; w++) {
+            workers.push_back(std::async(std::launch::async, work));
+        }
+        work();
+        for (auto& worker : workers) {
+            worker.get();
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            if (shouldStop) return consumed;
+
+            consumed++;
+            if (!consume(queue[i], results[i])) return consumed;
+
+            for (auto& subDir : results[i].subDirs) {
+                if (MarkVisited(subDir.firstCluster)) {
+                    queue.push_back(std::move(subDir));
+                }
+            }
+        }
+
+        queue.erase(queue.begin(), queue.begin() + static_cast<std::ptrdiff_t>(count));
+    }
+
+    return consumed;
+}
+
+} // namespace KVC
@@ -0,0 +1,54 @@
+// ============================================================================
+// FatDirectoryWalker.h - Parallel FAT32 / exFAT Directory Traversal
+// ============================================================================
+// Breadth-first walk whose front-of-queue directories are expanded by worker
+// threads pulling from a shared cursor. Results are consumed on the calling
+// thread in queue order, so output matches a single-threaded FIFO walk.
+// A volume-wide visited bitmap stops directory loops and cross-links.
+// ============================================================================
+
+#pragma once
+
+#include "RecoveryCandidate.h"
+#include "ClusterBitmap.h"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace KVC {
+
+struct FatDirectoryItem {
+    uint32_t firstCluster;
+    std::wstring path;
+};
+
+class FatDirectoryWalker {
+public:
+    // Everything one directory produced, filled by a worker
+    struct Batch {
+        std::vector<RecoveryCandidate> candidates;
+        std::deque<FatDirectoryItem> subDirs;
+    };
+
+    // Runs on worker threads; must only touch its own Batch
+    using ExpandFn = std::function<void(const FatDirectoryItem&, Batch&)>;
+    // Runs on the calling thread in queue order; return false to stop
+    using ConsumeFn = std::function<bool(const FatDirectoryItem&, Batch&)>;
+
+    FatDirectoryWalker(uint64_t clusterCount, size_t workerCount);
+
+    // Returns the number of directories consumed
+    uint64_t Walk(const FatDirectoryItem& root, const ExpandFn& expand, const ConsumeFn& consume,
+                  const bool& shouldStop);
+
+private:
+    // False if the cluster was already queued once
+    bool MarkVisited(uint32_t cluster);
+
+    ClusterBitmap m_visited;    // Indexed by FAT cluster number
+    size_t m_workerCount;
+};
+
+} // namespace KVC
@@ -0,0 +1,160 @@
+// ============================================================================
+// FatTable.cpp - Cached FAT32 / exFAT Allocation Table
+// ============================================================================
+
+#include "FatTable.h"
+#include "Constants.h"
+
+#include <algorithm>
+
+namespace KVC {
+
+FatTable::FatTable(DiskHandle& disk, uint64_t fatOffset, uint64_t entryCount, Format format)
+    : m_disk(disk)
+    , m_fatOffset(fatOffset)
+    , m_entryCount(std::min<uint64_t>(entryCount, UINT32_MAX))
+    , m_format(format)
+    , m_loaded(false)
+    , m_useCounter(0)
+    , m_paged(false)
+{
+    if (m_entryCount == 0) return;
+
+    if (m_entryCount * sizeof(uint32_t) <= Constants::FatCache::FULL_LOAD_LIMIT) {
+        m_loaded = ReadEntries(0, m_entryCount, m_entries);
+        return;
+    }
+
+    // Too large to hold: probe the first page, then fault pages in on demand
+    m_paged = true;
+    PagedEntry(0);
+    m_loaded = !m_pages.front().entries.empty();
+}
+
+bool FatTable::ReadEntries(uint64_t firstEntry, uint64_t count, std::vector<uint32_t>& out) const {
+    uint64_t sectorSize = m_disk.GetSectorSize();
+    if (sectorSize == 0) sectorSize = Constants::SECTOR_SIZE_DEFAULT;
+
+    // Every caller starts on a sector boundary; only the tail needs rounding
+    uint64_t bytes = count * sizeof(uint32_t);
+    uint64_t readBytes = (bytes + sectorSize - 1) / sectorSize * sectorSize;
+
+    out.assign(static_cast<size_t>(readBytes / sizeof(uint32_t)), 0);
+    size_t got = m_disk.ReadInto(m_fatOffset + firstEntry * sizeof(uint32_t),
+                                 reinterpret_cast<uint8_t*>(out.data()), static_cast<size_t>(readBytes));
+    if (got == 0) {
+        out.clear();
+        return false;
+    }
+
+    // Entries are little-endian on disk, matching the host
+    out.resize(static_cast<size_t>(std::min<uint64_t>(count, got / sizeof(uint32_t))));
+    for (auto& entry : out) {
+        entry = Decode(entry);
+    }
+    return true;
+}
+
+uint32_t FatTable::Decode(uint32_t raw) const {
+    // FAT32 reserves the top four bits
+    return m_format == Format::FAT32 ? (raw & 0x0FFFFFFF) : raw;
+}
+
+uint32_t FatTable::PagedEntry(uint32_t cluster) const {
+    constexpr uint64_t entriesPerPage = Constants::FatCache::PAGE_SIZE / sizeof(uint32_t);
+    uint64_t pageIndex = cluster / entriesPerPage;
+    size_t offsetInPage = static_cast<size_t>(cluster % entriesPerPage);
+
+    std::lock_guard<std::mutex> lock(m_pageMutex);
+
+    auto it = std::find_if(m_pages.begin(), m_pages.end(),
+        [pageIndex](const Page& page) { return page.index == pageIndex; });
+
+    if (it == m_pages.end()) {
+        // Evict the least recently used page once the budget is reached
+        if (m_pages.size() < Constants::FatCache::MAX_PAGES) {
+            m_pages.emplace_back();
+            it = m_pages.end() - 1;
+        } else {
+            it = std::min_element(m_pages.begin(), m_pages.end(),
+                [](const Page& a, const Page& b) { return a.lastUse < b.lastUse; });
+        }
+
+        uint64_t first = pageIndex * entriesPerPage;
+        uint64_t count = std::min(entriesPerPage, m_entryCount - first);
+        it->index = pageIndex;
+        if (!ReadEntries(first, count, it->entries)) {
+            it->entries.clear();
+        }
+    }
+
+    it->lastUse = ++m_useCounter;
+    return offsetInPage < it->entries.size() ? it->entries[offsetInPage] : 0;
+}
+
+uint32_t FatTable::Entry(uint32_t cluster) const {
+    if (cluster >= m_entryCount) return 0;
+    if (!m_paged) {
+        return cluster < m_entries.size() ? m_entries[cluster] : 0;
+    }
+    return PagedEntry(cluster);
+}
+
+std::optional<uint32_t> FatTable::Next(uint32_t cluster) const {
+    uint32_t entry = Entry(cluster);
+
+    // 0 = free, 1 = reserved; bad-cluster and end-of-chain markers sit at the top
+    uint32_t lastValid = (m_format == Format::FAT32) ? 0x0FFFFFF6 : 0xFFFFFFF6;
+    if (entry < 2 || entry > lastValid || entry >= m_entryCount) {
+        return std::nullopt;
+    }
+    return entry;
+}
+
+std::vector<uint32_t> FatTable::FollowChain(uint32_t startCluster, size_t maxClusters) const {
+    std::vector<uint32_t> clusters;
+    if (startCluster < 2 || maxClusters == 0) return clusters;
+
+    clusters.push_back(startCluster);
+    uint32_t current = startCluster;
+    while (clusters.size() < maxClusters) {
+        auto next = Next(current);
+        if (!next) break;
+        clusters.push_back(*next);
+        current = *next;
+    }
+
+    // A chain that hit the cap may be a loop; cut it at the first repeat
+    if (clusters.size() == maxClusters && clusters.size() > 1) {
+        std::vector<std::pair<uint32_t, size_t>> sorted;
+        sorted.reserve(clusters.size());
+        for (size_t i = 0; i < clusters.size(); i++) {
+            sorted.emplace_back(clusters[i], i);
+        }
+        std::sort(sorted.begin(), sorted.end());
+
+        // The earliest later occurrence of any cluster is where the walk re-entered
+        size_t cut = clusters.size();
+        for (size_t i = 1; i < sorted.size(); i++) {
+            if (sorted[i].first == sorted[i - 1].first) {
+                cut = std::min(cut, sorted[i].second);
+            }
+        }
+        clusters.resize(cut);
+    }
+    return clusters;
+}
+
+std::vector<ClusterRange> FatTable::CoalesceRuns(const std::vector<uint32_t>& clusters) {
+    std::vector<ClusterRange> runs;
+    for (uint32_t cluster : clusters) {
+        if (!runs.empty() && runs.back().start + runs.back().count == cluster) {
+            runs.back().count++;
+        } else {
+            runs.push_back({ cluster, 1 });
+        }
+    }
+    return runs;
+}
+
+} // namespace KVC
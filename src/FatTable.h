@@ -0,0 +1,75 @@
+// ============================================================================
+// FatTable.h - Cached FAT32 / exFAT Allocation Table
+// ============================================================================
+// Reads the active FAT with large sequential reads and decodes it into a
+// flat uint32_t array, so chain walks cost no disk I/O per link. FATs above
+// the full-load limit are paged through a small LRU instead.
+// Lookups are thread-safe.
+// ============================================================================
+
+#pragma once
+
+#include "DiskHandle.h"
+#include "FragmentedFile.h"
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace KVC {
+
+class FatTable {
+public:
+    enum class Format { FAT32, ExFAT };
+
+    // fatOffset is the byte offset of the FAT on the volume; entryCount
+    // includes the two reserved entries (cluster count + 2)
+    FatTable(DiskHandle& disk, uint64_t fatOffset, uint64_t entryCount, Format format);
+    ~FatTable() = default;
+
+    FatTable(const FatTable&) = delete;
+    FatTable& operator=(const FatTable&) = delete;
+
+    // True once the table (or its first page) could be read
+    bool IsLoaded() const { return m_loaded; }
+
+    // Decoded entry (FAT32 entries are masked to 28 bits); 0 means free
+    uint32_t Entry(uint32_t cluster) const;
+
+    // Next cluster of a chain, or nullopt at end-of-chain, free or bad entries
+    std::optional<uint32_t> Next(uint32_t cluster) const;
+
+    // Cluster chain from startCluster, at most maxClusters long
+    std::vector<uint32_t> FollowChain(uint32_t startCluster, size_t maxClusters) const;
+
+    // Merge consecutive cluster numbers into runs (start stays a FAT cluster number)
+    static std::vector<ClusterRange> CoalesceRuns(const std::vector<uint32_t>& clusters);
+
+    uint64_t EntryCount() const { return m_entryCount; }
+
+private:
+    struct Page {
+        uint64_t index = UINT64_MAX;
+        uint64_t lastUse = 0;
+        std::vector<uint32_t> entries;
+    };
+
+    bool ReadEntries(uint64_t firstEntry, uint64_t count, std::vector<uint32_t>& out) const;
+    uint32_t Decode(uint32_t raw) const;
+    uint32_t PagedEntry(uint32_t cluster) const;
+
+    DiskHandle& m_disk;
+    uint64_t m_fatOffset;
+    uint64_t m_entryCount;
+    Format m_format;
+    bool m_loaded;
+
+    std::vector<uint32_t> m_entries;      // Whole table when it fits the limit
+
+    mutable std::mutex m_pageMutex;       // Guards the LRU in paged mode
+    mutable std::vector<Page> m_pages;
+    mutable uint64_t m_useCounter;
+    bool m_paged;
+};
+
+} // namespace KVC
@@ -8,16 +8,19 @@
 #endif
 
 #include "FileCarver.h"
+#include "BifragmentCarver.h"
+#include "SignatureMatcher.h"
 #include "Constants.h"
 #include "StringUtils.h"
+#include "PerfCounters.h"
 
 #include <climits>
 #include <cstring>
 #include <cmath>
 #include <algorithm>
 #include <atomic>
-#include <unordered_set>
 #include <optional>
+#include <future>
 
 namespace KVC {
 
@@ -33,12 +36,15 @@ SequentialReader::SequentialReader(DiskHandle& disk, uint64_t startOffset, uint6
     , m_sectorSize(sectorSize)
     , m_volumeStartOffset(0)
     , m_fragmentMode(false)
+    , m_data(nullptr)
+    , m_window(nullptr)
+    , m_windowOffset(0)
+    , m_windowSize(0)
     , m_bufferPos(0)
     , m_bufferValid(0)
     , m_bufferFileOffset(0)
-{
-    m_buffer.resize(BUFFER_SIZE);
-}
+    , m_runHint(0)
+{}
 
 SequentialReader::SequentialReader(DiskHandle& disk, const FragmentMap& fragments, uint64_t sectorSize, uint64_t volumeStartOffset)
     : m_disk(disk)
@@ -49,12 +55,15 @@ SequentialReader::SequentialReader(DiskHandle& disk, const FragmentMap& fragment
     , m_volumeStartOffset(volumeStartOffset)
     , m_fragmentMode(true)
     , m_fragments(fragments)
+    , m_data(nullptr)
+    , m_window(nullptr)
+    , m_windowOffset(0)
+    , m_windowSize(0)
     , m_bufferPos(0)
     , m_bufferValid(0)
     , m_bufferFileOffset(0)
-{
-    m_buffer.resize(BUFFER_SIZE);
-}
+    , m_runHint(0)
+{}
 
 SequentialReader::SequentialReader(DiskHandle& disk, FragmentMap&& fragments, uint64_t sectorSize, uint64_t volumeStartOffset)
     : m_disk(disk)
@@ -65,19 +74,22 @@ SequentialReader::SequentialReader(DiskHandle& disk, FragmentMap&& fragments, ui
     , m_volumeStartOffset(volumeStartOffset)
     , m_fragmentMode(true)
     , m_fragments(std::move(fragments))
+    , m_data(nullptr)
+    , m_window(nullptr)
+    , m_windowOffset(0)
+    , m_windowSize(0)
     , m_bufferPos(0)
     , m_bufferValid(0)
     , m_bufferFileOffset(0)
-{
-    m_buffer.resize(BUFFER_SIZE);
-}
+    , m_runHint(0)
+{}
 
 std::optional<uint64_t> SequentialReader::TranslatePositionToDisk() const {
     if (!m_fragmentMode) {
         return m_startOffset + m_position;
     }
 
-    auto loc = m_fragments.TranslateOffset(m_position);
+    auto loc = m_fragments.TranslateOffset(m_position, m_runHint);
     if (!loc.valid) {
         return std::nullopt;
     }
@@ -88,96 +100,126 @@ std::optional<uint64_t> SequentialReader::TranslatePositionToDisk() const {
     return m_volumeStartOffset + (loc.cluster * sectorsPerCluster * m_sectorSize) + loc.offsetInCluster;
 }
 
-void SequentialReader::FillBuffer() {
+void SequentialReader::SetWindow(const uint8_t* data, uint64_t diskOffset, uint64_t size) {
+    m_window = data;
+    m_windowOffset = diskOffset;
+    m_windowSize = data != nullptr ? size : 0;
+}
+
+void SequentialReader::FillBuffer(bool useWindow) {
     if (m_fragmentMode) {
         FillBufferFragmented();
     } else {
-        FillBufferLinear();
+        FillBufferLinear(useWindow);
+    }
+}
+
+bool SequentialReader::EnsureBuffer() {
+    if (!m_buffer.IsValid()) {
+        m_buffer = AlignedBufferPool::Shared().Acquire(BUFFER_SIZE + 2 * static_cast<size_t>(m_sectorSize));
     }
+    return m_buffer.IsValid();
+}
+
+// Sector-aligned read straight into dest; dest needs toRead plus up to two
+// sectors of slack. Returns usable bytes now starting at dest[0].
+size_t SequentialReader::ReadAt(uint64_t diskOffset, uint8_t* dest, size_t toRead) {
+    uint64_t offsetInSector = diskOffset % m_sectorSize;
+    uint64_t alignedOffset = diskOffset - offsetInSector;
+    uint64_t sectorsNeeded = (offsetInSector + toRead + m_sectorSize - 1) / m_sectorSize;
+
+    // Through the shared window cache: nested end parses and lookahead past
+    // the batch re-read the same regions many times. A mapped image is
+    // already resident, so a window would only add a second copy.
+    const size_t alignedSize = static_cast<size_t>(sectorsNeeded * m_sectorSize);
+    size_t bytesRead = m_disk.IsMemoryMapped()
+        ? m_disk.ReadInto(alignedOffset, dest, alignedSize)
+        : m_disk.Cache().Read(alignedOffset, dest, alignedSize);
+
+    if (bytesRead <= offsetInSector) {
+        return 0;
+    }
+
+    size_t available = std::min<size_t>(bytesRead - static_cast<size_t>(offsetInSector), toRead);
+
+    // Unaligned start (rare - carving starts on cluster boundaries)
+    if (offsetInSector != 0) {
+        std::memmove(dest, dest + offsetInSector, available);
+    }
+
+    return available;
 }
 
-void SequentialReader::FillBufferLinear() {
+void SequentialReader::FillBufferLinear(bool useWindow) {
     uint64_t diskOffset = m_startOffset + m_position;
     uint64_t remaining = m_maxSize - m_position;
 
+    m_bufferPos = 0;
+    m_bufferFileOffset = m_position;
+
     if (remaining == 0) {
         m_bufferValid = 0;
         return;
     }
 
-    uint64_t toRead = std::min<uint64_t>(BUFFER_SIZE, remaining);
-
-    // FIX: Calculate offset BEFORE reading
-    uint64_t offsetInSector = diskOffset % m_sectorSize;
-    uint64_t startSector = diskOffset / m_sectorSize;
-
-    // FIX: No unconditional +1
-    uint64_t sectorsNeeded = (offsetInSector + toRead + m_sectorSize - 1) / m_sectorSize;
-
-    auto data = m_disk.ReadSectors(startSector, sectorsNeeded, m_sectorSize);
+    // Zero-copy: point straight into the resident batch
+    if (useWindow && m_window != nullptr &&
+        diskOffset >= m_windowOffset && diskOffset - m_windowOffset < m_windowSize) {
+        uint64_t inWindow = m_windowSize - (diskOffset - m_windowOffset);
+        m_data = m_window + (diskOffset - m_windowOffset);
+        m_bufferValid = static_cast<size_t>(std::min<uint64_t>(inWindow, std::min<uint64_t>(remaining, SIZE_MAX)));
+        return;
+    }
 
-    if (data.empty()) {
+    if (!EnsureBuffer()) {
         m_bufferValid = 0;
         return;
     }
 
-    size_t available = data.size() > offsetInSector ? data.size() - static_cast<size_t>(offsetInSector) : 0;
-    size_t toCopy = std::min<size_t>(available, static_cast<size_t>(toRead));
+    size_t toRead = static_cast<size_t>(std::min<uint64_t>(BUFFER_SIZE, remaining));
 
-    std::memcpy(m_buffer.data(), data.data() + offsetInSector, toCopy);
-    m_bufferValid = toCopy;
-    m_bufferPos = 0;
-    m_bufferFileOffset = m_position;
+    m_data = m_buffer.Data();
+    m_bufferValid = ReadAt(diskOffset, m_buffer.Data(), toRead);
 }
 
 void SequentialReader::FillBufferFragmented() {
     uint64_t remaining = m_maxSize - m_position;
 
-    if (remaining == 0) {
+    if (remaining == 0 || !EnsureBuffer()) {
         m_bufferValid = 0;
         return;
     }
+    m_data = m_buffer.Data();
 
     size_t bufferFilled = 0;
     uint64_t currentPos = m_position;
+    uint64_t sectorsPerCluster = m_fragments.BytesPerCluster() / m_sectorSize;
 
-    while (bufferFilled < BUFFER_SIZE && currentPos < m_maxSize) {
-        uint64_t contiguousBytes = m_fragments.ContiguousBytesFrom(currentPos);
-        if (contiguousBytes == 0) {
+    // One lookup per fill (O(1) when reading on from the last run), then
+    // whole extents until the buffer is full or the file has a hole
+    for (const FileExtent& extent : m_fragments.Extents(currentPos, m_runHint)) {
+        if (bufferFilled >= BUFFER_SIZE || currentPos >= m_maxSize) {
             break;
         }
 
         size_t toRead = static_cast<size_t>(std::min<uint64_t>(
-            contiguousBytes,
+            extent.length,
             std::min<uint64_t>(BUFFER_SIZE - bufferFilled, m_maxSize - currentPos)
         ));
 
-        auto loc = m_fragments.TranslateOffset(currentPos);
-        if (!loc.valid) {
-            break;
-        }
-
-        uint64_t bytesPerCluster = m_fragments.BytesPerCluster();
-        uint64_t sectorsPerCluster = bytesPerCluster / m_sectorSize;
-        uint64_t diskOffset = m_volumeStartOffset + (loc.cluster * sectorsPerCluster * m_sectorSize) + loc.offsetInCluster;
+        uint64_t diskOffset = m_volumeStartOffset + (extent.cluster * sectorsPerCluster * m_sectorSize) + extent.offsetInCluster;
 
-        // FIX: Calculate alignment BEFORE reading
-        uint64_t offsetInSector = diskOffset % m_sectorSize;
-        uint64_t startSector = diskOffset / m_sectorSize;
-        uint64_t sectorsNeeded = (offsetInSector + toRead + m_sectorSize - 1) / m_sectorSize;
-
-        auto data = m_disk.ReadSectors(startSector, sectorsNeeded, m_sectorSize);
-
-        if (data.empty()) {
+        size_t copied = ReadAt(diskOffset, m_buffer.Data() + bufferFilled, toRead);
+        m_runHint = extent.runIndex;
+        if (copied == 0) {
             break;
         }
 
-        size_t available = data.size() > offsetInSector ? data.size() - static_cast<size_t>(offsetInSector) : 0;
-        size_t toCopy = std::min<size_t>(available, toRead);
-
-        std::memcpy(m_buffer.data() + bufferFilled, data.data() + offsetInSector, toCopy);
-        bufferFilled += toCopy;
-        currentPos += toCopy;
+        bufferFilled += copied;
+        currentPos += copied;
+        if (copied < toRead) {
+            break;      // Short read: retry the rest of this extent on the next fill
+        }
     }
 
     m_bufferValid = bufferFilled;
@@ -197,7 +239,7 @@ bool SequentialReader::ReadByte(uint8_t& byte) {
         }
     }
 
-    byte = m_buffer[m_bufferPos++];
+    byte = m_data[m_bufferPos++];
     m_position++;
     return true;
 }
@@ -214,7 +256,7 @@ bool SequentialReader::Peek(uint8_t& byte) {
         }
     }
 
-    byte = m_buffer[m_bufferPos];
+    byte = m_data[m_bufferPos];
     return true;
 }
 
@@ -232,7 +274,7 @@ size_t SequentialReader::Read(uint8_t* buffer, size_t count) {
         size_t available = m_bufferValid - m_bufferPos;
         size_t toRead = std::min(available, count - totalRead);
 
-        std::memcpy(buffer + totalRead, m_buffer.data() + m_bufferPos, toRead);
+        std::memcpy(buffer + totalRead, m_data + m_bufferPos, toRead);
         m_bufferPos += toRead;
         m_position += toRead;
         totalRead += toRead;
@@ -280,6 +322,62 @@ bool SequentialReader::Seek(uint64_t position) {
     return true;
 }
 
+bool SequentialReader::SkipTo(uint8_t value, uint64_t limit) {
+    limit = std::min(limit, m_maxSize);
+
+    while (m_position < limit) {
+        if (m_bufferPos >= m_bufferValid) {
+            FillBuffer();
+            if (m_bufferValid == 0) {
+                return false;
+            }
+        }
+
+        size_t span = static_cast<size_t>(std::min<uint64_t>(m_bufferValid - m_bufferPos, limit - m_position));
+        const uint8_t* start = m_data + m_bufferPos;
+        const void* hit = std::memchr(start, value, span);
+        size_t advance = hit != nullptr ? static_cast<size_t>(static_cast<const uint8_t*>(hit) - start) : span;
+
+        m_bufferPos += advance;
+        m_position += advance;
+        if (hit != nullptr) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool SequentialReader::FindNext(const uint8_t* pattern, size_t length, uint64_t limit) {
+    limit = std::min(limit, m_maxSize);
+    if (length == 0 || length > BUFFER_SIZE) {
+        return false;
+    }
+
+    while (m_position + length <= limit) {
+        if (!SkipTo(pattern[0], limit - length + 1)) {
+            return false;
+        }
+
+        // A candidate split across the buffer (or window) end is re-read from disk
+        if (m_bufferValid - m_bufferPos < length) {
+            FillBuffer(false);
+            if (m_bufferValid < length) {
+                return false;
+            }
+        }
+
+        if (std::memcmp(m_data + m_bufferPos, pattern, length) == 0) {
+            return true;
+        }
+
+        m_bufferPos++;
+        m_position++;
+    }
+
+    return false;
+}
+
 // ============================================================================
 // FileCarver Implementation
 // ============================================================================
@@ -295,8 +393,16 @@ CarvingStatistics CreateCarvingDiagnostics() {
     stats.filesWithValidatedSize = 0;
     stats.potentiallyFragmented = 0;
     stats.severelyFragmented = 0;
+    stats.bifragmentsRecovered = 0;
     stats.unknownSize = 0;
     stats.clustersScanned = 0;
+    stats.nestedParsesSkipped = 0;
+    stats.windowCacheHits = 0;
+    stats.windowCacheMisses = 0;
+    stats.zeroClusters = 0;
+    stats.uniformClusters = 0;
+    stats.highEntropyClusters = 0;
+    stats.weakHitsSuppressed = 0;
     return stats;
 }
 
@@ -308,6 +414,12 @@ CarvingResult FileCarver::CarveVolume(
     std::atomic<bool>& shouldStop)
 {
     CarvingResult result;
+    result.stats = CreateCarvingDiagnostics();
+    m_openContainers.clear();
+    m_fragmentCandidates.clear();
+    m_skipUntilLCN = 0;
+    m_resumeLCN = options.startLCN;
+    m_lastCheckpoint = std::chrono::steady_clock::now();
     const auto& geom = reader.Geometry();
 
     uint64_t startLCN = options.startLCN;
@@ -319,44 +431,185 @@ CarvingResult FileCarver::CarveVolume(
         return result;
     }
 
-    std::unordered_set<uint64_t> seenStartLCNs;
+    // Clusters owned by files recovered so far (this run or earlier stages)
+    ClusterBitmap localClaims;
+    ClusterBitmap& claimed = options.claimedClusters ? *options.claimedClusters : localClaims;
+    if (claimed.Empty()) {
+        claimed.Reset(geom.totalClusters);
+    }
+
+    const SignatureMatcher matcher(options.signatures);
+
+    // Live files cannot hold deleted data, so an allocation map limits reads to free space
+    const std::vector<ClusterRange> batches = PlanBatches(options, startLCN, maxLCN);
+    uint64_t clustersToScan = 0;
+    for (const auto& batch : batches) {
+        clustersToScan += batch.count;
+    }
 
     wchar_t startMsg[256];
     swprintf_s(startMsg, L"File carving: Scanning %llu clusters (%.2f GB)...",
-              maxLCN - startLCN, ((maxLCN - startLCN) * geom.bytesPerCluster) / 1000000000.0);
+              clustersToScan, (clustersToScan * geom.bytesPerCluster) / 1000000000.0);
     onProgress(startMsg, 0.0f);
 
-    const uint64_t batchSize = options.batchClusters;
+    const WindowCache::Stats cacheBefore = reader.GetDiskHandle().Cache().GetStats();
 
-    for (uint64_t batchStart = startLCN;
-         batchStart < maxLCN && result.files.size() < options.maxFiles;
-         batchStart += batchSize) {
+    if (options.workerThreads > 1) {
+        CarveBatchesPipelined(reader, options, matcher, batches, maxLCN,
+                              claimed, result, onFileFound, onProgress, shouldStop);
+    } else {
+        CarveBatchesSequential(reader, options, matcher, batches, maxLCN,
+                               claimed, result, onFileFound, onProgress, shouldStop);
+    }
+
+    if (!m_fragmentCandidates.empty()) {
+        CarveFragmentedCandidates(reader, options, maxLCN, claimed, result,
+                                  onFileFound, onProgress, shouldStop);
+    }
+
+    result.stats.clustersScanned = clustersToScan;
+
+    const WindowCache::Stats cacheAfter = reader.GetDiskHandle().Cache().GetStats();
+    result.stats.windowCacheHits = cacheAfter.hits - cacheBefore.hits;
+    result.stats.windowCacheMisses = cacheAfter.misses - cacheBefore.misses;
+
+    // An interrupted pass always leaves its latest resume point behind
+    if (shouldStop) {
+        CompleteBatch(options, m_resumeLCN, claimed, result, true);
+    }
+
+    wchar_t completeMsg[256];
+    float percentScanned = (static_cast<float>(clustersToScan) / geom.totalClusters) * 100.0f;
+    swprintf_s(completeMsg, L"Carving complete: %llu files found (%.1f%% scanned)",
+               result.filesFound, percentScanned);
+    onProgress(completeMsg, 1.0f);
+
+    return result;
+}
+
+std::vector<ClusterRange> FileCarver::PlanBatches(
+    const CarvingOptions& options,
+    uint64_t startLCN,
+    uint64_t maxLCN)
+{
+    std::vector<ClusterRange> ranges;
+    const ClusterBitmap* allocated = options.allocatedClusters;
+
+    auto addRange = [&ranges](uint64_t start, uint64_t end) {
+        if (start >= end) return;
+        if (!ranges.empty()) {
+            uint64_t lastEnd = ranges.back().start + ranges.back().count;
+            if (start - lastEnd < Constants::Carving::ALLOCATED_GAP_CLUSTERS) {
+                ranges.back().count = end - ranges.back().start;
+                return;
+            }
+        }
+        ranges.push_back({ start, end - start });
+    };
+
+    if (allocated == nullptr || allocated->Empty()) {
+        addRange(startLCN, maxLCN);
+    } else {
+        // Clusters past the end of the map are unknown and scanned as free
+        uint64_t mapEnd = std::min(maxLCN, allocated->TotalClusters());
+        uint64_t pos = startLCN;
+        while (pos < mapEnd) {
+            uint64_t freeStart = allocated->NextClear(pos, mapEnd);
+            if (freeStart >= mapEnd) break;
+            uint64_t freeEnd = allocated->NextSet(freeStart, mapEnd);
+            addRange(freeStart, freeEnd);
+            pos = freeEnd;
+        }
+        addRange(std::max(startLCN, mapEnd), maxLCN);
+    }
+
+    const uint64_t batchSize = std::max<uint64_t>(options.batchClusters, 1);
+    std::vector<ClusterRange> batches;
+    for (const auto& range : ranges) {
+        for (uint64_t offset = 0; offset < range.count; offset += batchSize) {
+            batches.push_back({ range.start + offset, std::min(batchSize, range.count - offset) });
+        }
+    }
+    return batches;
+}
+
+void FileCarver::CarveBatchesSequential(
+    VolumeReader& reader,
+    const CarvingOptions& options,
+    const SignatureMatcher& matcher,
+    const std::vector<ClusterRange>& batches,
+    uint64_t maxLCN,
+    ClusterBitmap& claimed,
+    CarvingResult& result,
+    FileCallback& onFileFound,
+    ProgressCallback& onProgress,
+    std::atomic<bool>& shouldStop)
+{
+    const auto& geom = reader.Geometry();
+    const ClusterBitmap* allocated = options.allocatedClusters;
+    const uint64_t stride = ProbeStride(options, geom);
+    ClusterPrescreen prescreen(matcher, stride, options.prescreenClusters);
+
+    // Fallback reads reuse one aligned buffer instead of a fresh vector per batch
+    AlignedBuffer fallbackBuffer;
+    const auto readMode = options.unbufferedIO ? DiskHandle::ReadMode::Unbuffered
+                                               : DiskHandle::ReadMode::Cached;
+
+    uint64_t clustersTotal = 0;
+    for (const auto& planned : batches) {
+        clustersTotal += planned.count;
+    }
+    uint64_t clustersDone = 0;
+
+    for (const auto& planned : batches) {
+        if (result.filesFound >= options.maxFiles) {
+            break;
+        }
 
         if (shouldStop) {
             wchar_t stopMsg[256];
-            swprintf_s(stopMsg, L"Carving stopped: %zu files found", result.files.size());
+            swprintf_s(stopMsg, L"Carving stopped: %llu files found", result.filesFound);
             onProgress(stopMsg, 1.0f);
             break;
         }
 
-        uint64_t batchCount = std::min<uint64_t>(batchSize, maxLCN - batchStart);
+        if (options.syncClaims) {
+            options.syncClaims(claimed);
+        }
+
+        const uint64_t batchStart = planned.start;
+        const uint64_t batchCount = planned.count;
+        clustersDone += batchCount;
 
         const uint8_t* batchData = nullptr;
         uint64_t batchDataSize = 0;
-        std::vector<uint8_t> fallbackBuffer;
         bool usedMapping = false;
 
-        auto view = reader.MapClusters(batchStart, batchCount);
+        // Mapped views go through the cache manager; streaming skips them
+        // unless the image is memory-mapped, where the view costs no copy
+        VolumeReader::MappedView view = {};
+        if (!options.unbufferedIO || reader.GetDiskHandle().IsMemoryMapped()) {
+            view = reader.MapClusters(batchStart, batchCount);
+        }
 
         if (view.IsValid()) {
             batchData = view.data;
             batchDataSize = view.size;
             usedMapping = true;
         } else {
+            size_t batchBytes = static_cast<size_t>(batchCount * geom.bytesPerCluster);
+            if (fallbackBuffer.Size() < batchBytes) {
+                fallbackBuffer = AlignedBuffer(batchBytes);
+                if (!fallbackBuffer.IsValid()) {
+                    continue;
+                }
+            }
+
             try {
-                fallbackBuffer = reader.ReadClusters(batchStart, batchCount);
-                batchData = fallbackBuffer.data();
-                batchDataSize = fallbackBuffer.size();
+                batchDataSize = reader.ReadClustersInto(batchStart, batchCount,
+                                                        fallbackBuffer.Data(), fallbackBuffer.Size(),
+                                                        1, readMode);
+                batchData = fallbackBuffer.Data();
             } catch (const DiskReadError&) {
                 continue;
             }
@@ -368,9 +621,7 @@ CarvingResult FileCarver::CarveVolume(
         }
 
         uint64_t clusterInBatch = 0;
-        while (clusterInBatch < batchCount && result.files.size() < options.maxFiles) {
-            bool advancedBySkip = false;
-
+        while (clusterInBatch < batchCount && result.filesFound < options.maxFiles) {
             uint64_t currentLCN = batchStart + clusterInBatch;
             uint64_t offsetInBatch = clusterInBatch * geom.bytesPerCluster;
 
@@ -378,138 +629,658 @@ CarvingResult FileCarver::CarveVolume(
                 break;
             }
 
-            const uint8_t* clusterPtr = batchData + offsetInBatch;
-
-            for (const auto& sig : options.signatures) {
-                bool signatureMatches = false;
-
-                if (std::strcmp(sig.extension, "mp4") == 0) {
-                    if (offsetInBatch + 8 <= batchDataSize) {
-                        if (std::memcmp(clusterPtr + 4, sig.signature, sig.signatureSize) == 0) {
-                            uint32_t atomSize = (static_cast<uint32_t>(clusterPtr[0]) << 24) |
-                                              (static_cast<uint32_t>(clusterPtr[1]) << 16) |
-                                              (static_cast<uint32_t>(clusterPtr[2]) << 8) |
-                                              static_cast<uint32_t>(clusterPtr[3]);
-
-                            if (atomSize >= 8 && atomSize < 100 * 1024 * 1024) {
-                                signatureMatches = true;
-                            }
-                        }
-                    }
-                } else if (std::strcmp(sig.extension, "avi") == 0) {
-                    if (offsetInBatch + 12 <= batchDataSize) {
-                        if (std::memcmp(clusterPtr, sig.signature, sig.signatureSize) == 0 &&
-                            std::memcmp(clusterPtr + 8, "AVI ", 4) == 0) {
-                            signatureMatches = true;
-                        }
-                    }
-                } else if (std::strcmp(sig.extension, "wav") == 0) {
-                    if (offsetInBatch + 12 <= batchDataSize) {
-                        if (std::memcmp(clusterPtr, sig.signature, sig.signatureSize) == 0 &&
-                            std::memcmp(clusterPtr + 8, "WAVE", 4) == 0) {
-                            signatureMatches = true;
-                        }
-                    }
-                } else {
-                    if (offsetInBatch + sig.signatureSize <= batchDataSize) {
-                        if (std::memcmp(clusterPtr, sig.signature, sig.signatureSize) == 0) {
-                            signatureMatches = true;
-                        }
-                    }
+            // Inside a FastDedup file, possibly one found in an earlier batch
+            if (currentLCN < m_skipUntilLCN) {
+                clusterInBatch = std::min(m_skipUntilLCN, batchStart + batchCount) - batchStart;
+                continue;
+            }
+
+            // A claimed cluster can never start a new file; jump the whole run
+            if (claimed.Test(currentLCN)) {
+                uint64_t nextFree = claimed.NextClear(currentLCN, batchStart + batchCount);
+                clusterInBatch = nextFree - batchStart;
+                continue;
+            }
+
+            // Neither can live data in an allocated gap the batch reads through
+            if (allocated != nullptr && allocated->Test(currentLCN)) {
+                uint64_t nextFree = allocated->NextClear(currentLCN, batchStart + batchCount);
+                clusterInBatch = nextFree - batchStart;
+                continue;
+            }
+
+            size_t clusterBytes = static_cast<size_t>(
+                std::min<uint64_t>(geom.bytesPerCluster, batchDataSize - offsetInBatch));
+            const uint8_t* preceding = PrecedingFreeCluster(allocated, batchData, batchStart,
+                                                            clusterInBatch, geom.bytesPerCluster);
+            if (!prescreen.Admit(currentLCN, batchData + offsetInBatch, clusterBytes,
+                                 preceding, static_cast<size_t>(geom.bytesPerCluster))) {
+                clusterInBatch++;
+                continue;
+            }
+
+            // Probe the cluster head, then every stride step inside the cluster
+            uint64_t consumed = 0;
+            for (uint64_t offset = 0; offset < geom.bytesPerCluster; offset += stride) {
+                uint64_t probe = offsetInBatch + offset;
+                if (probe + 16 > batchDataSize || result.filesFound >= options.maxFiles) {
+                    break;
+                }
+
+                const FileSignature* matched = prescreen.Match(batchData + probe, batchDataSize - probe);
+                if (matched == nullptr) {
+                    continue;
+                }
+
+                consumed = ResolveHit(reader, options, currentLCN, offset, *matched,
+                                      { batchData, batchStart, batchDataSize }, maxLCN,
+                                      claimed, result, onFileFound);
+                if (consumed > 0 && options.dedupMode == DedupMode::FastDedup) {
+                    break;
                 }
+            }
+
+            if (consumed > 0 && options.dedupMode == DedupMode::FastDedup) {
+                m_skipUntilLCN = currentLCN + consumed;
+            }
+            clusterInBatch++;
+        }
+
+        if (usedMapping) {
+            reader.UnmapView(view);
+        }
+
+        ReportBatchProgress(result, options, batchStart, clustersDone, clustersTotal,
+                            geom.bytesPerCluster, onProgress);
+        CompleteBatch(options, batchStart + batchCount, claimed, result, false);
+    }
 
-                if (signatureMatches) {
-                    if (seenStartLCNs.find(currentLCN) != seenStartLCNs.end()) {
-                        continue;
-                    }
+    AddPrescreenCounts(result.stats, prescreen.Counts());
+}
 
-                    result.stats.totalSignaturesFound++;
+void FileCarver::CarveBatchesPipelined(
+    VolumeReader& reader,
+    const CarvingOptions& options,
+    const SignatureMatcher& matcher,
+    const std::vector<ClusterRange>& batches,
+    uint64_t maxLCN,
+    ClusterBitmap& claimed,
+    CarvingResult& result,
+    FileCallback& onFileFound,
+    ProgressCallback& onProgress,
+    std::atomic<bool>& shouldStop)
+{
+    // Batches are read into owned buffers: the reader's mapped window is a
+    // single shared view and cannot be held across a concurrent prefetch.
+    // A memory-mapped image is the exception - its view is the image itself.
+    struct PrefetchedBatch {
+        uint64_t startLCN = 0;
+        uint64_t clusterCount = 0;
+        AlignedBufferPool::Lease buffer;
+        VolumeReader::MappedView view = {};
+        const uint8_t* data = nullptr;
+        size_t bytesRead = 0;
+    };
+
+    if (batches.empty()) {
+        return;
+    }
 
-                    auto fileSize = ParseFileEnd(reader, currentLCN, sig);
+    const auto& geom = reader.Geometry();
+    const ClusterBitmap* allocated = options.allocatedClusters;
+    const size_t workerCount = options.workerThreads;
+    const uint64_t stride = ProbeStride(options, geom);
+
+    uint64_t largestBatch = 0;
+    uint64_t clustersTotal = 0;
+    for (const auto& planned : batches) {
+        largestBatch = std::max(largestBatch, planned.count);
+        clustersTotal += planned.count;
+    }
+    uint64_t clustersDone = 0;
+
+    // Two batch buffers circulate: one being scanned, one being filled
+    const uint64_t batchBytes = largestBatch * geom.bytesPerCluster;
+    AlignedBufferPool batchPool(2 * (batchBytes + Constants::ALLOCATION_GRANULARITY));
+
+    const auto readMode = options.unbufferedIO ? DiskHandle::ReadMode::Unbuffered
+                                               : DiskHandle::ReadMode::Cached;
+
+    auto fetchBatch = [&reader, &batchPool, &geom, readMode](uint64_t lcn, uint64_t count) {
+        PrefetchedBatch batch;
+        batch.startLCN = lcn;
+        batch.clusterCount = count;
+
+        if (reader.GetDiskHandle().IsMemoryMapped()) {
+            batch.view = reader.MapClusters(lcn, count);
+            if (batch.view.IsValid()) {
+                batch.data = batch.view.data;
+                batch.bytesRead = static_cast<size_t>(batch.view.size);
+                return batch;
+            }
+        }
 
-                    if (fileSize.has_value() && fileSize.value() > 0) {
-                        seenStartLCNs.insert(currentLCN);
+        batch.buffer = batchPool.Acquire(static_cast<size_t>(count * geom.bytesPerCluster));
+        if (!batch.buffer.IsValid()) {
+            return batch;
+        }
+        try {
+            batch.bytesRead = reader.ReadClustersInto(lcn, count, batch.buffer.Data(),
+                                                      batch.buffer.Size(),
+                                                      Constants::ASYNC_QUEUE_DEPTH, readMode);
+            batch.data = batch.buffer.Data();
+        } catch (const DiskReadError&) {
+            batch.bytesRead = 0;
+        }
+        return batch;
+    };
 
-                        CarvedFile carved;
-                        carved.signature = sig;
-                        carved.startLCN = currentLCN;
-                        carved.fileSize = fileSize.value();
+    std::future<PrefetchedBatch> pending = std::async(std::launch::async, fetchBatch,
+        batches[0].start, batches[0].count);
 
-                        carved.fragments = FragmentMap(geom.bytesPerCluster);
-                        uint64_t clustersNeeded = (fileSize.value() + geom.bytesPerCluster - 1) / geom.bytesPerCluster;
-                        carved.fragments.AddRun(currentLCN, clustersNeeded);
-                        carved.fragments.SetTotalSize(fileSize.value());
+    std::vector<SignatureHit> hits;
 
-                        result.stats.filesWithKnownSize++;
-                        result.stats.byFormat[sig.extension]++;
+    for (size_t batchIndex = 0; batchIndex < batches.size(); ++batchIndex) {
+        if (result.filesFound >= options.maxFiles) {
+            break;
+        }
 
-                        onFileFound(carved);
-                        result.files.push_back(carved);
+        if (shouldStop) {
+            wchar_t stopMsg[256];
+            swprintf_s(stopMsg, L"Carving stopped: %llu files found", result.filesFound);
+            onProgress(stopMsg, 1.0f);
+            break;
+        }
 
-                        if (options.dedupMode == DedupMode::FastDedup) {
-                            for (uint64_t i = 1; i < clustersNeeded && (currentLCN + i) < maxLCN; i++) {
-                                seenStartLCNs.insert(currentLCN + i);
-                            }
-                            clusterInBatch += clustersNeeded;
-                            advancedBySkip = true;
-                        }
-                    }
+        PrefetchedBatch batch = pending.get();
+        clustersDone += batch.clusterCount;
 
-                    break;
+        if (options.syncClaims) {
+            options.syncClaims(claimed);
+        }
+
+        // Kick off the next read before scanning so disk and CPU overlap
+        if (batchIndex + 1 < batches.size()) {
+            pending = std::async(std::launch::async, fetchBatch,
+                batches[batchIndex + 1].start, batches[batchIndex + 1].count);
+        }
+
+        if (batch.bytesRead > 0) {
+            const uint8_t* batchData = batch.data;
+            const uint64_t batchDataSize = batch.bytesRead;
+
+            // Same cut-off as the sequential loop: a cluster head needs 16 bytes
+            uint64_t scanClusters = batchDataSize >= 16
+                ? std::min<uint64_t>(batch.clusterCount,
+                                     (batchDataSize - 16) / geom.bytesPerCluster + 1)
+                : 0;
+
+            // Workers scan disjoint slices; concatenating them in slice
+            // order keeps the hit list sorted by LCN. They read the claim
+            // bitmap as it stood at the batch start; nothing writes it until
+            // every slice is done.
+            size_t sliceCount = static_cast<size_t>(
+                std::min<uint64_t>(workerCount, std::max<uint64_t>(scanClusters, 1)));
+            uint64_t clustersPerSlice = (scanClusters + sliceCount - 1) / sliceCount;
+
+            struct SliceScan {
+                std::vector<SignatureHit> hits;
+                PrescreenCounts counts;
+            };
+
+            std::vector<std::future<SliceScan>> futures;
+            for (size_t t = 0; t < sliceCount; ++t) {
+                uint64_t first = t * clustersPerSlice;
+                uint64_t end = std::min(first + clustersPerSlice, scanClusters);
+                if (first >= end) break;
+
+                futures.push_back(std::async(std::launch::async,
+                    [&matcher, &options, allocated, &claimed, batchData, batchDataSize, &batch, first, end, &geom, stride]() {
+                        SliceScan scan;
+                        ScanBatchSlice(matcher, options.prescreenClusters, allocated, claimed, batchData,
+                                       batchDataSize, batch.startLCN, first, end, geom.bytesPerCluster,
+                                       stride, scan.hits, scan.counts);
+                        return scan;
+                    }));
+            }
+
+            hits.clear();
+            for (auto& future : futures) {
+                auto scan = future.get();
+                hits.insert(hits.end(), scan.hits.begin(), scan.hits.end());
+                AddPrescreenCounts(result.stats, scan.counts);
+            }
+
+            // Resolve serially in LCN order so dedup matches the sequential path:
+            // a FastDedup skip simply shadows the hits that fall inside the file.
+            // Only this thread writes the claim bitmap.
+            for (const auto& hit : hits) {
+                if (result.filesFound >= options.maxFiles) break;
+                if (hit.lcn < m_skipUntilLCN) continue;
+
+                uint64_t consumed = ResolveHit(reader, options, hit.lcn, hit.offset, *hit.signature,
+                                               { batchData, batch.startLCN, batchDataSize },
+                                               maxLCN, claimed, result, onFileFound);
+
+                if (consumed > 0 && options.dedupMode == DedupMode::FastDedup) {
+                    m_skipUntilLCN = hit.lcn + consumed;
                 }
             }
+        }
 
-            if (!advancedBySkip) {
-                clusterInBatch++;
+        ReportBatchProgress(result, options, batch.startLCN, clustersDone, clustersTotal,
+                            geom.bytesPerCluster, onProgress);
+        CompleteBatch(options, batch.startLCN + batch.clusterCount, claimed, result, false);
+    }
+
+    // Never leave a read in flight against the caller's reader
+    if (pending.valid()) {
+        pending.wait();
+    }
+}
+
+void FileCarver::ScanBatchSlice(
+    const SignatureMatcher& matcher,
+    bool prescreen,
+    const ClusterBitmap* allocated,
+    const ClusterBitmap& claimed,
+    const uint8_t* batchData,
+    uint64_t batchDataSize,
+    uint64_t batchStartLCN,
+    uint64_t firstCluster,
+    uint64_t endCluster,
+    uint64_t bytesPerCluster,
+    uint64_t stride,
+    std::vector<SignatureHit>& hits,
+    PrescreenCounts& counts)
+{
+    Perf::ScopedTimer timer(Perf::Timer::SignatureScan);
+    ClusterPrescreen screen(matcher, stride, prescreen);
+
+    for (uint64_t cluster = firstCluster; cluster < endCluster; ++cluster) {
+        uint64_t offsetInBatch = cluster * bytesPerCluster;
+        if (offsetInBatch + 16 > batchDataSize) {
+            break;
+        }
+
+        // Skipped exactly as the sequential loop does: claimed runs, then
+        // allocated gaps inside a coalesced batch (live data only)
+        uint64_t lcn = batchStartLCN + cluster;
+        if (claimed.Test(lcn)) {
+            cluster = claimed.NextClear(lcn, batchStartLCN + endCluster) - batchStartLCN - 1;
+            continue;
+        }
+        if (allocated != nullptr && allocated->Test(lcn)) {
+            cluster = allocated->NextClear(lcn, batchStartLCN + endCluster) - batchStartLCN - 1;
+            continue;
+        }
+
+        size_t clusterBytes = static_cast<size_t>(std::min(bytesPerCluster, batchDataSize - offsetInBatch));
+        const uint8_t* preceding = PrecedingFreeCluster(allocated, batchData, batchStartLCN, cluster,
+                                                        bytesPerCluster);
+        if (!screen.Admit(lcn, batchData + offsetInBatch, clusterBytes,
+                          preceding, static_cast<size_t>(bytesPerCluster))) {
+            continue;
+        }
+
+        // Hits stay in (cluster, offset) order, matching the sequential probe order
+        for (uint64_t offset = 0; offset < bytesPerCluster; offset += stride) {
+            uint64_t probe = offsetInBatch + offset;
+            if (probe + 16 > batchDataSize) {
+                break;
+            }
+
+            const FileSignature* matched = screen.Match(batchData + probe, batchDataSize - probe);
+            if (matched != nullptr) {
+                hits.push_back({ lcn, offset, matched });
             }
         }
+    }
 
-        if (usedMapping) {
-            reader.UnmapView(view);
+    counts = screen.Counts();
+}
+
+const uint8_t* FileCarver::PrecedingFreeCluster(
+    const ClusterBitmap* allocated,
+    const uint8_t* batchData,
+    uint64_t batchStartLCN,
+    uint64_t clusterInBatch,
+    uint64_t bytesPerCluster)
+{
+    // A batch start or an allocated neighbour begins a new region for every
+    // slice layout alike
+    if (clusterInBatch == 0) {
+        return nullptr;
+    }
+    if (allocated != nullptr && allocated->Test(batchStartLCN + clusterInBatch - 1)) {
+        return nullptr;
+    }
+    return batchData + (clusterInBatch - 1) * bytesPerCluster;
+}
+
+void FileCarver::AddPrescreenCounts(CarvingStatistics& stats, const PrescreenCounts& counts) {
+    stats.zeroClusters += counts.zeroClusters;
+    stats.uniformClusters += counts.uniformClusters;
+    stats.highEntropyClusters += counts.highEntropyClusters;
+    stats.weakHitsSuppressed += counts.weakHitsSuppressed;
+}
+
+uint64_t FileCarver::ProbeStride(const CarvingOptions& options, const VolumeGeometry& geom) {
+    if (options.scanStride == 0 || options.scanStride >= geom.bytesPerCluster) {
+        return geom.bytesPerCluster;
+    }
+
+    // Recovery addresses whole sectors, so probes never split one
+    uint64_t sector = geom.sectorSize > 0 ? geom.sectorSize : Constants::SECTOR_SIZE_DEFAULT;
+    uint64_t stride = std::max(sector, options.scanStride / sector * sector);
+    return (geom.bytesPerCluster % stride == 0) ? stride : sector;
+}
+
+uint64_t FileCarver::ResolveHit(
+    VolumeReader& reader,
+    const CarvingOptions& options,
+    uint64_t lcn,
+    uint64_t offset,
+    const FileSignature& sig,
+    const BatchView& view,
+    uint64_t maxLCN,
+    ClusterBitmap& claimed,
+    CarvingResult& result,
+    FileCallback& onFileFound)
+{
+    const auto& geom = reader.Geometry();
+    uint64_t startByte = lcn * geom.bytesPerCluster + offset;
+
+    if (options.dedupMode == DedupMode::ForensicBounded) {
+        // Hits arrive in disk order, so a container the scan has passed is done
+        while (!m_openContainers.empty() && m_openContainers.back().endByte <= startByte) {
+            m_openContainers.pop_back();
         }
+    }
+
+    // A claimed cluster cannot start another file, but the forensic modes
+    // still report signatures embedded further in, unless a container's
+    // spent budget is what claimed it
+    if (claimed.Test(lcn)) {
+        bool budgetSpent = !m_openContainers.empty() &&
+                           m_openContainers.back().nestedParses >= Constants::Carving::MAX_NESTED_PARSES;
+        if (offset == 0 || options.dedupMode == DedupMode::FastDedup || budgetSpent) {
+            return 0;
+        }
+    }
+
+    result.stats.totalSignaturesFound++;
+    Perf::Add(Perf::Counter::SignatureHits);
+
+    uint64_t scanLimit = UINT64_MAX;
+
+    if (options.dedupMode == DedupMode::ForensicBounded) {
+        if (!m_openContainers.empty()) {
+            OpenContainer& container = m_openContainers.back();
+            if (container.nestedParses >= Constants::Carving::MAX_NESTED_PARSES) {
+                // Budget spent: claim the container's remaining whole clusters so the scan skips them
+                uint64_t endLCN = std::min(container.endByte / geom.bytesPerCluster, maxLCN);
+                if (endLCN > lcn) {
+                    claimed.SetRange(lcn, endLCN - lcn);
+                }
+                result.stats.nestedParsesSkipped++;
+                return 0;
+            }
 
-        if ((batchStart % Constants::Progress::CARVING_INTERVAL) == 0 || result.files.size() >= options.maxFiles) {
-            float progress = static_cast<float>(batchStart - startLCN) / (maxLCN - startLCN);
-            float percentDone = progress * 100.0f;
-            float gbProcessed = ((batchStart - startLCN) * geom.bytesPerCluster) / 1000000000.0f;
-            float gbTotal = ((maxLCN - startLCN) * geom.bytesPerCluster) / 1000000000.0f;
+            // A nested file cannot outlast its container
+            container.nestedParses++;
+            scanLimit = container.endByte - startByte;
+        }
+    }
 
-            wchar_t statusMsg[256];
-            swprintf_s(statusMsg, L"Carving: %.1f%% (%.2f / %.2f GB) - %zu files found",
-                      percentDone, gbProcessed, gbTotal, result.files.size());
-            onProgress(statusMsg, progress);
+    std::optional<uint64_t> fileSize;
+    {
+        Perf::ScopedTimer timer(Perf::Timer::EndParse);
+
+        // Structured formats are walked strictly instead: a file that leaves
+        // its run partway is deferred to the gap-carving pass
+        if (options.gapCarving && offset == 0 && scanLimit == UINT64_MAX && BifragmentCarver::Supports(sig)) {
+            uint64_t volumeBytes = geom.totalClusters * geom.bytesPerCluster;
+            SequentialReader walker(reader.GetDiskHandle(), geom.volumeStartOffset + startByte,
+                                    std::min(Constants::MAX_FILE_SCAN_SIZE, volumeBytes - startByte),
+                                    geom.sectorSize);
+            walker.SetWindow(view.data, geom.volumeStartOffset + view.startLCN * geom.bytesPerCluster, view.size);
+            auto validation = BifragmentCarver::Validate(sig, walker);
+
+            if (validation.outcome == BifragmentCarver::Outcome::Complete) {
+                fileSize = validation.endByte;
+            } else {
+                fileSize = ParseFileEnd(reader, startByte, sig, view, scanLimit);
+                auto candidate = BifragmentCarver::MakeCandidate(sig, lcn, geom.bytesPerCluster,
+                                                                 validation, fileSize);
+                if (candidate.has_value()) {
+                    result.stats.potentiallyFragmented++;
+                    result.stats.fragmentedByFormat[sig.extension]++;
+                    m_fragmentCandidates.push_back(std::move(candidate.value()));
+                    // Everything before the break is this file's; nothing is
+                    // claimed until the second pass decides where it ends, so
+                    // the FastDedup skip (kept across batches) shields it
+                    return m_fragmentCandidates.back().maxSplit;
+                }
+            }
+        } else {
+            fileSize = ParseFileEnd(reader, startByte, sig, view, scanLimit);
         }
     }
+    if (!fileSize.has_value() || fileSize.value() == 0) {
+        return 0;
+    }
 
-    result.stats.clustersScanned = maxLCN - startLCN;
+    if (options.dedupMode == DedupMode::ForensicBounded) {
+        m_openContainers.push_back({ startByte + fileSize.value(), 0 });
+    }
 
-    wchar_t completeMsg[256];
-    float percentScanned = (static_cast<float>(maxLCN - startLCN) / geom.totalClusters) * 100.0f;
-    swprintf_s(completeMsg, L"Carving complete: %zu files found (%.1f%% scanned)",
-               result.files.size(), percentScanned);
-    onProgress(completeMsg, 1.0f);
+    // Only a cluster-aligned file owns its first cluster outright
+    if (offset == 0) {
+        claimed.Set(lcn);
+    }
 
-    return result;
+    CarvedFile carved;
+    carved.signature = sig;
+    carved.startLCN = lcn;
+    carved.startOffset = offset;
+    carved.fileSize = fileSize.value();
+
+    uint64_t clustersNeeded = (offset + fileSize.value() + geom.bytesPerCluster - 1) / geom.bytesPerCluster;
+    if (offset == 0) {
+        carved.fragments = FragmentMap(geom.bytesPerCluster);
+        carved.fragments.AddRun(lcn, clustersNeeded);
+    } else {
+        // Cluster runs cannot start mid-cluster; describe the file in sectors
+        carved.fragments = FragmentMap(geom.sectorSize);
+        carved.fragments.AddRun(startByte / geom.sectorSize,
+                                (fileSize.value() + geom.sectorSize - 1) / geom.sectorSize);
+    }
+    carved.fragments.SetTotalSize(fileSize.value());
+
+    PublishFile(carved, options, result, onFileFound);
+
+    if (options.dedupMode == DedupMode::FastDedup) {
+        claimed.SetRange(lcn + 1, std::min<uint64_t>(clustersNeeded, maxLCN - lcn) - 1);
+    }
+
+    return clustersNeeded;
 }
 
-std::optional<uint64_t> FileCarver::ParseFileEnd(
+void FileCarver::PublishFile(
+    const CarvedFile& carved,
+    const CarvingOptions& options,
+    CarvingResult& result,
+    FileCallback& onFileFound)
+{
+    result.stats.filesWithKnownSize++;
+    result.stats.byFormat[carved.signature.extension]++;
+
+    onFileFound(carved);
+    result.filesFound++;
+    if (options.retainFiles) {
+        result.files.push_back(carved);
+    }
+    Perf::Add(Perf::Counter::FilesCarved);
+}
+
+void FileCarver::CarveFragmentedCandidates(
     VolumeReader& reader,
-    uint64_t startLCN,
-    const FileSignature& sig)
+    const CarvingOptions& options,
+    uint64_t maxLCN,
+    ClusterBitmap& claimed,
+    CarvingResult& result,
+    FileCallback& onFileFound,
+    ProgressCallback& onProgress,
+    std::atomic<bool>& shouldStop)
 {
     const auto& geom = reader.Geometry();
+    const size_t candidateCount = m_fragmentCandidates.size();
+
+    wchar_t startMsg[256];
+    swprintf_s(startMsg, L"Gap carving: %zu fragmented candidates", candidateCount);
+    onProgress(startMsg, 1.0f);
+
+    // The certain first fragments are reserved so no search lands in them
+    if (options.syncClaims) {
+        options.syncClaims(claimed);
+    }
+    for (const auto& candidate : m_fragmentCandidates) {
+        claimed.SetRange(candidate.startLCN, std::min(candidate.minSplit, maxLCN - candidate.startLCN));
+    }
+
+    // Searches only read; the claim map stays untouched until all are done
+    std::vector<std::optional<CarvedFile>> resolved(candidateCount);
+    if (!shouldStop) {
+        BifragmentCarver gapCarver(reader, claimed, options.allocatedClusters, maxLCN);
+        std::atomic<size_t> nextCandidate{ 0 };
+        size_t workerCount = std::max<size_t>(1, std::min(options.workerThreads, candidateCount));
+
+        std::vector<std::future<void>> workers;
+        for (size_t t = 0; t < workerCount; ++t) {
+            workers.push_back(std::async(std::launch::async, [&]() {
+                for (size_t i = nextCandidate++; i < candidateCount && !shouldStop; i = nextCandidate++) {
+                    resolved[i] = gapCarver.Resolve(m_fragmentCandidates[i]);
+                }
+            }));
+        }
+        for (auto& worker : workers) {
+            worker.get();
+        }
+    }
+
+    // Publish in disk order; a continuation another file already took
+    // falls back like an unresolved candidate
+    for (size_t i = 0; i < candidateCount && result.filesFound < options.maxFiles; ++i) {
+        const FragmentCandidate& candidate = m_fragmentCandidates[i];
+
+        if (resolved[i].has_value()) {
+            const ClusterRun& second = resolved[i]->fragments.GetRuns()[1];
+            if (claimed.NextSet(second.startCluster, second.startCluster + second.clusterCount) >=
+                second.startCluster + second.clusterCount) {
+                for (const auto& run : resolved[i]->fragments.GetRuns()) {
+                    claimed.SetRange(run.startCluster, run.clusterCount);
+                }
+                result.stats.bifragmentsRecovered++;
+                PublishFile(resolved[i].value(), options, result, onFileFound);
+                continue;
+            }
+        }
+
+        // As the contiguous carver would have reported it
+        result.stats.severelyFragmented++;
+        if (!candidate.contiguousSize.has_value() || candidate.contiguousSize.value() == 0) {
+            continue;
+        }
+
+        CarvedFile carved;
+        carved.signature = candidate.signature;
+        carved.startLCN = candidate.startLCN;
+        carved.startOffset = 0;
+        carved.fileSize = candidate.contiguousSize.value();
+
+        uint64_t clustersNeeded = std::min((carved.fileSize + geom.bytesPerCluster - 1) / geom.bytesPerCluster,
+                                           maxLCN - candidate.startLCN);
+        carved.fragments = FragmentMap(geom.bytesPerCluster);
+        carved.fragments.AddRun(candidate.startLCN, clustersNeeded);
+        carved.fragments.SetTotalSize(carved.fileSize);
+        claimed.SetRange(candidate.startLCN, clustersNeeded);
+
+        PublishFile(carved, options, result, onFileFound);
+    }
+
+    m_fragmentCandidates.clear();
+}
+
+void FileCarver::CompleteBatch(
+    const CarvingOptions& options,
+    uint64_t resumeLCN,
+    const ClusterBitmap& claimed,
+    const CarvingResult& result,
+    bool force)
+{
+    // A batch cut short by the file limit was not carved to its end
+    if (result.filesFound >= options.maxFiles) {
+        return;
+    }
+
+    // Deferred candidates are not in the checkpoint yet; resuming must find them again
+    if (!m_fragmentCandidates.empty()) {
+        resumeLCN = std::min(resumeLCN, m_fragmentCandidates.front().startLCN);
+    }
+
+    m_resumeLCN = std::max(m_resumeLCN, resumeLCN);
+    if (!options.onCheckpoint) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (force || now - m_lastCheckpoint >= options.checkpointInterval) {
+        options.onCheckpoint(m_resumeLCN, claimed, result.files);
+        m_lastCheckpoint = now;
+    }
+}
 
-    uint64_t maxScanSize = std::min<uint64_t>(
-        Constants::MAX_FILE_SCAN_SIZE,
-        (geom.totalClusters - startLCN) * geom.bytesPerCluster
-    );
+void FileCarver::ReportBatchProgress(
+    const CarvingResult& result,
+    const CarvingOptions& options,
+    uint64_t batchStart,
+    uint64_t clustersDone,
+    uint64_t clustersTotal,
+    uint64_t bytesPerCluster,
+    ProgressCallback& onProgress)
+{
+    if ((batchStart % Constants::Progress::CARVING_INTERVAL) == 0 || result.filesFound >= options.maxFiles) {
+        float progress = static_cast<float>(clustersDone) / clustersTotal;
+        float percentDone = progress * 100.0f;
+        float gbProcessed = (clustersDone * bytesPerCluster) / 1000000000.0f;
+        float gbTotal = (clustersTotal * bytesPerCluster) / 1000000000.0f;
+
+        wchar_t statusMsg[256];
+        swprintf_s(statusMsg, L"Carving: %.1f%% (%.2f / %.2f GB) - %llu files found",
+                  percentDone, gbProcessed, gbTotal, result.filesFound);
+        onProgress(statusMsg, progress);
+    }
+}
 
-    FragmentMap fragments(geom.bytesPerCluster);
-    uint64_t estimatedClusters = maxScanSize / geom.bytesPerCluster;
-    fragments.AddRun(startLCN, estimatedClusters);
-    fragments.SetTotalSize(maxScanSize);
+std::optional<uint64_t> FileCarver::ParseFileEnd(
+    VolumeReader& reader,
+    uint64_t startByte,
+    const FileSignature& sig,
+    const BatchView& view,
+    uint64_t scanLimit)
+{
+    const auto& geom = reader.Geometry();
 
-    SequentialReader seqReader(reader.GetDiskHandle(), std::move(fragments), geom.sectorSize, geom.volumeStartOffset);
+    uint64_t volumeBytes = geom.totalClusters * geom.bytesPerCluster;
+    if (startByte >= volumeBytes) {
+        return std::nullopt;
+    }
+    uint64_t maxScanSize = std::min<uint64_t>({ Constants::MAX_FILE_SCAN_SIZE, volumeBytes - startByte, scanLimit });
+
+    SequentialReader seqReader(reader.GetDiskHandle(), geom.volumeStartOffset + startByte,
+                               maxScanSize, geom.sectorSize);
+    seqReader.SetWindow(view.data, geom.volumeStartOffset + view.startLCN * geom.bytesPerCluster, view.size);
 
     if (std::strcmp(sig.extension, "jpg") == 0) {
         return ParseJpegEnd(seqReader);
@@ -554,17 +1325,11 @@ std::optional<uint64_t> FileCarver::ParseJpegEnd(SequentialReader& reader) {
     constexpr uint8_t RST7_MARKER = 0xD7;
 
     while (!reader.AtEOF()) {
-        if (reader.Read(tmp, 2) != 2) {
+        // Resynchronise on the next 0xFF; the byte after it is the marker
+        if (!reader.SkipTo(0xFF) || reader.Read(tmp, 2) != 2) {
             return std::nullopt;
         }
 
-        while (tmp[0] != 0xFF) {
-            tmp[0] = tmp[1];
-            if (!reader.ReadByte(tmp[1])) {
-                return std::nullopt;
-            }
-        }
-
         uint8_t marker = tmp[1];
 
         if (marker == 0x00) {
@@ -599,36 +1364,34 @@ std::optional<uint64_t> FileCarver::ParseJpegEnd(SequentialReader& reader) {
         }
 
         if (marker == SOS_MARKER) {
+            // Entropy-coded data: only 0xFF can introduce a marker
             while (!reader.AtEOF()) {
-                uint8_t byte;
-                if (!reader.ReadByte(byte)) {
+                if (!reader.SkipTo(0xFF) || !reader.Skip(1)) {
                     return std::nullopt;
                 }
 
-                if (byte == 0xFF) {
-                    uint8_t nextByte;
-                    if (!reader.ReadByte(nextByte)) {
-                        return std::nullopt;
-                    }
-
-                    if (nextByte == 0x00) {
-                        continue;
-                    }
+                uint8_t nextByte;
+                if (!reader.ReadByte(nextByte)) {
+                    return std::nullopt;
+                }
 
-                    if (nextByte >= RST0_MARKER && nextByte <= RST7_MARKER) {
-                        continue;
-                    }
+                if (nextByte == 0x00) {
+                    continue;
+                }
 
-                    if (nextByte == 0xFF) {
-                        continue;
-                    }
+                if (nextByte >= RST0_MARKER && nextByte <= RST7_MARKER) {
+                    continue;
+                }
 
-                    if (nextByte == EOI_MARKER) {
-                        return reader.Position();
-                    }
+                if (nextByte == 0xFF) {
+                    continue;
+                }
 
-                    break;
+                if (nextByte == EOI_MARKER) {
+                    return reader.Position();
                 }
+
+                break;
             }
         }
     }
@@ -691,19 +1454,13 @@ std::optional<uint64_t> FileCarver::ParsePdfEnd(SequentialReader& reader) {
 
     constexpr uint64_t MAX_PDF_SIZE = 64 * 1024 * 1024;
 
+    // Incremental updates append trailers; the last %%EOF ends the file
+    static const uint8_t EOF_MARKER[] = { '%', '%', 'E', 'O', 'F' };
     uint64_t lastEofPos = 0;
-    uint8_t searchBuf[5] = {0};
 
-    while (!reader.AtEOF() && reader.Position() < MAX_PDF_SIZE) {
-        std::memmove(searchBuf, searchBuf + 1, 4);
-
-        if (!reader.ReadByte(searchBuf[4])) {
-            break;
-        }
-
-        if (std::memcmp(searchBuf, "%%EOF", 5) == 0) {
-            lastEofPos = reader.Position();
-        }
+    while (reader.FindNext(EOF_MARKER, sizeof(EOF_MARKER), MAX_PDF_SIZE)) {
+        lastEofPos = reader.Position() + sizeof(EOF_MARKER);
+        reader.Skip(sizeof(EOF_MARKER));
     }
 
     if (lastEofPos > 0) {
@@ -727,20 +1484,13 @@ std::optional<uint64_t> FileCarver::ParseZipEnd(SequentialReader& reader) {
 
     constexpr uint64_t MAX_ZIP_SIZE = 100 * 1024 * 1024;
 
-    uint8_t searchBuf[4] = {0};
+    // Last end-of-central-directory record wins
+    static const uint8_t EOCD_SIG[] = { 0x50, 0x4B, 0x05, 0x06 };
     uint64_t eocdPos = 0;
 
-    while (!reader.AtEOF() && reader.Position() < MAX_ZIP_SIZE) {
-        std::memmove(searchBuf, searchBuf + 1, 3);
-
-        if (!reader.ReadByte(searchBuf[3])) {
-            break;
-        }
-
-        if (searchBuf[0] == 0x50 && searchBuf[1] == 0x4B &&
-            searchBuf[2] == 0x05 && searchBuf[3] == 0x06) {
-            eocdPos = reader.Position() - 4;
-        }
+    while (reader.FindNext(EOCD_SIG, sizeof(EOCD_SIG), MAX_ZIP_SIZE)) {
+        eocdPos = reader.Position();
+        reader.Skip(sizeof(EOCD_SIG));
     }
 
     if (eocdPos > 0) {
@@ -845,15 +1595,9 @@ std::optional<uint64_t> FileCarver::ParseGifEnd(SequentialReader& reader) {
 
     constexpr uint64_t MAX_GIF_SIZE = 50 * 1024 * 1024;
 
-    uint8_t byte;
-    while (!reader.AtEOF() && reader.Position() < MAX_GIF_SIZE) {
-        if (!reader.ReadByte(byte)) {
-            break;
-        }
-
-        if (byte == 0x3B) {
-            return reader.Position();
-        }
+    // Trailer byte
+    if (reader.SkipTo(0x3B, MAX_GIF_SIZE)) {
+        return reader.Position() + 1;
     }
 
     return std::nullopt;
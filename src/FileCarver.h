@@ -9,10 +9,16 @@
 #include "VolumeReader.h"
 #include "FileSignatures.h"
 #include "FragmentedFile.h"
+#include "SignatureMatcher.h"
+#include "ClusterClassifier.h"
+#include "ClusterBitmap.h"
+#include "AlignedBufferPool.h"
 #include <vector>
 #include <functional>
 #include <atomic>
+#include <chrono>
 #include <map>
+#include <optional>
 #include <string>
 
 namespace KVC {
@@ -26,11 +32,20 @@ public:
     SequentialReader(DiskHandle& disk, const FragmentMap& fragments, uint64_t sectorSize, uint64_t volumeStartOffset = 0);
     SequentialReader(DiskHandle& disk, FragmentMap&& fragments, uint64_t sectorSize, uint64_t volumeStartOffset = 0);
     
+    // Serve linear reads that land inside an already-resident copy of the
+    // disk (the carving batch) straight from that memory, without I/O
+    void SetWindow(const uint8_t* data, uint64_t diskOffset, uint64_t size);
+
     bool ReadByte(uint8_t& byte);
     bool Peek(uint8_t& byte);
     size_t Read(uint8_t* buffer, size_t count);
     bool Skip(uint64_t count);
     bool Seek(uint64_t position);
+
+    // Bulk searches: the position lands on the match; false if none starts
+    // (or, for FindNext, fits) before limit
+    bool SkipTo(uint8_t value, uint64_t limit = UINT64_MAX);
+    bool FindNext(const uint8_t* pattern, size_t length, uint64_t limit = UINT64_MAX);
     
     uint64_t Position() const { return m_position; }
     uint64_t MaxSize() const { return m_maxSize; }
@@ -38,9 +53,11 @@ public:
     std::optional<uint64_t> TranslatePositionToDisk() const;
 
 private:
-    void FillBuffer();
-    void FillBufferLinear();
+    void FillBuffer(bool useWindow = true);
+    void FillBufferLinear(bool useWindow);
     void FillBufferFragmented();
+    bool EnsureBuffer();
+    size_t ReadAt(uint64_t diskOffset, uint8_t* dest, size_t toRead);
     
     static constexpr size_t BUFFER_SIZE = 65536;
     
@@ -52,10 +69,15 @@ private:
     uint64_t m_volumeStartOffset;
     bool m_fragmentMode;
     FragmentMap m_fragments;
-    std::vector<uint8_t> m_buffer;
+    AlignedBufferPool::Lease m_buffer;  // BUFFER_SIZE + sector slack, pooled on first disk read
+    const uint8_t* m_data;              // Current bytes: m_buffer or the window
+    const uint8_t* m_window;
+    uint64_t m_windowOffset;
+    uint64_t m_windowSize;
     size_t m_bufferPos;
     size_t m_bufferValid;
     uint64_t m_bufferFileOffset;
+    size_t m_runHint;                   // Run of the last fragmented read
 };
 
 // ============================================================================
@@ -63,48 +85,102 @@ private:
 // ============================================================================
 
 enum class DedupMode {
-    FastDedup,
-    ForensicFull
+    FastDedup,          // Skip everything inside a recovered file
+    ForensicFull,       // Report every signature, parsing each in full
+    ForensicBounded     // Report nested signatures, parsing them only up to
+                        // the enclosing file's end and at most MAX_NESTED_PARSES per file
+};
+
+struct CarvedFile {
+    FileSignature signature;
+    uint64_t startLCN;
+    uint64_t startOffset;       // Header position inside startLCN (sub-cluster scans)
+    uint64_t fileSize;
+    FragmentMap fragments;      // Sector-unit runs when startOffset != 0
 };
 
+// A cluster-aligned file whose structure breaks before its end. The first
+// fragment ends between minSplit and maxSplit clusters after startLCN.
+struct FragmentCandidate {
+    FileSignature signature;
+    uint64_t startLCN = 0;
+    uint64_t minSplit = 0;
+    uint64_t maxSplit = 0;
+    uint64_t breakByte = 0;             // First byte that failed validation
+    bool restartMarkers = false;        // JPEG: the next RSTn locates the continuation
+    uint8_t nextRestart = 0;
+    std::optional<uint64_t> contiguousSize;  // First-pass end; published if no gap fits
+};
+
+// Resume point after fully carved batches: a pass restarted at resumeLCN
+// with the same claims finds exactly the files this one had left to find
+using CheckpointCallback = std::function<void(uint64_t resumeLCN, const ClusterBitmap& claimed,
+                                              const std::vector<CarvedFile>& files)>;
+
+// Merge claims other stages made meanwhile; runs on the carving thread
+// before each batch, the only place the claim map may change underneath
+using ClaimSyncCallback = std::function<void(ClusterBitmap& claimed)>;
+
 struct CarvingOptions {
     uint64_t maxFiles;
     uint64_t startLCN;
     uint64_t clusterLimit;
     uint64_t batchClusters;     // Clusters per batch for scanning
+    size_t workerThreads;       // >1 enables pipelined prefetch + parallel scan
     DedupMode dedupMode;
     std::vector<FileSignature> signatures;
+    ClusterBitmap* claimedClusters;  // Optional shared claim map (not owned)
+    const ClusterBitmap* allocatedClusters;  // Optional allocation map; only free space is read (not owned)
+    bool unbufferedIO;          // Stream batches past the system cache
+    uint64_t scanStride;        // Bytes between signature probes (0 = cluster starts only)
+    bool retainFiles;           // false: files only reach onFileFound, result.files stays empty
+    bool prescreenClusters;     // Skip zero/uniform clusters, drop weak magics in random runs
+    bool gapCarving;            // Second pass joins broken JPEG/ZIP files to their continuation
+    CheckpointCallback onCheckpoint;        // Optional; also called once when stopped
+    std::chrono::seconds checkpointInterval;
+    ClaimSyncCallback syncClaims;           // Optional; concurrent metadata stages
 
     CarvingOptions()
         : maxFiles(10000000)
         , startLCN(0)
         , clusterLimit(0)
         , batchClusters(65536)  // ~256MB at 4KB clusters
+        , workerThreads(1)
         , dedupMode(DedupMode::FastDedup)
+        , claimedClusters(nullptr)
+        , allocatedClusters(nullptr)
+        , unbufferedIO(false)
+        , scanStride(0)
+        , retainFiles(true)
+        , prescreenClusters(true)
+        , gapCarving(true)
+        , checkpointInterval(60)
     {}
 };
 
-struct CarvedFile {
-    FileSignature signature;
-    uint64_t startLCN;
-    uint64_t fileSize;
-    FragmentMap fragments;
-};
-
 struct CarvingStatistics {
     uint64_t totalSignaturesFound;
     uint64_t filesWithKnownSize;
     uint64_t filesWithValidatedSize;
-    uint64_t potentiallyFragmented;
-    uint64_t severelyFragmented;
+    uint64_t potentiallyFragmented; // Broke validation in the contiguous pass
+    uint64_t severelyFragmented;    // ... and no two-fragment layout validated either
+    uint64_t bifragmentsRecovered;
     uint64_t unknownSize;
     uint64_t clustersScanned;
+    uint64_t nestedParsesSkipped;   // ForensicBounded hits dropped once a file's budget ran out
+    uint64_t windowCacheHits;       // Shared read-window lookups during this pass
+    uint64_t windowCacheMisses;
+    uint64_t zeroClusters;          // Prescreen tags; zero/uniform ones are not probed
+    uint64_t uniformClusters;
+    uint64_t highEntropyClusters;
+    uint64_t weakHitsSuppressed;    // Two-byte magic matches inside high-entropy runs
     std::map<std::string, uint64_t> byFormat;
     std::map<std::string, uint64_t> fragmentedByFormat;
 };
 
 struct CarvingResult {
-    std::vector<CarvedFile> files;
+    std::vector<CarvedFile> files;      // Empty unless CarvingOptions::retainFiles
+    uint64_t filesFound = 0;            // Reported files, retained or not
     CarvingStatistics stats;
 };
 
@@ -135,10 +211,156 @@ public:
     );
 
 private:
-    std::optional<uint64_t> ParseFileEnd(
+    // A batch already in memory; end parsers read from it before the disk
+    struct BatchView {
+        const uint8_t* data = nullptr;
+        uint64_t startLCN = 0;
+        uint64_t size = 0;
+    };
+
+    // A file accepted in ForensicBounded mode that may still enclose later hits
+    struct OpenContainer {
+        uint64_t endByte;
+        uint64_t nestedParses;
+    };
+
+    struct SignatureHit {
+        uint64_t lcn;
+        uint64_t offset;        // Bytes into the cluster
+        const FileSignature* signature;
+    };
+
+    // Probe spacing inside a cluster: a sector multiple that divides the
+    // cluster, or the cluster size itself when sub-cluster scanning is off
+    static uint64_t ProbeStride(const CarvingOptions& options, const VolumeGeometry& geom);
+
+    void CarveBatchesSequential(
         VolumeReader& reader,
+        const CarvingOptions& options,
+        const SignatureMatcher& matcher,
+        const std::vector<ClusterRange>& batches,
+        uint64_t maxLCN,
+        ClusterBitmap& claimed,
+        CarvingResult& result,
+        FileCallback& onFileFound,
+        ProgressCallback& onProgress,
+        std::atomic<bool>& shouldStop
+    );
+
+    void CarveBatchesPipelined(
+        VolumeReader& reader,
+        const CarvingOptions& options,
+        const SignatureMatcher& matcher,
+        const std::vector<ClusterRange>& batches,
+        uint64_t maxLCN,
+        ClusterBitmap& claimed,
+        CarvingResult& result,
+        FileCallback& onFileFound,
+        ProgressCallback& onProgress,
+        std::atomic<bool>& shouldStop
+    );
+
+    // Split [startLCN, maxLCN) into read batches. With an allocation map only
+    // free runs are kept, and allocated gaps shorter than ALLOCATED_GAP_CLUSTERS
+    // are read through so requests stay large.
+    static std::vector<ClusterRange> PlanBatches(
+        const CarvingOptions& options,
         uint64_t startLCN,
-        const FileSignature& sig
+        uint64_t maxLCN
+    );
+
+    // Collect signature hits for clusters [firstCluster, endCluster) of a batch
+    static void ScanBatchSlice(
+        const SignatureMatcher& matcher,
+        bool prescreen,
+        const ClusterBitmap* allocated,
+        const ClusterBitmap& claimed,
+        const uint8_t* batchData,
+        uint64_t batchDataSize,
+        uint64_t batchStartLCN,
+        uint64_t firstCluster,
+        uint64_t endCluster,
+        uint64_t bytesPerCluster,
+        uint64_t stride,
+        std::vector<SignatureHit>& hits,
+        PrescreenCounts& counts
+    );
+
+    // The cluster before clusterInBatch for ClusterPrescreen::Admit, or
+    // nullptr at the batch start and after an allocated cluster
+    static const uint8_t* PrecedingFreeCluster(
+        const ClusterBitmap* allocated,
+        const uint8_t* batchData,
+        uint64_t batchStartLCN,
+        uint64_t clusterInBatch,
+        uint64_t bytesPerCluster
+    );
+
+    static void AddPrescreenCounts(CarvingStatistics& stats, const PrescreenCounts& counts);
+
+    // Parse and publish a hit; returns clusters covered from lcn (0 = rejected)
+    uint64_t ResolveHit(
+        VolumeReader& reader,
+        const CarvingOptions& options,
+        uint64_t lcn,
+        uint64_t offset,
+        const FileSignature& sig,
+        const BatchView& view,
+        uint64_t maxLCN,
+        ClusterBitmap& claimed,
+        CarvingResult& result,
+        FileCallback& onFileFound
+    );
+
+    // Count and report a file; the caller claims its clusters
+    void PublishFile(
+        const CarvedFile& carved,
+        const CarvingOptions& options,
+        CarvingResult& result,
+        FileCallback& onFileFound
+    );
+
+    // Second pass over m_fragmentCandidates: gap search in parallel, then
+    // claims and publishes in disk order. A stopped pass only publishes
+    // the contiguous fallbacks.
+    void CarveFragmentedCandidates(
+        VolumeReader& reader,
+        const CarvingOptions& options,
+        uint64_t maxLCN,
+        ClusterBitmap& claimed,
+        CarvingResult& result,
+        FileCallback& onFileFound,
+        ProgressCallback& onProgress,
+        std::atomic<bool>& shouldStop
+    );
+
+    // Record that every cluster before resumeLCN is carved; checkpoints at
+    // most once per interval unless forced
+    void CompleteBatch(
+        const CarvingOptions& options,
+        uint64_t resumeLCN,
+        const ClusterBitmap& claimed,
+        const CarvingResult& result,
+        bool force
+    );
+
+    static void ReportBatchProgress(
+        const CarvingResult& result,
+        const CarvingOptions& options,
+        uint64_t batchStart,
+        uint64_t clustersDone,
+        uint64_t clustersTotal,
+        uint64_t bytesPerCluster,
+        ProgressCallback& onProgress
+    );
+
+    // startByte is relative to the volume start
+    std::optional<uint64_t> ParseFileEnd(
+        VolumeReader& reader,
+        uint64_t startByte,
+        const FileSignature& sig,
+        const BatchView& view,
+        uint64_t scanLimit = UINT64_MAX
     );
     
     // FIXED: Made static for internal use
@@ -151,6 +373,13 @@ private:
     static std::optional<uint64_t> ParseBmpEnd(SequentialReader& reader);
     static std::optional<uint64_t> ParseAviEnd(SequentialReader& reader);
     static std::optional<uint64_t> ParseWavEnd(SequentialReader& reader);
+
+    // Innermost last; reset per CarveVolume, so one carve at a time per carver
+    std::vector<OpenContainer> m_openContainers;
+    std::vector<FragmentCandidate> m_fragmentCandidates;   // Disk order; checkpoints stop before the first
+    uint64_t m_skipUntilLCN = 0;    // FastDedup: clusters below belong to a file already resolved
+    uint64_t m_resumeLCN = 0;
+    std::chrono::steady_clock::time_point m_lastCheckpoint;
 };
 
 } // namespace KVC
\ No newline at end of file
@@ -2,9 +2,41 @@
 
 #include "FileSignatures.h"
 #include <climits>
+#include <cstring>
 
 namespace KVC {
 
+// ============================================================================
+// Header Validators
+// ============================================================================
+
+namespace {
+
+// ftyp box must be preceded by a plausible big-endian atom size
+bool ValidateMp4Header(const uint8_t* data, size_t available) {
+    if (available < 8) return false;
+    uint32_t atomSize = (static_cast<uint32_t>(data[0]) << 24) |
+                        (static_cast<uint32_t>(data[1]) << 16) |
+                        (static_cast<uint32_t>(data[2]) << 8) |
+                        static_cast<uint32_t>(data[3]);
+    return atomSize >= 8 && atomSize < 100 * 1024 * 1024;
+}
+
+// RIFF container form type lives at offset 8
+bool ValidateAviHeader(const uint8_t* data, size_t available) {
+    return available >= 12 && std::memcmp(data + 8, "AVI ", 4) == 0;
+}
+
+bool ValidateWavHeader(const uint8_t* data, size_t available) {
+    return available >= 12 && std::memcmp(data + 8, "WAVE", 4) == 0;
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// Signature Table
+// ============================================================================
+
 const FileSignature FileSignatures::PNG = {
     "png", Signatures::PNG_SIG, sizeof(Signatures::PNG_SIG), L"PNG image"
 };
@@ -54,11 +86,13 @@ const FileSignature FileSignatures::PPT = {
 };
 
 const FileSignature FileSignatures::MP4 = {
-    "mp4", Signatures::MP4_SIG, sizeof(Signatures::MP4_SIG), L"MP4 video"
+    "mp4", Signatures::MP4_SIG, sizeof(Signatures::MP4_SIG), L"MP4 video",
+    4, 8, ValidateMp4Header
 };
 
 const FileSignature FileSignatures::AVI = {
-    "avi", Signatures::AVI_SIG, sizeof(Signatures::AVI_SIG), L"AVI video"
+    "avi", Signatures::AVI_SIG, sizeof(Signatures::AVI_SIG), L"AVI video",
+    0, 12, ValidateAviHeader
 };
 
 const FileSignature FileSignatures::MKV = {
@@ -70,7 +104,8 @@ const FileSignature FileSignatures::MP3 = {
 };
 
 const FileSignature FileSignatures::WAV = {
-    "wav", Signatures::WAV_SIG, sizeof(Signatures::WAV_SIG), L"WAV audio"
+    "wav", Signatures::WAV_SIG, sizeof(Signatures::WAV_SIG), L"WAV audio",
+    0, 12, ValidateWavHeader
 };
 
 const FileSignature FileSignatures::RAR = {
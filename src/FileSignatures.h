@@ -8,16 +8,24 @@
 #pragma once
 
 #include <climits>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
 namespace KVC {
 
+// Secondary header check run after the magic bytes matched.
+// Receives the cluster head and the number of readable bytes.
+using SignatureValidator = bool (*)(const uint8_t* data, size_t available);
+
 struct FileSignature {
     const char* extension;
     const uint8_t* signature;
     size_t signatureSize;
     const wchar_t* description;
+    size_t headerOffset = 0;                // Magic bytes position relative to cluster start
+    size_t minHeaderSize = 0;               // Bytes the validator needs (0 = offset + size)
+    SignatureValidator validator = nullptr; // Optional format-specific check
 };
 
 class FileSignatures {
@@ -63,7 +63,7 @@ void FragmentMap::BuildFromClusterList(const std::vector<uint64_t>& clusters) {
 // Merge adjacent runs for better I/O performance
 void FragmentMap::Coalesce() {
     if (m_runs.size() < 2) return;
-    std::vector<ClusterRun> merged;
+    RunList merged;
     merged.reserve(m_runs.size());
     ClusterRun current = m_runs[0];
     for (size_t i = 1; i < m_runs.size(); ++i) {
@@ -110,11 +110,37 @@ bool FragmentMap::HasOverlappingRuns() const {
     return false;
 }
 
+// Location of fileOffset if it falls inside the given run
+PhysicalLocation FragmentMap::LocateInRun(size_t runIndex, uint64_t fileOffset) const {
+    const ClusterRun& run = m_runs[runIndex];
+    uint64_t runEnd = run.fileOffset + run.clusterCount * m_bytesPerCluster;
+    if (fileOffset < run.fileOffset || fileOffset >= runEnd) {
+        return PhysicalLocation::Invalid();
+    }
+
+    PhysicalLocation loc;
+    uint64_t offsetInRun = fileOffset - run.fileOffset;
+    loc.cluster = run.startCluster + (offsetInRun / m_bytesPerCluster);
+    loc.offsetInCluster = offsetInRun % m_bytesPerCluster;
+    loc.contiguousBytes = runEnd - fileOffset;
+    loc.runIndex = runIndex;
+    loc.valid = true;
+    return loc;
+}
+
 // Translate virtual file offset to physical disk location
-PhysicalLocation FragmentMap::TranslateOffset(uint64_t fileOffset) const {
+PhysicalLocation FragmentMap::TranslateOffset(uint64_t fileOffset, size_t hintRun) const {
     if (m_runs.empty() || m_bytesPerCluster == 0) {
         return PhysicalLocation::Invalid();
     }
+
+    // Sequential access stays in the hinted run or moves to the next one
+    for (size_t i = hintRun; i < m_runs.size() && i <= hintRun + 1; ++i) {
+        PhysicalLocation loc = LocateInRun(i, fileOffset);
+        if (loc.valid) {
+            return loc;
+        }
+    }
     
     // Binary search for the run containing this offset
     size_t left = 0;
@@ -127,18 +153,49 @@ PhysicalLocation FragmentMap::TranslateOffset(uint64_t fileOffset) const {
         } else if (fileOffset >= runEnd) {
             left = mid + 1;
         } else {
-            PhysicalLocation loc;
-            uint64_t offsetInRun = fileOffset - m_runs[mid].fileOffset;
-            loc.cluster = m_runs[mid].startCluster + (offsetInRun / m_bytesPerCluster);
-            loc.offsetInCluster = offsetInRun % m_bytesPerCluster;
-            loc.runIndex = mid;
-            loc.valid = true;
-            return loc;
+            return LocateInRun(mid, fileOffset);
         }
     }
     return PhysicalLocation::Invalid();
 }
 
+// First extent at fileOffset; the iterator walks the following runs
+FragmentMap::ExtentRange FragmentMap::Extents(uint64_t fileOffset, size_t hintRun) const {
+    PhysicalLocation loc = TranslateOffset(fileOffset, hintRun);
+    if (!loc.valid) {
+        return ExtentRange{};
+    }
+    return ExtentRange{ ExtentIterator(this, loc.runIndex, fileOffset) };
+}
+
+FileExtent FragmentMap::ExtentIterator::operator*() const {
+    const ClusterRun& run = m_map->m_runs[m_runIndex];
+    uint64_t offsetInRun = m_fileOffset - run.fileOffset;
+    uint64_t bytesPerCluster = m_map->m_bytesPerCluster;
+
+    FileExtent extent;
+    extent.fileOffset = m_fileOffset;
+    extent.cluster = run.startCluster + offsetInRun / bytesPerCluster;
+    extent.offsetInCluster = offsetInRun % bytesPerCluster;
+    extent.length = run.clusterCount * bytesPerCluster - offsetInRun;
+    extent.runIndex = m_runIndex;
+    return extent;
+}
+
+FragmentMap::ExtentIterator& FragmentMap::ExtentIterator::operator++() {
+    const RunList& runs = m_map->m_runs;
+    uint64_t runEnd = runs[m_runIndex].fileOffset + runs[m_runIndex].clusterCount * m_map->m_bytesPerCluster;
+
+    // A hole in file offsets ends the walk just like the last run does
+    if (m_runIndex + 1 >= runs.size() || runs[m_runIndex + 1].fileOffset != runEnd) {
+        *this = ExtentIterator();
+        return *this;
+    }
+    m_runIndex++;
+    m_fileOffset = runEnd;
+    return *this;
+}
+
 // Get the run containing a specific file offset
 std::optional<ClusterRun> FragmentMap::GetRunForOffset(uint64_t fileOffset) const {
     auto loc = TranslateOffset(fileOffset);
@@ -160,12 +217,7 @@ uint64_t FragmentMap::TotalClusters() const {
 // Get contiguous read size from a given offset
 uint64_t FragmentMap::ContiguousBytesFrom(uint64_t fileOffset) const {
     auto loc = TranslateOffset(fileOffset);
-    if (!loc.valid || loc.runIndex >= m_runs.size()) {
-        return 0;
-    }
-    const auto& run = m_runs[loc.runIndex];
-    uint64_t runEnd = run.fileOffset + run.clusterCount * m_bytesPerCluster;
-    return runEnd - fileOffset;
+    return loc.valid ? loc.contiguousBytes : 0;
 }
 
 // ============================================================================
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "Constants.h"
 #include <vector>
 #include <cstdint>
 #include <optional>
@@ -56,6 +57,63 @@ struct ClusterRun {
     }
 };
 
+// ============================================================================
+// RunList - Cluster runs stored inline until they outgrow INLINE_RUNS
+// ============================================================================
+// Most files have one to a few runs; those never touch the heap. Longer
+// lists move to a vector once and stay there until cleared.
+
+class RunList {
+public:
+    static constexpr size_t INLINE_RUNS = Constants::Fragmentation::INLINE_RUNS;
+
+    using iterator = ClusterRun*;
+    using const_iterator = const ClusterRun*;
+
+    size_t size() const { return m_heap.empty() ? m_inlineCount : m_heap.size(); }
+    bool empty() const { return size() == 0; }
+
+    ClusterRun* data() { return m_heap.empty() ? m_inline : m_heap.data(); }
+    const ClusterRun* data() const { return m_heap.empty() ? m_inline : m_heap.data(); }
+    iterator begin() { return data(); }
+    iterator end() { return data() + size(); }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size(); }
+
+    ClusterRun& operator[](size_t index) { return data()[index]; }
+    const ClusterRun& operator[](size_t index) const { return data()[index]; }
+    ClusterRun& front() { return data()[0]; }
+    const ClusterRun& front() const { return data()[0]; }
+    ClusterRun& back() { return data()[size() - 1]; }
+    const ClusterRun& back() const { return data()[size() - 1]; }
+
+    void push_back(const ClusterRun& run) {
+        if (m_heap.empty() && m_inlineCount < INLINE_RUNS) {
+            m_inline[m_inlineCount++] = run;
+            return;
+        }
+        if (m_heap.empty()) {
+            m_heap.reserve(INLINE_RUNS * 2);
+            m_heap.assign(m_inline, m_inline + m_inlineCount);
+            m_inlineCount = 0;
+        }
+        m_heap.push_back(run);
+    }
+
+    void reserve(size_t count) {
+        if (count > INLINE_RUNS && m_heap.capacity() < count) {
+            m_heap.reserve(count);
+        }
+    }
+
+    void clear() { m_heap.clear(); m_inlineCount = 0; }
+
+private:
+    ClusterRun m_inline[INLINE_RUNS];
+    size_t m_inlineCount = 0;
+    std::vector<ClusterRun> m_heap;     // Holds every run once non-empty
+};
+
 // ============================================================================
 // PhysicalLocation - Result of virtual-to-physical translation
 // ============================================================================
@@ -63,12 +121,14 @@ struct ClusterRun {
 struct PhysicalLocation {
     uint64_t cluster;
     uint64_t offsetInCluster;
+    uint64_t contiguousBytes;   // Bytes to the end of the run from this offset
     size_t runIndex;
     bool valid;
     
     PhysicalLocation()
         : cluster(0)
         , offsetInCluster(0)
+        , contiguousBytes(0)
         , runIndex(0)
         , valid(false)
     {}
@@ -76,12 +136,49 @@ struct PhysicalLocation {
     static PhysicalLocation Invalid() { return PhysicalLocation(); }
 };
 
+// ============================================================================
+// FileExtent - Contiguous physical piece of a file
+// ============================================================================
+
+struct FileExtent {
+    uint64_t fileOffset;        // File byte offset of the first byte
+    uint64_t cluster;           // Cluster holding that byte
+    uint64_t offsetInCluster;
+    uint64_t length;            // Bytes up to the end of the run
+    size_t runIndex;
+};
+
 // ============================================================================
 // FragmentMap - Collection of cluster runs forming a complete file
 // ============================================================================
 
 class FragmentMap {
 public:
+    // Forward walk over the extents from a file offset, ending at the last
+    // run or the first hole in file offsets. Steps are O(1).
+    class ExtentIterator {
+    public:
+        ExtentIterator() = default;
+        ExtentIterator(const FragmentMap* map, size_t runIndex, uint64_t fileOffset)
+            : m_map(map), m_runIndex(runIndex), m_fileOffset(fileOffset) {}
+
+        FileExtent operator*() const;
+        ExtentIterator& operator++();
+        bool operator==(const ExtentIterator& other) const { return m_map == other.m_map; }
+        bool operator!=(const ExtentIterator& other) const { return m_map != other.m_map; }
+
+    private:
+        const FragmentMap* m_map = nullptr;     // Null at the end
+        size_t m_runIndex = 0;
+        uint64_t m_fileOffset = 0;
+    };
+
+    struct ExtentRange {
+        ExtentIterator first;
+        ExtentIterator begin() const { return first; }
+        ExtentIterator end() const { return ExtentIterator(); }
+    };
+
     FragmentMap() 
         : m_totalSize(0)
         , m_bytesPerCluster(4096)
@@ -116,13 +213,18 @@ public:
     bool IsValid() const { return !m_runs.empty() && m_bytesPerCluster > 0; }
     bool IsContiguous() const { return m_runs.size() <= 1; }
     
-    // Translation
-    PhysicalLocation TranslateOffset(uint64_t fileOffset) const;
+    // Translation; runs must be in file offset order. hintRun is checked
+    // (with its successor) before the binary search, so sequential callers
+    // passing the previous runIndex resolve in O(1).
+    PhysicalLocation TranslateOffset(uint64_t fileOffset, size_t hintRun = 0) const;
     std::optional<ClusterRun> GetRunForOffset(uint64_t fileOffset) const;
+
+    // Contiguous extents from fileOffset; empty if it isn't mapped
+    ExtentRange Extents(uint64_t fileOffset, size_t hintRun = 0) const;
     
     // Accessors
-    const std::vector<ClusterRun>& GetRuns() const { return m_runs; }
-    std::vector<ClusterRun>& GetRuns() { return m_runs; }
+    const RunList& GetRuns() const { return m_runs; }
+    RunList& GetRuns() { return m_runs; }
     size_t RunCount() const { return m_runs.size(); }
     size_t FragmentCount() const { return m_runs.size(); }
     uint64_t TotalSize() const { return m_totalSize; }
@@ -130,6 +232,7 @@ public:
     void SetTotalSize(uint64_t size) { m_totalSize = size; }
     void SetBytesPerCluster(uint64_t bpc) { m_bytesPerCluster = bpc; }
     void SetDiskTotalClusters(uint64_t total) { m_diskTotalClusters = total; }
+    uint64_t DiskTotalClusters() const { return m_diskTotalClusters; }
     uint64_t TotalClusters() const;
     uint64_t ContiguousBytesFrom(uint64_t fileOffset) const;
     void Clear() { m_runs.clear(); m_totalSize = 0; }
@@ -137,7 +240,9 @@ public:
     bool IsEmpty() const { return m_runs.empty(); }
 
 private:
-    std::vector<ClusterRun> m_runs;
+    PhysicalLocation LocateInRun(size_t runIndex, uint64_t fileOffset) const;
+
+    RunList m_runs;
     uint64_t m_totalSize;
     uint64_t m_bytesPerCluster;
     uint64_t m_diskTotalClusters;
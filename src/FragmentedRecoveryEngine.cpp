@@ -9,9 +9,11 @@
 #include "FragmentedRecoveryEngine.h"
 #include "SafetyLimits.h"
 #include "StringUtils.h"
+#include "RecoveryScheduler.h"
+#include "Constants.h"
 
 #include <climits>
-#include <fstream>
+#include <cstring>
 #include <filesystem>
 #include <cwctype>
 #include <algorithm>
@@ -20,6 +22,20 @@
 
 namespace KVC {
 
+namespace {
+
+void ReportUnreadable(const FragmentedRecoveryEngine::ValidationResult& validation,
+                      const FragmentedRecoveryEngine::ProgressCallback& onProgress) {
+    if (!validation.allClustersValid && onProgress) {
+        wchar_t msg[512];
+        swprintf_s(msg, L"Warning: %llu clusters unreadable, recovery may be incomplete",
+                  validation.invalidClusters);
+        onProgress(msg, -1.0f);
+    }
+}
+
+} // namespace
+
 FragmentedRecoveryEngine::FragmentedRecoveryEngine() = default;
 FragmentedRecoveryEngine::~FragmentedRecoveryEngine() = default;
 
@@ -104,20 +120,13 @@ FragmentedRecoveryEngine::ValidationResult FragmentedRecoveryEngine::ValidateFra
         return result;
     }
 
-    const auto& runs = fragments.GetRuns();
-
-    for (const auto& run : runs) {
-        for (uint64_t i = 0; i < run.clusterCount; ++i) {
-            uint64_t cluster = run.startCluster + i;
+    AlignedBuffer buffer = AllocateScanBuffer(reader, fragments);
+    if (!buffer.IsValid()) {
+        throw RecoveryError("Failed to allocate validation buffer");
+    }
 
-            if (ValidateCluster(reader, cluster)) {
-                result.validClusters++;
-            } else {
-                result.invalidClusters++;
-                result.failedClusters.push_back(cluster);
-                result.allClustersValid = false;
-            }
-        }
+    for (const auto& run : fragments.GetRuns()) {
+        ScanRun(reader, run.startCluster, run.clusterCount, buffer, result, nullptr);
     }
 
     if (!result.allClustersValid) {
@@ -143,76 +152,69 @@ FragmentedRecoveryEngine::ValidationResult FragmentedRecoveryEngine::ValidateFra
         return result;
     }
 
-    // Build flat list of clusters
-    std::vector<uint64_t> allClusters;
-    const auto& runs = fragments.GetRuns();
+    // Split runs into read-sized chunks; positional reads need no lock
+    const uint64_t chunkClusters = ScanChunkClusters(reader);
+    std::vector<ClusterRun> chunks;
+    uint64_t totalClusters = 0;
 
-    for (const auto& run : runs) {
-        for (uint64_t i = 0; i < run.clusterCount; ++i) {
-            allClusters.push_back(run.startCluster + i);
+    for (const auto& run : fragments.GetRuns()) {
+        for (uint64_t done = 0; done < run.clusterCount; done += chunkClusters) {
+            ClusterRun chunk;
+            chunk.startCluster = run.startCluster + done;
+            chunk.clusterCount = std::min(chunkClusters, run.clusterCount - done);
+            chunks.push_back(chunk);
         }
+        totalClusters += run.clusterCount;
     }
 
-    if (allClusters.empty()) {
+    if (chunks.empty()) {
         return result;
     }
 
-    // Parallel validation
-    size_t numThreads = std::min(m_config.maxParallelThreads, allClusters.size());
-    size_t clustersPerThread = (allClusters.size() + numThreads - 1) / numThreads;
-
+    size_t numThreads = std::min(m_config.maxParallelThreads, chunks.size());
     std::mutex resultMutex;
-    std::atomic<uint64_t> processedClusters(0);
-    std::vector<std::future<std::vector<uint64_t>>> futures;
+    std::atomic<size_t> cursor(0);
+    uint64_t processedClusters = 0;
+    std::vector<std::future<void>> futures;
 
     for (size_t t = 0; t < numThreads; ++t) {
-        size_t start = t * clustersPerThread;
-        size_t end = std::min(start + clustersPerThread, allClusters.size());
-
-        if (start >= allClusters.size()) break;
-
-        futures.push_back(std::async(std::launch::async, [&, start, end]() {
-            std::vector<uint64_t> localFailed;
-
-            for (size_t i = start; i < end; ++i) {
-                uint64_t cluster = allClusters[i];
-
-                bool valid;
-                {
-                    std::lock_guard<std::mutex> lock(resultMutex);
-                    valid = ValidateCluster(reader, cluster);
-                }
-
-                if (!valid) {
-                    localFailed.push_back(cluster);
-                }
-
-                processedClusters++;
+        futures.push_back(std::async(std::launch::async, [&]() {
+            AlignedBuffer buffer(static_cast<size_t>(chunkClusters * reader.Geometry().bytesPerCluster));
+            if (!buffer.IsValid()) {
+                throw RecoveryError("Failed to allocate validation buffer");
+            }
 
-                if (onProgress && (processedClusters % 100 == 0)) {
-                    float progress = static_cast<float>(processedClusters) / allClusters.size();
+            for (size_t i = cursor.fetch_add(1); i < chunks.size(); i = cursor.fetch_add(1)) {
+                ValidationResult local;
+                local.allClustersValid = true;
+                local.validClusters = 0;
+                local.invalidClusters = 0;
+                ScanRun(reader, chunks[i].startCluster, chunks[i].clusterCount, buffer, local, nullptr);
+
+                std::lock_guard<std::mutex> lock(resultMutex);
+                result.validClusters += local.validClusters;
+                result.invalidClusters += local.invalidClusters;
+                result.failedClusters.insert(result.failedClusters.end(),
+                                            local.failedClusters.begin(), local.failedClusters.end());
+                result.allClustersValid = result.allClustersValid && local.allClustersValid;
+                processedClusters += chunks[i].clusterCount;
+
+                if (onProgress) {
+                    float progress = static_cast<float>(processedClusters) / totalClusters;
                     wchar_t msg[256];
-                    swprintf_s(msg, L"Validating clusters: %llu / %zu",
-                              processedClusters.load(), allClusters.size());
+                    swprintf_s(msg, L"Validating clusters: %llu / %llu",
+                              processedClusters, totalClusters);
                     onProgress(msg, progress);
                 }
             }
-
-            return localFailed;
         }));
     }
 
     for (auto& future : futures) {
-        auto failed = future.get();
-        if (!failed.empty()) {
-            result.failedClusters.insert(result.failedClusters.end(),
-                                        failed.begin(), failed.end());
-            result.allClustersValid = false;
-        }
+        future.get();
     }
 
-    result.invalidClusters = result.failedClusters.size();
-    result.validClusters = allClusters.size() - result.invalidClusters;
+    std::sort(result.failedClusters.begin(), result.failedClusters.end());
 
     if (!result.allClustersValid) {
         result.errorMessage = "Some clusters are unreadable";
@@ -221,15 +223,101 @@ FragmentedRecoveryEngine::ValidationResult FragmentedRecoveryEngine::ValidateFra
     return result;
 }
 
-bool FragmentedRecoveryEngine::ValidateCluster(VolumeReader& reader, uint64_t cluster) {
+uint64_t FragmentedRecoveryEngine::ScanChunkClusters(VolumeReader& reader) const {
+    return std::max<uint64_t>(1, Constants::Fragmentation::MAX_CONTIGUOUS_READ / reader.Geometry().bytesPerCluster);
+}
+
+AlignedBuffer FragmentedRecoveryEngine::AllocateScanBuffer(VolumeReader& reader, const FragmentMap& fragments) const {
+    // Small files get a buffer sized to their longest run, not a full chunk
+    uint64_t longestRun = 0;
+    for (const auto& run : fragments.GetRuns()) {
+        longestRun = std::max(longestRun, run.clusterCount);
+    }
+    uint64_t clusters = std::max<uint64_t>(1, std::min(longestRun, ScanChunkClusters(reader)));
+    return AlignedBuffer(static_cast<size_t>(clusters * reader.Geometry().bytesPerCluster));
+}
+
+void FragmentedRecoveryEngine::ScanRun(
+    VolumeReader& reader,
+    uint64_t startLCN,
+    uint64_t count,
+    AlignedBuffer& buffer,
+    ValidationResult& result,
+    const ChunkCallback& onChunk)
+{
+    const VolumeGeometry& geom = reader.Geometry();
+    const uint64_t bytesPerCluster = geom.bytesPerCluster;
+    const uint64_t chunkClusters = std::max<uint64_t>(1, buffer.Size() / bytesPerCluster);
+
+    // Clusters past the volume end are never read, only counted and zero-filled
+    uint64_t inBounds = 0;
+    if (startLCN < geom.totalClusters) {
+        inBounds = std::min(count, geom.totalClusters - startLCN);
+    }
+
+    for (uint64_t done = 0; done < inBounds; done += chunkClusters) {
+        uint64_t clusters = std::min(chunkClusters, inBounds - done);
+        ReadBisected(reader, startLCN + done, clusters, buffer.Data(), result);
+        if (onChunk) {
+            onChunk(buffer.Data(), clusters * bytesPerCluster);
+        }
+    }
+
+    if (inBounds < count) {
+        uint64_t missing = count - inBounds;
+        for (uint64_t i = inBounds; i < count; i++) {
+            result.failedClusters.push_back(startLCN + i);
+        }
+        result.invalidClusters += missing;
+        result.allClustersValid = false;
+        if (onChunk) {
+            onChunk(nullptr, missing * bytesPerCluster);
+        }
+    }
+}
+
+void FragmentedRecoveryEngine::ReadBisected(
+    VolumeReader& reader,
+    uint64_t startLCN,
+    uint64_t count,
+    uint8_t* buffer,
+    ValidationResult& result)
+{
+    const uint64_t bytesPerCluster = reader.Geometry().bytesPerCluster;
+    const size_t bytes = static_cast<size_t>(count * bytesPerCluster);
+
+    size_t bytesRead = 0;
     try {
-        auto data = reader.ReadClusters(cluster, 1);
-        return !data.empty();
+        bytesRead = reader.ReadClustersInto(startLCN, count, buffer, bytes);
     } catch (const ClusterOutOfBoundsError&) {
-        return false;
     } catch (const DiskReadError&) {
-        return false;
     }
+
+    if (bytesRead >= bytes) {
+        result.validClusters += count;
+        return;
+    }
+
+    if (count == 1) {
+        memset(buffer, 0, bytes);
+        result.invalidClusters++;
+        result.failedClusters.push_back(startLCN);
+        result.allClustersValid = false;
+        return;
+    }
+
+    // Whole clusters before a short read are good; split the rest in halves
+    // until the unreadable clusters are isolated
+    uint64_t good = bytesRead / bytesPerCluster;
+    if (good > 0) {
+        result.validClusters += good;
+        ReadBisected(reader, startLCN + good, count - good, buffer + good * bytesPerCluster, result);
+        return;
+    }
+
+    uint64_t half = count / 2;
+    ReadBisected(reader, startLCN, half, buffer, result);
+    ReadBisected(reader, startLCN + half, count - half, buffer + half * bytesPerCluster, result);
 }
 
 // ============================================================================
@@ -253,18 +341,10 @@ void FragmentedRecoveryEngine::RecoverFragmentedFile(
 {
     // Handle resident data
     if (file.HasResidentData()) {
-        std::ofstream outFile(outputPath, std::ios::binary | std::ios::trunc);
-        if (!outFile.is_open()) {
-            throw RecoveryError("Failed to create output file");
-        }
-
+        auto output = OutputSink::Open(outputPath);
         const auto& resData = file.GetResidentData();
-        outFile.write(reinterpret_cast<const char*>(resData.data()), resData.size());
-        outFile.close();
-
-        if (!outFile.good()) {
-            throw RecoveryError("Failed to write resident data");
-        }
+        output->Write(resData.data(), resData.size());
+        output->Close();
         return;
     }
 
@@ -274,35 +354,31 @@ void FragmentedRecoveryEngine::RecoverFragmentedFile(
         throw RecoveryError("No cluster data available for recovery");
     }
 
-    // Optionally validate clusters
-    if (m_config.validateClusters) {
-        ValidationResult validation;
-
-        if (m_config.parallelValidation && fragments.FragmentCount() > 10) {
-            validation = ValidateFragmentMapParallel(reader, fragments, onProgress);
-        } else {
-            validation = ValidateFragmentMap(reader, fragments);
-        }
+    // Recover using appropriate method; the unmapped path validates each
+    // chunk with the read that recovers it, so only mapping needs a pre-pass
+    if (m_config.useMemoryMapping) {
+        if (m_config.validateClusters) {
+            ValidationResult validation;
 
-        if (!validation.allClustersValid && onProgress) {
-            wchar_t msg[512];
-            swprintf_s(msg, L"Warning: %llu clusters unreadable, recovery may be incomplete",
-                      validation.invalidClusters);
-            onProgress(msg, -1.0f);
+            if (m_config.parallelValidation &&
+                fragments.FragmentCount() > Constants::Fragmentation::PARALLEL_VALIDATION_THRESHOLD) {
+                validation = ValidateFragmentMapParallel(reader, fragments, onProgress);
+            } else {
+                validation = ValidateFragmentMap(reader, fragments);
+            }
+            ReportUnreadable(validation, onProgress);
         }
-    }
 
-    // Recover using appropriate method
-    if (m_config.useMemoryMapping) {
         RecoverWithMapping(reader, fragments, file.GetSize(), outputPath, onProgress);
     } else {
-        std::ofstream outFile(outputPath, std::ios::binary | std::ios::trunc);
-        if (!outFile.is_open()) {
-            throw RecoveryError("Failed to create output file");
-        }
+        auto output = OutputSink::Open(outputPath);
+        output->Reserve(file.GetSize());
+        ValidationResult validation = WriteFragmentedData(reader, fragments, file.GetSize(), *output, onProgress);
+        output->Close();
 
-        WriteFragmentedData(reader, fragments, file.GetSize(), outFile, onProgress);
-        outFile.close();
+        if (m_config.validateClusters) {
+            ReportUnreadable(validation, onProgress);
+        }
     }
 }
 
@@ -317,18 +393,9 @@ void FragmentedRecoveryEngine::RecoverFile(
     // Handle resident data
     if (file.file.HasResidentData()) {
         const auto& residentData = file.file.GetResidentData();
-        std::ofstream outFile(destinationPath, std::ios::binary | std::ios::trunc);
-        if (!outFile.is_open()) {
-            throw RecoveryError("Failed to create output file");
-        }
-
-        outFile.write(reinterpret_cast<const char*>(residentData.data()),
-                     residentData.size());
-        outFile.close();
-
-        if (!outFile.good()) {
-            throw RecoveryError("Failed to write resident data");
-        }
+        auto output = OutputSink::Open(destinationPath);
+        output->Write(residentData.data(), residentData.size());
+        output->Close();
         return;
     }
 
@@ -346,17 +413,13 @@ void FragmentedRecoveryEngine::RecoverFile(
     VolumeGeometry geom = BuildGeometry(disk, file);
     VolumeReader reader(disk, geom);
 
-    std::ofstream outFile(destinationPath, std::ios::binary | std::ios::trunc);
-    if (!outFile.is_open()) {
-        throw RecoveryError("Failed to create output file");
-    }
-
     if (m_config.useMemoryMapping) {
-        outFile.close();
         RecoverWithMapping(reader, fragments, file.fileSize, destinationPath, onProgress);
     } else {
-        WriteFragmentedData(reader, fragments, file.fileSize, outFile, onProgress);
-        outFile.close();
+        auto output = OutputSink::Open(destinationPath);
+        output->Reserve(file.fileSize);
+        WriteFragmentedData(reader, fragments, file.fileSize, *output, onProgress);
+        output->Close();
     }
 
     if (onProgress) {
@@ -399,89 +462,60 @@ FragmentedRecoveryEngine::BatchResult FragmentedRecoveryEngine::RecoverMultipleF
 
     int totalFiles = static_cast<int>(files.size());
 
-    for (int i = 0; i < totalFiles; ++i) {
-        if (shouldStop && *shouldStop) {
-            if (onProgress) {
-                onProgress(L"Recovery cancelled by user", -1.0f);
-            }
-            break;
-        }
-
-        const auto& file = files[i];
-        std::wstring destPath = destinationFolder + L"\\" + file.name;
-
-        // Handle duplicate filenames
-        int suffix = 1;
-        while (std::filesystem::exists(destPath)) {
-            size_t dotPos = file.name.rfind(L'.');
-            std::wstring baseName, ext;
-            if (dotPos != std::wstring::npos) {
-                baseName = file.name.substr(0, dotPos);
-                ext = file.name.substr(dotPos);
-            } else {
-                baseName = file.name;
-                ext = L"";
-            }
-            destPath = destinationFolder + L"\\" + baseName + L"_" + std::to_wstring(suffix) + ext;
-            suffix++;
+    // Names are fixed up front so concurrent jobs never race for one path
+    const std::vector<std::wstring> destPaths =
+        RecoveryScheduler::AssignDestinations(files, destinationFolder, true);
+
+    RecoveryScheduler scheduler(m_config.maxParallelThreads);
+    auto outcomes = scheduler.Run(files, [&](size_t index) -> uint64_t {
+        const auto& file = files[index];
+        const std::wstring& destPath = destPaths[index];
+
+        // Handle resident data
+        if (file.file.HasResidentData()) {
+            const auto& residentData = file.file.GetResidentData();
+            auto output = OutputSink::Open(destPath);
+            output->Write(residentData.data(), residentData.size());
+            output->Close();
+            return residentData.size();
         }
 
-        float progress = static_cast<float>(i) / totalFiles;
+        FragmentMap fragments = BuildFragmentMap(file);
 
-        if (onProgress) {
-            wchar_t progressMsg[512];
-            swprintf_s(progressMsg, L"Recovering %s (%d/%d)", file.name.c_str(), i + 1, totalFiles);
-            onProgress(progressMsg, progress);
+        if (fragments.IsEmpty()) {
+            throw RecoveryError("No cluster data");
         }
 
-        try {
-            // Handle resident data
-            if (file.file.HasResidentData()) {
-                const auto& residentData = file.file.GetResidentData();
-                std::ofstream outFile(destPath, std::ios::binary | std::ios::trunc);
-                if (outFile.is_open()) {
-                    outFile.write(reinterpret_cast<const char*>(residentData.data()),
-                                 residentData.size());
-                    outFile.close();
-                    if (outFile.good()) {
-                        result.successCount++;
-                        result.successFiles.push_back(file.name);
-                        continue;
-                    }
-                }
-                throw RecoveryError("Failed to write resident data");
-            }
-
-            FragmentMap fragments = BuildFragmentMap(file);
+        VolumeGeometry geom = BuildGeometry(disk, file);
+        VolumeReader reader(disk, geom);
 
-            if (fragments.IsEmpty()) {
-                throw RecoveryError("No cluster data");
-            }
-
-            VolumeGeometry geom = BuildGeometry(disk, file);
-            VolumeReader reader(disk, geom);
+        if (m_config.useMemoryMapping) {
+            RecoverWithMapping(reader, fragments, file.fileSize, destPath, nullptr);
+        } else {
+            auto output = OutputSink::Open(destPath);
+            output->Reserve(file.fileSize);
+            ProgressCallback nullCallback = nullptr;
+            WriteFragmentedData(reader, fragments, file.fileSize, *output, nullCallback);
+            output->Close();
+        }
 
-            if (m_config.useMemoryMapping) {
-                RecoverWithMapping(reader, fragments, file.fileSize, destPath, nullptr);
-            } else {
-                std::ofstream outFile(destPath, std::ios::binary | std::ios::trunc);
-                if (!outFile.is_open()) {
-                    throw RecoveryError("Failed to create output file");
-                }
-                ProgressCallback nullCallback = nullptr;
-                WriteFragmentedData(reader, fragments, file.fileSize, outFile, nullCallback);
-                outFile.close();
-            }
+        return file.fileSize > 0 ? file.fileSize : fragments.TotalSize();
+    }, onProgress, shouldStop);
 
+    for (size_t i = 0; i < files.size(); i++) {
+        if (outcomes[i].success) {
             result.successCount++;
-            result.successFiles.push_back(file.name);
-
-        } catch (const ForensicsException&) {
+            result.successFiles.push_back(files[i].name);
+        } else if (outcomes[i].attempted) {
             result.failedCount++;
-            result.failedFiles.push_back(file.name);
+            result.failedFiles.push_back(files[i].name);
         }
     }
 
+    if (shouldStop && *shouldStop && onProgress) {
+        onProgress(L"Recovery cancelled by user", -1.0f);
+    }
+
     if (onProgress) {
         wchar_t completeMsg[256];
         swprintf_s(completeMsg, L"Recovery complete: %d/%d files recovered",
@@ -503,15 +537,13 @@ void FragmentedRecoveryEngine::RecoverWithMapping(
     const std::wstring& outputPath,
     ProgressCallback onProgress)
 {
-    std::ofstream outFile(outputPath, std::ios::binary | std::ios::trunc);
-    if (!outFile.is_open()) {
-        throw RecoveryError("Failed to create output file");
-    }
-
     const auto& runs = fragments.GetRuns();
     uint64_t bytesWritten = 0;
     uint64_t totalBytes = fileSize > 0 ? fileSize : fragments.TotalSize();
 
+    auto output = OutputSink::Open(outputPath);
+    output->Reserve(totalBytes);
+
     for (size_t runIndex = 0; runIndex < runs.size() && bytesWritten < totalBytes; ++runIndex) {
         const auto& run = runs[runIndex];
 
@@ -523,7 +555,7 @@ void FragmentedRecoveryEngine::RecoverWithMapping(
 
         if (view.valid && view.data) {
             size_t toWrite = static_cast<size_t>(std::min(bytesToProcess, view.size));
-            outFile.write(reinterpret_cast<const char*>(view.data), toWrite);
+            output->Write(view.data, toWrite);
             reader.UnmapView(view);
             bytesWritten += toWrite;
         } else {
@@ -536,13 +568,12 @@ void FragmentedRecoveryEngine::RecoverWithMapping(
                     static_cast<uint64_t>(data.size())
                 ));
 
-                outFile.write(reinterpret_cast<const char*>(data.data()), toWrite);
+                output->Write(data.data(), toWrite);
                 bytesWritten += toWrite;
 
             } catch (const DiskReadError&) {
-                // Write zeros for unreadable clusters
-                std::vector<char> zeros(static_cast<size_t>(bytesToProcess), 0);
-                outFile.write(zeros.data(), static_cast<std::streamsize>(bytesToProcess));
+                // Zero-fill unreadable clusters
+                output->WriteZeros(bytesToProcess);
                 bytesWritten += bytesToProcess;
             }
         }
@@ -558,7 +589,7 @@ void FragmentedRecoveryEngine::RecoverWithMapping(
         }
     }
 
-    outFile.close();
+    output->Close();
 
     if (bytesWritten == 0) {
         throw RecoveryError("No data was written");
@@ -569,54 +600,50 @@ void FragmentedRecoveryEngine::RecoverWithMapping(
 // Data Writing with VolumeReader
 // ============================================================================
 
-void FragmentedRecoveryEngine::WriteFragmentedData(
+FragmentedRecoveryEngine::ValidationResult FragmentedRecoveryEngine::WriteFragmentedData(
     VolumeReader& reader,
     const FragmentMap& fragments,
     uint64_t fileSize,
-    std::ofstream& outFile,
+    OutputSink& output,
     const ProgressCallback& onProgress)
 {
+    ValidationResult validation;
+    validation.allClustersValid = true;
+    validation.validClusters = 0;
+    validation.invalidClusters = 0;
+
     const auto& runs = fragments.GetRuns();
     uint64_t bytesWritten = 0;
     uint64_t totalBytes = fileSize > 0 ? fileSize : fragments.TotalSize();
     uint64_t bytesPerCluster = fragments.BytesPerCluster();
 
-    for (const auto& run : runs) {
-        if (bytesWritten >= totalBytes) break;
-
-        try {
-            auto data = reader.ReadClusters(run.startCluster, run.clusterCount);
-
-            uint64_t runBytes = run.clusterCount * bytesPerCluster;
-            size_t toWrite = static_cast<size_t>(std::min(
-                std::min(runBytes, static_cast<uint64_t>(data.size())),
-                totalBytes - bytesWritten
-            ));
-
-            outFile.write(reinterpret_cast<const char*>(data.data()), toWrite);
+    if (bytesPerCluster == 0) {
+        throw InvalidGeometryError("Invalid cluster size (0)");
+    }
 
-            if (!outFile.good()) {
-                throw RecoveryError("Write error during recovery");
-            }
+    AlignedBuffer buffer = AllocateScanBuffer(reader, fragments);
+    if (!buffer.IsValid()) {
+        throw RecoveryError("Failed to allocate recovery buffer");
+    }
 
-            bytesWritten += toWrite;
+    // Each chunk is validated by the read that recovers it; unreadable
+    // clusters come back zeroed and are written as such
+    ChunkCallback writeChunk = [&](const uint8_t* data, uint64_t size) {
+        uint64_t toWrite = std::min(size, totalBytes - bytesWritten);
+        if (data) {
+            output.Write(data, static_cast<size_t>(toWrite));
+        } else {
+            output.WriteZeros(toWrite);
+        }
+        bytesWritten += toWrite;
+    };
 
-        } catch (const ClusterOutOfBoundsError&) {
-            // Write zeros
-            uint64_t runBytes = run.clusterCount * bytesPerCluster;
-            size_t toWrite = static_cast<size_t>(std::min(runBytes, totalBytes - bytesWritten));
-            std::vector<char> zeros(toWrite, 0);
-            outFile.write(zeros.data(), toWrite);
-            bytesWritten += toWrite;
+    for (const auto& run : runs) {
+        if (bytesWritten >= totalBytes) break;
 
-        } catch (const DiskReadError&) {
-            // Write zeros
-            uint64_t runBytes = run.clusterCount * bytesPerCluster;
-            size_t toWrite = static_cast<size_t>(std::min(runBytes, totalBytes - bytesWritten));
-            std::vector<char> zeros(toWrite, 0);
-            outFile.write(zeros.data(), toWrite);
-            bytesWritten += toWrite;
-        }
+        // Never read past the clusters the file size still needs
+        uint64_t needed = (totalBytes - bytesWritten + bytesPerCluster - 1) / bytesPerCluster;
+        ScanRun(reader, run.startCluster, std::min(run.clusterCount, needed), buffer, validation, writeChunk);
 
         if (onProgress && totalBytes > 0) {
             float progress = static_cast<float>(bytesWritten) / static_cast<float>(totalBytes);
@@ -629,13 +656,19 @@ void FragmentedRecoveryEngine::WriteFragmentedData(
     if (bytesWritten == 0) {
         throw RecoveryError("No data was written");
     }
+
+    if (!validation.allClustersValid) {
+        validation.errorMessage = "Some clusters are unreadable";
+    }
+
+    return validation;
 }
 
 void FragmentedRecoveryEngine::WriteFragmentedDataMapped(
     VolumeReader& reader,
     const FragmentMap& fragments,
     uint64_t fileSize,
-    std::ofstream& outFile,
+    OutputSink& output,
     const ProgressCallback& onProgress)
 {
     const auto& runs = fragments.GetRuns();
@@ -652,7 +685,7 @@ void FragmentedRecoveryEngine::WriteFragmentedDataMapped(
 
         if (view.valid && view.data) {
             size_t toWrite = static_cast<size_t>(std::min(runSize, view.size));
-            outFile.write(reinterpret_cast<const char*>(view.data), toWrite);
+            output.Write(view.data, toWrite);
             reader.UnmapView(view);
             bytesWritten += toWrite;
         } else {
@@ -663,12 +696,11 @@ void FragmentedRecoveryEngine::WriteFragmentedDataMapped(
                     static_cast<uint64_t>(data.size()),
                     totalBytes - bytesWritten
                 ));
-                outFile.write(reinterpret_cast<const char*>(data.data()), toWrite);
+                output.Write(data.data(), toWrite);
                 bytesWritten += toWrite;
 
             } catch (const ForensicsException&) {
-                std::vector<char> zeros(static_cast<size_t>(runSize), 0);
-                outFile.write(zeros.data(), static_cast<std::streamsize>(runSize));
+                output.WriteZeros(runSize);
                 bytesWritten += runSize;
             }
         }
@@ -4,7 +4,7 @@
 // Enhanced recovery engine that properly handles fragmented files.
 // Uses VolumeReader for consistent LCN-based cluster access.
 // Uses FragmentMap for accurate data extraction across non-contiguous clusters.
-// Provides parallel cluster validation for heavily fragmented files.
+// Validates clusters with coalesced run reads, bisecting only failed runs.
 // ============================================================================
 
 #pragma once
@@ -15,6 +15,8 @@
 #include "VolumeReader.h"
 #include "VolumeGeometry.h"
 #include "ForensicsExceptions.h"
+#include "OutputSink.h"
+#include "AlignedBufferPool.h"
 #include <vector>
 #include <string>
 #include <functional>
@@ -106,7 +108,8 @@ public:
         ProgressCallback onProgress
     );
 
-    // Batch recovery of multiple files
+    // Batch recovery of multiple files in on-disk order; runs up to
+    // maxParallelThreads jobs at once unless memory mapping is enabled
     struct BatchResult {
         int successCount;
         int failedCount;
@@ -143,13 +146,40 @@ private:
     // Build FragmentMap from RecoveryCandidate
     FragmentMap BuildFragmentMap(const RecoveryCandidate& file);
 
-    // Write data from disk to output file, following fragment map
-    // Throws: RecoveryError, DiskReadError
-    void WriteFragmentedData(
+    // Receives each chunk read by ScanRun; data is nullptr for a zero gap
+    using ChunkCallback = std::function<void(const uint8_t* data, uint64_t size)>;
+
+    // Clusters per validation/recovery read
+    uint64_t ScanChunkClusters(VolumeReader& reader) const;
+    AlignedBuffer AllocateScanBuffer(VolumeReader& reader, const FragmentMap& fragments) const;
+
+    // Read a run in large chunks, bisecting failed chunks down to the
+    // unreadable clusters; those are recorded in result and zero-filled
+    void ScanRun(
+        VolumeReader& reader,
+        uint64_t startLCN,
+        uint64_t count,
+        AlignedBuffer& buffer,
+        ValidationResult& result,
+        const ChunkCallback& onChunk
+    );
+
+    void ReadBisected(
+        VolumeReader& reader,
+        uint64_t startLCN,
+        uint64_t count,
+        uint8_t* buffer,
+        ValidationResult& result
+    );
+
+    // Write data from disk to output file, following fragment map; the
+    // recovery reads double as cluster validation
+    // Throws: RecoveryError, DiskWriteError
+    ValidationResult WriteFragmentedData(
         VolumeReader& reader,
         const FragmentMap& fragments,
         uint64_t fileSize,
-        std::ofstream& outFile,
+        OutputSink& output,
         const ProgressCallback& onProgress
     );
 
@@ -159,13 +189,10 @@ private:
         VolumeReader& reader,
         const FragmentMap& fragments,
         uint64_t fileSize,
-        std::ofstream& outFile,
+        OutputSink& output,
         const ProgressCallback& onProgress
     );
 
-    // Validate a single cluster is readable using VolumeReader
-    bool ValidateCluster(VolumeReader& reader, uint64_t cluster);
-
     RecoveryConfig m_config;
 };
 
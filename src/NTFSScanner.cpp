@@ -6,12 +6,15 @@
 #include "RecoveryCandidate.h"
 #include "Constants.h"
 #include "StringUtils.h"
+#include "AlignedBufferPool.h"
+#include "PerfCounters.h"
 
 #include <climits>
 #include <algorithm>
 #include <cwctype>
 #include <vector>
-#include <set>
+#include <deque>
+#include <future>
 
 namespace KVC {
 
@@ -193,6 +196,10 @@ bool NTFSDataRunParser::ValidateRuns(
 
 NTFSScanner::NTFSScanner() 
     : m_diskTotalClusters(0)
+    , m_mftRecordCount(0)
+    , m_mftLayoutLoaded(false)
+    , m_retainedRecordSize(0)
+    , m_retainRecords(false)
 {}
 
 NTFSScanner::~NTFSScanner() = default;
@@ -208,8 +215,9 @@ NTFSBootSector NTFSScanner::ReadBootSector(DiskHandle& disk) {
     return boot;
 }
 
-bool NTFSScanner::ApplyFixups(std::vector<uint8_t>& recordData, uint16_t bytesPerSector) {
+bool NTFSScanner::ApplyFixups(std::span<uint8_t> recordData, uint16_t bytesPerSector) {
     if (recordData.size() < sizeof(MFTFileRecord)) return false;
+    Perf::ScopedTimer timer(Perf::Timer::Fixups);
     
     MFTFileRecord* header = reinterpret_cast<MFTFileRecord*>(recordData.data());
     uint16_t usaOffset = header->updateSequenceOffset;
@@ -233,51 +241,457 @@ bool NTFSScanner::ApplyFixups(std::vector<uint8_t>& recordData, uint16_t bytesPe
     return true;
 }
 
-std::vector<uint8_t> NTFSScanner::ReadMFTRecord(DiskHandle& disk, const NTFSBootSector& boot, uint64_t recordNum) {
+uint64_t NTFSScanner::MftRecordSize(const NTFSBootSector& boot) {
     uint64_t bytesPerCluster = boot.bytesPerSector * boot.sectorsPerCluster;
-    uint64_t sectorSize = boot.bytesPerSector;
-    
-    uint64_t mftRecordSize = (boot.clustersPerMFTRecord >= 0) 
+    return (boot.clustersPerMFTRecord >= 0)
         ? boot.clustersPerMFTRecord * bytesPerCluster
         : (1ULL << (-boot.clustersPerMFTRecord));
+}
 
-    uint64_t mftOffset = boot.mftCluster * bytesPerCluster;
-    uint64_t recordOffset = mftOffset + (recordNum * mftRecordSize);
-    
-    uint64_t startSector = recordOffset / sectorSize;
-    uint64_t numSectors = (mftRecordSize + sectorSize - 1) / sectorSize;
+bool NTFSScanner::TranslateMftOffset(const NTFSBootSector& boot, uint64_t fileOffset,
+                                     uint64_t& diskOffset, uint64_t& contiguousBytes) const {
+    if (m_mftExtents.empty()) {
+        uint64_t bytesPerCluster = boot.bytesPerSector * boot.sectorsPerCluster;
+        diskOffset = boot.mftCluster * bytesPerCluster + fileOffset;
+        contiguousBytes = UINT64_MAX - diskOffset;
+        return true;
+    }
 
-    auto data = disk.ReadSectors(startSector, numSectors, sectorSize);
-    if (data.empty()) return {};
+    auto it = std::upper_bound(m_mftExtents.begin(), m_mftExtents.end(), fileOffset,
+        [](uint64_t offset, const MftExtent& extent) { return offset < extent.fileOffset; });
+    if (it == m_mftExtents.begin()) return false;
+    --it;
 
-    uint64_t offsetInSector = recordOffset % sectorSize;
-    
-    if (offsetInSector + mftRecordSize > data.size()) {
-        mftRecordSize = data.size() - offsetInSector;
+    uint64_t delta = fileOffset - it->fileOffset;
+    if (delta >= it->length) return false;  // Sparse gap or past the stream
+
+    diskOffset = it->diskOffset + delta;
+    contiguousBytes = it->length - delta;
+    return true;
+}
+
+std::vector<uint8_t> NTFSScanner::ReadMftBytes(DiskHandle& disk, const NTFSBootSector& boot,
+                                               uint64_t fileOffset, uint64_t size) const {
+    uint64_t sectorSize = boot.bytesPerSector;
+    std::vector<uint8_t> result;
+    result.reserve(static_cast<size_t>(size));
+
+    // Gather piecewise: a record may straddle two extents
+    while (result.size() < size) {
+        uint64_t diskOffset = 0;
+        uint64_t contiguous = 0;
+        if (!TranslateMftOffset(boot, fileOffset + result.size(), diskOffset, contiguous)) break;
+
+        uint64_t wanted = std::min<uint64_t>(size - result.size(), contiguous);
+        uint64_t offsetInSector = diskOffset % sectorSize;
+        uint64_t numSectors = (offsetInSector + wanted + sectorSize - 1) / sectorSize;
+
+        auto data = disk.ReadSectors(diskOffset / sectorSize, numSectors, sectorSize);
+        if (offsetInSector >= data.size()) break;
+
+        size_t got = static_cast<size_t>(std::min<uint64_t>(wanted, data.size() - offsetInSector));
+        result.insert(result.end(), data.begin() + static_cast<size_t>(offsetInSector),
+                      data.begin() + static_cast<size_t>(offsetInSector) + got);
+        if (got < wanted) break;
     }
-    
-    if (offsetInSector >= data.size()) return {};
 
-    std::vector<uint8_t> result(
-        data.begin() + static_cast<size_t>(offsetInSector), 
-        data.begin() + static_cast<size_t>(offsetInSector + mftRecordSize)
-    );
-    
+    return result;
+}
+
+std::vector<uint8_t> NTFSScanner::ReadNonResidentStream(DiskHandle& disk, const NTFSBootSector& boot,
+                                                        const std::vector<ClusterRun>& runs,
+                                                        uint64_t size) const {
+    uint64_t bytesPerCluster = boot.bytesPerSector * boot.sectorsPerCluster;
+    std::vector<uint8_t> stream(static_cast<size_t>(size), 0);  // Sparse runs stay zero
+
+    for (const auto& run : runs) {
+        if (run.fileOffset >= size) continue;
+        uint64_t length = std::min(run.clusterCount * bytesPerCluster, size - run.fileOffset);
+        uint64_t numSectors = (length + boot.bytesPerSector - 1) / boot.bytesPerSector;
+
+        auto data = disk.ReadSectors(run.startCluster * boot.sectorsPerCluster, numSectors,
+                                     boot.bytesPerSector);
+        size_t copy = static_cast<size_t>(std::min<uint64_t>(length, data.size()));
+        std::memcpy(stream.data() + run.fileOffset, data.data(), copy);
+    }
+
+    return stream;
+}
+
+void NTFSScanner::CollectMftDataRuns(std::span<const uint8_t> record, const NTFSBootSector& boot,
+                                     std::vector<ClusterRun>& runs, uint64_t& initializedSize,
+                                     std::vector<uint64_t>* extensionRecords,
+                                     std::vector<uint8_t>* bitmap, DiskHandle& disk) const {
+    if (record.size() < sizeof(MFTFileRecord)) return;
+
+    const MFTFileRecord* header = reinterpret_cast<const MFTFileRecord*>(record.data());
+    if (std::memcmp(header->signature, "FILE", 4) != 0) return;
+
+    uint64_t bytesPerCluster = boot.bytesPerSector * boot.sectorsPerCluster;
+    size_t offset = header->firstAttributeOffset;
+
+    while (offset + sizeof(AttributeHeader) <= record.size()) {
+        const AttributeHeader* attr = reinterpret_cast<const AttributeHeader*>(record.data() + offset);
+        if (attr->type == 0xFFFFFFFF) break;
+        if (attr->length == 0 || offset > record.size() - attr->length) break;
+
+        // $ATTRIBUTE_LIST: $DATA continues in extension records
+        if (attr->type == 0x20 && attr->nonResident == 0 && extensionRecords != nullptr) {
+            const ResidentAttributeHeader* resAttr =
+                reinterpret_cast<const ResidentAttributeHeader*>(record.data() + offset);
+            size_t pos = offset + resAttr->valueOffset;
+            size_t end = std::min<size_t>(offset + attr->length, pos + resAttr->valueLength);
+
+            while (pos + 26 <= end) {
+                uint32_t entryType = *reinterpret_cast<const uint32_t*>(record.data() + pos);
+                uint16_t entryLength = *reinterpret_cast<const uint16_t*>(record.data() + pos + 4);
+                uint64_t reference = *reinterpret_cast<const uint64_t*>(record.data() + pos + 16) &
+                                     0x0000FFFFFFFFFFFF;
+                if (entryLength == 0) break;
+
+                if (entryType == 0x80 && reference != 0) {
+                    extensionRecords->push_back(reference);
+                }
+                pos += entryLength;
+            }
+        }
+
+        if ((attr->type == 0x80 || attr->type == 0xB0) && attr->nameLength == 0) {
+            if (attr->nonResident != 0 && attr->length >= sizeof(NonResidentAttributeHeader)) {
+                const NonResidentAttributeHeader* nrAttr =
+                    reinterpret_cast<const NonResidentAttributeHeader*>(record.data() + offset);
+
+                if (nrAttr->dataRunOffset < attr->length) {
+                    auto parsed = NTFSDataRunParser::Parse(
+                        record.data() + offset + nrAttr->dataRunOffset,
+                        attr->length - nrAttr->dataRunOffset, bytesPerCluster, m_diskTotalClusters);
+
+                    if (parsed.valid) {
+                        // Each segment's runs restart at its own starting VCN
+                        uint64_t segmentOffset = nrAttr->startVCN * bytesPerCluster;
+                        for (auto& run : parsed.runs) {
+                            run.fileOffset += segmentOffset;
+                        }
+
+                        if (attr->type == 0x80) {
+                            runs.insert(runs.end(), parsed.runs.begin(), parsed.runs.end());
+                            if (nrAttr->startVCN == 0) {
+                                initializedSize = nrAttr->initializedSize;
+                            }
+                        } else if (bitmap != nullptr && nrAttr->startVCN == 0 && !parsed.runs.empty()) {
+                            // Never size the buffer beyond what the runs can back
+                            const auto& lastRun = parsed.runs.back();
+                            uint64_t backed = lastRun.fileOffset + lastRun.clusterCount * bytesPerCluster;
+                            *bitmap = ReadNonResidentStream(disk, boot, parsed.runs,
+                                                            std::min(nrAttr->realSize, backed));
+                        }
+                    }
+                }
+            } else if (attr->nonResident == 0 && attr->type == 0xB0 && bitmap != nullptr) {
+                const ResidentAttributeHeader* resAttr =
+                    reinterpret_cast<const ResidentAttributeHeader*>(record.data() + offset);
+                if (resAttr->valueOffset <= attr->length &&
+                    resAttr->valueLength <= attr->length - resAttr->valueOffset) {
+                    const uint8_t* value = record.data() + offset + resAttr->valueOffset;
+                    bitmap->assign(value, value + resAttr->valueLength);
+                }
+            }
+        }
+
+        offset += attr->length;
+    }
+}
+
+bool NTFSScanner::LoadMftLayout(DiskHandle& disk, const NTFSBootSector& boot) {
+    m_mftLayoutLoaded = true;
+    m_mftExtents.clear();
+    m_mftBitmap.clear();
+    m_mftRecordCount = 0;
+
+    uint64_t bytesPerCluster = boot.bytesPerSector * boot.sectorsPerCluster;
+    uint64_t mftRecordSize = MftRecordSize(boot);
+    if (bytesPerCluster == 0 || mftRecordSize == 0) return false;
+
+    // Record 0 always sits at boot.mftCluster, so the contiguous fallback reads it
+    auto record = ReadMftBytes(disk, boot, 0, mftRecordSize);
+    if (record.size() < mftRecordSize) return false;
+    ApplyFixups(record, boot.bytesPerSector);
+
+    std::vector<ClusterRun> runs;
+    std::vector<uint64_t> extensionRecords;
+    std::vector<uint8_t> bitmap;
+    uint64_t initializedSize = 0;
+    CollectMftDataRuns(record, boot, runs, initializedSize, &extensionRecords, &bitmap, disk);
+
+    auto buildExtents = [&]() {
+        std::sort(runs.begin(), runs.end(),
+            [](const ClusterRun& a, const ClusterRun& b) { return a.fileOffset < b.fileOffset; });
+        m_mftExtents.clear();
+        for (const auto& run : runs) {
+            m_mftExtents.push_back({ run.fileOffset, run.startCluster * bytesPerCluster,
+                                     run.clusterCount * bytesPerCluster });
+        }
+    };
+    buildExtents();
+
+    // Extension records live in extents already known from record 0
+    std::sort(extensionRecords.begin(), extensionRecords.end());
+    extensionRecords.erase(std::unique(extensionRecords.begin(), extensionRecords.end()),
+                           extensionRecords.end());
+    if (!extensionRecords.empty() && !m_mftExtents.empty()) {
+        for (uint64_t extension : extensionRecords) {
+            auto extRecord = ReadMftBytes(disk, boot, extension * mftRecordSize, mftRecordSize);
+            if (extRecord.size() < mftRecordSize) continue;
+            ApplyFixups(extRecord, boot.bytesPerSector);
+
+            uint64_t unused = 0;
+            CollectMftDataRuns(extRecord, boot, runs, unused, nullptr, nullptr, disk);
+        }
+        buildExtents();
+    }
+
+    if (m_mftExtents.empty()) return false;
+
+    uint64_t streamBytes = m_mftExtents.back().fileOffset + m_mftExtents.back().length;
+    if (initializedSize > 0) streamBytes = std::min(streamBytes, initializedSize);
+    m_mftRecordCount = streamBytes / mftRecordSize;
+    m_mftBitmap = std::move(bitmap);
+    return true;
+}
+
+std::vector<NTFSScanner::MftBatch> NTFSScanner::PlanMftBatches(const NTFSBootSector& boot,
+                                                               uint64_t maxRecords) const {
+    uint64_t mftRecordSize = MftRecordSize(boot);
+    uint64_t limit = m_mftRecordCount > 0 ? std::min(maxRecords, m_mftRecordCount) : maxRecords;
+    std::vector<MftBatch> batches;
+
+    if (m_mftExtents.empty()) {
+        uint64_t bytesPerCluster = boot.bytesPerSector * boot.sectorsPerCluster;
+        uint64_t mftOffset = boot.mftCluster * bytesPerCluster;
+        for (uint64_t i = 0; i < limit; i += Constants::NTFS::RECORDS_PER_BATCH) {
+            uint64_t count = std::min<uint64_t>(Constants::NTFS::RECORDS_PER_BATCH, limit - i);
+            batches.push_back({ i, count, mftOffset + i * mftRecordSize });
+        }
+        return batches;
+    }
+
+    for (const auto& extent : m_mftExtents) {
+        uint64_t first = (extent.fileOffset + mftRecordSize - 1) / mftRecordSize;
+        uint64_t end = std::min((extent.fileOffset + extent.length) / mftRecordSize, limit);
+
+        // In-use records are never deleted-file candidates; free slots are
+        // where deleted records live, so only allocated runs are skipped
+        uint64_t record = first;
+        while (record < end) {
+            while (record < end && IsMftRecordInUse(record)) record++;
+            if (record >= end) break;
+
+            uint64_t start = record;
+            uint64_t lastFree = record;
+            for (uint64_t r = record; r < end && r - start < Constants::NTFS::RECORDS_PER_BATCH; r++) {
+                if (!IsMftRecordInUse(r)) {
+                    lastFree = r;
+                } else if (r - lastFree >= Constants::NTFS::MFT_SKIP_MIN_RECORDS) {
+                    break;
+                }
+            }
+
+            batches.push_back({ start, lastFree - start + 1,
+                                extent.diskOffset + (start * mftRecordSize - extent.fileOffset) });
+            record = lastFree + 1;
+        }
+
+        // A record cut by the extent boundary is gathered from both pieces
+        uint64_t extentEnd = extent.fileOffset + extent.length;
+        uint64_t tail = extentEnd / mftRecordSize;
+        if (extentEnd % mftRecordSize != 0 && tail < limit && !IsMftRecordInUse(tail)) {
+            MftBatch straddling = { tail, 1, 0 };
+            straddling.spansExtents = true;
+            batches.push_back(straddling);
+        }
+    }
+
+    return batches;
+}
+
+std::vector<uint8_t> NTFSScanner::ReadMFTRecord(DiskHandle& disk, const NTFSBootSector& boot, uint64_t recordNum) {
+    if (!m_mftLayoutLoaded) {
+        LoadMftLayout(disk, boot);
+    }
+
+    uint64_t mftRecordSize = MftRecordSize(boot);
+    auto result = ReadMftBytes(disk, boot, recordNum * mftRecordSize, mftRecordSize);
+    if (result.empty()) return {};
+
     ApplyFixups(result, boot.bytesPerSector);
-    
     return result;
 }
 
+bool NTFSScanner::LoadVolumeBitmap(DiskHandle& disk, const NTFSBootSector& boot, ClusterBitmap& allocated) {
+    uint64_t bytesPerCluster = boot.bytesPerSector * boot.sectorsPerCluster;
+    auto record = ReadMFTRecord(disk, boot, Constants::NTFS::VOLUME_BITMAP_RECORD_NUMBER);
+    if (record.empty() || bytesPerCluster == 0 || allocated.Empty()) return false;
+
+    std::vector<ClusterRun> runs;
+    uint64_t initializedSize = 0;
+    CollectMftDataRuns(record, boot, runs, initializedSize, nullptr, nullptr, disk);
+    if (runs.empty()) return false;
+
+    // One bit per cluster; anything past the volume is padding
+    uint64_t streamBytes = (allocated.TotalClusters() + 7) / 8;
+    if (initializedSize > 0) streamBytes = std::min(streamBytes, initializedSize);
+
+    AlignedBuffer chunk(static_cast<size_t>(Constants::MAX_READ_CHUNK));
+    if (!chunk.IsValid()) return false;
+
+    uint64_t bytesLoaded = 0;
+    for (const auto& run : runs) {
+        if (run.fileOffset >= streamBytes) continue;
+        uint64_t runBytes = std::min(run.clusterCount * bytesPerCluster, streamBytes - run.fileOffset);
+
+        // Runs are cluster-aligned, so every chunk stays sector-aligned
+        for (uint64_t done = 0; done < runBytes; ) {
+            size_t want = static_cast<size_t>(std::min<uint64_t>(chunk.Size(), runBytes - done));
+            size_t readSize = static_cast<size_t>((want + boot.bytesPerSector - 1) /
+                                                  boot.bytesPerSector * boot.bytesPerSector);
+            size_t got = disk.ReadInto(run.startCluster * bytesPerCluster + done, chunk.Data(),
+                                       std::min(readSize, chunk.Size()));
+            if (got == 0) break;
+
+            size_t usable = std::min(got, want);
+            allocated.MergeBytes((run.fileOffset + done) * 8, chunk.Data(), usable);
+            bytesLoaded += usable;
+            done += usable;
+        }
+    }
+
+    return bytesLoaded > 0;
+}
+
+void NTFSScanner::ResetSession() {
+    m_directoryIndex.Clear();
+    m_mftExtents.clear();
+    m_mftBitmap.clear();
+    m_mftRecordCount = 0;
+    m_mftLayoutLoaded = false;
+
+    m_scannedRanges.clear();
+    m_retainedRecords.clear();
+    m_retainedRecordData.clear();
+    m_candidateRecords.clear();
+    m_retainedRecordSize = 0;
+    m_retainRecords = false;
+}
+
+bool NTFSScanner::FindScannedRecord(uint64_t recordNum, std::span<const uint8_t>& data) const {
+    auto range = std::upper_bound(m_scannedRanges.begin(), m_scannedRanges.end(), recordNum,
+        [](uint64_t record, const std::pair<uint64_t, uint64_t>& r) { return record < r.first; });
+    if (range == m_scannedRanges.begin() || recordNum >= (--range)->second) return false;
+    if (std::binary_search(m_candidateRecords.begin(), m_candidateRecords.end(), recordNum)) return false;
+
+    data = {};
+    auto it = std::lower_bound(m_retainedRecords.begin(), m_retainedRecords.end(), recordNum);
+    if (it != m_retainedRecords.end() && *it == recordNum) {
+        size_t index = static_cast<size_t>(it - m_retainedRecords.begin());
+        data = std::span<const uint8_t>(m_retainedRecordData.data() + index * m_retainedRecordSize,
+                                        static_cast<size_t>(m_retainedRecordSize));
+    }
+    return true;
+}
+
+void NTFSScanner::RetainBatchRecords(const MftBatch& batch, MftBatchResult& result) {
+    if (!m_retainRecords || result.recordsParsed == 0) return;
+
+    // Past the budget, later records are simply read again on demand
+    if (m_retainedRecordData.size() + result.retainedData.size() > Constants::NTFS::MFT_RECORD_CACHE_BYTES) {
+        m_retainRecords = false;
+        return;
+    }
+
+    // Batches arrive in ascending record order, so every list stays sorted
+    uint64_t end = batch.firstRecord + result.recordsParsed;
+    if (!m_scannedRanges.empty() && m_scannedRanges.back().second == batch.firstRecord) {
+        m_scannedRanges.back().second = end;
+    } else {
+        m_scannedRanges.push_back({ batch.firstRecord, end });
+    }
+
+    m_retainedRecords.insert(m_retainedRecords.end(), result.retainedRecords.begin(), result.retainedRecords.end());
+    m_retainedRecordData.insert(m_retainedRecordData.end(), result.retainedData.begin(), result.retainedData.end());
+    for (const auto& pending : result.candidates) {
+        m_candidateRecords.push_back(*pending.candidate.mftRecord);
+    }
+}
+
+bool NTFSScanner::ReadMFTRecords(DiskHandle& disk, const NTFSBootSector& boot,
+                                 std::vector<uint64_t> recordNums, const MftRecordVisitor& visitor) {
+    if (!m_mftLayoutLoaded) {
+        LoadMftLayout(disk, boot);
+    }
+
+    uint64_t mftRecordSize = MftRecordSize(boot);
+    if (mftRecordSize == 0) return true;
+    bool useRetained = (mftRecordSize == m_retainedRecordSize);
+
+    std::sort(recordNums.begin(), recordNums.end());
+    recordNums.erase(std::unique(recordNums.begin(), recordNums.end()), recordNums.end());
+
+    std::span<const uint8_t> retained;
+    size_t i = 0;
+    while (i < recordNums.size()) {
+        if (useRetained && FindScannedRecord(recordNums[i], retained)) {
+            if (!visitor(recordNums[i], retained)) return false;
+            i++;
+            continue;
+        }
+
+        // Extend the read over close neighbours that share one contiguous
+        // extent; short gaps are cheaper to read through than to seek over
+        uint64_t first = recordNums[i];
+        uint64_t diskOffset = 0;
+        uint64_t contiguous = 0;
+        if (!TranslateMftOffset(boot, first * mftRecordSize, diskOffset, contiguous)) {
+            contiguous = 0;
+        }
+
+        size_t last = i;
+        while (last + 1 < recordNums.size()) {
+            uint64_t next = recordNums[last + 1];
+            if (next - recordNums[last] > Constants::NTFS::MFT_SKIP_MIN_RECORDS) break;
+            if (next - first >= Constants::NTFS::RECORDS_PER_BATCH) break;
+            if ((next + 1 - first) * mftRecordSize > contiguous) break;
+            if (useRetained && FindScannedRecord(next, retained)) break;
+            last++;
+        }
+
+        auto data = ReadMftBytes(disk, boot, first * mftRecordSize,
+                                 (recordNums[last] - first + 1) * mftRecordSize);
+
+        for (size_t k = i; k <= last; k++) {
+            size_t offset = static_cast<size_t>((recordNums[k] - first) * mftRecordSize);
+            std::span<uint8_t> record;
+            if (offset + mftRecordSize <= data.size()) {
+                record = std::span<uint8_t>(data.data() + offset, static_cast<size_t>(mftRecordSize));
+                ApplyFixups(record, boot.bytesPerSector);
+            }
+            if (!visitor(recordNums[k], record)) return false;
+        }
+        i = last + 1;
+    }
+
+    return true;
+}
+
 NTFSDataRunParser::ParseResult NTFSScanner::ParseDataRunsEnhanced(
     const uint8_t* runData,
     size_t maxSize,
     uint64_t bytesPerCluster,
-    uint64_t maxCluster)
+    uint64_t maxCluster) const
 {
     return NTFSDataRunParser::Parse(runData, maxSize, bytesPerCluster, maxCluster);
 }
 
-std::vector<ClusterRange> NTFSScanner::ParseDataRuns(const uint8_t* runData, size_t maxSize, uint64_t bytesPerCluster) {
+std::vector<ClusterRange> NTFSScanner::ParseDataRuns(const uint8_t* runData, size_t maxSize, uint64_t bytesPerCluster) const {
     auto result = NTFSDataRunParser::Parse(runData, maxSize, bytesPerCluster, m_diskTotalClusters);
     
     if (!result.valid) {
@@ -315,7 +729,7 @@ std::vector<ClusterRange> NTFSScanner::ParseDataRuns(const uint8_t* runData, siz
 }
 
 std::optional<FragmentedFile> NTFSScanner::ParseMFTRecordToFragmentedFile(
-    const std::vector<uint8_t>& data,
+    std::span<const uint8_t> data,
     uint64_t /*recordNum*/,
     const NTFSBootSector& boot)
 {
@@ -391,12 +805,26 @@ std::optional<FragmentedFile> NTFSScanner::ParseMFTRecordToFragmentedFile(
     return std::nullopt;
 }
 
-bool NTFSScanner::ParseMFTRecord(const std::vector<uint8_t>& data, uint64_t recordNum,
+bool NTFSScanner::ParseMFTRecord(std::span<const uint8_t> data, uint64_t recordNum,
                                 DiskForensicsCore::FileFoundCallback& callback,
                                 DiskHandle& disk,
                                 const NTFSBootSector& boot,
                                 const std::wstring& folderFilter,
                                 const std::wstring& filenameFilter) {
+    RecoveryCandidate candidate;
+    uint64_t parentRecord = 0;
+    if (!BuildCandidate(data, recordNum, boot, candidate, parentRecord)) return false;
+
+    FetchMissingDirectories(disk, boot, { parentRecord });
+    candidate.path = m_directoryIndex.BuildPath(parentRecord, candidate.name);
+    Perf::Add(Perf::Counter::PathsBuilt);
+    return DeliverCandidate(candidate, folderFilter, filenameFilter, callback);
+}
+
+bool NTFSScanner::BuildCandidate(std::span<const uint8_t> data, uint64_t recordNum,
+                                 const NTFSBootSector& boot, RecoveryCandidate& candidate,
+                                 uint64_t& parentRecord) const {
+    parentRecord = 0;
     if (data.size() < sizeof(MFTFileRecord)) return false;
 
     const MFTFileRecord* record = reinterpret_cast<const MFTFileRecord*>(data.data());
@@ -409,7 +837,7 @@ bool NTFSScanner::ParseMFTRecord(const std::vector<uint8_t>& data, uint64_t reco
 
     uint64_t bytesPerCluster = boot.bytesPerSector * boot.sectorsPerCluster;
 
-    RecoveryCandidate candidate = {};
+    candidate = {};
     candidate.mftRecord = recordNum;
     candidate.source = RecoverySource::MFT;
     candidate.fileSize = 0;
@@ -449,6 +877,7 @@ bool NTFSScanner::ParseMFTRecord(const std::vector<uint8_t>& data, uint64_t reco
                             offset <= data.size() - resAttr->valueOffset - requiredSize) {
 
                             candidate.name.assign(fnAttr->name, nameLen);
+                            parentRecord = fnAttr->parentDirectory & 0x0000FFFFFFFFFFFF;
                             hasFileName = true;
                         }
                     }
@@ -516,116 +945,181 @@ bool NTFSScanner::ParseMFTRecord(const std::vector<uint8_t>& data, uint64_t reco
         offset += attr->length;
     }
     
-    if (hasFileName) {
-        candidate.path = ReconstructPath(disk, boot, recordNum, candidate.name);
+    if (!hasFileName) return false;
 
-        if (!hasData) {
-            candidate.fileSize = 0;
-            candidate.sizeFormatted = L"Unknown";
-            candidate.quality = RecoveryQuality::Unrecoverable;
-        }
-
-        if (!folderFilter.empty()) {
-            std::wstring lowerPath = candidate.path;
-            std::wstring lowerFilter = folderFilter;
-            std::transform(lowerPath.begin(), lowerPath.end(), lowerPath.begin(), ::towlower);
-            std::transform(lowerFilter.begin(), lowerFilter.end(), lowerFilter.begin(), ::towlower);
-            if (lowerPath.find(lowerFilter) == std::wstring::npos) return false;
-        }
+    if (!hasData) {
+        candidate.fileSize = 0;
+        candidate.sizeFormatted = L"Unknown";
+        candidate.quality = RecoveryQuality::Unrecoverable;
+    }
+    return true;
+}
 
-        if (!filenameFilter.empty()) {
-            std::wstring lowerName = candidate.name;
-            std::wstring lowerFilter = filenameFilter;
-            std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::towlower);
-            std::transform(lowerFilter.begin(), lowerFilter.end(), lowerFilter.begin(), ::towlower);
-            if (lowerName.find(lowerFilter) == std::wstring::npos) return false;
-        }
+bool NTFSScanner::DeliverCandidate(RecoveryCandidate& candidate,
+                                   const std::wstring& folderFilter, const std::wstring& filenameFilter,
+                                   DiskForensicsCore::FileFoundCallback& callback) {
+    if (!folderFilter.empty()) {
+        std::wstring lowerPath = candidate.path;
+        std::wstring lowerFilter = folderFilter;
+        std::transform(lowerPath.begin(), lowerPath.end(), lowerPath.begin(), ::towlower);
+        std::transform(lowerFilter.begin(), lowerFilter.end(), lowerFilter.begin(), ::towlower);
+        if (lowerPath.find(lowerFilter) == std::wstring::npos) return false;
+    }
 
-        callback(candidate);
-        return true;
+    if (!filenameFilter.empty()) {
+        std::wstring lowerName = candidate.name;
+        std::wstring lowerFilter = filenameFilter;
+        std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::towlower);
+        std::transform(lowerFilter.begin(), lowerFilter.end(), lowerFilter.begin(), ::towlower);
+        if (lowerName.find(lowerFilter) == std::wstring::npos) return false;
     }
 
-    return false;
+    callback(candidate);
+    return true;
 }
 
-std::wstring NTFSScanner::ReconstructPath(DiskHandle& disk, const NTFSBootSector& boot,
-                                          uint64_t mftRecord, const std::wstring& filename) {
-    auto it = m_pathCache.find(mftRecord);
-    if (it != m_pathCache.end()) {
-        return filename.empty() ? it->second : it->second + L"\\" + filename;
-    }
-    
-    static std::set<uint64_t> visitedRecords;
-    
-    if (visitedRecords.empty() || visitedRecords.size() > Constants::NTFS::PATH_CACHE_SIZE_LIMIT) {
-        visitedRecords.clear();
-    }
-    
-    if (visitedRecords.find(mftRecord) != visitedRecords.end()) {
-        return L"<deleted>\\" + filename;
-    }
-    
-    if (visitedRecords.size() > Constants::NTFS::PATH_CACHE_DEPTH_LIMIT) return L"<deleted>\\" + filename;
-    
-    visitedRecords.insert(mftRecord);
-    
-    if (mftRecord == 5 || mftRecord == 0) {
-        m_pathCache[mftRecord] = L"<deleted>";
-        return filename.empty() ? L"<deleted>" : L"<deleted>\\" + filename;
-    }
-    
-    auto data = ReadMFTRecord(disk, boot, mftRecord);
-    if (data.size() < sizeof(MFTFileRecord)) return L"<deleted>\\" + filename;
-    
+bool NTFSScanner::ParseDirectoryRecord(std::span<const uint8_t> data, std::wstring& name,
+                                       uint64_t& parentRecord) {
+    if (data.size() < sizeof(MFTFileRecord)) return false;
+
     const MFTFileRecord* record = reinterpret_cast<const MFTFileRecord*>(data.data());
-    if (std::memcmp(record->signature, "FILE", 4) != 0) return L"<deleted>\\" + filename;
-    
+    if (std::memcmp(record->signature, "FILE", 4) != 0) return false;
+
+    const uint16_t FLAG_IS_DIRECTORY = 0x0002;
+    if ((record->flags & FLAG_IS_DIRECTORY) == 0) return false;
+
+    bool haveLongName = false;
+    bool haveName = false;
     size_t offset = record->firstAttributeOffset;
-    uint64_t parentMftRecord = 0;
-    
+
     while (offset + sizeof(AttributeHeader) <= data.size()) {
         const AttributeHeader* attr = reinterpret_cast<const AttributeHeader*>(data.data() + offset);
         if (attr->type == 0xFFFFFFFF) break;
         if (attr->length == 0 || offset > data.size() - attr->length) break;
-        
+
         if (attr->type == 0x30 && attr->nonResident == 0) {
-            const ResidentAttributeHeader* resAttr = 
+            const ResidentAttributeHeader* resAttr =
                 reinterpret_cast<const ResidentAttributeHeader*>(data.data() + offset);
-            
-            if (resAttr->valueOffset + sizeof(FileNameAttribute) <= data.size() - offset) {
-                const FileNameAttribute* fnAttr = 
-                    reinterpret_cast<const FileNameAttribute*>(
-                        data.data() + offset + resAttr->valueOffset);
-                
-                uint64_t parent = fnAttr->parentDirectory & 0x0000FFFFFFFFFFFF;
-                
-                if (fnAttr->nameType == 0x01) {
-                    parentMftRecord = parent;
-                    break;
-                }
-                else if (fnAttr->nameType == 0x03) {
-                    parentMftRecord = parent;
-                }
-                else if (fnAttr->nameType == 0x02 && parentMftRecord == 0) {
-                    parentMftRecord = parent;
+
+            if (resAttr->valueOffset <= data.size() - sizeof(FileNameAttribute) &&
+                offset <= data.size() - resAttr->valueOffset - sizeof(FileNameAttribute)) {
+
+                const FileNameAttribute* fnAttr =
+                    reinterpret_cast<const FileNameAttribute*>(data.data() + offset + resAttr->valueOffset);
+
+                // Prefer the long name; a DOS 8.3 name is only a fallback
+                bool isDosName = fnAttr->nameType == 0x02;
+                size_t nameLen = std::min(static_cast<size_t>(fnAttr->nameLength), size_t(255));
+                size_t requiredSize = sizeof(FileNameAttribute) + (nameLen - 1) * sizeof(wchar_t);
+
+                if (nameLen > 0 && (!haveName || (!haveLongName && !isDosName)) &&
+                    requiredSize <= data.size() &&
+                    resAttr->valueOffset <= data.size() - requiredSize &&
+                    offset <= data.size() - resAttr->valueOffset - requiredSize) {
+
+                    name.assign(fnAttr->name, nameLen);
+                    parentRecord = fnAttr->parentDirectory & 0x0000FFFFFFFFFFFF;
+                    haveName = true;
+                    haveLongName = !isDosName;
                 }
             }
         }
         offset += attr->length;
     }
-    
-    if (parentMftRecord == 0 || parentMftRecord == 5 || parentMftRecord == mftRecord) {
-        m_pathCache[mftRecord] = L"<deleted>";
-        visitedRecords.erase(mftRecord);
-        return filename.empty() ? L"<deleted>" : L"<deleted>\\" + filename;
+
+    return haveName;
+}
+
+void NTFSScanner::FetchMissingDirectories(DiskHandle& disk, const NTFSBootSector& boot,
+                                          const std::vector<uint64_t>& parentRecords) {
+    Perf::ScopedTimer timer(Perf::Timer::PathLookup);
+
+    // Each round reads one more tree level; every fetched record becomes
+    // known, so the loop ends once no chain has a gap left
+    for (uint64_t round = 0; round < Constants::NTFS::PATH_CACHE_DEPTH_LIMIT; round++) {
+        std::vector<uint64_t> missing;
+        for (uint64_t parent : parentRecords) {
+            uint64_t gap = m_directoryIndex.FindMissingAncestor(parent);
+            if (gap != 0) missing.push_back(gap);
+        }
+        if (missing.empty()) break;
+        Perf::Add(Perf::Counter::PathRecordsFetched, missing.size());
+
+        // Sorted, coalesced reads keep moving forward through the MFT
+        ReadMFTRecords(disk, boot, std::move(missing),
+            [this](uint64_t record, std::span<const uint8_t> data) {
+                std::wstring name;
+                uint64_t parent = 0;
+                if (ParseDirectoryRecord(data, name, parent)) {
+                    m_directoryIndex.AddDirectory(record, parent, name);
+                } else {
+                    m_directoryIndex.AddNonDirectory(record);
+                }
+                return true;
+            });
     }
-    
-    std::wstring parentPath = ReconstructPath(disk, boot, parentMftRecord, L"");
-    
-    visitedRecords.erase(mftRecord);
-    
-    m_pathCache[mftRecord] = parentPath;
-    return filename.empty() ? parentPath : parentPath + L"\\" + filename;
+}
+
+NTFSScanner::MftBatchResult NTFSScanner::ScanMftBatch(
+    DiskHandle& disk,
+    const NTFSBootSector& boot,
+    const MftBatch& batch,
+    uint64_t mftRecordSize,
+    uint8_t* buffer,
+    size_t bufferSize,
+    DiskHandle::ReadMode mode,
+    bool retainRecords) const
+{
+    Perf::ScopedTimer timer(Perf::Timer::MftBatch);
+    MftBatchResult result;
+    size_t bytesRead = 0;
+
+    if (batch.spansExtents) {
+        auto record = ReadMftBytes(disk, boot, batch.firstRecord * mftRecordSize, mftRecordSize);
+        bytesRead = std::min(record.size(), bufferSize);
+        std::memcpy(buffer, record.data(), bytesRead);
+    } else {
+        // Round up to whole sectors so unbuffered reads stay aligned
+        uint64_t batchBytes = batch.recordCount * mftRecordSize;
+        uint64_t readBytes = ((batchBytes + boot.bytesPerSector - 1) / boot.bytesPerSector) * boot.bytesPerSector;
+        bytesRead = disk.ReadInto(batch.diskOffset, buffer,
+                                  static_cast<size_t>(std::min<uint64_t>(readBytes, bufferSize)), mode);
+    }
+
+    if (bytesRead == 0) {
+        result.readFailed = true;
+        return result;
+    }
+
+    for (uint64_t j = 0; j < batch.recordCount; ++j) {
+        size_t offsetInBuffer = static_cast<size_t>(j * mftRecordSize);
+        if (offsetInBuffer + mftRecordSize > bytesRead) break;
+
+        // Fixups are applied in place; the buffer is refilled for the next batch
+        std::span<uint8_t> recordData(buffer + offsetInBuffer, static_cast<size_t>(mftRecordSize));
+        ApplyFixups(recordData, boot.bytesPerSector);
+
+        uint64_t recordNum = batch.firstRecord + j;
+        ParsedDirectory directory;
+        PendingCandidate pending;
+        if (ParseDirectoryRecord(recordData, directory.name, directory.parentRecord)) {
+            directory.record = recordNum;
+            result.directories.push_back(std::move(directory));
+        } else if (BuildCandidate(recordData, recordNum, boot, pending.candidate, pending.parentRecord)) {
+            result.candidates.push_back(std::move(pending));
+            result.recordsParsed++;
+            continue;
+        }
+
+        if (retainRecords && std::memcmp(recordData.data(), "FILE", 4) == 0) {
+            result.retainedRecords.push_back(recordNum);
+            result.retainedData.insert(result.retainedData.end(), recordData.begin(), recordData.end());
+        }
+        result.recordsParsed++;
+    }
+
+    Perf::Add(Perf::Counter::MftRecordsParsed, result.recordsParsed);
+    return result;
 }
 
 bool NTFSScanner::ScanVolume(
@@ -637,7 +1131,7 @@ bool NTFSScanner::ScanVolume(
     bool& shouldStop,
     const ScanConfiguration& config)
 {
-    m_pathCache.clear();
+    ResetSession();
     
     NTFSBootSector boot = ReadBootSector(disk);
     if (std::memcmp(boot.oemID, "NTFS    ", 8) != 0) return false;
@@ -650,58 +1144,147 @@ bool NTFSScanner::ScanVolume(
     uint64_t recordsScanned = 0;
     uint64_t filesFound = 0;
     
-    uint64_t mftRecordSize = (boot.clustersPerMFTRecord >= 0) 
-        ? boot.clustersPerMFTRecord * bytesPerCluster
-        : (1ULL << (-boot.clustersPerMFTRecord));
+    uint64_t mftRecordSize = MftRecordSize(boot);
 
     uint64_t batchBufferSize = Constants::NTFS::RECORDS_PER_BATCH * mftRecordSize;
     uint64_t sectorsPerBatch = (batchBufferSize + boot.bytesPerSector - 1) / boot.bytesPerSector;
+    size_t batchReadSize = static_cast<size_t>(sectorsPerBatch * boot.bytesPerSector);
 
-    for (uint64_t i = 0; i < maxRecords && !shouldStop; i += Constants::NTFS::RECORDS_PER_BATCH) {
-        if ((i % 100) == 0 && shouldStop) break;
+    // Walk the real $MFT extents; falls back to a contiguous MFT if record 0
+    // cannot be decoded
+    LoadMftLayout(disk, boot);
+    std::vector<MftBatch> batches = PlanMftBatches(boot, maxRecords);
+    m_retainedRecordSize = mftRecordSize;
+    m_retainRecords = true;
+    uint64_t totalRecords = m_mftRecordCount > 0 ? std::min(maxRecords, m_mftRecordCount) : maxRecords;
+    uint64_t nextProgressRecord = 0;
 
-        uint64_t mftOffset = boot.mftCluster * bytesPerCluster;
-        uint64_t batchStartOffset = mftOffset + (i * mftRecordSize);
-        uint64_t startSector = batchStartOffset / boot.bytesPerSector;
-        
-        auto batchData = disk.ReadSectors(startSector, sectorsPerBatch, boot.bytesPerSector);
-        if (batchData.empty()) {
-            if (i == 0) {
+    // The MFT is read once front to back, so streaming past the file cache
+    // avoids evicting pages that other stages still need
+    const auto readMode = config.unbufferedStreaming ? DiskHandle::ReadMode::Unbuffered
+                                                     : DiskHandle::ReadMode::Cached;
+
+    // Candidates whose parent chain is not fully indexed yet
+    std::vector<PendingCandidate> deferred;
+
+    // Index updates, filters and callbacks run here, on the calling thread, in batch order
+    auto consumeBatch = [&](const MftBatch& batch, MftBatchResult& result) {
+        if (result.readFailed) {
+            if (&batch == &batches.front()) {
                 onProgress(L"Failed to read MFT data from disk", 0.0f);
                 return false;
             }
-            recordsScanned += Constants::NTFS::RECORDS_PER_BATCH;
-            continue;
+            recordsScanned += batch.recordCount;
+            return true;
         }
 
-        for (uint64_t j = 0; j < Constants::NTFS::RECORDS_PER_BATCH; ++j) {
-            uint64_t currentRecordIdx = i + j;
-            if (currentRecordIdx >= maxRecords || shouldStop) break;
+        for (const auto& directory : result.directories) {
+            m_directoryIndex.AddDirectory(directory.record, directory.parentRecord, directory.name);
+        }
+        RetainBatchRecords(batch, result);
 
-            size_t offsetInBuffer = static_cast<size_t>(j * mftRecordSize);
-            if (offsetInBuffer + mftRecordSize > batchData.size()) break;
+        for (auto& pending : result.candidates) {
+            if (shouldStop) break;
+            if (m_directoryIndex.FindMissingAncestor(pending.parentRecord) != 0) {
+                deferred.push_back(std::move(pending));
+                continue;
+            }
+            pending.candidate.path = m_directoryIndex.BuildPath(pending.parentRecord, pending.candidate.name);
+            Perf::Add(Perf::Counter::PathsBuilt);
+            if (DeliverCandidate(pending.candidate, folderFilter, filenameFilter, onFileFound)) {
+                filesFound++;
+            }
+        }
+        recordsScanned += result.recordsParsed;
 
-            std::vector<uint8_t> recordData(
-                batchData.begin() + static_cast<size_t>(offsetInBuffer), 
-                batchData.begin() + static_cast<size_t>(offsetInBuffer + mftRecordSize)
-            );
+        if (batch.firstRecord >= nextProgressRecord) {
+            nextProgressRecord = batch.firstRecord + Constants::Progress::MFT_SCAN_INTERVAL;
+            float progress = static_cast<float>(batch.firstRecord) / totalRecords;
+            wchar_t statusMsg[256];
+            swprintf_s(statusMsg, L"Stage 1 (MFT): Scanned %llu records, found %llu deleted files",
+                       batch.firstRecord, filesFound);
+            onProgress(statusMsg, progress * 0.33f);
+        }
+        return true;
+    };
 
-            ApplyFixups(recordData, boot.bytesPerSector);
+    const size_t workerCount = std::max<size_t>(1, config.parallelThreads);
 
-            bool foundFile = ParseMFTRecord(recordData, currentRecordIdx, onFileFound, disk, boot,
-                                          folderFilter, filenameFilter);
-            if (foundFile) filesFound++;
-            recordsScanned++;
+    if (workerCount == 1) {
+        AlignedBuffer batchBuffer(batchReadSize);
+        if (!batchBuffer.IsValid()) {
+            onProgress(L"Failed to allocate MFT read buffer", 0.0f);
+            return false;
         }
 
-        if ((i % Constants::Progress::MFT_SCAN_INTERVAL) == 0) {
-            float progress = static_cast<float>(i) / maxRecords;
-            wchar_t statusMsg[256];
-            swprintf_s(statusMsg, L"Stage 1 (MFT): Scanned %llu records, found %llu deleted files", i, filesFound);
-            onProgress(statusMsg, progress * 0.33f);
+        for (const auto& batch : batches) {
+            if (shouldStop) break;
+            auto result = ScanMftBatch(disk, boot, batch, mftRecordSize,
+                                       batchBuffer.Data(), batchBuffer.Size(), readMode, m_retainRecords);
+            if (!consumeBatch(batch, result)) return false;
+        }
+    } else {
+        // Workers read and parse batches ahead of the consumer; at most two
+        // batches per worker are in flight, which bounds memory use
+        const size_t maxInFlight = workerCount * 2;
+        AlignedBufferPool bufferPool(maxInFlight * (batchReadSize + Constants::ALLOCATION_GRANULARITY));
+        std::deque<std::future<MftBatchResult>> inFlight;
+        size_t nextBatch = 0;
+
+        auto launch = [&](const MftBatch& batch) {
+            bool retainRecords = m_retainRecords;
+            return std::async(std::launch::async, [this, &disk, &boot, &bufferPool, batch,
+                                                   mftRecordSize, batchReadSize, readMode, retainRecords]() {
+                auto buffer = bufferPool.Acquire(batchReadSize);
+                if (!buffer.IsValid()) {
+                    MftBatchResult failed;
+                    failed.readFailed = true;
+                    return failed;
+                }
+                return ScanMftBatch(disk, boot, batch, mftRecordSize,
+                                    buffer.Data(), buffer.Size(), readMode, retainRecords);
+            });
+        };
+
+        size_t consumed = 0;
+        while (consumed < batches.size()) {
+            while (!shouldStop && nextBatch < batches.size() && inFlight.size() < maxInFlight) {
+                inFlight.push_back(launch(batches[nextBatch++]));
+            }
+            if (inFlight.empty()) break;
+
+            auto result = inFlight.front().get();
+            inFlight.pop_front();
+            if (!consumeBatch(batches[consumed++], result)) return false;
         }
     }
     
+    // Pass two: parents in skipped or later batches are fetched level by
+    // level, then every remaining path resolves from memory
+    if (!deferred.empty()) {
+        wchar_t resolveMsg[256];
+        swprintf_s(resolveMsg, L"Stage 1 (MFT): Resolving paths for %llu files",
+                   static_cast<uint64_t>(deferred.size()));
+        onProgress(resolveMsg, 0.33f);
+
+        if (!shouldStop) {
+            std::vector<uint64_t> parents;
+            parents.reserve(deferred.size());
+            for (const auto& pending : deferred) {
+                parents.push_back(pending.parentRecord);
+            }
+            FetchMissingDirectories(disk, boot, parents);
+        }
+
+        for (auto& pending : deferred) {
+            pending.candidate.path = m_directoryIndex.BuildPath(pending.parentRecord, pending.candidate.name);
+            Perf::Add(Perf::Counter::PathsBuilt);
+            if (DeliverCandidate(pending.candidate, folderFilter, filenameFilter, onFileFound)) {
+                filesFound++;
+            }
+        }
+    }
+
     wchar_t finalMsg[256];
     swprintf_s(finalMsg, L"MFT scan complete: %llu records scanned, %llu deleted files found", 
                recordsScanned, filesFound);
@@ -709,4 +1292,69 @@ bool NTFSScanner::ScanVolume(
 
     return true;
 }
-} // namespace KVC
\ No newline at end of file
+
+bool NTFSScanner::ScanRecords(
+    DiskHandle& disk,
+    std::vector<uint64_t> recordNums,
+    const std::wstring& folderFilter,
+    const std::wstring& filenameFilter,
+    DiskForensicsCore::FileFoundCallback onFileFound,
+    DiskForensicsCore::ProgressCallback onProgress,
+    bool& shouldStop)
+{
+    NTFSBootSector boot = ReadBootSector(disk);
+    if (std::memcmp(boot.oemID, "NTFS    ", 8) != 0) return false;
+
+    uint64_t bytesPerCluster = boot.bytesPerSector * boot.sectorsPerCluster;
+    m_diskTotalClusters = disk.GetDiskSize() / bytesPerCluster;
+
+    wchar_t startMsg[256];
+    swprintf_s(startMsg, L"Stage 1 (MFT): Re-reading %llu changed records",
+               static_cast<uint64_t>(recordNums.size()));
+    onProgress(startMsg, 0.0f);
+
+    // Directories first, so every candidate's path sees the current tree
+    std::vector<PendingCandidate> candidates;
+    uint64_t recordsParsed = 0;
+    bool completed = ReadMFTRecords(disk, boot, std::move(recordNums),
+        [&](uint64_t recordNum, std::span<const uint8_t> data) {
+            if (shouldStop) return false;
+
+            std::wstring name;
+            uint64_t parentRecord = 0;
+            PendingCandidate pending;
+            if (ParseDirectoryRecord(data, name, parentRecord)) {
+                m_directoryIndex.ReplaceDirectory(recordNum, parentRecord, name);
+            } else if (BuildCandidate(data, recordNum, boot, pending.candidate, pending.parentRecord)) {
+                candidates.push_back(std::move(pending));
+            }
+            recordsParsed++;
+            return true;
+        });
+    Perf::Add(Perf::Counter::MftRecordsParsed, recordsParsed);
+    if (!completed) return false;
+
+    std::vector<uint64_t> parents;
+    parents.reserve(candidates.size());
+    for (const auto& pending : candidates) {
+        parents.push_back(pending.parentRecord);
+    }
+    FetchMissingDirectories(disk, boot, parents);
+
+    uint64_t filesFound = 0;
+    for (auto& pending : candidates) {
+        pending.candidate.path = m_directoryIndex.BuildPath(pending.parentRecord, pending.candidate.name);
+        Perf::Add(Perf::Counter::PathsBuilt);
+        if (DeliverCandidate(pending.candidate, folderFilter, filenameFilter, onFileFound)) {
+            filesFound++;
+        }
+    }
+
+    wchar_t finalMsg[256];
+    swprintf_s(finalMsg, L"MFT update complete: %llu records re-read, %llu deleted files found",
+               recordsParsed, filesFound);
+    onProgress(finalMsg, 0.33f);
+
+    return true;
+}
+} // namespace KVC
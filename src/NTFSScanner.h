@@ -16,9 +16,14 @@
 #include "ForensicsExceptions.h"
 #include "Constants.h"
 #include "StringUtils.h"
+#include "DirectoryIndex.h"
+#include "ClusterBitmap.h"
 #include <map>
 #include <vector>
 #include <optional>
+#include <span>
+#include <functional>
+#include <utility>
 
 namespace KVC {
 
@@ -179,22 +184,156 @@ public:
         const ScanConfiguration& config
     );
 
+    // Re-parse only recordNums (records the change journal says were touched)
+    // against the directory table already loaded. Directories update the
+    // table; deleted files are filtered and reported as in ScanVolume.
+    bool ScanRecords(
+        DiskHandle& disk,
+        std::vector<uint64_t> recordNums,
+        const std::wstring& folderFilter,
+        const std::wstring& filenameFilter,
+        DiskForensicsCore::FileFoundCallback onFileFound,
+        DiskForensicsCore::ProgressCallback onProgress,
+        bool& shouldStop
+    );
+
     NTFSBootSector ReadBootSector(DiskHandle& disk);
+    static uint64_t MftRecordSize(const NTFSBootSector& boot);
+    // Records in the $MFT stream found by the last ScanVolume (0 if unknown)
+    uint64_t MftRecordCount() const { return m_mftRecordCount; }
+    // Reads through $MFT's own data runs, so fragmented MFTs resolve correctly
     std::vector<uint8_t> ReadMFTRecord(DiskHandle& disk, const NTFSBootSector& boot, uint64_t recordNum);
-    bool ParseMFTRecord(const std::vector<uint8_t>& data, uint64_t recordNum,
+
+    // Return false to stop; data is empty when the record is unavailable
+    using MftRecordVisitor = std::function<bool(uint64_t recordNum, std::span<const uint8_t> data)>;
+
+    // Visit fixed-up records once each, in ascending order. Neighbours are
+    // coalesced into sequential reads, and records the last ScanVolume parsed
+    // come from memory (empty if that slot held no FILE record).
+    // Returns false if the visitor stopped early.
+    bool ReadMFTRecords(DiskHandle& disk, const NTFSBootSector& boot,
+                        std::vector<uint64_t> recordNums, const MftRecordVisitor& visitor);
+
+    // Mark the clusters $Bitmap (record 6) reports in use. allocated must
+    // already be sized to the volume; false if the bitmap could not be read
+    bool LoadVolumeBitmap(DiskHandle& disk, const NTFSBootSector& boot, ClusterBitmap& allocated);
+
+    // Forget the MFT layout, directory index and retained records; call
+    // before working on a different volume
+    void ResetSession();
+
+    // Parent directory table of this session; saved and restored by the scan index
+    DirectoryIndex& Directories() { return m_directoryIndex; }
+    const DirectoryIndex& Directories() const { return m_directoryIndex; }
+
+    // Parsers take a view of one fixed-up record; vectors convert implicitly,
+    // and the MFT scan passes records in place inside its batch buffer
+    bool ParseMFTRecord(std::span<const uint8_t> data, uint64_t recordNum,
         DiskForensicsCore::FileFoundCallback& callback, DiskHandle& disk, const NTFSBootSector& boot,
         const std::wstring& folderFilter, const std::wstring& filenameFilter);
     
     // NEW: Parse MFT record into FragmentedFile structure
     std::optional<FragmentedFile> ParseMFTRecordToFragmentedFile(
-        const std::vector<uint8_t>& data,
+        std::span<const uint8_t> data,
         uint64_t recordNum,
         const NTFSBootSector& boot
     );
 
 private:
+    // One contiguous slice of the MFT fetched with a single read
+    struct MftBatch {
+        uint64_t firstRecord;
+        uint64_t recordCount;
+        uint64_t diskOffset;
+        bool spansExtents = false;  // Single record split across two extents
+    };
+
+    // Byte range of the $MFT data stream and where it lives on the volume
+    struct MftExtent {
+        uint64_t fileOffset;
+        uint64_t diskOffset;
+        uint64_t length;
+    };
+
+    // Parse record 0's $DATA runs (following $ATTRIBUTE_LIST) and $BITMAP.
+    // On failure the MFT is treated as one contiguous run at boot.mftCluster.
+    bool LoadMftLayout(DiskHandle& disk, const NTFSBootSector& boot);
+    void CollectMftDataRuns(std::span<const uint8_t> record, const NTFSBootSector& boot,
+                            std::vector<ClusterRun>& runs, uint64_t& initializedSize,
+                            std::vector<uint64_t>* extensionRecords, std::vector<uint8_t>* bitmap,
+                            DiskHandle& disk) const;
+    std::vector<uint8_t> ReadNonResidentStream(DiskHandle& disk, const NTFSBootSector& boot,
+                                               const std::vector<ClusterRun>& runs, uint64_t size) const;
+
+    // Read size bytes of the $MFT stream starting at fileOffset
+    std::vector<uint8_t> ReadMftBytes(DiskHandle& disk, const NTFSBootSector& boot,
+                                      uint64_t fileOffset, uint64_t size) const;
+    bool TranslateMftOffset(const NTFSBootSector& boot, uint64_t fileOffset,
+                            uint64_t& diskOffset, uint64_t& contiguousBytes) const;
+
+    bool IsMftRecordInUse(uint64_t recordNum) const {
+        uint64_t byteIndex = recordNum >> 3;
+        return byteIndex < m_mftBitmap.size() && (m_mftBitmap[byteIndex] >> (recordNum & 7)) & 1;
+    }
+
+    // Batches covering records that may hold deleted files, in record order
+    std::vector<MftBatch> PlanMftBatches(const NTFSBootSector& boot, uint64_t maxRecords) const;
+
+    // Candidate waiting for its path; parentRecord comes from the chosen $FILE_NAME
+    struct PendingCandidate {
+        RecoveryCandidate candidate;
+        uint64_t parentRecord;
+    };
+
+    // Directory record seen while streaming the MFT (any allocation state)
+    struct ParsedDirectory {
+        uint64_t record;
+        uint64_t parentRecord;
+        std::wstring name;
+    };
+
+    // Deleted-file candidates parsed from one batch, paths not yet resolved
+    struct MftBatchResult {
+        std::vector<PendingCandidate> candidates;
+        std::vector<ParsedDirectory> directories;
+        std::vector<uint64_t> retainedRecords;  // Other FILE records, copied for ReadMFTRecords
+        std::vector<uint8_t> retainedData;
+        uint64_t recordsParsed = 0;
+        bool readFailed = false;
+    };
+
+    // Read, fix up and parse one batch; thread-safe (no scanner state written)
+    MftBatchResult ScanMftBatch(DiskHandle& disk, const NTFSBootSector& boot, const MftBatch& batch,
+                                uint64_t mftRecordSize, uint8_t* buffer, size_t bufferSize,
+                                DiskHandle::ReadMode mode, bool retainRecords) const;
+
+    // Keep a consumed batch's records for later stages, within the cache budget
+    void RetainBatchRecords(const MftBatch& batch, MftBatchResult& result);
+
+    // True if the last ScanVolume parsed recordNum; data is empty for slots
+    // without a FILE record
+    bool FindScannedRecord(uint64_t recordNum, std::span<const uint8_t>& data) const;
+
+    // Build a candidate from a deleted file record; true if it carries a name
+    bool BuildCandidate(std::span<const uint8_t> data, uint64_t recordNum,
+                        const NTFSBootSector& boot, RecoveryCandidate& candidate,
+                        uint64_t& parentRecord) const;
+
+    // Name and parent of a directory record; false for files and non-records
+    static bool ParseDirectoryRecord(std::span<const uint8_t> data, std::wstring& name,
+                                     uint64_t& parentRecord);
+
+    // Apply filters and report a candidate whose path is set; single-threaded
+    bool DeliverCandidate(RecoveryCandidate& candidate,
+                          const std::wstring& folderFilter, const std::wstring& filenameFilter,
+                          DiskForensicsCore::FileFoundCallback& callback);
+
+    // Read unindexed ancestors (sorted, one pass per tree level) into the index
+    void FetchMissingDirectories(DiskHandle& disk, const NTFSBootSector& boot,
+                                 const std::vector<uint64_t>& parentRecords);
+
     // Legacy interface for compatibility
-    std::vector<ClusterRange> ParseDataRuns(const uint8_t* runData, size_t maxSize, uint64_t bytesPerCluster = 4096);
+    std::vector<ClusterRange> ParseDataRuns(const uint8_t* runData, size_t maxSize, uint64_t bytesPerCluster = 4096) const;
     
     // NEW: Enhanced data run parsing with validation
     NTFSDataRunParser::ParseResult ParseDataRunsEnhanced(
@@ -202,14 +341,26 @@ private:
         size_t maxSize,
         uint64_t bytesPerCluster,
         uint64_t maxCluster
-    );
+    ) const;
     
-    std::wstring ReconstructPath(DiskHandle& disk, const NTFSBootSector& boot, 
-                              uint64_t mftRecord, const std::wstring& filename);
-    bool ApplyFixups(std::vector<uint8_t>& recordData, uint16_t bytesPerSector);
+    static bool ApplyFixups(std::span<uint8_t> recordData, uint16_t bytesPerSector);
 
-    std::map<uint64_t, std::wstring> m_pathCache;
+    DirectoryIndex m_directoryIndex;      // Pass-one parent directory table
     uint64_t m_diskTotalClusters;  // For validation
+
+    std::vector<MftExtent> m_mftExtents;  // Sorted by fileOffset; empty = contiguous
+    std::vector<uint8_t> m_mftBitmap;     // $MFT:$BITMAP, one bit per record in use
+    uint64_t m_mftRecordCount;            // Initialized records (0 = unknown)
+    bool m_mftLayoutLoaded;
+
+    // Records seen by the last ScanVolume. Reported candidates are not
+    // copied; callers that still want one get it from disk.
+    std::vector<std::pair<uint64_t, uint64_t>> m_scannedRanges;  // Ascending [first, end)
+    std::vector<uint64_t> m_retainedRecords;     // Ascending
+    std::vector<uint8_t> m_retainedRecordData;   // m_retainedRecordSize bytes per record
+    std::vector<uint64_t> m_candidateRecords;    // Ascending
+    uint64_t m_retainedRecordSize;
+    bool m_retainRecords;
 };
 
 } // namespace KVC
@@ -0,0 +1,298 @@
+// ============================================================================
+// OutputSink.cpp - Recovered File Writers
+// ============================================================================
+
+#include "OutputSink.h"
+#include "Constants.h"
+#include "ForensicsExceptions.h"
+#include <winioctl.h>
+#include <algorithm>
+#include <cstring>
+
+namespace KVC {
+
+namespace {
+
+std::string NarrowPath(const std::wstring& path) {
+    int length = WideCharToMultiByte(CP_UTF8, 0, path.c_str(), static_cast<int>(path.size()),
+                                     nullptr, 0, nullptr, nullptr);
+    std::string result(static_cast<size_t>(std::max(length, 0)), '\0');
+    if (length > 0) {
+        WideCharToMultiByte(CP_UTF8, 0, path.c_str(), static_cast<int>(path.size()),
+                            &result[0], length, nullptr, nullptr);
+    }
+    return result;
+}
+
+uint64_t AlignUp(uint64_t value) {
+    const uint64_t alignment = Constants::Output::ALIGNMENT;
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+// ============================================================================
+// OutputSink
+// ============================================================================
+
+std::unique_ptr<OutputSink> OutputSink::Open(const std::wstring& path) {
+    HANDLE handle = CreateFileW(
+        path.c_str(),
+        GENERIC_WRITE,
+        0,
+        nullptr,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING | FILE_FLAG_OVERLAPPED,
+        nullptr
+    );
+
+    if (handle != INVALID_HANDLE_VALUE) {
+        auto direct = std::make_unique<DirectOutputSink>(handle, path);
+        if (direct->IsValid()) {
+            return direct;
+        }
+    }
+
+    // Network shares and some filter drivers refuse unbuffered handles
+    auto stream = std::make_unique<StreamOutputSink>(path);
+    if (!stream->IsOpen()) {
+        throw RecoveryError("Failed to create output file");
+    }
+    return stream;
+}
+
+// ============================================================================
+// DirectOutputSink
+// ============================================================================
+
+DirectOutputSink::DirectOutputSink(HANDLE handle, const std::wstring& path)
+    : m_handle(handle)
+    , m_event(CreateEventW(nullptr, TRUE, FALSE, nullptr))
+    , m_path(NarrowPath(path))
+    , m_blocks{ AlignedBuffer(Constants::Output::BLOCK_SIZE), AlignedBuffer(Constants::Output::BLOCK_SIZE) }
+    , m_active(0)
+    , m_fill(0)
+    , m_blockOffset(0)
+    , m_pending{}
+    , m_inFlight(false)
+    , m_sparse(SparseState::Untried)
+{}
+
+DirectOutputSink::~DirectOutputSink() {
+    if (m_handle != INVALID_HANDLE_VALUE) {
+        // Abandoned mid-file: the buffer must outlive any write still in flight
+        if (m_inFlight) {
+            DWORD transferred = 0;
+            GetOverlappedResult(m_handle, &m_pending, &transferred, TRUE);
+        }
+        CloseHandle(m_handle);
+    }
+    if (m_event != nullptr) {
+        CloseHandle(m_event);
+    }
+}
+
+void DirectOutputSink::Reserve(uint64_t size) {
+    // Best effort: one allocation up front instead of growth per write
+    FILE_ALLOCATION_INFO allocation = {};
+    allocation.AllocationSize.QuadPart = static_cast<LONGLONG>(AlignUp(size));
+    SetFileInformationByHandle(m_handle, FileAllocationInfo, &allocation, sizeof(allocation));
+}
+
+void DirectOutputSink::Write(const uint8_t* data, size_t size) {
+    while (size > 0) {
+        size_t chunk = std::min(size, Constants::Output::BLOCK_SIZE - m_fill);
+        memcpy(m_blocks[m_active].Data() + m_fill, data, chunk);
+        m_fill += chunk;
+        m_position += chunk;
+        data += chunk;
+        size -= chunk;
+
+        if (m_fill == Constants::Output::BLOCK_SIZE) {
+            SubmitBlock(m_fill);
+        }
+    }
+}
+
+void DirectOutputSink::WriteZeros(uint64_t size) {
+    const uint64_t alignment = Constants::Output::ALIGNMENT;
+
+    if (m_sparse != SparseState::Unsupported && size >= Constants::Output::MIN_SPARSE_HOLE) {
+        // Zero-pad the staged block to alignment so the hole starts on a boundary
+        uint64_t lead = std::min<uint64_t>(size, (alignment - m_fill % alignment) % alignment);
+        uint64_t hole = (size - lead) / alignment * alignment;
+
+        if (hole >= Constants::Output::MIN_SPARSE_HOLE) {
+            AppendZeros(lead);
+            if (PunchHole(hole)) {
+                AppendZeros(size - lead - hole);
+                return;
+            }
+            size -= lead;
+        }
+    }
+
+    AppendZeros(size);
+}
+
+void DirectOutputSink::Close() {
+    if (m_handle == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    // The tail goes out padded to a sector multiple and is trimmed below
+    if (m_fill > 0) {
+        size_t padded = static_cast<size_t>(AlignUp(m_fill));
+        memset(m_blocks[m_active].Data() + m_fill, 0, padded - m_fill);
+        SubmitBlock(padded);
+    }
+    WaitPending();
+
+    if (!SetFileSize(m_position)) {
+        Fail();
+    }
+
+    CloseHandle(m_handle);
+    m_handle = INVALID_HANDLE_VALUE;
+}
+
+void DirectOutputSink::AppendZeros(uint64_t size) {
+    while (size > 0) {
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(size, Constants::Output::BLOCK_SIZE - m_fill));
+        memset(m_blocks[m_active].Data() + m_fill, 0, chunk);
+        m_fill += chunk;
+        m_position += chunk;
+        size -= chunk;
+
+        if (m_fill == Constants::Output::BLOCK_SIZE) {
+            SubmitBlock(m_fill);
+        }
+    }
+}
+
+bool DirectOutputSink::PunchHole(uint64_t size) {
+    // Staged data must land before the file is extended past it
+    if (m_fill > 0) {
+        SubmitBlock(m_fill);
+    }
+    WaitPending();
+
+    if (m_sparse == SparseState::Untried) {
+        // FAT32/exFAT destinations (typical recovery USB sticks) reject this
+        m_sparse = Control(FSCTL_SET_SPARSE, nullptr, 0) ? SparseState::Enabled : SparseState::Unsupported;
+    }
+    if (m_sparse != SparseState::Enabled) {
+        return false;
+    }
+
+    // Deallocates whatever Reserve() preallocated under the hole
+    FILE_ZERO_DATA_INFORMATION zero = {};
+    zero.FileOffset.QuadPart = static_cast<LONGLONG>(m_blockOffset);
+    zero.BeyondFinalZero.QuadPart = static_cast<LONGLONG>(m_blockOffset + size);
+    if (!SetFileSize(m_blockOffset + size) || !Control(FSCTL_SET_ZERO_DATA, &zero, sizeof(zero))) {
+        Fail();
+    }
+
+    m_blockOffset += size;
+    m_position += size;
+    return true;
+}
+
+void DirectOutputSink::SubmitBlock(size_t bytes) {
+    // Only one write in flight; it used the other block, which is reused next
+    WaitPending();
+
+    m_pending = {};
+    m_pending.Offset = static_cast<DWORD>(m_blockOffset & 0xFFFFFFFFULL);
+    m_pending.OffsetHigh = static_cast<DWORD>(m_blockOffset >> 32);
+    m_pending.hEvent = m_event;
+    ResetEvent(m_event);
+
+    if (!WriteFile(m_handle, m_blocks[m_active].Data(), static_cast<DWORD>(bytes), nullptr, &m_pending) &&
+        GetLastError() != ERROR_IO_PENDING) {
+        Fail();
+    }
+
+    m_inFlight = true;
+    m_blockOffset += bytes;
+    m_active ^= 1;
+    m_fill = 0;
+}
+
+void DirectOutputSink::WaitPending() {
+    if (!m_inFlight) {
+        return;
+    }
+
+    DWORD transferred = 0;
+    BOOL success = GetOverlappedResult(m_handle, &m_pending, &transferred, TRUE);
+    m_inFlight = false;
+    if (!success) {
+        Fail();
+    }
+}
+
+bool DirectOutputSink::Control(DWORD code, void* input, DWORD inputSize) {
+    // The handle is overlapped, so even control codes need an OVERLAPPED
+    OVERLAPPED overlapped = {};
+    overlapped.hEvent = m_event;
+    ResetEvent(m_event);
+
+    DWORD returned = 0;
+    if (!DeviceIoControl(m_handle, code, input, inputSize, nullptr, 0, &returned, &overlapped)) {
+        if (GetLastError() != ERROR_IO_PENDING) {
+            return false;
+        }
+        return GetOverlappedResult(m_handle, &overlapped, &returned, TRUE) != FALSE;
+    }
+    return true;
+}
+
+bool DirectOutputSink::SetFileSize(uint64_t size) {
+    // Unlike SetEndOfFile this needs no aligned file pointer
+    FILE_END_OF_FILE_INFO endOfFile = {};
+    endOfFile.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+    return SetFileInformationByHandle(m_handle, FileEndOfFileInfo, &endOfFile, sizeof(endOfFile)) != FALSE;
+}
+
+void DirectOutputSink::Fail() {
+    throw DiskWriteError(m_path, GetLastError());
+}
+
+// ============================================================================
+// StreamOutputSink
+// ============================================================================
+
+StreamOutputSink::StreamOutputSink(const std::wstring& path)
+    : m_stream(path, std::ios::binary | std::ios::trunc)
+    , m_path(NarrowPath(path))
+{}
+
+void StreamOutputSink::Write(const uint8_t* data, size_t size) {
+    m_stream.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    if (!m_stream.good()) {
+        throw DiskWriteError(m_path, 0);
+    }
+    m_position += size;
+}
+
+void StreamOutputSink::WriteZeros(uint64_t size) {
+    static const uint8_t zeros[64 * 1024] = {};
+    while (size > 0) {
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(size, sizeof(zeros)));
+        Write(zeros, chunk);
+        size -= chunk;
+    }
+}
+
+void StreamOutputSink::Close() {
+    if (!m_stream.is_open()) {
+        return;
+    }
+    m_stream.close();
+    if (!m_stream.good()) {
+        throw DiskWriteError(m_path, 0);
+    }
+}
+
+} // namespace KVC
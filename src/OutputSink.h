@@ -0,0 +1,110 @@
+// ============================================================================
+// OutputSink.h - Recovered File Writers
+// ============================================================================
+// Append-only destination for recovered data. The direct backend preallocates
+// the file, stages data into large aligned blocks written unbuffered and
+// overlapped (one block in flight while the next fills), and turns long zero
+// gaps into sparse holes. Destinations that refuse unbuffered handles fall
+// back to a plain stream. Throws DiskWriteError on write failures.
+// ============================================================================
+
+#pragma once
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Windows.h>
+#include "AlignedBufferPool.h"
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace KVC {
+
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+
+    // Create (truncate) path with the best available backend
+    // Throws: RecoveryError if the file cannot be created
+    static std::unique_ptr<OutputSink> Open(const std::wstring& path);
+
+    // Hint the final size so the destination can reserve it up front
+    virtual void Reserve(uint64_t size) { (void)size; }
+
+    virtual void Write(const uint8_t* data, size_t size) = 0;
+
+    // Append size zero bytes (a sparse hole where the backend allows it)
+    virtual void WriteZeros(uint64_t size) = 0;
+
+    // Flush and trim the file to Position(); the sink is unusable afterwards
+    virtual void Close() = 0;
+
+    uint64_t Position() const { return m_position; }
+
+protected:
+    uint64_t m_position = 0;
+};
+
+// ============================================================================
+// DirectOutputSink - Unbuffered overlapped Win32 writer
+// ============================================================================
+class DirectOutputSink : public OutputSink {
+public:
+    DirectOutputSink(HANDLE handle, const std::wstring& path);
+    ~DirectOutputSink() override;
+
+    DirectOutputSink(const DirectOutputSink&) = delete;
+    DirectOutputSink& operator=(const DirectOutputSink&) = delete;
+
+    bool IsValid() const { return m_blocks[0].IsValid() && m_blocks[1].IsValid() && m_event != nullptr; }
+
+    void Reserve(uint64_t size) override;
+    void Write(const uint8_t* data, size_t size) override;
+    void WriteZeros(uint64_t size) override;
+    void Close() override;
+
+private:
+    enum class SparseState { Untried, Enabled, Unsupported };
+
+    void AppendZeros(uint64_t size);
+    bool PunchHole(uint64_t size);
+    void SubmitBlock(size_t bytes);
+    void WaitPending();
+    bool Control(DWORD code, void* input, DWORD inputSize);
+    bool SetFileSize(uint64_t size);
+    [[noreturn]] void Fail();
+
+    HANDLE m_handle;
+    HANDLE m_event;
+    std::string m_path;             // UTF-8, for error reports
+    AlignedBuffer m_blocks[2];      // One filling, one possibly in flight
+    size_t m_active;
+    size_t m_fill;                  // Bytes staged in the active block
+    uint64_t m_blockOffset;         // File offset the active block lands at
+    OVERLAPPED m_pending;
+    bool m_inFlight;
+    SparseState m_sparse;
+};
+
+// ============================================================================
+// StreamOutputSink - std::ofstream fallback
+// ============================================================================
+class StreamOutputSink : public OutputSink {
+public:
+    explicit StreamOutputSink(const std::wstring& path);
+
+    bool IsOpen() const { return m_stream.is_open(); }
+
+    void Write(const uint8_t* data, size_t size) override;
+    void WriteZeros(uint64_t size) override;
+    void Close() override;
+
+private:
+    std::ofstream m_stream;
+    std::string m_path;
+};
+
+} // namespace KVC
@@ -0,0 +1,247 @@
+// ============================================================================
+// PerfCounters.cpp - Per-Stage Performance Counters and Scoped Timers
+// ============================================================================
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Windows.h>
+#include <TraceLoggingProvider.h>
+#include "PerfCounters.h"
+#include <algorithm>
+#include <cstdio>
+
+// {6B0E5C3A-2F4D-4E8B-9C71-3A5D2E8F1B47}
+TRACELOGGING_DEFINE_PROVIDER(g_kvcTraceProvider, "KVC.FileRecovery",
+    (0x6b0e5c3a, 0x2f4d, 0x4e8b, 0x9c, 0x71, 0x3a, 0x5d, 0x2e, 0x8f, 0x1b, 0x47));
+
+namespace KVC {
+namespace Perf {
+
+namespace {
+
+constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::Count);
+constexpr size_t TIMER_COUNT = static_cast<size_t>(Timer::Count);
+
+// Own cache line each: worker threads bump different counters at once
+struct alignas(64) Slot {
+    std::atomic<uint64_t> value{ 0 };
+};
+
+struct alignas(64) TimerSlot {
+    std::atomic<uint64_t> calls{ 0 };
+    std::atomic<uint64_t> nanoseconds{ 0 };
+};
+
+std::atomic<bool> g_enabled{ false };
+Slot g_counters[COUNTER_COUNT];
+TimerSlot g_timers[TIMER_COUNT];
+Slot g_readLatency[LATENCY_BUCKETS];
+
+constexpr const char* COUNTER_NAMES[COUNTER_COUNT] = {
+    "read_calls",
+    "bytes_read",
+    "mft_records_parsed",
+    "usn_records_parsed",
+    "paths_built",
+    "path_records_fetched",
+    "signature_hits",
+    "files_carved",
+    "window_cache_hits",
+    "window_cache_misses",
+};
+
+constexpr const char* TIMER_NAMES[TIMER_COUNT] = {
+    "disk_read",
+    "fixups",
+    "path_lookup",
+    "signature_scan",
+    "end_parse",
+    "mft_batch",
+    "usn_chunk",
+    "bandwidth_wait",
+};
+
+size_t LatencyBucket(uint64_t nanoseconds) {
+    uint64_t micros = nanoseconds / 1000;
+    size_t bucket = 0;
+    while (bucket + 1 < LATENCY_BUCKETS && (1ULL << bucket) <= micros) {
+        bucket++;
+    }
+    return bucket;
+}
+
+} // namespace
+
+uint64_t Snapshot::ReadLatencyPercentile(double percentile) const {
+    uint64_t total = 0;
+    for (uint64_t count : readLatency) total += count;
+    if (total == 0) return 0;
+
+    uint64_t target = static_cast<uint64_t>(std::clamp(percentile, 0.0, 1.0) * total);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += readLatency[i];
+        if (seen >= target && seen > 0) return 1ULL << i;
+    }
+    return 1ULL << (LATENCY_BUCKETS - 1);
+}
+
+void Enable(bool enabled) {
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Enabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void Reset() {
+    for (auto& slot : g_counters) slot.value.store(0, std::memory_order_relaxed);
+    for (auto& slot : g_readLatency) slot.value.store(0, std::memory_order_relaxed);
+    for (auto& timer : g_timers) {
+        timer.calls.store(0, std::memory_order_relaxed);
+        timer.nanoseconds.store(0, std::memory_order_relaxed);
+    }
+}
+
+Snapshot Capture() {
+    Snapshot snapshot;
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        snapshot.counters[i] = g_counters[i].value.load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < TIMER_COUNT; i++) {
+        snapshot.timers[i].calls = g_timers[i].calls.load(std::memory_order_relaxed);
+        snapshot.timers[i].nanoseconds = g_timers[i].nanoseconds.load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+        snapshot.readLatency[i] = g_readLatency[i].value.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+const char* CounterName(Counter counter) {
+    size_t index = static_cast<size_t>(counter);
+    return index < COUNTER_COUNT ? COUNTER_NAMES[index] : "unknown";
+}
+
+const char* TimerName(Timer timer) {
+    size_t index = static_cast<size_t>(timer);
+    return index < TIMER_COUNT ? TIMER_NAMES[index] : "unknown";
+}
+
+void Add(Counter counter, uint64_t amount) {
+    if (!Enabled()) return;
+    g_counters[static_cast<size_t>(counter)].value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+void AddTime(Timer timer, uint64_t nanoseconds) {
+    if (!Enabled()) return;
+    TimerSlot& slot = g_timers[static_cast<size_t>(timer)];
+    slot.calls.fetch_add(1, std::memory_order_relaxed);
+    slot.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+void RecordReadLatency(uint64_t nanoseconds) {
+    if (!Enabled()) return;
+    g_readLatency[LatencyBucket(nanoseconds)].value.fetch_add(1, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// ScopedTimer
+// ============================================================================
+
+ScopedTimer::ScopedTimer(Timer timer)
+    : m_timer(timer)
+    , m_active(Enabled())
+{
+    if (m_active) {
+        m_start = std::chrono::steady_clock::now();
+    }
+}
+
+ScopedTimer::~ScopedTimer() {
+    if (m_active) {
+        AddTime(m_timer, Elapsed());
+    }
+}
+
+uint64_t ScopedTimer::Elapsed() const {
+    if (!m_active) return 0;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_start).count());
+}
+
+// ============================================================================
+// Export
+// ============================================================================
+
+std::string ToJson(const Snapshot& snapshot) {
+    char number[64];
+    std::string json = "{\"counters\":{";
+
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        snprintf(number, sizeof(number), "%s\"%s\":%llu", i > 0 ? "," : "", COUNTER_NAMES[i],
+                 static_cast<unsigned long long>(snapshot.counters[i]));
+        json += number;
+    }
+
+    json += "},\"timers\":{";
+    for (size_t i = 0; i < TIMER_COUNT; i++) {
+        snprintf(number, sizeof(number), "%s\"%s\":{\"calls\":%llu,", i > 0 ? "," : "", TIMER_NAMES[i],
+                 static_cast<unsigned long long>(snapshot.timers[i].calls));
+        json += number;
+        snprintf(number, sizeof(number), "\"ns\":%llu}",
+                 static_cast<unsigned long long>(snapshot.timers[i].nanoseconds));
+        json += number;
+    }
+
+    // Keyed by bucket upper bound in microseconds
+    json += "},\"read_latency_us\":{";
+    bool first = true;
+    for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+        if (snapshot.readLatency[i] == 0) continue;
+        snprintf(number, sizeof(number), "%s\"%s%llu\":%llu", first ? "" : ",",
+                 i + 1 < LATENCY_BUCKETS ? "<" : ">=",
+                 static_cast<unsigned long long>(i + 1 < LATENCY_BUCKETS ? 1ULL << i : 1ULL << (i - 1)),
+                 static_cast<unsigned long long>(snapshot.readLatency[i]));
+        json += number;
+        first = false;
+    }
+
+    return json + "}}";
+}
+
+bool WriteEtwEvents(const Snapshot& snapshot) {
+    if (FAILED(TraceLoggingRegister(g_kvcTraceProvider))) {
+        return false;
+    }
+
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        if (snapshot.counters[i] == 0) continue;
+        TraceLoggingWrite(g_kvcTraceProvider, "Counter",
+            TraceLoggingString(COUNTER_NAMES[i], "Name"),
+            TraceLoggingUInt64(snapshot.counters[i], "Value"));
+    }
+
+    for (size_t i = 0; i < TIMER_COUNT; i++) {
+        if (snapshot.timers[i].calls == 0) continue;
+        TraceLoggingWrite(g_kvcTraceProvider, "Timer",
+            TraceLoggingString(TIMER_NAMES[i], "Name"),
+            TraceLoggingUInt64(snapshot.timers[i].calls, "Calls"),
+            TraceLoggingUInt64(snapshot.timers[i].nanoseconds, "Nanoseconds"));
+    }
+
+    for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+        if (snapshot.readLatency[i] == 0) continue;
+        TraceLoggingWrite(g_kvcTraceProvider, "ReadLatency",
+            TraceLoggingUInt64(1ULL << i, "BucketMicros"),
+            TraceLoggingUInt64(snapshot.readLatency[i], "Reads"));
+    }
+
+    TraceLoggingUnregister(g_kvcTraceProvider);
+    return true;
+}
+
+} // namespace Perf
+} // namespace KVC
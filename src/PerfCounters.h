@@ -0,0 +1,111 @@
+// ============================================================================
+// PerfCounters.h - Per-Stage Performance Counters and Scoped Timers
+// ============================================================================
+// Process-wide counters for the scan hot paths: disk reads (count, bytes,
+// latency histogram), records parsed, signature hits versus carved files,
+// cache hit rates, and time spent in fixups, path lookups, signature scans
+// and end parsing. Everything is off until Enable(true); a disabled counter
+// or timer costs one relaxed load. Snapshots export as JSON or ETW events.
+// ============================================================================
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace KVC {
+namespace Perf {
+
+enum class Counter {
+    ReadCalls,              // DiskHandle reads issued (sync, queued or mapped)
+    BytesRead,
+    MftRecordsParsed,
+    UsnRecordsParsed,
+    PathsBuilt,             // Candidate paths assembled from the directory index
+    PathRecordsFetched,     // Directory records read from disk to close path gaps
+    SignatureHits,          // Signature matches handed to the end parser
+    FilesCarved,            // Hits that produced a carved file
+    WindowCacheHits,
+    WindowCacheMisses,
+    Count
+};
+
+enum class Timer {
+    DiskRead,               // Synchronous ReadFile / mapped copies
+    Fixups,                 // NTFSScanner::ApplyFixups
+    PathLookup,             // Directory gap fetches during path resolution
+    SignatureScan,          // Batch slices scanned by the signature matcher
+    EndParse,               // FileCarver::ParseFileEnd
+    MftBatch,               // One MFT batch: read, fixups and parse
+    UsnChunk,               // One $J chunk: read and record walk
+    BandwidthWait,          // Reads held back by the shared bandwidth budget
+    Count
+};
+
+// Read latency buckets: bucket i holds reads under 2^i microseconds,
+// the last one everything slower
+constexpr size_t LATENCY_BUCKETS = 24;
+
+struct TimerTotals {
+    uint64_t calls = 0;
+    uint64_t nanoseconds = 0;
+};
+
+struct Snapshot {
+    std::array<uint64_t, static_cast<size_t>(Counter::Count)> counters = {};
+    std::array<TimerTotals, static_cast<size_t>(Timer::Count)> timers = {};
+    std::array<uint64_t, LATENCY_BUCKETS> readLatency = {};
+
+    uint64_t Get(Counter counter) const { return counters[static_cast<size_t>(counter)]; }
+    const TimerTotals& Get(Timer timer) const { return timers[static_cast<size_t>(timer)]; }
+
+    // Upper bound of the bucket holding the given percentile (0..1), in us
+    uint64_t ReadLatencyPercentile(double percentile) const;
+};
+
+void Enable(bool enabled);
+bool Enabled();
+
+// Zero every counter, timer and bucket
+void Reset();
+
+Snapshot Capture();
+
+const char* CounterName(Counter counter);
+const char* TimerName(Timer timer);
+
+void Add(Counter counter, uint64_t amount = 1);
+void AddTime(Timer timer, uint64_t nanoseconds);
+void RecordReadLatency(uint64_t nanoseconds);
+
+// Times its scope into one timer; inert while counters are disabled
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Timer timer);
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    // Nanoseconds since construction (0 while disabled)
+    uint64_t Elapsed() const;
+
+private:
+    Timer m_timer;
+    bool m_active;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// One JSON object, no trailing newline
+std::string ToJson(const Snapshot& snapshot);
+
+// Writes the snapshot as TraceLogging events (provider "KVC.FileRecovery"):
+// one per non-zero counter and timer plus the latency histogram.
+// Returns false if the provider could not be registered.
+bool WriteEtwEvents(const Snapshot& snapshot);
+
+} // namespace Perf
+} // namespace KVC
@@ -51,9 +51,14 @@ RecoveryApplication::RecoveryApplication(HINSTANCE hInstance)
     , m_hwndCheckMft(nullptr)
     , m_hwndCheckUsn(nullptr)
     , m_hwndCheckCarving(nullptr)
+    , m_hwndCheckUnbuffered(nullptr)
+    , m_hwndCheckFreeSpace(nullptr)
+    , m_hwndCheckReuseScan(nullptr)
     , m_hwndBrowseFolderButton(nullptr)
     , m_isScanning(false)
     , m_shouldStopScan(false)
+    , m_delivery(Constants::Results::DELIVERY_RING_SLOTS)
+    , m_isSorting(false)
     , m_lastScannedDrive(L'C')                  // Default drive selection
 {
     m_forensicsCore = std::make_unique<DiskForensicsCore>();   // Low-level disk scanner
@@ -200,6 +205,24 @@ void RecoveryApplication::CreateControls() {
         490, 120, 170, 20, m_hwnd, reinterpret_cast<HMENU>(static_cast<UINT_PTR>(CHECK_CARVING_ID)), m_hInstance, nullptr);
     SendMessage(m_hwndCheckCarving, WM_SETFONT, (WPARAM)hFont, TRUE);
 
+    // Unbuffered reads checkbox (off by default).
+    m_hwndCheckUnbuffered = CreateWindowExW(0, L"BUTTON", L"Unbuffered Reads",
+        WS_VISIBLE | WS_CHILD | BS_AUTOCHECKBOX,
+        150, 145, 140, 20, m_hwnd, reinterpret_cast<HMENU>(static_cast<UINT_PTR>(CHECK_UNBUFFERED_ID)), m_hInstance, nullptr);
+    SendMessage(m_hwndCheckUnbuffered, WM_SETFONT, (WPARAM)hFont, TRUE);
+
+    // Scan index and checkpoint checkbox (off by default: nothing is saved).
+    m_hwndCheckReuseScan = CreateWindowExW(0, L"BUTTON", L"Reuse Saved Scan",
+        WS_VISIBLE | WS_CHILD | BS_AUTOCHECKBOX,
+        300, 145, 180, 20, m_hwnd, reinterpret_cast<HMENU>(static_cast<UINT_PTR>(CHECK_REUSE_SCAN_ID)), m_hInstance, nullptr);
+    SendMessage(m_hwndCheckReuseScan, WM_SETFONT, (WPARAM)hFont, TRUE);
+
+    // Free-space-only carving checkbox (off by default: carve every cluster).
+    m_hwndCheckFreeSpace = CreateWindowExW(0, L"BUTTON", L"Carve Free Space Only",
+        WS_VISIBLE | WS_CHILD | BS_AUTOCHECKBOX,
+        490, 145, 170, 20, m_hwnd, reinterpret_cast<HMENU>(static_cast<UINT_PTR>(CHECK_FREE_SPACE_ID)), m_hInstance, nullptr);
+    SendMessage(m_hwndCheckFreeSpace, WM_SETFONT, (WPARAM)hFont, TRUE);
+
     // Start scan button.
     m_hwndScanButton = CreateWindowExW(0, L"BUTTON", L"Start Scan",
         WS_VISIBLE | WS_CHILD | BS_PUSHBUTTON,
@@ -403,30 +426,30 @@ LRESULT RecoveryApplication::HandleMessage(UINT uMsg, WPARAM wParam, LPARAM lPar
                     std::lock_guard<std::mutex> lock(m_filesMutex); // Protect shared data
                     
                     // Provide data for virtual ListView items.
-                    if (itemIndex >= 0 && itemIndex < static_cast<int>(m_filteredFiles.size())) {
-                        const auto& file = m_filteredFiles[itemIndex];
+                    if (itemIndex >= 0 && itemIndex < static_cast<int>(m_view.size())) {
+                        ResultStore::Index row = m_view[itemIndex];
 
                         if (pDispInfo->item.mask & LVIF_TEXT) {
                             switch (pDispInfo->item.iSubItem) {
                             case 0: // Name
                                 wcsncpy_s(pDispInfo->item.pszText, pDispInfo->item.cchTextMax, 
-                                         file.name.c_str(), _TRUNCATE);
+                                         m_results.Name(row), _TRUNCATE);
                                 break;
                             case 1: // Path
                                 wcsncpy_s(pDispInfo->item.pszText, pDispInfo->item.cchTextMax, 
-                                         file.path.c_str(), _TRUNCATE);
+                                         m_results.Path(row), _TRUNCATE);
                                 break;
-                            case 2: // Size
+                            case 2: // Size (formatted on demand)
                                 wcsncpy_s(pDispInfo->item.pszText, pDispInfo->item.cchTextMax, 
-                                         file.sizeFormatted.c_str(), _TRUNCATE);
+                                         m_results.SizeText(row).c_str(), _TRUNCATE);
                                 break;
                             case 3: // Type
                                 wcsncpy_s(pDispInfo->item.pszText, pDispInfo->item.cchTextMax, 
-                                         file.filesystemType.c_str(), _TRUNCATE);
+                                         m_results.FilesystemType(row), _TRUNCATE);
                                 break;
                             case 4: // Recoverable
                                 wcsncpy_s(pDispInfo->item.pszText, pDispInfo->item.cchTextMax, 
-                                         file.isRecoverable ? L"Yes" : L"No", _TRUNCATE);
+                                         m_results.IsRecoverable(row) ? L"Yes" : L"No", _TRUNCATE);
                                 break;
                             }
                         }
@@ -443,11 +466,21 @@ LRESULT RecoveryApplication::HandleMessage(UINT uMsg, WPARAM wParam, LPARAM lPar
         SendMessage(m_hwndProgress, PBM_SETPOS, wParam, 0); // Update progress bar
         break;
 
+    case WM_TIMER:
+        if (wParam == RESULTS_TIMER_ID) {
+            DrainResults();                      // Take the latest batch of results
+        }
+        break;
+
     case WM_SCAN_FILE_FOUND:
-        PopulateResultsList();                   // Refresh results when file is found
+        DrainResults();                          // Scan thread is waiting for ring space
         break;
 
     case WM_SCAN_COMPLETE:
+        // Everything the scan delivered is queued by now
+        KillTimer(m_hwnd, RESULTS_TIMER_ID);
+        DrainResults();
+
         // Restore UI state after scan completes.
         ShowWindow(m_hwndScanButton, SW_SHOW);
         ShowWindow(m_hwndStopButton, SW_HIDE);
@@ -455,6 +488,9 @@ LRESULT RecoveryApplication::HandleMessage(UINT uMsg, WPARAM wParam, LPARAM lPar
         EnableWindow(m_hwndCheckMft, TRUE);
         EnableWindow(m_hwndCheckUsn, TRUE);
         EnableWindow(m_hwndCheckCarving, TRUE);
+        EnableWindow(m_hwndCheckUnbuffered, TRUE);
+        EnableWindow(m_hwndCheckFreeSpace, TRUE);
+        EnableWindow(m_hwndCheckReuseScan, TRUE);
         m_isScanning = false;
         
         if (m_scanThread && m_scanThread->joinable()) {
@@ -477,13 +513,16 @@ LRESULT RecoveryApplication::HandleMessage(UINT uMsg, WPARAM wParam, LPARAM lPar
         EnableWindow(m_hwndCheckMft, TRUE);
         EnableWindow(m_hwndCheckUsn, TRUE);
         EnableWindow(m_hwndCheckCarving, TRUE);
+        EnableWindow(m_hwndCheckUnbuffered, TRUE);
+        EnableWindow(m_hwndCheckFreeSpace, TRUE);
+        EnableWindow(m_hwndCheckReuseScan, TRUE);
         UpdateStatusBar(wParam ? L"Recovery Completed" : L"Recovery Failed");
         break;
 
     case WM_SORT_COMPLETE:
         {
             // Refresh ListView after background sort completes.
-            int count = static_cast<int>(m_filteredFiles.size());
+            int count = static_cast<int>(m_view.size());
             if (count > 0) {
                 ListView_RedrawItems(m_hwndListView, 0, count - 1);
                 UpdateWindow(m_hwndListView);
@@ -491,7 +530,7 @@ LRESULT RecoveryApplication::HandleMessage(UINT uMsg, WPARAM wParam, LPARAM lPar
             
             wchar_t status[256];
             swprintf_s(status, L"Sorted %zu files          |          💡 TIP: Use Shift/Ctrl+Arrows to select", 
-                       m_filteredFiles.size());
+                       m_view.size());
             UpdateStatusBar(status);
         }
         break;
@@ -544,7 +583,7 @@ void RecoveryApplication::OnMenuCommand(WORD menuId) {
 }
 // Initiate a new scan operation.
 void RecoveryApplication::OnStartScan() {
-    if (m_isScanning) return;                    // Prevent concurrent scans
+    if (m_isScanning || m_isSorting) return;     // Prevent concurrent scans; sorts read the store
 
     int idx = static_cast<int>(SendMessage(m_hwndDriveCombo, CB_GETCURSEL, 0, 0));
     if (idx == CB_ERR) {
@@ -572,8 +611,13 @@ void RecoveryApplication::OnStartScan() {
         return;
     }
 
-    m_deletedFiles.clear();                      // Clear previous results
-    m_filteredFiles.clear();                     // Clear filtered view
+    {
+        std::lock_guard<std::mutex> lock(m_filesMutex);
+        m_results.Clear();                       // Clear previous results
+        m_view.clear();                          // Clear filtered view
+        m_viewedRows = 0;
+        m_viewGeneration++;
+    }
     ListView_SetItemCountEx(m_hwndListView, 0, 0);
 
     // Update UI for scanning state.
@@ -583,10 +627,36 @@ void RecoveryApplication::OnStartScan() {
     EnableWindow(m_hwndCheckMft, FALSE);
     EnableWindow(m_hwndCheckUsn, FALSE);
     EnableWindow(m_hwndCheckCarving, FALSE);
+    EnableWindow(m_hwndCheckUnbuffered, FALSE);
+    EnableWindow(m_hwndCheckFreeSpace, FALSE);
+    EnableWindow(m_hwndCheckReuseScan, FALSE);
+
+    // Read options apply to the scan about to start; none is running
+    m_forensicsCore->SetUnbufferedStreaming(SendMessage(m_hwndCheckUnbuffered, BM_GETCHECK, 0, 0) == BST_CHECKED);
+    m_forensicsCore->SetCarvingUnallocatedOnly(SendMessage(m_hwndCheckFreeSpace, BM_GETCHECK, 0, 0) == BST_CHECKED);
+
+    // Checkpoints and the scan index are kept only when asked for, beside
+    // the executable when that is off the scanned drive
+    bool reuseScan = (SendMessage(m_hwndCheckReuseScan, BM_GETCHECK, 0, 0) == BST_CHECKED);
+    std::wstring checkpointFolder;
+    wchar_t exePath[MAX_PATH] = {};
+    if (reuseScan && GetModuleFileNameW(nullptr, exePath, MAX_PATH) > 0) {
+        std::wstring exeDir = exePath;
+        size_t slash = exeDir.find_last_of(L"\\/");
+        if (slash != std::wstring::npos) exeDir.resize(slash);
+        if (m_recoveryEngine->ValidateDestination(driveLetter[0], exeDir)) {
+            checkpointFolder = exeDir;       // Resumes or updates an earlier scan of this drive
+        }
+    }
+    m_forensicsCore->SetCheckpointFolder(checkpointFolder);
+    m_forensicsCore->SetIncrementalRescan(reuseScan);
 
     m_isScanning = true;
     m_shouldStopScan = false;
 
+    // Results reach the list in timer-sized batches rather than one message each
+    SetTimer(m_hwnd, RESULTS_TIMER_ID, Constants::Results::DRAIN_INTERVAL_MS, nullptr);
+
     // Launch background scan thread.
     m_scanThread = std::make_unique<std::thread>([this, drive = driveLetter[0], folderFilter, filenameFilter, enableMft, enableUsn, enableCarving]() {
         StartBackgroundScan(drive, folderFilter, filenameFilter, enableMft, enableUsn, enableCarving);
@@ -610,12 +680,13 @@ void RecoveryApplication::StartBackgroundScan(wchar_t driveLetter, std::wstring
     };
     
     auto onFile = [this](const DeletedFileEntry& file) {
-        {
-            std::lock_guard<std::mutex> lock(m_filesMutex); // Protect shared results
-            m_deletedFiles.push_back(file);   // Append discovered file
+        DeletedFileEntry entry = file;
+        // A full ring means the UI thread is behind: nudge it and wait for room
+        while (!m_delivery.TryPush(std::move(entry))) {
+            if (m_shouldStopScan) return;
+            PostMessage(m_hwnd, WM_SCAN_FILE_FOUND, 0, 0);
+            Sleep(1);
         }
-        // Synchronous update to ensure UI consistency.
-        SendMessage(m_hwnd, WM_SCAN_FILE_FOUND, 0, 0);
     };
 
     bool success = m_forensicsCore->StartScan(
@@ -634,77 +705,98 @@ void RecoveryApplication::StartBackgroundScan(wchar_t driveLetter, std::wstring
     PostMessage(m_hwnd, WM_SCAN_COMPLETE, success ? 1 : 0, 0);
 }
 
-// Refresh ListView contents after scan update.
-void RecoveryApplication::PopulateResultsList() {
-    FilterResults();                             // Re-apply filters and redraw
+// Move queued scan results into the store and extend the view.
+void RecoveryApplication::DrainResults() {
+    size_t drained = m_delivery.Drain([this](DeletedFileEntry&& entry) {
+        m_results.Append(entry);
+    });
+    if (drained == 0) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_filesMutex);
+        ExtendView();
+    }
+    RefreshResultsView();
 }
 
-// Check if a file matches the selected type filter.
-bool RecoveryApplication::IsFileOfType(const std::wstring& name, int typeIndex) {
-    if (typeIndex <= 0) return true;             // All Files selected
-    size_t dotPos = name.rfind(L'.');            // Locate file extension
-    if (dotPos == std::wstring::npos) return false;
-
-    std::wstring ext = name.substr(dotPos + 1);
-    std::transform(ext.begin(), ext.end(), ext.begin(), ::towlower);
-
-    switch (typeIndex) {
-    case 1: // Documents
-        return (ext == L"doc" || ext == L"docx" || ext == L"pdf" || ext == L"txt" || 
-                ext == L"rtf" || ext == L"xls" || ext == L"xlsx" || ext == L"ppt" || ext == L"pptx");
-    case 2: // Images
-        return (ext == L"jpg" || ext == L"jpeg" || ext == L"png" || ext == L"bmp" || 
-                ext == L"gif" || ext == L"tiff" || ext == L"raw" || ext == L"ico");
-    case 3: // Videos
-        return (ext == L"mp4" || ext == L"avi" || ext == L"mkv" || ext == L"mov" || 
-                ext == L"wmv" || ext == L"flv" || ext == L"mpg");
-    case 4: // Archives
-        return (ext == L"zip" || ext == L"rar" || ext == L"7z" || ext == L"tar" || ext == L"gz");
-    default:
-        return true;
+// Append store rows the view has not filtered yet; m_filesMutex held.
+void RecoveryApplication::ExtendView() {
+    size_t count = m_results.Count();
+    for (size_t i = m_viewedRows; i < count; ++i) {
+        auto index = static_cast<ResultStore::Index>(i);
+        if (MatchesFilter(index)) {
+            m_view.push_back(index);
+        }
     }
+    m_viewedRows = count;
+}
+
+// Check a stored row against the current name and type filters.
+bool RecoveryApplication::MatchesFilter(ResultStore::Index index) const {
+    if (m_filterTypeIndex > 0 &&
+        static_cast<int>(m_results.Category(index)) != m_filterTypeIndex) {
+        return false;                            // Skip non-matching types
+    }
+
+    if (!m_filterText.empty() && !m_results.NameContains(index, m_filterText, m_filterMask)) {
+        return false;                            // Skip non-matching names
+    }
+
+    return true;
 }
 
 // Apply text and type filters to scan results.
 void RecoveryApplication::FilterResults() {
     int typeIndex = static_cast<int>(SendMessage(GetDlgItem(m_hwnd, TYPE_COMBO_ID), CB_GETCURSEL, 0, 0));
+    if (typeIndex < 0) typeIndex = 0;
     wchar_t buffer[MAX_PATH];
     GetWindowTextW(GetDlgItem(m_hwnd, FILTER_EDIT_ID), buffer, MAX_PATH);
     std::wstring searchName = buffer;
     std::transform(searchName.begin(), searchName.end(), searchName.begin(), ::towlower);
 
+    // Typing onto the previous search can only drop rows, so refine the
+    // current view (keeping its sort order) instead of rescanning the store
+    bool refine = typeIndex == m_filterTypeIndex &&
+                  searchName.find(m_filterText) != std::wstring::npos;
+
+    m_filterTypeIndex = typeIndex;
+    m_filterText = std::move(searchName);
+    m_filterMask = ResultStore::TrigramMask(m_filterText);
+
     {
         std::lock_guard<std::mutex> lock(m_filesMutex); // Protect shared data
-        m_filteredFiles.clear();
-
-        for (const auto& file : m_deletedFiles) {
-            if (!searchName.empty()) {
-                std::wstring lowerName = file.name;
-                std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::towlower);
-                if (lowerName.find(searchName) == std::wstring::npos) {
-                    continue;                  // Skip non-matching names
-                }
-            }
+        m_viewGeneration++;                      // An in-flight sort of the old view is discarded
+        if (refine) {
+            std::erase_if(m_view, [this](ResultStore::Index index) { return !MatchesFilter(index); });
+        } else {
+            m_view.clear();
+            m_viewedRows = 0;
+        }
+        ExtendView();
+    }
 
-            if (!IsFileOfType(file.name, typeIndex)) {
-                continue;                      // Skip non-matching types
-            }
+    RefreshResultsView();
+}
 
-            m_filteredFiles.push_back(file);    // Add matching file
-        }
+// Resize the virtual ListView to the view and report counts.
+void RecoveryApplication::RefreshResultsView() {
+    size_t shown = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_filesMutex);
+        shown = m_view.size();
     }
 
     // Update virtual ListView item count.
-    ListView_SetItemCountEx(m_hwndListView, m_filteredFiles.size(), LVSICF_NOINVALIDATEALL | LVSICF_NOSCROLL);
+    ListView_SetItemCountEx(m_hwndListView, shown, LVSICF_NOINVALIDATEALL | LVSICF_NOSCROLL);
 
-    if (!m_filteredFiles.empty()) {
-        ListView_RedrawItems(m_hwndListView, 0, static_cast<int>(m_filteredFiles.size()) - 1);
+    if (shown > 0) {
+        ListView_RedrawItems(m_hwndListView, 0, static_cast<int>(shown) - 1);
     }
     UpdateWindow(m_hwndListView);
 
     wchar_t status[256];
     swprintf_s(status, L"Showing %zu of %zu files          |          💡 TIP: Use Shift/Ctrl+Arrows to select, Ctrl+A for All", 
-               m_filteredFiles.size(), m_deletedFiles.size());
+               shown, m_results.Count());
     UpdateStatusBar(status);
 }
 
@@ -715,8 +807,8 @@ void RecoveryApplication::OnRecoverSelected() {
     for (int i = 0; i < itemCount; ++i) {
         if (ListView_GetCheckState(m_hwndListView, i)) {
             std::lock_guard<std::mutex> lock(m_filesMutex);
-            if (i < static_cast<int>(m_filteredFiles.size())) {
-                selectedFiles.push_back(m_filteredFiles[i]);
+            if (i < static_cast<int>(m_view.size())) {
+                selectedFiles.push_back(m_results.Materialize(m_view[i]));
             }
         }
     }
@@ -843,15 +935,15 @@ void RecoveryApplication::OnExportCSV() {
             csvFile << L"Name,Path,Size,Filesystem,Recoverable\n";
             
             std::lock_guard<std::mutex> lock(m_filesMutex);
-            for (const auto& file : m_filteredFiles) {
-                std::wstring cleanName = file.name;
+            for (ResultStore::Index index : m_view) {
+                std::wstring cleanName = m_results.Name(index);
                 std::replace(cleanName.begin(), cleanName.end(), L',', L'_');
 
                 csvFile << cleanName << L"," 
-                       << file.path << L"," 
-                       << file.sizeFormatted << L"," 
-                       << file.filesystemType << L"," 
-                       << (file.isRecoverable ? L"Yes" : L"No") << L"\n";
+                       << m_results.Path(index) << L"," 
+                       << m_results.SizeText(index) << L"," 
+                       << m_results.FilesystemType(index) << L"," 
+                       << (m_results.IsRecoverable(index) ? L"Yes" : L"No") << L"\n";
             }
             
             MessageBoxW(m_hwnd, L"CSV export completed successfully", L"Export Complete", MB_OK | MB_ICONINFORMATION);
@@ -961,6 +1053,8 @@ void RecoveryApplication::UpdateScanStatus(const std::wstring& status) {
 
 // Handle column header clicks for sorting.
 void RecoveryApplication::OnColumnClick(LPNMLISTVIEW pnmv) {
+    if (m_isSorting) return;                     // One sort at a time
+
     // Update sorting state on UI thread.
     if (pnmv->iSubItem == m_sortColumn) {
         m_sortAscending = !m_sortAscending;
@@ -970,49 +1064,36 @@ void RecoveryApplication::OnColumnClick(LPNMLISTVIEW pnmv) {
     }
 
     UpdateStatusBar(L"Sorting files... please wait");
+    m_isSorting = true;
 
     // Launch background sorting thread to avoid UI freeze on large datasets.
+    // Only row indices move; the store itself is read in place.
     std::thread([this, col = m_sortColumn, asc = m_sortAscending]() {
         
-        std::vector<DeletedFileEntry> tempFiles;
+        std::vector<ResultStore::Index> order;
+        uint64_t generation = 0;
 
         // Copy working data with minimal mutex lock time.
         {
             std::lock_guard<std::mutex> lock(m_filesMutex);
-            tempFiles = m_filteredFiles;
+            order = m_view;
+            generation = m_viewGeneration;
         }
+        const size_t sortedCount = order.size();
 
-        // Sort on background thread without holding mutex.
-        std::sort(tempFiles.begin(), tempFiles.end(), 
-            [col, asc](const DeletedFileEntry& a, const DeletedFileEntry& b) {
-                int result = 0;
-                switch (col) {
-                case 0: // Name
-                    result = _wcsicmp(a.name.c_str(), b.name.c_str());
-                    break;
-                case 1: // Path
-                    result = _wcsicmp(a.path.c_str(), b.path.c_str());
-                    break;
-                case 2: // Size
-                    if (a.size < b.size) result = -1;
-                    else if (a.size > b.size) result = 1;
-                    break;
-                case 3: // Type
-                    result = _wcsicmp(a.filesystemType.c_str(), b.filesystemType.c_str());
-                    break;
-                case 4: // Recoverable
-                    if (a.isRecoverable == b.isRecoverable) result = 0;
-                    else result = (a.isRecoverable ? 1 : -1);
-                    break;
-                }
-                return asc ? (result < 0) : (result > 0);
-            });
+        // Sort on background thread without holding mutex, on precomputed keys.
+        m_results.Sort(order, static_cast<ResultStore::SortColumn>(col), asc);
 
-        // Swap sorted data back with minimal mutex lock time.
+        // Swap sorted data back; rows that arrived meanwhile follow the sorted block.
+        // A view rebuilt by a filter change in the meantime wins.
         {
             std::lock_guard<std::mutex> lock(m_filesMutex);
-            m_filteredFiles = std::move(tempFiles);
+            if (generation == m_viewGeneration) {
+                order.insert(order.end(), m_view.begin() + sortedCount, m_view.end());
+                m_view = std::move(order);
+            }
         }
+        m_isSorting = false;
 
         // Notify UI thread that sort is complete.
         PostMessage(m_hwnd, WM_SORT_COMPLETE, 0, 0);
@@ -1057,8 +1138,8 @@ void RecoveryApplication::RecoverHighlightedFiles() {
     int iPos = ListView_GetNextItem(m_hwndListView, -1, LVNI_SELECTED);
     while (iPos != -1) {
         std::lock_guard<std::mutex> lock(m_filesMutex);
-        if (iPos < static_cast<int>(m_filteredFiles.size())) {
-            filesToRecover.push_back(m_filteredFiles[iPos]);
+        if (iPos < static_cast<int>(m_view.size())) {
+            filesToRecover.push_back(m_results.Materialize(m_view[iPos]));
         }
         iPos = ListView_GetNextItem(m_hwndListView, iPos, LVNI_SELECTED);
     }
@@ -22,6 +22,8 @@
 #include <mutex>
 #include <chrono>
 #include "DiskForensicsCore.h"
+#include "ResultStore.h"
+#include "SpscRing.h"
 
 namespace KVC {
     class RecoveryEngine;
@@ -61,9 +63,11 @@ private:
                             std::wstring filenameFilter, bool enableMft, 
                             bool enableUsn, bool enableCarving);
     void UpdateScanStatus(const std::wstring& status);
-    void PopulateResultsList();
     void FilterResults();
-    bool IsFileOfType(const std::wstring& name, int typeIndex);
+    void DrainResults();
+    void ExtendView();
+    bool MatchesFilter(ResultStore::Index index) const;
+    void RefreshResultsView();
     void RecoverFile(const DeletedFileEntry& file);
     void RecoverMultipleFiles(const std::vector<DeletedFileEntry>& files);
     void RecoverHighlightedFiles();
@@ -86,6 +90,9 @@ private:
     HWND m_hwndCheckMft;
     HWND m_hwndCheckUsn;
     HWND m_hwndCheckCarving;
+    HWND m_hwndCheckUnbuffered;
+    HWND m_hwndCheckFreeSpace;
+    HWND m_hwndCheckReuseScan;
 
     std::unique_ptr<std::thread> m_scanThread;
     std::atomic<bool> m_isScanning;
@@ -93,12 +100,17 @@ private:
     std::mutex m_filesMutex;
     
     // Data storage
-    std::vector<DeletedFileEntry> m_deletedFiles;  // Raw scan results
-    std::vector<DeletedFileEntry> m_filteredFiles; // Currently displayed results
+    ResultStore m_results;                          // Raw scan results, append-only
+    std::vector<ResultStore::Index> m_view;         // Displayed rows (filtered, maybe sorted)
+    size_t m_viewedRows = 0;                        // Store rows the view filter has seen
+    uint64_t m_viewGeneration = 0;                  // Bumped when the view is rebuilt
+    SpscRing<DeletedFileEntry> m_delivery;          // Scan thread -> UI thread, drained on a timer
+    std::atomic<bool> m_isSorting;
     
     std::wstring m_scanStatus;
-    std::wstring m_filterText;
-    std::wstring m_filterType;
+    std::wstring m_filterText;                      // Lowercased name filter
+    uint64_t m_filterMask = 0;                      // ResultStore::TrigramMask of m_filterText
+    int m_filterTypeIndex = 0;                      // 0 = all, else ResultStore::TypeCategory
 
     std::unique_ptr<DiskForensicsCore> m_forensicsCore;
     std::unique_ptr<RecoveryEngine> m_recoveryEngine;
@@ -125,11 +137,15 @@ private:
     static constexpr int CHECK_USN_ID = 1013;
     static constexpr int CHECK_CARVING_ID = 1014;
     static constexpr int BROWSE_FOLDER_BTN_ID = 1015;
+    static constexpr int CHECK_UNBUFFERED_ID = 1016;
+    static constexpr int CHECK_FREE_SPACE_ID = 1017;
+    static constexpr int CHECK_REUSE_SCAN_ID = 1018;
     static constexpr int ID_CONTEXT_SAVE_AS = 40020;
     static constexpr int ID_EDIT_SELECTALL = 40021;
+    static constexpr UINT_PTR RESULTS_TIMER_ID = 1;
 
     static constexpr UINT WM_SCAN_PROGRESS = WM_APP + 1;
-    static constexpr UINT WM_SCAN_FILE_FOUND = WM_APP + 2;
+    static constexpr UINT WM_SCAN_FILE_FOUND = WM_APP + 2;     // Results ring is full; drain now
     static constexpr UINT WM_SCAN_COMPLETE = WM_APP + 3;
     static constexpr UINT WM_RECOVERY_COMPLETE = WM_APP + 4;
     static constexpr UINT WM_SORT_COMPLETE = WM_APP + 5;
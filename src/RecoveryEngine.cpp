@@ -12,10 +12,12 @@
 #include "RecoveryEngine.h"
 #include "RecoveryCandidate.h"
 #include "SafetyLimits.h"
+#include "RecoveryScheduler.h"
+#include "OutputSink.h"
+#include "Constants.h"
 
 #include <Windows.h>
 #include <climits>
-#include <fstream>
 #include <filesystem>
 #include <cwctype>
 #include <algorithm>
@@ -145,40 +147,39 @@ int RecoveryEngine::RecoverMultipleFiles(
         throw DiskReadError(0, 0, GetLastError());
     }
 
-    int successCount = 0;
-    int totalFiles = static_cast<int>(files.size());
-
-    for (int i = 0; i < totalFiles; ++i) {
-        const auto& file = files[i];
-        std::wstring destPath = destinationFolder + L"\\" + file.name;
+    return RecoverMultipleFiles(files, disk, destinationFolder, onProgress);
+}
 
-        // Progress
-        float progress = static_cast<float>(i) / totalFiles;
+int RecoveryEngine::RecoverMultipleFiles(
+    const std::vector<RecoveryCandidate>& files,
+    DiskHandle& disk,
+    const std::wstring& destinationFolder,
+    const ProgressCallback& onProgress)
+{
+    if (files.empty()) {
         if (onProgress) {
-            wchar_t progressMsg[512];
-            swprintf_s(progressMsg, L"Recovering %s (%d/%d)",
-                      file.name.c_str(), i + 1, totalFiles);
-            onProgress(progressMsg, progress);
-        }
-
-        try {
-            // Build geometry for this file
-            VolumeGeometry geom = BuildGeometry(disk, file);
-            VolumeReader reader(disk, geom);
-
-            WriteRecoveredData(reader, file, destPath, onProgress);
-            ++successCount;
-        } catch (const ForensicsException& e) {
-            // Log error but continue with other files
-            if (onProgress) {
-                wchar_t errMsg[512];
-                swprintf_s(errMsg, L"Failed to recover %s: %hs",
-                          file.name.c_str(), e.what());
-                onProgress(errMsg, -1.0f);
-            }
+            onProgress(L"No files to recover", 0.0f);
         }
+        return 0;
     }
 
+    int totalFiles = static_cast<int>(files.size());
+
+    // Existing files are overwritten as before; only in-batch name clashes are renamed
+    const std::vector<std::wstring> destPaths =
+        RecoveryScheduler::AssignDestinations(files, destinationFolder, false);
+
+    // Each job gets its own reader; the shared handle only serves positional reads
+    RecoveryScheduler scheduler(Constants::Recovery::WORKER_THREADS);
+    auto outcomes = scheduler.Run(files, [&](size_t index) {
+        VolumeGeometry geom = BuildGeometry(disk, files[index]);
+        VolumeReader reader(disk, geom);
+        return WriteRecoveredData(reader, files[index], destPaths[index], nullptr);
+    }, onProgress);
+
+    int successCount = static_cast<int>(std::count_if(outcomes.begin(), outcomes.end(),
+        [](const RecoveryScheduler::Outcome& outcome) { return outcome.success; }));
+
     if (onProgress) {
         wchar_t completeMsg[256];
         swprintf_s(completeMsg, L"Recovery complete: %d/%d files recovered",
@@ -193,7 +194,7 @@ int RecoveryEngine::RecoverMultipleFiles(
 // Data Writing with VolumeReader
 // ============================================================================
 
-void RecoveryEngine::WriteRecoveredData(
+uint64_t RecoveryEngine::WriteRecoveredData(
     VolumeReader& reader,
     const RecoveryCandidate& file,
     const std::wstring& outputPath,
@@ -216,10 +217,7 @@ void RecoveryEngine::WriteRecoveredData(
     // Phase 2: Create output file
     // ========================================================================
 
-    std::ofstream outFile(outputPath, std::ios::binary | std::ios::trunc);
-    if (!outFile.is_open()) {
-        throw RecoveryError("Failed to create output file");
-    }
+    auto output = OutputSink::Open(outputPath);
 
     // ========================================================================
     // Phase 3: Handle resident data (small files stored directly in MFT)
@@ -227,15 +225,9 @@ void RecoveryEngine::WriteRecoveredData(
 
     if (file.file.HasResidentData()) {
         const auto& residentData = file.file.GetResidentData();
-        outFile.write(reinterpret_cast<const char*>(residentData.data()),
-                     residentData.size());
-        outFile.flush();
-        outFile.close();
-
-        if (!outFile.good()) {
-            throw RecoveryError("Failed to write resident data");
-        }
-        return;
+        output->Write(residentData.data(), residentData.size());
+        output->Close();
+        return residentData.size();
     }
 
     // ========================================================================
@@ -245,10 +237,11 @@ void RecoveryEngine::WriteRecoveredData(
     const VolumeGeometry& geom = reader.Geometry();
 
     if (geom.bytesPerCluster == 0) {
-        outFile.close();
         throw InvalidGeometryError("Invalid cluster size (0)");
     }
 
+    output->Reserve(file.fileSize);
+
     // ========================================================================
     // Phase 5: Recover data from disk clusters using VolumeReader
     // ========================================================================
@@ -260,41 +253,27 @@ void RecoveryEngine::WriteRecoveredData(
     for (const auto& run : runs) {
         if (bytesWritten >= file.fileSize) break;
 
+        uint64_t bytesInRun = run.clusterCount * geom.bytesPerCluster;
+        uint64_t bytesToWrite = std::min(bytesInRun, file.fileSize - bytesWritten);
+
         // Read clusters using VolumeReader (LCN-based)
         try {
             auto data = reader.ReadClusters(run.startCluster, run.clusterCount);
 
-            // Calculate how much to write
-            uint64_t bytesInRun = run.clusterCount * geom.bytesPerCluster;
-            uint64_t bytesToWrite = std::min(bytesInRun, file.fileSize - bytesWritten);
-
             if (data.size() < bytesToWrite) {
                 bytesToWrite = data.size();
             }
 
-            outFile.write(reinterpret_cast<const char*>(data.data()),
-                         static_cast<std::streamsize>(bytesToWrite));
-
-            if (!outFile.good()) {
-                outFile.close();
-                throw RecoveryError("Write error during recovery");
-            }
-
+            output->Write(data.data(), static_cast<size_t>(bytesToWrite));
             bytesWritten += bytesToWrite;
 
         } catch (const ClusterOutOfBoundsError&) {
-            // Write zeros for out-of-bounds clusters
-            uint64_t bytesInRun = run.clusterCount * geom.bytesPerCluster;
-            uint64_t bytesToWrite = std::min(bytesInRun, file.fileSize - bytesWritten);
-            std::vector<char> zeroBuffer(static_cast<size_t>(bytesToWrite), 0);
-            outFile.write(zeroBuffer.data(), static_cast<std::streamsize>(bytesToWrite));
+            // Zero-fill out-of-bounds clusters
+            output->WriteZeros(bytesToWrite);
             bytesWritten += bytesToWrite;
         } catch (const DiskReadError&) {
-            // Write zeros for unreadable clusters
-            uint64_t bytesInRun = run.clusterCount * geom.bytesPerCluster;
-            uint64_t bytesToWrite = std::min(bytesInRun, file.fileSize - bytesWritten);
-            std::vector<char> zeroBuffer(static_cast<size_t>(bytesToWrite), 0);
-            outFile.write(zeroBuffer.data(), static_cast<std::streamsize>(bytesToWrite));
+            // Zero-fill unreadable clusters
+            output->WriteZeros(bytesToWrite);
             bytesWritten += bytesToWrite;
         }
     }
@@ -303,8 +282,7 @@ void RecoveryEngine::WriteRecoveredData(
     // Phase 6: Finalize and verify
     // ========================================================================
 
-    outFile.flush();
-    outFile.close();
+    output->Close();
 
     if (bytesWritten == 0) {
         throw RecoveryError("No data was written during recovery");
@@ -316,6 +294,7 @@ void RecoveryEngine::WriteRecoveredData(
                   bytesWritten, file.name.c_str());
         onProgress(progressMsg, -1.0f);
     }
+    return bytesWritten;
 }
 
 } // namespace KVC
\ No newline at end of file
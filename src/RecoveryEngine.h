@@ -36,7 +36,8 @@ public:
         const ProgressCallback& onProgress
     );
 
-    // Recover multiple files to a folder
+    // Recover multiple files to a folder through one source handle, in
+    // on-disk order on a small worker pool
     // Throws: DestinationInvalidError, RecoveryError
     // Returns count of successfully recovered files
     int RecoverMultipleFiles(
@@ -46,6 +47,15 @@ public:
         const ProgressCallback& onProgress
     );
 
+    // Same, reading from an already open source (e.g. a volume image);
+    // the caller is responsible for keeping the destination off the source
+    int RecoverMultipleFiles(
+        const std::vector<RecoveryCandidate>& files,
+        DiskHandle& disk,
+        const std::wstring& destinationFolder,
+        const ProgressCallback& onProgress
+    );
+
 	// Validate destination is not on source drive
 	// Returns false if invalid, true if valid
 	bool ValidateDestination(wchar_t sourceDrive, const std::wstring& destPath);
@@ -54,9 +64,9 @@ private:
     // Build VolumeGeometry from RecoveryCandidate
     VolumeGeometry BuildGeometry(DiskHandle& disk, const RecoveryCandidate& file);
 
-    // Write recovered data using VolumeReader
+    // Write recovered data using VolumeReader; returns bytes written
     // Throws: RecoveryError, DiskReadError
-    void WriteRecoveredData(
+    uint64_t WriteRecoveredData(
         VolumeReader& reader,
         const RecoveryCandidate& file,
         const std::wstring& outputPath,
@@ -0,0 +1,180 @@
+// ============================================================================
+// RecoveryScheduler.cpp - Parallel Batch Recovery Queue
+// ============================================================================
+
+#include "RecoveryScheduler.h"
+#include "StringUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cwctype>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <unordered_set>
+
+namespace KVC {
+
+RecoveryScheduler::RecoveryScheduler(size_t workerCount)
+    : m_workerCount(std::max<size_t>(1, workerCount))
+{}
+
+std::vector<size_t> RecoveryScheduler::SweepOrder(const std::vector<RecoveryCandidate>& files) {
+    // Carved sub-cluster files use sector-unit runs, so compare byte offsets
+    auto firstByte = [](const RecoveryCandidate& file) -> uint64_t {
+        const auto& fragments = file.file.GetFragments();
+        if (file.file.HasResidentData() || fragments.IsEmpty()) return 0;
+        return file.volumeStartOffset + fragments.GetRuns()[0].startCluster * fragments.BytesPerCluster();
+    };
+
+    std::vector<std::pair<uint64_t, size_t>> keyed;
+    keyed.reserve(files.size());
+    for (size_t i = 0; i < files.size(); i++) {
+        keyed.emplace_back(firstByte(files[i]), i);
+    }
+    std::sort(keyed.begin(), keyed.end());
+
+    std::vector<size_t> order;
+    order.reserve(keyed.size());
+    for (const auto& entry : keyed) {
+        order.push_back(entry.second);
+    }
+    return order;
+}
+
+std::vector<std::wstring> RecoveryScheduler::AssignDestinations(
+    const std::vector<RecoveryCandidate>& files,
+    const std::wstring& folder,
+    bool avoidExisting)
+{
+    // Two concurrent jobs must never share an output file
+    std::unordered_set<std::wstring> used;
+    std::vector<std::wstring> paths;
+    paths.reserve(files.size());
+
+    for (const auto& file : files) {
+        size_t dotPos = file.name.rfind(L'.');
+        std::wstring baseName = dotPos != std::wstring::npos ? file.name.substr(0, dotPos) : file.name;
+        std::wstring ext = dotPos != std::wstring::npos ? file.name.substr(dotPos) : L"";
+
+        std::wstring path = folder + L"\\" + file.name;
+        for (int suffix = 1; ; suffix++) {
+            std::wstring key = path;
+            std::transform(key.begin(), key.end(), key.begin(), ::towlower);
+
+            std::error_code ec;
+            bool taken = used.count(key) > 0 || (avoidExisting && std::filesystem::exists(path, ec));
+            if (!taken) {
+                used.insert(std::move(key));
+                break;
+            }
+            path = folder + L"\\" + baseName + L"_" + std::to_wstring(suffix) + ext;
+        }
+        paths.push_back(std::move(path));
+    }
+    return paths;
+}
+
+std::vector<RecoveryScheduler::Outcome> RecoveryScheduler::Run(
+    const std::vector<RecoveryCandidate>& files,
+    const RecoverFn& recover,
+    const ProgressCallback& onProgress,
+    const std::atomic<bool>* shouldStop)
+{
+    std::vector<Outcome> outcomes(files.size());
+    if (files.empty()) {
+        return outcomes;
+    }
+
+    const std::vector<size_t> order = SweepOrder(files);
+    const size_t workerCount = std::min(m_workerCount, order.size());
+
+    std::atomic<size_t> cursor{ 0 };
+    std::mutex mutex;
+    std::condition_variable finishedCv;
+    std::deque<size_t> finished;
+    size_t activeWorkers = workerCount;
+
+    // Workers pull in sweep order, so reads advance across the disk while
+    // earlier files are still being written
+    auto work = [&]() {
+        for (size_t n = cursor.fetch_add(1); n < order.size(); n = cursor.fetch_add(1)) {
+            if (shouldStop && *shouldStop) break;
+
+            size_t index = order[n];
+            Outcome outcome;
+            outcome.attempted = true;
+            try {
+                outcome.bytesWritten = recover(index);
+                outcome.success = true;
+            } catch (const std::exception& e) {
+                outcome.error = e.what();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                outcomes[index] = std::move(outcome);
+                finished.push_back(index);
+            }
+            finishedCv.notify_one();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            activeWorkers--;
+        }
+        finishedCv.notify_one();
+    };
+
+    std::vector<std::future<void>> workers;
+    workers.reserve(workerCount);
+    for (size_t w = 0; w < workerCount; w++) {
+        workers.push_back(std::async(std::launch::async, work));
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    size_t completed = 0;
+    uint64_t totalBytes = 0;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        finishedCv.wait(lock, [&] { return !finished.empty() || activeWorkers == 0; });
+        if (finished.empty()) break;
+
+        size_t index = finished.front();
+        finished.pop_front();
+        const Outcome& outcome = outcomes[index];
+        completed++;
+        totalBytes += outcome.bytesWritten;
+
+        // Report outside the lock so a slow UI never stalls the workers
+        lock.unlock();
+        if (onProgress) {
+            // Long names and paths are cut short rather than overflow msg
+            wchar_t msg[512];
+            if (outcome.success) {
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+                double bytesPerSecond = seconds > 0.0 ? totalBytes / seconds : 0.0;
+                _snwprintf_s(msg, _TRUNCATE, L"Recovered %s (%zu/%zu) - %s at %s/s",
+                             files[index].name.c_str(), completed, files.size(),
+                             StringUtils::FormatFileSize(totalBytes).c_str(),
+                             StringUtils::FormatFileSize(static_cast<uint64_t>(bytesPerSecond)).c_str());
+                onProgress(msg, static_cast<float>(completed) / files.size());
+            } else {
+                _snwprintf_s(msg, _TRUNCATE, L"Failed to recover %s: %hs",
+                             files[index].name.c_str(), outcome.error.c_str());
+                onProgress(msg, -1.0f);
+            }
+        }
+        lock.lock();
+    }
+    lock.unlock();
+
+    for (auto& worker : workers) {
+        worker.get();
+    }
+    return outcomes;
+}
+
+} // namespace KVC
@@ -0,0 +1,61 @@
+// ============================================================================
+// RecoveryScheduler.h - Parallel Batch Recovery Queue
+// ============================================================================
+// Runs a batch of file recoveries against one opened source volume. Jobs are
+// started in ascending on-disk order so reads sweep the disk in one direction,
+// and a bounded worker pool overlaps one file's source reads with another's
+// destination writes. Progress is reported only from the calling thread.
+// ============================================================================
+
+#pragma once
+
+#include "RecoveryCandidate.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace KVC {
+
+class RecoveryScheduler {
+public:
+    using ProgressCallback = std::function<void(const std::wstring&, float)>;
+
+    // Recovers files[index] on a worker thread and returns the bytes written.
+    // Throws ForensicsException on failure; must not call the progress callback.
+    using RecoverFn = std::function<uint64_t(size_t index)>;
+
+    struct Outcome {
+        bool attempted = false;     // False if cancelled before it started
+        bool success = false;
+        uint64_t bytesWritten = 0;
+        std::string error;
+    };
+
+    explicit RecoveryScheduler(size_t workerCount);
+
+    // Outcomes are indexed like files
+    std::vector<Outcome> Run(
+        const std::vector<RecoveryCandidate>& files,
+        const RecoverFn& recover,
+        const ProgressCallback& onProgress,
+        const std::atomic<bool>* shouldStop = nullptr
+    );
+
+    // Job order: resident files first, then by first byte on the volume
+    static std::vector<size_t> SweepOrder(const std::vector<RecoveryCandidate>& files);
+
+    // One output path per file; names repeated within the batch (and, with
+    // avoidExisting, names already in the folder) get a _N suffix
+    static std::vector<std::wstring> AssignDestinations(
+        const std::vector<RecoveryCandidate>& files,
+        const std::wstring& folder,
+        bool avoidExisting
+    );
+
+private:
+    size_t m_workerCount;
+};
+
+} // namespace KVC
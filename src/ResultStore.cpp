@@ -0,0 +1,348 @@
+// ============================================================================
+// ResultStore.cpp - Append-Only Scan Result Store
+// ============================================================================
+
+#include "ResultStore.h"
+#include "StringUtils.h"
+#include <algorithm>
+#include <cwctype>
+#include <future>
+#include <iterator>
+
+namespace KVC {
+
+namespace {
+    std::wstring Lowered(std::wstring_view text) {
+        std::wstring lower(text);
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::towlower);
+        return lower;
+    }
+
+    int CompareKeys(uint64_t a, uint64_t b) {
+        return a < b ? -1 : (a > b ? 1 : 0);
+    }
+
+    // Sort slices concurrently, then merge neighbours pairwise until one run is left
+    template <typename Compare>
+    void ParallelSort(std::vector<ResultStore::Index>& rows, Compare less, size_t threads) {
+        if (rows.size() < Constants::Results::PARALLEL_SORT_THRESHOLD || threads < 2) {
+            std::sort(rows.begin(), rows.end(), less);
+            return;
+        }
+
+        const size_t sliceSize = (rows.size() + threads - 1) / threads;
+        std::vector<size_t> bounds;
+        for (size_t start = 0; start < rows.size(); start += sliceSize) {
+            bounds.push_back(start);
+        }
+        bounds.push_back(rows.size());
+
+        std::vector<std::future<void>> work;
+        for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+            work.push_back(std::async(std::launch::async, [&rows, &less, first = bounds[i], last = bounds[i + 1]]() {
+                std::sort(rows.begin() + first, rows.begin() + last, less);
+            }));
+        }
+        for (auto& task : work) task.get();
+
+        while (bounds.size() > 2) {
+            std::vector<size_t> merged;
+            work.clear();
+            for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+                merged.push_back(bounds[i]);
+                if (i + 2 < bounds.size()) {
+                    work.push_back(std::async(std::launch::async,
+                        [&rows, &less, first = bounds[i], middle = bounds[i + 1], last = bounds[i + 2]]() {
+                            std::inplace_merge(rows.begin() + first, rows.begin() + middle,
+                                               rows.begin() + last, less);
+                        }));
+                }
+            }
+            merged.push_back(rows.size());
+            for (auto& task : work) task.get();
+            bounds.swap(merged);
+        }
+    }
+}
+
+ResultStore::ResultStore()
+    : m_chunks(std::make_unique<std::unique_ptr<Chunk>[]>(Constants::Results::STORE_MAX_CHUNKS))
+    , m_strings(Constants::Results::STRING_BLOCK_CHARS)
+{}
+
+ResultStore::~ResultStore() = default;
+
+bool ResultStore::Append(const RecoveryCandidate& candidate) {
+    size_t count = m_count.load(std::memory_order_relaxed);
+    size_t chunkIndex = count / CHUNK_ROWS;
+    if (chunkIndex >= Constants::Results::STORE_MAX_CHUNKS) {
+        return false;
+    }
+
+    if (!m_chunks[chunkIndex]) {
+        m_chunks[chunkIndex] = std::make_unique<Chunk>();
+    }
+
+    Chunk& chunk = *m_chunks[chunkIndex];
+    size_t slot = count % CHUNK_ROWS;
+    CompactRow& row = chunk.rows[slot];
+    row = CompactRow();
+
+    // Carved names are unique; paths, types and size labels repeat heavily
+    row.name = m_strings.Store(candidate.name);
+    row.path = m_strings.Intern(candidate.path);
+    row.filesystemType = m_strings.Intern(candidate.filesystemType);
+    if (candidate.sizeFormatted != StringUtils::FormatFileSize(candidate.fileSize)) {
+        row.sizeLabel = m_strings.Intern(candidate.sizeFormatted);
+    }
+
+    row.fileSize = candidate.fileSize;
+    row.quality = static_cast<uint8_t>(candidate.quality);
+    row.source = static_cast<uint8_t>(candidate.source);
+    if (candidate.hasDeletedTime) row.flags |= DELETED_FLAG;
+    if (candidate.deletedTime) {
+        row.flags |= HAS_DELETED_TIME;
+        row.deletedTicks = static_cast<int64_t>(candidate.deletedTime->time_since_epoch().count());
+    }
+
+    bool recordsAgree = !candidate.mftRecord || !candidate.fileRecord ||
+                        *candidate.mftRecord == *candidate.fileRecord;
+    if (candidate.mftRecord) {
+        row.flags |= HAS_MFT_RECORD;
+        row.record = *candidate.mftRecord;
+    }
+    else if (candidate.fileRecord) {
+        row.record = *candidate.fileRecord;
+    }
+    if (candidate.fileRecord) row.flags |= HAS_FILE_RECORD;
+
+    if (!recordsAgree || !PackInline(candidate, row)) {
+        row.spill = std::make_unique<Spill>();
+        row.spill->file = candidate.file;
+        row.spill->volumeStartOffset = candidate.volumeStartOffset;
+        if (!recordsAgree) row.spill->fileRecord = candidate.fileRecord;
+    }
+
+    chunk.sizes[slot] = candidate.size;
+    chunk.nameKeys[slot] = PrefixKey(candidate.name);
+    chunk.pathKeys[slot] = PrefixKey(candidate.path);
+    chunk.filesystemKeys[slot] = PrefixKey(candidate.filesystemType);
+    chunk.nameTrigrams[slot] = TrigramMask(Lowered(candidate.name));
+    chunk.categories[slot] = Classify(candidate.name);
+    chunk.recoverable[slot] = candidate.isRecoverable;
+
+    // Publish only after the row and its columns are fully written
+    m_count.store(count + 1, std::memory_order_release);
+    return true;
+}
+
+bool ResultStore::PackInline(const RecoveryCandidate& candidate, CompactRow& row) {
+    const FragmentedFile& file = candidate.file;
+    const FragmentMap& map = file.Fragments();
+    if (file.IsResident() || map.RunCount() > 1) {
+        return false;
+    }
+
+    if (file.FileSize() == candidate.fileSize) row.flags |= DATA_SIZE_FILE;
+    else if (file.FileSize() != 0) return false;
+
+    uint64_t runSpan = 0;
+    if (map.RunCount() == 1) {
+        const ClusterRun& run = map.GetRuns().front();
+        if (run.fileOffset != 0) return false;
+        row.flags |= HAS_RUN;
+        row.runStart = run.startCluster;
+        row.runClusters = run.clusterCount;
+        runSpan = run.clusterCount * map.BytesPerCluster();
+    }
+    if (map.TotalSize() == candidate.fileSize) row.flags |= MAP_SIZE_FILE;
+    else if (map.TotalSize() != runSpan) return false;
+
+    // One scan contributes one or two layouts, so a short linear search suffices
+    Geometry geometry{ map.BytesPerCluster(), map.DiskTotalClusters(), candidate.volumeStartOffset };
+    for (size_t i = 0; i < m_geometryCount; i++) {
+        const Geometry& known = m_geometries[i];
+        if (known.bytesPerCluster == geometry.bytesPerCluster &&
+            known.diskTotalClusters == geometry.diskTotalClusters &&
+            known.volumeStartOffset == geometry.volumeStartOffset) {
+            row.geometry = static_cast<uint8_t>(i);
+            return true;
+        }
+    }
+    if (m_geometryCount == m_geometries.size()) {
+        return false;
+    }
+    m_geometries[m_geometryCount] = geometry;
+    row.geometry = static_cast<uint8_t>(m_geometryCount++);
+    return true;
+}
+
+RecoveryCandidate ResultStore::Materialize(Index index) const {
+    const Chunk& chunk = ChunkOf(index);
+    size_t slot = index % CHUNK_ROWS;
+    const CompactRow& row = chunk.rows[slot];
+
+    RecoveryCandidate candidate;
+    candidate.name = row.name;
+    candidate.path = row.path;
+    candidate.fileSize = row.fileSize;
+    candidate.sizeFormatted = SizeText(index);
+    candidate.quality = static_cast<RecoveryQuality>(row.quality);
+    candidate.source = static_cast<RecoverySource>(row.source);
+    candidate.filesystemType = row.filesystemType;
+    candidate.hasDeletedTime = (row.flags & DELETED_FLAG) != 0;
+    candidate.size = chunk.sizes[slot];
+    candidate.isRecoverable = chunk.recoverable[slot];
+
+    if (row.flags & HAS_DELETED_TIME) {
+        candidate.deletedTime = std::chrono::system_clock::time_point(
+            std::chrono::system_clock::duration(row.deletedTicks));
+    }
+    if (row.flags & HAS_MFT_RECORD) candidate.mftRecord = row.record;
+    if (row.flags & HAS_FILE_RECORD) candidate.fileRecord = row.record;
+
+    if (row.spill) {
+        candidate.file = row.spill->file;
+        candidate.volumeStartOffset = row.spill->volumeStartOffset;
+        if (row.spill->fileRecord) candidate.fileRecord = row.spill->fileRecord;
+        return candidate;
+    }
+
+    const Geometry& geometry = m_geometries[row.geometry];
+    FragmentMap map(geometry.bytesPerCluster, geometry.diskTotalClusters);
+    if (row.flags & HAS_RUN) {
+        map.AddRun(row.runStart, row.runClusters);
+    }
+    if (row.flags & MAP_SIZE_FILE) {
+        map.SetTotalSize(row.fileSize);
+    }
+
+    candidate.file = FragmentedFile((row.flags & DATA_SIZE_FILE) ? row.fileSize : 0, geometry.bytesPerCluster);
+    candidate.file.SetFragmentMap(std::move(map));
+    candidate.volumeStartOffset = geometry.volumeStartOffset;
+    return candidate;
+}
+
+std::wstring ResultStore::SizeText(Index index) const {
+    const CompactRow& row = RowOf(index);
+    return row.sizeLabel ? std::wstring(row.sizeLabel) : StringUtils::FormatFileSize(row.fileSize);
+}
+
+bool ResultStore::IsRecoverable(Index index) const {
+    return ChunkOf(index).recoverable[index % CHUNK_ROWS];
+}
+
+uint64_t ResultStore::FileSize(Index index) const {
+    return ChunkOf(index).sizes[index % CHUNK_ROWS];
+}
+
+ResultStore::TypeCategory ResultStore::Category(Index index) const {
+    return ChunkOf(index).categories[index % CHUNK_ROWS];
+}
+
+bool ResultStore::NameContains(Index index, const std::wstring& loweredQuery, uint64_t queryMask) const {
+    const Chunk& chunk = ChunkOf(index);
+    size_t slot = index % CHUNK_ROWS;
+    if ((chunk.nameTrigrams[slot] & queryMask) != queryMask) {
+        return false;                            // Some query trigram is missing
+    }
+    return Lowered(chunk.rows[slot].name).find(loweredQuery) != std::wstring::npos;
+}
+
+int ResultStore::Compare(SortColumn column, Index a, Index b) const {
+    const Chunk& chunkA = ChunkOf(a);
+    const Chunk& chunkB = ChunkOf(b);
+    size_t slotA = a % CHUNK_ROWS;
+    size_t slotB = b % CHUNK_ROWS;
+    const CompactRow& rowA = chunkA.rows[slotA];
+    const CompactRow& rowB = chunkB.rows[slotB];
+
+    // Keys settle almost every text comparison; equal prefixes fall back to the strings
+    int result = 0;
+    switch (column) {
+    case SortColumn::Name:
+        result = CompareKeys(chunkA.nameKeys[slotA], chunkB.nameKeys[slotB]);
+        if (result == 0) result = _wcsicmp(rowA.name, rowB.name);
+        break;
+    case SortColumn::Path:
+        result = CompareKeys(chunkA.pathKeys[slotA], chunkB.pathKeys[slotB]);
+        if (result == 0) result = _wcsicmp(rowA.path, rowB.path);
+        break;
+    case SortColumn::Size:
+        result = CompareKeys(chunkA.sizes[slotA], chunkB.sizes[slotB]);
+        break;
+    case SortColumn::Filesystem:
+        result = CompareKeys(chunkA.filesystemKeys[slotA], chunkB.filesystemKeys[slotB]);
+        if (result == 0) result = _wcsicmp(rowA.filesystemType, rowB.filesystemType);
+        break;
+    case SortColumn::Recoverable:
+        result = static_cast<int>(chunkA.recoverable[slotA]) - static_cast<int>(chunkB.recoverable[slotB]);
+        break;
+    }
+    return result;
+}
+
+void ResultStore::Sort(std::vector<Index>& rows, SortColumn column, bool ascending) const {
+    auto less = [this, column, ascending](Index a, Index b) {
+        int result = Compare(column, a, b);
+        return ascending ? (result < 0) : (result > 0);
+    };
+    ParallelSort(rows, less, Constants::Results::SORT_THREADS);
+}
+
+void ResultStore::Clear() {
+    size_t chunkCount = (m_count.load(std::memory_order_relaxed) + CHUNK_ROWS - 1) / CHUNK_ROWS;
+    m_count.store(0, std::memory_order_release);
+    for (size_t i = 0; i < chunkCount; i++) {
+        m_chunks[i].reset();
+    }
+    m_strings.Clear();
+    m_geometryCount = 0;
+}
+
+ResultStore::TypeCategory ResultStore::Classify(const std::wstring& name) {
+    size_t dotPos = name.rfind(L'.');
+    if (dotPos == std::wstring::npos) return TypeCategory::Other;
+
+    std::wstring ext = name.substr(dotPos + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::towlower);
+
+    if (ext == L"doc" || ext == L"docx" || ext == L"pdf" || ext == L"txt" ||
+        ext == L"rtf" || ext == L"xls" || ext == L"xlsx" || ext == L"ppt" || ext == L"pptx") {
+        return TypeCategory::Document;
+    }
+    if (ext == L"jpg" || ext == L"jpeg" || ext == L"png" || ext == L"bmp" ||
+        ext == L"gif" || ext == L"tiff" || ext == L"raw" || ext == L"ico") {
+        return TypeCategory::Image;
+    }
+    if (ext == L"mp4" || ext == L"avi" || ext == L"mkv" || ext == L"mov" ||
+        ext == L"wmv" || ext == L"flv" || ext == L"mpg") {
+        return TypeCategory::Video;
+    }
+    if (ext == L"zip" || ext == L"rar" || ext == L"7z" || ext == L"tar" || ext == L"gz") {
+        return TypeCategory::Archive;
+    }
+    return TypeCategory::Other;
+}
+
+uint64_t ResultStore::PrefixKey(const std::wstring& text) {
+    uint64_t key = 0;
+    for (size_t i = 0; i < 4; i++) {
+        uint64_t unit = i < text.size() ? static_cast<uint64_t>(::towlower(text[i])) : 0;
+        key = (key << 16) | std::min<uint64_t>(unit, 0xFFFF);
+    }
+    return key;
+}
+
+uint64_t ResultStore::TrigramMask(const std::wstring& lowered) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i + 3 <= lowered.size(); i++) {
+        uint64_t h = (static_cast<uint64_t>(lowered[i]) * 0x9E3779B1u) ^
+                     (static_cast<uint64_t>(lowered[i + 1]) * 0x85EBCA77u) ^
+                     (static_cast<uint64_t>(lowered[i + 2]) * 0xC2B2AE3Du);
+        mask |= 1ULL << ((h ^ (h >> 29)) & 63);
+    }
+    return mask;
+}
+
+} // namespace KVC
@@ -0,0 +1,165 @@
+// ============================================================================
+// ResultStore.h - Append-Only Scan Result Store
+// ============================================================================
+// Scan results in fixed-size chunks that never move once written, plus the
+// hot columns filtering and sorting touch: size, type category, lowercased
+// prefix keys and a name trigram mask, all computed once at insert. Rows are
+// kept compact (pooled strings, one inline cluster run, no derived text) and
+// expanded back into a RecoveryCandidate only for recovery and export. The
+// view layer keeps index vectors into the store instead of copying rows.
+// One thread appends; any thread may read rows below Count().
+// ============================================================================
+
+#pragma once
+
+#include "RecoveryCandidate.h"
+#include "Constants.h"
+#include "StringPool.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace KVC {
+
+class ResultStore {
+public:
+    using Index = uint32_t;
+
+    // Type filter groups of the GUI's type combo, in combo order after "All"
+    enum class TypeCategory : uint8_t {
+        Other,
+        Document,
+        Image,
+        Video,
+        Archive
+    };
+
+    // Sortable list columns, in ListView column order
+    enum class SortColumn {
+        Name,
+        Path,
+        Size,
+        Filesystem,
+        Recoverable
+    };
+
+    ResultStore();
+    ~ResultStore();
+
+    ResultStore(const ResultStore&) = delete;
+    ResultStore& operator=(const ResultStore&) = delete;
+
+    // Single writer; false once STORE_MAX_CHUNKS are full
+    bool Append(const RecoveryCandidate& candidate);
+
+    // Rows below Count() are complete and immutable
+    size_t Count() const { return m_count.load(std::memory_order_acquire); }
+
+    // Full candidate rebuilt from the compact row
+    RecoveryCandidate Materialize(Index index) const;
+
+    const wchar_t* Name(Index index) const { return RowOf(index).name; }
+    const wchar_t* Path(Index index) const { return RowOf(index).path; }
+    const wchar_t* FilesystemType(Index index) const { return RowOf(index).filesystemType; }
+    std::wstring SizeText(Index index) const;
+    bool IsRecoverable(Index index) const;
+    uint64_t FileSize(Index index) const;
+    TypeCategory Category(Index index) const;
+
+    // Substring test on the lowercased name; queryMask from TrigramMask(query)
+    bool NameContains(Index index, const std::wstring& loweredQuery, uint64_t queryMask) const;
+
+    // Order rows by one column, splitting large views across threads
+    void Sort(std::vector<Index>& rows, SortColumn column, bool ascending) const;
+
+    // Drop every row; no reader may hold a row across this
+    void Clear();
+
+    static TypeCategory Classify(const std::wstring& name);
+
+    // One bit per hashed trigram; a row can only contain the query when its
+    // mask covers the query's. Zero for strings under three characters.
+    static uint64_t TrigramMask(const std::wstring& lowered);
+
+private:
+    static constexpr size_t CHUNK_ROWS = Constants::Results::STORE_CHUNK_ROWS;
+
+    // Anything a compact row can't express: several runs, resident data,
+    // unusual sizes or geometry, or an MFT and file record that disagree
+    struct Spill {
+        FragmentedFile file;
+        uint64_t volumeStartOffset = 0;
+        std::optional<uint64_t> fileRecord;
+    };
+
+    // Cluster size and volume placement shared by every row of one scan
+    struct Geometry {
+        uint64_t bytesPerCluster = 0;
+        uint64_t diskTotalClusters = 0;
+        uint64_t volumeStartOffset = 0;
+    };
+
+    enum RowFlags : uint16_t {
+        HAS_MFT_RECORD   = 1 << 0,
+        HAS_FILE_RECORD  = 1 << 1,
+        HAS_DELETED_TIME = 1 << 2,      // deletedTime is set
+        DELETED_FLAG     = 1 << 3,      // hasDeletedTime
+        HAS_RUN          = 1 << 4,
+        DATA_SIZE_FILE   = 1 << 5,      // FragmentedFile size equals fileSize, else zero
+        MAP_SIZE_FILE    = 1 << 6,      // Map total equals fileSize, else the run's span
+    };
+
+    struct CompactRow {
+        const wchar_t* name = nullptr;          // Pooled strings
+        const wchar_t* path = nullptr;
+        const wchar_t* filesystemType = nullptr;
+        const wchar_t* sizeLabel = nullptr;     // Null when FormatFileSize(fileSize) matches
+        uint64_t fileSize = 0;
+        uint64_t record = 0;                    // mftRecord and/or fileRecord per flags
+        int64_t deletedTicks = 0;
+        uint64_t runStart = 0;
+        uint64_t runClusters = 0;
+        std::unique_ptr<Spill> spill;           // Replaces the run and geometry when set
+        uint8_t geometry = 0;
+        uint8_t quality = 0;
+        uint8_t source = 0;
+        uint16_t flags = 0;
+    };
+
+    struct Chunk {
+        CompactRow rows[CHUNK_ROWS];
+        uint64_t sizes[CHUNK_ROWS];
+        uint64_t nameKeys[CHUNK_ROWS];          // First four lowercased characters
+        uint64_t pathKeys[CHUNK_ROWS];
+        uint64_t filesystemKeys[CHUNK_ROWS];
+        uint64_t nameTrigrams[CHUNK_ROWS];
+        TypeCategory categories[CHUNK_ROWS];
+        bool recoverable[CHUNK_ROWS];
+    };
+
+    const Chunk& ChunkOf(Index index) const { return *m_chunks[index / CHUNK_ROWS]; }
+    const CompactRow& RowOf(Index index) const { return ChunkOf(index).rows[index % CHUNK_ROWS]; }
+
+    // Fill the run, geometry and size fields; false when the row must spill
+    bool PackInline(const RecoveryCandidate& candidate, CompactRow& row);
+
+    // Three-way comparison of two rows on one column
+    int Compare(SortColumn column, Index a, Index b) const;
+
+    // Packs the first four lowercased characters so integer order is text order
+    static uint64_t PrefixKey(const std::wstring& text);
+
+    std::unique_ptr<std::unique_ptr<Chunk>[]> m_chunks;    // Fixed directory, filled in order
+    std::atomic<size_t> m_count{ 0 };
+
+    // Written by the appending thread before the rows that refer to them
+    StringPool m_strings;
+    std::array<Geometry, Constants::Results::STORE_MAX_GEOMETRIES> m_geometries;
+    size_t m_geometryCount = 0;
+};
+
+} // namespace KVC
@@ -0,0 +1,274 @@
+// ============================================================================
+// ResultStream.cpp - Streaming CSV / NDJSON Result Writer
+// ============================================================================
+
+#include "ResultStream.h"
+#include "Constants.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+namespace KVC {
+
+namespace {
+
+const char* SourceName(RecoverySource source) {
+    switch (source) {
+        case RecoverySource::MFT:      return "mft";
+        case RecoverySource::USN:      return "usn";
+        case RecoverySource::Carving:  return "carving";
+        case RecoverySource::FAT32:    return "fat32";
+        case RecoverySource::ExFAT:    return "exfat";
+    }
+    return "unknown";
+}
+
+const char* QualityName(RecoveryQuality quality) {
+    switch (quality) {
+        case RecoveryQuality::Full:          return "full";
+        case RecoveryQuality::Partial:       return "partial";
+        case RecoveryQuality::MetadataOnly:  return "metadata_only";
+        case RecoveryQuality::Unrecoverable: return "unrecoverable";
+    }
+    return "unknown";
+}
+
+std::string Utf8(const std::wstring& text) {
+    if (text.empty()) return {};
+    int length = WideCharToMultiByte(CP_UTF8, 0, text.c_str(), static_cast<int>(text.size()),
+                                     nullptr, 0, nullptr, nullptr);
+    std::string result(static_cast<size_t>(std::max(length, 0)), '\0');
+    if (length > 0) {
+        WideCharToMultiByte(CP_UTF8, 0, text.c_str(), static_cast<int>(text.size()),
+                            &result[0], length, nullptr, nullptr);
+    }
+    return result;
+}
+
+// Quoted only when needed, so plain names read as before
+std::string CsvField(const std::wstring& text) {
+    std::string value = Utf8(text);
+    if (value.find_first_of(",\"\r\n") == std::string::npos) {
+        return value;
+    }
+    std::string quoted = "\"";
+    for (char c : value) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+std::string JsonString(const std::wstring& text) {
+    std::string out = "\"";
+    for (char c : Utf8(text)) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+// Local time, as the batch CSV export always wrote it
+std::string LocalTimestamp(const std::chrono::system_clock::time_point& time) {
+    std::time_t value = std::chrono::system_clock::to_time_t(time);
+    std::tm tm = {};
+    localtime_s(&tm, &value);
+    char text[32];
+    strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &tm);
+    return text;
+}
+
+std::string UtcTimestamp(const std::chrono::system_clock::time_point& time) {
+    std::time_t value = std::chrono::system_clock::to_time_t(time);
+    std::tm tm = {};
+    gmtime_s(&tm, &value);
+    char text[32];
+    strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    return text;
+}
+
+} // namespace
+
+ResultStreamWriter::~ResultStreamWriter() {
+    Close();
+}
+
+bool ResultStreamWriter::Open(const std::wstring& path, Format format) {
+    HANDLE handle = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    Start(handle, true, format);
+    return true;
+}
+
+bool ResultStreamWriter::Attach(HANDLE handle, Format format) {
+    if (handle == INVALID_HANDLE_VALUE || handle == nullptr) {
+        return false;
+    }
+    Start(handle, false, format);
+    return true;
+}
+
+void ResultStreamWriter::Start(HANDLE handle, bool ownsHandle, Format format) {
+    Close();
+
+    m_handle = handle;
+    m_ownsHandle = ownsHandle;
+    m_format = format;
+    m_closing = false;
+    m_failed = false;
+    m_written = 0;
+    m_pending = format == Format::Csv ? FormatCsvHeader() : std::string();
+
+    m_writer = std::thread(&ResultStreamWriter::WriterLoop, this);
+}
+
+void ResultStreamWriter::Write(const RecoveryCandidate& candidate) {
+    if (!IsOpen()) {
+        return;
+    }
+
+    std::string line = m_format == Format::Csv ? FormatCsv(candidate) : FormatNdjson(candidate);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_drained.wait(lock, [this] {
+        return m_pending.size() < Constants::ResultStream::BUFFER_BYTES || m_failed;
+    });
+    if (m_failed) {
+        return;
+    }
+
+    bool wasEmpty = m_pending.empty();
+    m_pending += line;
+    m_written++;
+    if (wasEmpty) {
+        m_ready.notify_one();
+    }
+}
+
+void ResultStreamWriter::WriterLoop() {
+    std::string writing;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_ready.wait(lock, [this] { return !m_pending.empty() || m_closing; });
+            if (m_pending.empty()) {
+                return;  // Closing and drained
+            }
+            writing.swap(m_pending);
+            m_pending.clear();
+        }
+        m_drained.notify_all();
+
+        size_t offset = 0;
+        while (offset < writing.size()) {
+            DWORD chunk = static_cast<DWORD>(std::min<size_t>(writing.size() - offset,
+                                                              Constants::ResultStream::BUFFER_BYTES));
+            DWORD written = 0;
+            if (!WriteFile(m_handle, writing.data() + offset, chunk, &written, nullptr) || written == 0) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_failed = true;
+                m_pending.clear();
+                break;
+            }
+            offset += written;
+        }
+        writing.clear();
+
+        if (m_failed) {
+            m_drained.notify_all();
+            return;
+        }
+    }
+}
+
+bool ResultStreamWriter::Close() {
+    if (!m_writer.joinable()) {
+        return !m_failed;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closing = true;
+    }
+    m_ready.notify_one();
+    m_writer.join();
+
+    if (m_ownsHandle) {
+        CloseHandle(m_handle);
+    }
+    m_handle = INVALID_HANDLE_VALUE;
+    m_ownsHandle = false;
+    return !m_failed;
+}
+
+// ============================================================================
+// Line Formats
+// ============================================================================
+
+std::string ResultStreamWriter::FormatCsvHeader() {
+    return "Name,Path,Size,Size_Formatted,Filesystem,Recoverable,Has_Deleted_Time,Deleted_Time\r\n";
+}
+
+std::string ResultStreamWriter::FormatCsv(const RecoveryCandidate& candidate) {
+    std::string row = CsvField(candidate.name);
+    row += ',';
+    row += CsvField(candidate.path);
+    row += ',';
+    row += std::to_string(candidate.size);
+    row += ',';
+    row += CsvField(candidate.sizeFormatted);
+    row += ',';
+    row += CsvField(candidate.filesystemType);
+    row += candidate.isRecoverable ? ",Yes," : ",No,";
+    row += candidate.hasDeletedTime ? "Yes," : "No,";
+    if (candidate.hasDeletedTime && candidate.deletedTime.has_value()) {
+        row += LocalTimestamp(candidate.deletedTime.value());
+    }
+    return row + "\r\n";
+}
+
+std::string ResultStreamWriter::FormatNdjson(const RecoveryCandidate& candidate) {
+    const FragmentMap& fragments = candidate.file.GetFragments();
+
+    std::string line = "{\"name\":" + JsonString(candidate.name);
+    line += ",\"path\":" + JsonString(candidate.path);
+    line += ",\"size\":" + std::to_string(candidate.fileSize);
+    line += ",\"source\":\"";
+    line += SourceName(candidate.source);
+    line += "\",\"quality\":\"";
+    line += QualityName(candidate.quality);
+    line += "\"";
+    if (!candidate.filesystemType.empty()) {
+        line += ",\"filesystem\":" + JsonString(candidate.filesystemType);
+    }
+    if (candidate.mftRecord.has_value()) {
+        line += ",\"mft_record\":" + std::to_string(candidate.mftRecord.value());
+    }
+    if (!fragments.IsEmpty()) {
+        line += ",\"first_cluster\":" + std::to_string(fragments.GetRuns()[0].startCluster);
+        line += ",\"fragments\":" + std::to_string(fragments.GetRuns().size());
+    }
+    if (candidate.deletedTime.has_value()) {
+        line += ",\"deleted_time\":\"" + UtcTimestamp(candidate.deletedTime.value()) + "\"";
+    }
+    return line + "}\n";
+}
+
+} // namespace KVC
@@ -0,0 +1,77 @@
+// ============================================================================
+// ResultStream.h - Streaming CSV / NDJSON Result Writer
+// ============================================================================
+// Writes each candidate as it is found instead of after the scan. Lines are
+// formatted (UTF-8) on the calling scan thread and handed to a writer thread
+// through a bounded buffer, so slow destinations (pipes, network shares)
+// never stall a scan for long and memory stays flat on huge volumes.
+// ============================================================================
+
+#pragma once
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Windows.h>
+#include "RecoveryCandidate.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace KVC {
+
+class ResultStreamWriter {
+public:
+    enum class Format {
+        Csv,        // Header row, one row per candidate
+        Ndjson      // One JSON object per line
+    };
+
+    ResultStreamWriter() = default;
+    ~ResultStreamWriter();
+
+    ResultStreamWriter(const ResultStreamWriter&) = delete;
+    ResultStreamWriter& operator=(const ResultStreamWriter&) = delete;
+
+    // Create (truncate) path; false if it cannot be created
+    bool Open(const std::wstring& path, Format format);
+
+    // Write to a handle the caller keeps open (e.g. redirected stdout)
+    bool Attach(HANDLE handle, Format format);
+
+    bool IsOpen() const { return m_handle != INVALID_HANDLE_VALUE; }
+
+    // Safe from any scan thread; blocks only while the buffer is full
+    void Write(const RecoveryCandidate& candidate);
+
+    // Drain and stop the writer thread; false if any write failed
+    bool Close();
+
+    uint64_t Written() const { return m_written; }
+
+private:
+    void Start(HANDLE handle, bool ownsHandle, Format format);
+    void WriterLoop();
+
+    static std::string FormatCsvHeader();
+    static std::string FormatCsv(const RecoveryCandidate& candidate);
+    static std::string FormatNdjson(const RecoveryCandidate& candidate);
+
+    HANDLE m_handle = INVALID_HANDLE_VALUE;
+    bool m_ownsHandle = false;
+    Format m_format = Format::Csv;
+
+    std::mutex m_mutex;
+    std::condition_variable m_ready;        // Writer: data or close pending
+    std::condition_variable m_drained;      // Producers: buffer has room again
+    std::string m_pending;
+    bool m_closing = false;
+    bool m_failed = false;
+    uint64_t m_written = 0;                 // Candidates accepted, under m_mutex
+    std::thread m_writer;
+};
+
+} // namespace KVC
@@ -30,6 +30,12 @@ struct ScanConfiguration {
     uint64_t carvingMaxFiles = 10000000;         // Max carved files
     uint64_t carvingClusterLimit = 0;            // 0 = scan entire volume
     uint64_t carvingBatchClusters = 65536;       // Clusters per batch (~256MB at 4KB)
+    bool carvingUnallocatedOnly = false;         // Opt-in: skip clusters the volume bitmap marks in use
+    uint64_t carvingScanStride = 0;              // Probe spacing in bytes (0 = cluster starts, 512 = every sector)
+    bool overlapStages = false;                  // NTFS: carve while MFT/USN run, metadata reads first
+    bool carvingRetainFiles = true;              // false: carved files are only reported, never collected
+    bool carvingPrescreen = true;                // Skip zero/uniform clusters, drop weak magics in random runs
+    bool carvingGapSearch = true;                // Rejoin JPEG/ZIP files split into two fragments
 
     // ========================================================================
     // ExFAT/FAT32 Settings
@@ -48,6 +54,22 @@ struct ScanConfiguration {
     // ========================================================================
     size_t parallelThreads = 4;
 
+    // ========================================================================
+    // I/O Settings
+    // ========================================================================
+    bool unbufferedStreaming = false;            // Opt-in: full-volume passes bypass the file cache
+
+    // ========================================================================
+    // Scan Index Settings
+    // ========================================================================
+    bool incrementalRescan = false;              // Opt-in, NTFS: update a saved index from the USN journal
+
+    // ========================================================================
+    // Multi-Volume Scan Settings
+    // ========================================================================
+    uint64_t totalBandwidthLimit = 0;            // Bytes/s shared by every volume read (0 = unlimited)
+    size_t totalThreadBudget = 0;                // Workers across concurrent volumes (0 = hardware threads)
+
     // ========================================================================
     // Aliases for legacy compatibility
     // ========================================================================
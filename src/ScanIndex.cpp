@@ -0,0 +1,337 @@
+// ============================================================================
+// ScanIndex.cpp - Persistent Scan Results for Re-open and Incremental Rescans
+// ============================================================================
+// Layout: a fixed header with the volume stamp and a section table, then
+// each section 8-byte aligned so records can be read straight from the view.
+// ============================================================================
+
+#include "ScanIndex.h"
+#include "Constants.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace KVC {
+
+namespace {
+
+enum Section : uint32_t {
+    RESULTS,
+    RUNS,
+    STRINGS,
+    RESIDENT,
+    DIRECTORIES,
+    DIRECTORY_NAMES,
+    CLAIMED,
+    UNCARVED,
+    SECTION_COUNT
+};
+
+struct SectionEntry {
+    uint64_t offset;
+    uint64_t size;              // Bytes
+};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t sectionCount;
+    ScanIndexState state;
+    SectionEntry sections[SECTION_COUNT];
+};
+
+static_assert(sizeof(IndexedResult) == 120, "IndexedResult is part of the file format");
+static_assert(sizeof(IndexedRun) == 24, "IndexedRun is part of the file format");
+static_assert(sizeof(DirectoryIndex::Entry) == 24, "DirectoryIndex::Entry is part of the file format");
+
+uint64_t AlignUp(uint64_t value) {
+    return (value + 7) & ~7ULL;
+}
+
+template <typename T>
+std::span<const T> SectionAs(const uint8_t* view, const SectionEntry& section) {
+    return std::span<const T>(reinterpret_cast<const T*>(view + section.offset),
+                              static_cast<size_t>(section.size / sizeof(T)));
+}
+
+} // namespace
+
+// ============================================================================
+// Builder
+// ============================================================================
+
+void ScanIndexBuilder::Add(const RecoveryCandidate& candidate) {
+    IndexedResult result = {};
+    result.fileSize = candidate.fileSize;
+    result.size = candidate.size;
+    result.volumeStartOffset = candidate.volumeStartOffset;
+    result.source = static_cast<uint8_t>(candidate.source);
+    result.quality = static_cast<uint8_t>(candidate.quality);
+
+    if (candidate.mftRecord) {
+        result.flags |= IndexedResult::HAS_MFT_RECORD;
+        result.mftRecord = *candidate.mftRecord;
+    }
+    if (candidate.fileRecord) {
+        result.flags |= IndexedResult::HAS_FILE_RECORD;
+        result.fileRecord = *candidate.fileRecord;
+    }
+    if (candidate.deletedTime) {
+        result.flags |= IndexedResult::HAS_DELETED_TIME;
+        result.deletedTime = std::chrono::duration_cast<std::chrono::microseconds>(
+            candidate.deletedTime->time_since_epoch()).count();
+    }
+    if (candidate.hasDeletedTime) result.flags |= IndexedResult::DELETED_TIME_FLAG;
+    if (candidate.isRecoverable) result.flags |= IndexedResult::IS_RECOVERABLE;
+
+    result.stringOffset = m_strings.size();
+    result.nameLength = static_cast<uint32_t>(candidate.name.size());
+    result.pathLength = static_cast<uint32_t>(candidate.path.size());
+    result.filesystemLength = static_cast<uint16_t>(std::min<size_t>(candidate.filesystemType.size(), UINT16_MAX));
+    result.sizeTextLength = static_cast<uint16_t>(std::min<size_t>(candidate.sizeFormatted.size(), UINT16_MAX));
+    m_strings += candidate.name;
+    m_strings += candidate.path;
+    m_strings.append(candidate.filesystemType, 0, result.filesystemLength);
+    m_strings.append(candidate.sizeFormatted, 0, result.sizeTextLength);
+
+    const FragmentMap& fragments = candidate.file.GetFragments();
+    result.dataSize = candidate.file.FileSize();
+    result.fragmentUnit = fragments.BytesPerCluster();
+    result.fragmentSize = fragments.TotalSize();
+    result.firstRun = m_runs.size();
+    result.runCount = static_cast<uint32_t>(fragments.RunCount());
+    for (const auto& run : fragments.GetRuns()) {
+        m_runs.push_back({ run.startCluster, run.clusterCount, run.fileOffset });
+    }
+
+    if (candidate.file.IsResident()) {
+        const auto& data = candidate.file.ResidentData();
+        result.flags |= IndexedResult::IS_RESIDENT;
+        result.residentOffset = m_resident.size();
+        result.residentLength = static_cast<uint32_t>(data.size());
+        m_resident.insert(m_resident.end(), data.begin(), data.end());
+    }
+
+    m_results.push_back(result);
+}
+
+bool ScanIndexBuilder::Save(const std::wstring& path, const ScanIndexState& state,
+                            const DirectoryIndex& directories, const ClusterBitmap& claimed,
+                            const ClusterBitmap* uncarved) const
+{
+    const std::vector<DirectoryIndex::Entry> entries = directories.Export();
+    const std::wstring& names = directories.NameArena();
+
+    struct Blob {
+        const void* data;
+        uint64_t size;
+    };
+    const Blob blobs[SECTION_COUNT] = {
+        { m_results.data(), m_results.size() * sizeof(IndexedResult) },
+        { m_runs.data(), m_runs.size() * sizeof(IndexedRun) },
+        { m_strings.data(), m_strings.size() * sizeof(wchar_t) },
+        { m_resident.data(), m_resident.size() },
+        { entries.data(), entries.size() * sizeof(DirectoryIndex::Entry) },
+        { names.data(), names.size() * sizeof(wchar_t) },
+        { claimed.Words(), claimed.ByteSize() },
+        { uncarved ? uncarved->Words() : nullptr, uncarved ? uncarved->ByteSize() : 0 },
+    };
+
+    FileHeader header = {};
+    std::memcpy(header.magic, Constants::Index::MAGIC, sizeof(header.magic));
+    header.version = Constants::Index::VERSION;
+    header.sectionCount = SECTION_COUNT;
+    header.state = state;
+
+    uint64_t offset = AlignUp(sizeof(FileHeader));
+    for (uint32_t i = 0; i < SECTION_COUNT; i++) {
+        header.sections[i] = { offset, blobs[i].size };
+        offset = AlignUp(offset + blobs[i].size);
+    }
+
+    std::wstring tempPath = path + L".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+
+        static const char padding[8] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        uint64_t written = sizeof(header);
+        for (uint32_t i = 0; i < SECTION_COUNT; i++) {
+            out.write(padding, static_cast<std::streamsize>(header.sections[i].offset - written));
+            if (blobs[i].size > 0) {
+                out.write(static_cast<const char*>(blobs[i].data), static_cast<std::streamsize>(blobs[i].size));
+            }
+            written = header.sections[i].offset + blobs[i].size;
+        }
+
+        out.flush();
+        if (!out) {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    return !ec;
+}
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+ScanIndex::~ScanIndex() {
+    if (m_view) UnmapViewOfFile(m_view);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+}
+
+std::unique_ptr<ScanIndex> ScanIndex::Open(const std::wstring& path) {
+    std::unique_ptr<ScanIndex> index(new ScanIndex());
+
+    index->m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (index->m_file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(index->m_file, &fileSize) ||
+        static_cast<uint64_t>(fileSize.QuadPart) < sizeof(FileHeader) ||
+        static_cast<uint64_t>(fileSize.QuadPart) > SIZE_MAX) {
+        return nullptr;
+    }
+    uint64_t size = static_cast<uint64_t>(fileSize.QuadPart);
+
+    index->m_mapping = CreateFileMappingW(index->m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!index->m_mapping) {
+        return nullptr;
+    }
+    index->m_view = static_cast<const uint8_t*>(MapViewOfFile(index->m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!index->m_view) {
+        return nullptr;
+    }
+
+    const auto* header = reinterpret_cast<const FileHeader*>(index->m_view);
+    if (std::memcmp(header->magic, Constants::Index::MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != Constants::Index::VERSION ||
+        header->sectionCount != SECTION_COUNT) {
+        return nullptr;
+    }
+
+    static constexpr size_t ELEMENT_SIZE[SECTION_COUNT] = {
+        sizeof(IndexedResult), sizeof(IndexedRun), sizeof(wchar_t), 1,
+        sizeof(DirectoryIndex::Entry), sizeof(wchar_t), sizeof(uint64_t), sizeof(uint64_t)
+    };
+    for (uint32_t i = 0; i < SECTION_COUNT; i++) {
+        const SectionEntry& section = header->sections[i];
+        if (section.offset % 8 != 0 || section.offset > size || section.size > size - section.offset ||
+            section.size % ELEMENT_SIZE[i] != 0) {
+            return nullptr;
+        }
+    }
+
+    const uint8_t* view = index->m_view;
+    const SectionEntry* sections = header->sections;
+    index->m_results = SectionAs<IndexedResult>(view, sections[RESULTS]);
+    index->m_runs = SectionAs<IndexedRun>(view, sections[RUNS]);
+    auto strings = SectionAs<wchar_t>(view, sections[STRINGS]);
+    index->m_strings = std::wstring_view(strings.data(), strings.size());
+    index->m_resident = SectionAs<uint8_t>(view, sections[RESIDENT]);
+    index->m_directories = SectionAs<DirectoryIndex::Entry>(view, sections[DIRECTORIES]);
+    auto names = SectionAs<wchar_t>(view, sections[DIRECTORY_NAMES]);
+    index->m_directoryNames = std::wstring_view(names.data(), names.size());
+    index->m_claimed = SectionAs<uint8_t>(view, sections[CLAIMED]);
+    index->m_uncarved = SectionAs<uint8_t>(view, sections[UNCARVED]);
+    return index;
+}
+
+void ScanIndex::Remove(const std::wstring& path) {
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
+const ScanIndexState& ScanIndex::State() const {
+    return reinterpret_cast<const FileHeader*>(m_view)->state;
+}
+
+bool ScanIndex::GetResult(size_t index, RecoveryCandidate& candidate) const {
+    if (index >= m_results.size()) return false;
+    const IndexedResult& result = m_results[index];
+
+    // Every offset is checked before use; a damaged record is skipped, not trusted
+    uint64_t stringLength = static_cast<uint64_t>(result.nameLength) + result.pathLength +
+                            result.filesystemLength + result.sizeTextLength;
+    if (result.stringOffset > m_strings.size() || stringLength > m_strings.size() - result.stringOffset ||
+        result.firstRun > m_runs.size() || result.runCount > m_runs.size() - result.firstRun ||
+        result.residentOffset > m_resident.size() ||
+        result.residentLength > m_resident.size() - result.residentOffset ||
+        result.source > static_cast<uint8_t>(RecoverySource::ExFAT) ||
+        result.quality > static_cast<uint8_t>(RecoveryQuality::Unrecoverable)) {
+        return false;
+    }
+
+    candidate = RecoveryCandidate();
+    candidate.fileSize = result.fileSize;
+    candidate.size = result.size;
+    candidate.volumeStartOffset = result.volumeStartOffset;
+    candidate.source = static_cast<RecoverySource>(result.source);
+    candidate.quality = static_cast<RecoveryQuality>(result.quality);
+    candidate.hasDeletedTime = (result.flags & IndexedResult::DELETED_TIME_FLAG) != 0;
+    candidate.isRecoverable = (result.flags & IndexedResult::IS_RECOVERABLE) != 0;
+    if (result.flags & IndexedResult::HAS_MFT_RECORD) candidate.mftRecord = result.mftRecord;
+    if (result.flags & IndexedResult::HAS_FILE_RECORD) candidate.fileRecord = result.fileRecord;
+    if (result.flags & IndexedResult::HAS_DELETED_TIME) {
+        candidate.deletedTime = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::microseconds(result.deletedTime)));
+    }
+
+    size_t pos = static_cast<size_t>(result.stringOffset);
+    candidate.name.assign(m_strings.substr(pos, result.nameLength));
+    pos += result.nameLength;
+    candidate.path.assign(m_strings.substr(pos, result.pathLength));
+    pos += result.pathLength;
+    candidate.filesystemType.assign(m_strings.substr(pos, result.filesystemLength));
+    pos += result.filesystemLength;
+    candidate.sizeFormatted.assign(m_strings.substr(pos, result.sizeTextLength));
+
+    FragmentMap fragments(result.fragmentUnit);
+    fragments.GetRuns().reserve(result.runCount);
+    for (uint32_t i = 0; i < result.runCount; i++) {
+        const IndexedRun& run = m_runs[static_cast<size_t>(result.firstRun) + i];
+        fragments.AddRun(ClusterRun(run.startCluster, run.clusterCount, run.fileOffset));
+    }
+    fragments.SetTotalSize(result.fragmentSize);
+
+    candidate.file = FragmentedFile(result.dataSize, result.fragmentUnit);
+    candidate.file.SetFragmentMap(std::move(fragments));
+    if (result.flags & IndexedResult::IS_RESIDENT) {
+        const uint8_t* data = m_resident.data() + result.residentOffset;
+        candidate.file.SetResidentData(std::vector<uint8_t>(data, data + result.residentLength));
+    }
+    return true;
+}
+
+bool ScanIndex::LoadBitmap(std::span<const uint8_t> bits, ClusterBitmap& map) const {
+    uint64_t totalClusters = State().totalClusters;
+    if (bits.empty() || bits.size() != (totalClusters + 63) / 64 * sizeof(uint64_t)) {
+        return false;
+    }
+    map.Reset(totalClusters);
+    map.MergeBytes(0, bits.data(), bits.size());
+    return true;
+}
+
+bool ScanIndex::LoadClaimed(ClusterBitmap& map) const {
+    return LoadBitmap(m_claimed, map);
+}
+
+bool ScanIndex::LoadUncarved(ClusterBitmap& map) const {
+    return LoadBitmap(m_uncarved, map);
+}
+
+} // namespace KVC
@@ -0,0 +1,148 @@
+// ============================================================================
+// ScanIndex.h - Persistent Scan Results for Re-open and Incremental Rescans
+// ============================================================================
+// A finished NTFS scan's results, parent directory table, claimed clusters
+// and carving coverage, stamped with the change-journal position they
+// reflect. The file is mapped read-only and its sections are used in place,
+// so reopening a volume replays results without parsing anything; a rescan
+// then only handles journal entries after the saved USN and clusters that
+// became free since.
+// ============================================================================
+
+#pragma once
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Windows.h>
+#include "RecoveryCandidate.h"
+#include "DirectoryIndex.h"
+#include "ClusterBitmap.h"
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace KVC {
+
+// Fixed-layout volume stamp stored in the file header
+struct ScanIndexState {
+    uint64_t volumeSerial = 0;
+    uint64_t totalClusters = 0;
+    uint64_t bytesPerCluster = 0;
+    uint64_t settingsHash = 0;      // Filters, stages and limits the results depend on
+    uint64_t usnJournalId = 0;
+    int64_t usnNext = 0;            // Journal entries from here on are not reflected
+    uint64_t carvingResumeLCN = 0;  // Carving reached this cluster
+};
+
+// One result as stored; strings and runs live in their own sections
+struct IndexedResult {
+    uint64_t fileSize;
+    uint64_t size;                  // RecoveryCandidate compatibility field
+    uint64_t mftRecord;             // With HAS_MFT_RECORD
+    uint64_t fileRecord;            // With HAS_FILE_RECORD
+    int64_t deletedTime;            // Microseconds since 1970, with HAS_DELETED_TIME
+    uint64_t volumeStartOffset;
+    uint64_t dataSize;              // FragmentedFile::FileSize
+    uint64_t fragmentUnit;          // FragmentMap bytes per run unit
+    uint64_t fragmentSize;          // FragmentMap::TotalSize
+    uint64_t firstRun;
+    uint64_t stringOffset;          // Name, path, filesystem and size text, back to back
+    uint64_t residentOffset;
+    uint32_t runCount;
+    uint32_t residentLength;
+    uint32_t nameLength;
+    uint32_t pathLength;
+    uint16_t filesystemLength;
+    uint16_t sizeTextLength;
+    uint8_t source;
+    uint8_t quality;
+    uint8_t flags;
+    uint8_t reserved;
+
+    static constexpr uint8_t HAS_MFT_RECORD = 0x01;
+    static constexpr uint8_t HAS_FILE_RECORD = 0x02;
+    static constexpr uint8_t HAS_DELETED_TIME = 0x04;   // deletedTime holds a value
+    static constexpr uint8_t DELETED_TIME_FLAG = 0x08;  // RecoveryCandidate::hasDeletedTime
+    static constexpr uint8_t IS_RECOVERABLE = 0x10;
+    static constexpr uint8_t IS_RESIDENT = 0x20;
+};
+
+struct IndexedRun {
+    uint64_t startCluster;
+    uint64_t clusterCount;
+    uint64_t fileOffset;
+};
+
+// Collects a scan's results as they are reported. Not thread-safe; callers
+// serialize Add the same way they serialize result delivery.
+class ScanIndexBuilder {
+public:
+    void Add(const RecoveryCandidate& candidate);
+    size_t Count() const { return m_results.size(); }
+
+    // uncarved may be null (nothing known to be carved). Writes path + ".tmp",
+    // then renames it over path; the old file must not be open.
+    bool Save(const std::wstring& path, const ScanIndexState& state, const DirectoryIndex& directories,
+              const ClusterBitmap& claimed, const ClusterBitmap* uncarved) const;
+
+private:
+    std::vector<IndexedResult> m_results;
+    std::vector<IndexedRun> m_runs;
+    std::wstring m_strings;
+    std::vector<uint8_t> m_resident;
+};
+
+// Read-only view of a saved index
+class ScanIndex {
+public:
+    ~ScanIndex();
+    ScanIndex(const ScanIndex&) = delete;
+    ScanIndex& operator=(const ScanIndex&) = delete;
+
+    // nullptr if the file is missing, from another format version or its
+    // sections do not fit inside it
+    static std::unique_ptr<ScanIndex> Open(const std::wstring& path);
+
+    static void Remove(const std::wstring& path);
+
+    const ScanIndexState& State() const;
+
+    size_t ResultCount() const { return m_results.size(); }
+
+    // Materialize result i; false if it points outside its sections
+    bool GetResult(size_t index, RecoveryCandidate& candidate) const;
+
+    std::span<const DirectoryIndex::Entry> Directories() const { return m_directories; }
+    std::wstring_view DirectoryNames() const { return m_directoryNames; }
+
+    // Reset map to the volume and load the saved bits; false if the section
+    // is absent or sized for another volume
+    bool LoadClaimed(ClusterBitmap& map) const;
+    bool LoadUncarved(ClusterBitmap& map) const;
+
+private:
+    ScanIndex() = default;
+
+    bool LoadBitmap(std::span<const uint8_t> bits, ClusterBitmap& map) const;
+
+    // Held without write sharing, so the mapping cannot shrink underneath
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+    const uint8_t* m_view = nullptr;
+
+    std::span<const IndexedResult> m_results;
+    std::span<const IndexedRun> m_runs;
+    std::wstring_view m_strings;
+    std::span<const uint8_t> m_resident;
+    std::span<const DirectoryIndex::Entry> m_directories;
+    std::wstring_view m_directoryNames;
+    std::span<const uint8_t> m_claimed;
+    std::span<const uint8_t> m_uncarved;
+};
+
+} // namespace KVC
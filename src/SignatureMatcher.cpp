@@ -0,0 +1,126 @@
+// ============================================================================
+// SignatureMatcher.cpp - Precompiled Multi-Pattern Signature Matcher
+// ============================================================================
+
+#include "SignatureMatcher.h"
+#include <algorithm>
+#include <cstring>
+
+namespace KVC {
+
+namespace {
+
+inline uint32_t LoadPrefix(const uint8_t* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+} // anonymous namespace
+
+SignatureMatcher::SignatureMatcher(const std::vector<FileSignature>& signatures)
+    : m_signatures(signatures)
+{
+    for (size_t i = 0; i < m_signatures.size(); i++) {
+        const auto& sig = m_signatures[i];
+        if (sig.signature == nullptr || sig.signatureSize == 0) {
+            continue;
+        }
+
+        // A later signature with identical magic and no stricter check can
+        // never win (e.g. DOCX behind ZIP), so drop it from the table
+        bool shadowed = false;
+        for (const auto& pattern : m_patterns) {
+            if (IsShadowedBy(sig, m_signatures[pattern.signatureIndex])) {
+                shadowed = true;
+                break;
+            }
+        }
+        if (shadowed) {
+            continue;
+        }
+
+        uint8_t valueBytes[4] = {};
+        uint8_t maskBytes[4] = {};
+        size_t prefixLen = std::min<size_t>(sig.signatureSize, 4);
+        std::memcpy(valueBytes, sig.signature, prefixLen);
+        std::memset(maskBytes, 0xFF, prefixLen);
+
+        Pattern pattern{};
+        pattern.prefixValue = LoadPrefix(valueBytes);
+        pattern.prefixMask = LoadPrefix(maskBytes);
+        pattern.offset = static_cast<uint32_t>(sig.headerOffset);
+        pattern.required = static_cast<uint32_t>(std::max<size_t>({
+            sig.headerOffset + std::max<size_t>(sig.signatureSize, 4),
+            sig.minHeaderSize
+        }));
+        pattern.magicSize = static_cast<uint32_t>(sig.signatureSize);
+        pattern.signatureIndex = i;
+
+        m_maxHeaderSize = std::max<size_t>(m_maxHeaderSize, pattern.required);
+        m_maxMagicEnd = std::max<size_t>(m_maxMagicEnd, sig.headerOffset + sig.signatureSize);
+        m_repeatedByteMagic = m_repeatedByteMagic ||
+            std::all_of(sig.signature, sig.signature + sig.signatureSize,
+                        [&sig](uint8_t b) { return b == sig.signature[0]; });
+        m_patterns.push_back(pattern);
+    }
+
+    // Build CSR-style buckets keyed by the first byte of the cluster head.
+    // Patterns anchored past offset 0 cannot be keyed and land in every bucket.
+    std::array<std::vector<uint16_t>, 256> buckets;
+    for (size_t p = 0; p < m_patterns.size(); p++) {
+        const auto& sig = m_signatures[m_patterns[p].signatureIndex];
+        if (m_patterns[p].offset == 0) {
+            buckets[sig.signature[0]].push_back(static_cast<uint16_t>(p));
+        } else {
+            for (auto& bucket : buckets) {
+                bucket.push_back(static_cast<uint16_t>(p));
+            }
+        }
+    }
+
+    for (size_t b = 0; b < buckets.size(); b++) {
+        m_bucketStart[b] = static_cast<uint32_t>(m_entries.size());
+        m_entries.insert(m_entries.end(), buckets[b].begin(), buckets[b].end());
+    }
+    m_bucketStart[256] = static_cast<uint32_t>(m_entries.size());
+}
+
+bool SignatureMatcher::IsShadowedBy(const FileSignature& later, const FileSignature& earlier) {
+    if (earlier.validator != nullptr) return false;
+    if (earlier.headerOffset != later.headerOffset) return false;
+    if (earlier.signatureSize > later.signatureSize) return false;
+    return std::memcmp(earlier.signature, later.signature, earlier.signatureSize) == 0;
+}
+
+const FileSignature* SignatureMatcher::Match(const uint8_t* data, size_t available, size_t minMagicSize) const {
+    if (available == 0) {
+        return nullptr;
+    }
+
+    const uint8_t lead = data[0];
+    for (uint32_t e = m_bucketStart[lead]; e < m_bucketStart[lead + 1]; e++) {
+        const Pattern& pattern = m_patterns[m_entries[e]];
+
+        if (available < pattern.required) continue;
+
+        const uint8_t* head = data + pattern.offset;
+        if ((LoadPrefix(head) & pattern.prefixMask) != pattern.prefixValue) continue;
+
+        const FileSignature& sig = m_signatures[pattern.signatureIndex];
+        if (pattern.magicSize < minMagicSize && sig.validator == nullptr) continue;
+
+        if (sig.signatureSize > 4 &&
+            std::memcmp(head + 4, sig.signature + 4, sig.signatureSize - 4) != 0) {
+            continue;
+        }
+
+        if (sig.validator != nullptr && !sig.validator(data, available)) continue;
+
+        return &sig;
+    }
+
+    return nullptr;
+}
+
+} // namespace KVC
@@ -0,0 +1,62 @@
+// ============================================================================
+// SignatureMatcher.h - Precompiled Multi-Pattern Signature Matcher
+// ============================================================================
+// Compiles a signature list once into a first-byte dispatch table so that
+// each cluster head costs one table lookup plus the few candidate compares.
+// Format-specific checks run through the per-signature validator hooks.
+// ============================================================================
+
+#pragma once
+
+#include "FileSignatures.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace KVC {
+
+class SignatureMatcher {
+public:
+    explicit SignatureMatcher(const std::vector<FileSignature>& signatures);
+
+    // Returns the first signature (in registration order) matching the
+    // head of data, or nullptr when nothing matches. Signatures whose magic
+    // is shorter than minMagicSize and that have no validator are passed over.
+    const FileSignature* Match(const uint8_t* data, size_t available, size_t minMagicSize = 0) const;
+
+    // Largest number of bytes any pattern inspects
+    size_t MaxHeaderSize() const { return m_maxHeaderSize; }
+
+    // Furthest byte any magic reaches from the probe position
+    size_t MaxMagicEnd() const { return m_maxMagicEnd; }
+
+    // True if some magic is one byte repeated, so it could match uniform data
+    bool HasRepeatedByteMagic() const { return m_repeatedByteMagic; }
+    size_t PatternCount() const { return m_patterns.size(); }
+    bool Empty() const { return m_patterns.empty(); }
+
+private:
+    struct Pattern {
+        uint32_t prefixValue;   // First up to 4 magic bytes
+        uint32_t prefixMask;    // Mask for magic shorter than 4 bytes
+        uint32_t offset;        // Magic position relative to data start
+        uint32_t required;      // Bytes needed to evaluate the pattern
+        uint32_t magicSize;
+        size_t signatureIndex;  // Index into m_signatures
+    };
+
+    static bool IsShadowedBy(const FileSignature& later, const FileSignature& earlier);
+
+    std::vector<FileSignature> m_signatures;
+    std::vector<Pattern> m_patterns;
+
+    // Bucket b spans m_entries[m_bucketStart[b] .. m_bucketStart[b + 1])
+    std::array<uint32_t, 257> m_bucketStart{};
+    std::vector<uint16_t> m_entries;
+    size_t m_maxHeaderSize = 0;
+    size_t m_maxMagicEnd = 0;
+    bool m_repeatedByteMagic = false;
+};
+
+} // namespace KVC
@@ -0,0 +1,72 @@
+// ============================================================================
+// SpscRing.h - Single-Producer Single-Consumer Ring Buffer
+// ============================================================================
+// Fixed-capacity lock-free queue between one producing and one consuming
+// thread. Items are moved in and out of preallocated slots, so steady-state
+// traffic allocates nothing beyond what the items themselves own.
+// ============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace KVC {
+
+template <typename T>
+class SpscRing {
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscRing(size_t capacity)
+        : m_slots(std::bit_ceil(capacity < 2 ? size_t(2) : capacity))
+        , m_mask(m_slots.size() - 1)
+    {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer side; false (item untouched) when the ring is full
+    bool TryPush(T&& item) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == m_slots.size()) {
+            return false;
+        }
+        m_slots[tail & m_mask] = std::move(item);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; hands up to maxItems queued items to consume(T&&)
+    template <typename Consume>
+    size_t Drain(Consume&& consume, size_t maxItems = SIZE_MAX) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        size_t available = m_tail.load(std::memory_order_acquire) - head;
+        size_t count = available < maxItems ? available : maxItems;
+
+        for (size_t i = 0; i < count; i++) {
+            T& slot = m_slots[(head + i) & m_mask];
+            consume(std::move(slot));
+            slot = T();     // Release what the item owned before the slot is reused
+        }
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    bool Empty() const {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    std::vector<T> m_slots;
+    const size_t m_mask;
+
+    // Apart so the two threads don't share a cache line
+    alignas(64) std::atomic<size_t> m_head{ 0 };    // Next slot to consume
+    alignas(64) std::atomic<size_t> m_tail{ 0 };    // Next slot to fill
+};
+
+} // namespace KVC
@@ -0,0 +1,54 @@
+// ============================================================================
+// StringPool.cpp - Arena-Backed String Storage
+// ============================================================================
+
+#include "StringPool.h"
+#include <algorithm>
+
+namespace KVC {
+
+StringPool::StringPool(size_t blockChars)
+    : m_blockChars(std::max<size_t>(blockChars, 1))
+{}
+
+const wchar_t* StringPool::Intern(std::wstring_view text) {
+    auto it = m_interned.find(text);
+    if (it != m_interned.end()) {
+        return it->data();
+    }
+
+    const wchar_t* stored = Store(text);
+    m_interned.insert(std::wstring_view(stored, text.size()));
+    return stored;
+}
+
+const wchar_t* StringPool::Store(std::wstring_view text) {
+    size_t needed = text.size() + 1;
+
+    wchar_t* dest = nullptr;
+    if (needed > m_blockChars) {
+        m_oversized.push_back(std::make_unique<wchar_t[]>(needed));
+        dest = m_oversized.back().get();
+    }
+    else {
+        if (m_blocks.empty() || m_used + needed > m_blockChars) {
+            m_blocks.push_back(std::make_unique<wchar_t[]>(m_blockChars));
+            m_used = 0;
+        }
+        dest = m_blocks.back().get() + m_used;
+        m_used += needed;
+    }
+
+    std::copy(text.begin(), text.end(), dest);
+    dest[text.size()] = L'\0';
+    return dest;
+}
+
+void StringPool::Clear() {
+    m_interned.clear();
+    m_blocks.clear();
+    m_oversized.clear();
+    m_used = 0;
+}
+
+} // namespace KVC
@@ -0,0 +1,46 @@
+// ============================================================================
+// StringPool.h - Arena-Backed String Storage
+// ============================================================================
+// NUL-terminated wide strings packed into fixed blocks that never move, so a
+// returned pointer stays valid until Clear(). Intern() shares one copy of
+// repeated text (paths, labels); Store() skips the lookup for unique text.
+// One thread writes; pointers may be read by any thread once published.
+// ============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace KVC {
+
+class StringPool {
+public:
+    explicit StringPool(size_t blockChars);
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    // Copy of text, shared with every earlier Intern() of the same text
+    const wchar_t* Intern(std::wstring_view text);
+
+    // Fresh copy of text without deduplication
+    const wchar_t* Store(std::wstring_view text);
+
+    // Drop every string; no reader may hold a pointer across this
+    void Clear();
+
+    size_t BytesReserved() const { return m_blocks.size() * m_blockChars * sizeof(wchar_t); }
+
+private:
+    size_t m_blockChars;
+    std::vector<std::unique_ptr<wchar_t[]>> m_blocks;
+    std::vector<std::unique_ptr<wchar_t[]>> m_oversized;   // Strings longer than a block
+    size_t m_used = 0;                                      // Characters used in the last block
+    std::unordered_set<std::wstring_view> m_interned;       // Views into the blocks
+};
+
+} // namespace KVC
@@ -2,6 +2,8 @@
 
 #include "UsnJournalScanner.h"
 #include "Constants.h"
+#include "AlignedBufferPool.h"
+#include "PerfCounters.h"
 
 #include <climits>
 #include <cstring>
@@ -11,57 +13,180 @@
 
 namespace KVC {
 
+// Little-endian field readers for in-place record parsing.
+static uint16_t ReadLE16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0]) | (static_cast<uint16_t>(p[1]) << 8);
+}
+
+static uint32_t ReadLE32(const uint8_t* p) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= static_cast<uint32_t>(p[i]) << (i * 8);
+    }
+    return value;
+}
+
+static uint64_t ReadLE64(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= static_cast<uint64_t>(p[i]) << (i * 8);
+    }
+    return value;
+}
+
 UsnJournalScanner::UsnJournalScanner() = default;
 UsnJournalScanner::~UsnJournalScanner() = default;
 
-// Parse USN Journal and group records by MFT record number.
-std::map<uint64_t, std::vector<UsnRecord>> UsnJournalScanner::ParseJournal(
+// Stream the $J data runs chunk by chunk, visiting each record in place.
+uint64_t UsnJournalScanner::ScanJournal(
     DiskHandle& disk,
-    uint64_t maxRecords)
+    uint64_t maxRecords,
+    const RecordVisitor& visitor,
+    DiskHandle::ReadMode mode,
+    int64_t fromUsn)
 {
-    std::map<uint64_t, std::vector<UsnRecord>> recordsByMft;
+    if (maxRecords == 0) {
+        return 0;
+    }
+    uint64_t budget = maxRecords;
 
     try {
         auto boot = ReadBootSector(disk);
-        
+        uint64_t bytesPerCluster = static_cast<uint64_t>(boot.bytesPerSector) * boot.sectorsPerCluster;
+        if (bytesPerCluster == 0) {
+            return 0;
+        }
+
         // $Extend\$UsnJrnl is usually at MFT record 38.
         auto usnjrnlData = ReadMFTRecord(disk, boot, Constants::NTFS::USNJRNL_RECORD_NUMBER);
         if (usnjrnlData.empty()) {
-            return recordsByMft;
+            return 0;
         }
 
         // Find $J stream location within the MFT record.
-        auto jStreamClusters = ParseJStreamLocation(usnjrnlData);
-        if (jStreamClusters.empty()) {
-            return recordsByMft;
+        auto jStreamRuns = ParseJStreamLocation(usnjrnlData);
+        if (jStreamRuns.empty()) {
+            return 0;
         }
 
-        // Read $J stream data from disk.
-        auto jData = ReadClusters(disk, boot, jStreamClusters);
-        if (jData.empty()) {
-            return recordsByMft;
+        // Reads land after a reserve that holds the tail record of the previous
+        // chunk, so the read target stays page-aligned for unbuffered I/O.
+        constexpr size_t carryReserve = Constants::NTFS::USN_MAX_RECORD_SIZE;
+        uint64_t chunkBytes = std::max<uint64_t>(
+            bytesPerCluster, Constants::NTFS::USN_STREAM_CHUNK_SIZE / bytesPerCluster * bytesPerCluster);
+        AlignedBuffer buffer(static_cast<size_t>(carryReserve + chunkBytes));
+        if (!buffer.IsValid()) {
+            return 0;
         }
+        uint8_t* readTarget = buffer.Data() + carryReserve;
+
+        size_t carry = 0;
+        bool stop = false;
+        uint64_t streamOffset = 0;
+        // Records never straddle a journal page, so a page start is a record start
+        const uint64_t resumeAt = fromUsn > 0
+            ? static_cast<uint64_t>(fromUsn) / Constants::NTFS::USN_PAGE_SIZE * Constants::NTFS::USN_PAGE_SIZE
+            : 0;
+
+        for (const auto& run : jStreamRuns) {
+            uint64_t runBytes = run.count * bytesPerCluster;
+            uint64_t runStart = streamOffset;
+            streamOffset += runBytes;
+
+            if (run.sparse || streamOffset <= resumeAt) {
+                // Deallocated journal head, or records the caller has seen
+                carry = 0;
+                continue;
+            }
 
-        // Parse all USN records from the buffer.
-        auto records = ParseRecordsFromBuffer(jData);
-        
-        // Group by MFT record number and apply limit.
-        uint64_t count = 0;
-        for (const auto& record : records) {
-            if (count >= maxRecords) break;
-            
-            uint64_t mftNum = record.MftRecordNumber();
-            recordsByMft[mftNum].push_back(record);
-            count++;
+            uint64_t firstPos = resumeAt > runStart ? resumeAt - runStart : 0;
+            for (uint64_t pos = firstPos; pos < runBytes; pos += chunkBytes) {
+                Perf::ScopedTimer timer(Perf::Timer::UsnChunk);
+                size_t want = static_cast<size_t>(std::min(chunkBytes, runBytes - pos));
+                size_t got = disk.ReadInto(run.lcn * bytesPerCluster + pos, readTarget, want, mode);
+
+                uint8_t* chunk = readTarget - carry;
+                size_t chunkSize = carry + got;
+                const uint64_t budgetBefore = budget;
+                size_t consumed = ParseRecordsFromChunk(chunk, chunkSize, budget, visitor, stop);
+                Perf::Add(Perf::Counter::UsnRecordsParsed, budgetBefore - budget);
+                if (stop) {
+                    return maxRecords - budget;
+                }
+
+                // A short read breaks stream continuity; drop the partial record
+                carry = (got == want) ? chunkSize - consumed : 0;
+                if (carry > carryReserve) {
+                    carry = 0;
+                }
+                if (carry > 0) {
+                    std::memmove(readTarget - carry, chunk + consumed, carry);
+                }
+            }
         }
     }
     catch (...) {
         // Silent failure - USN Journal is optional and may not exist.
     }
 
+    return maxRecords - budget;
+}
+
+// Parse USN Journal and group records by MFT record number.
+std::map<uint64_t, std::vector<UsnRecord>> UsnJournalScanner::ParseJournal(
+    DiskHandle& disk,
+    uint64_t maxRecords)
+{
+    std::map<uint64_t, std::vector<UsnRecord>> recordsByMft;
+
+    ScanJournal(disk, maxRecords, [&](const UsnRecordView& view) {
+        recordsByMft[view.MftRecordNumber()].push_back(view.ToRecord());
+        return true;
+    });
+
     return recordsByMft;
 }
 
+// Read the journal identity ($Max) and the next USN ($J data size).
+std::optional<UsnJournalState> UsnJournalScanner::ReadJournalState(DiskHandle& disk) {
+    try {
+        auto boot = ReadBootSector(disk);
+        if (boot.bytesPerSector == 0 || boot.sectorsPerCluster == 0) {
+            return std::nullopt;
+        }
+
+        auto usnjrnlData = ReadMFTRecord(disk, boot, Constants::NTFS::USNJRNL_RECORD_NUMBER);
+
+        // $Max is resident: MaximumSize, AllocationDelta, UsnJournalID, LowestValidUsn
+        uint32_t maxLength = 0;
+        const uint8_t* maxAttr = FindNamedData(usnjrnlData, L"$Max", maxLength);
+        if (maxAttr == nullptr || maxLength < 24 || maxAttr[8] != 0) {
+            return std::nullopt;
+        }
+        uint32_t valueLength = ReadLE32(maxAttr + 16);
+        uint16_t valueOffset = ReadLE16(maxAttr + 20);
+        if (valueLength < 32 || valueOffset > maxLength || valueLength > maxLength - valueOffset) {
+            return std::nullopt;
+        }
+
+        // $J is non-resident; its data size is the next USN to be handed out
+        uint32_t jLength = 0;
+        const uint8_t* jAttr = FindNamedData(usnjrnlData, L"$J", jLength);
+        if (jAttr == nullptr || jLength < 64 || jAttr[8] == 0) {
+            return std::nullopt;
+        }
+
+        UsnJournalState state;
+        state.journalId = ReadLE64(maxAttr + valueOffset + 16);
+        state.lowestValidUsn = static_cast<int64_t>(ReadLE64(maxAttr + valueOffset + 24));
+        state.nextUsn = static_cast<int64_t>(ReadLE64(jAttr + 48));
+        return state;
+    }
+    catch (...) {
+        return std::nullopt;
+    }
+}
+
 // Read and parse the NTFS boot sector.
 UsnJournalScanner::NtfsBootSector UsnJournalScanner::ReadBootSector(DiskHandle& disk) {
     auto data = disk.ReadSectors(0, 1, disk.GetSectorSize());
@@ -120,16 +245,30 @@ std::vector<uint8_t> UsnJournalScanner::ReadMFTRecord(
 }
 
 // Parse MFT record to find $J stream data runs.
-std::vector<ClusterRange> UsnJournalScanner::ParseJStreamLocation(
+std::vector<UsnJournalScanner::JournalRun> UsnJournalScanner::ParseJStreamLocation(
     const std::vector<uint8_t>& mftData)
 {
-    if (mftData.size() < 48) {
+    uint32_t attrLength = 0;
+    const uint8_t* attr = FindNamedData(mftData, L"$J", attrLength);
+    if (attr == nullptr) {
         return {};
     }
+    return ParseDataRuns(attr, attrLength);
+}
+
+// Find a named $DATA attribute within the MFT record.
+const uint8_t* UsnJournalScanner::FindNamedData(
+    const std::vector<uint8_t>& mftData,
+    const wchar_t* wanted,
+    uint32_t& length)
+{
+    if (mftData.size() < 48) {
+        return nullptr;
+    }
 
     // Check FILE signature at the beginning.
     if (std::memcmp(mftData.data(), "FILE", 4) != 0) {
-        return {};
+        return nullptr;
     }
 
     // Extract offset to first attribute (bytes 20-21).
@@ -137,7 +276,6 @@ std::vector<ClusterRange> UsnJournalScanner::ParseJStreamLocation(
                                (static_cast<uint16_t>(mftData[21]) << 8);
     size_t offset = firstAttrOffset;
 
-    // Look for $DATA attribute with name "$J".
     while (offset + 16 < mftData.size()) {
         // Read attribute type (4 bytes, little-endian).
         uint32_t attrType = 0;
@@ -176,9 +314,9 @@ std::vector<ClusterRange> UsnJournalScanner::ParseJStreamLocation(
                     name += c;
                 }
 
-                // Found the $J stream - parse its data runs.
-                if (name == L"$J") {
-                    return ParseDataRuns(mftData.data() + offset, attrLength);
+                if (name == wanted) {
+                    length = attrLength;
+                    return mftData.data() + offset;
                 }
             }
         }
@@ -186,11 +324,11 @@ std::vector<ClusterRange> UsnJournalScanner::ParseJStreamLocation(
         offset += attrLength;
     }
 
-    return {};
+    return nullptr;
 }
 
-// Parse NTFS data runs to extract cluster locations.
-std::vector<ClusterRange> UsnJournalScanner::ParseDataRuns(
+// Parse NTFS data runs, keeping sparse runs as placeholders.
+std::vector<UsnJournalScanner::JournalRun> UsnJournalScanner::ParseDataRuns(
     const uint8_t* attrData, 
     size_t attrLength)
 {
@@ -216,7 +354,7 @@ std::vector<ClusterRange> UsnJournalScanner::ParseDataRuns(
         return {};
     }
 
-    std::vector<ClusterRange> ranges;
+    std::vector<JournalRun> ranges;
     size_t offset = runlistOffset;
     int64_t currentLCN = 0;
 
@@ -267,13 +405,12 @@ std::vector<ClusterRange> UsnJournalScanner::ParseDataRuns(
         // Update current LCN (cumulative offset).
         currentLCN += lcnOffset;
 
-        // Add range if valid (non-sparse).
-        if (lcnSize > 0 && currentLCN > 0) {
-            ClusterRange range;
-            range.start = static_cast<uint64_t>(currentLCN);
-            range.count = runLength;
-            ranges.push_back(range);
-        }
+        // Sparse runs (and invalid LCNs) are kept so run order is preserved.
+        JournalRun range;
+        range.sparse = (lcnSize == 0 || currentLCN <= 0);
+        range.lcn = range.sparse ? 0 : static_cast<uint64_t>(currentLCN);
+        range.count = runLength;
+        ranges.push_back(range);
 
         // Safety limit to prevent infinite loops.
         if (ranges.size() > 10000) {
@@ -284,152 +421,75 @@ std::vector<ClusterRange> UsnJournalScanner::ParseDataRuns(
     return ranges;
 }
 
-// Read clusters from disk based on cluster ranges.
-std::vector<uint8_t> UsnJournalScanner::ReadClusters(
-    DiskHandle& disk,
-    const NtfsBootSector& boot,
-    const std::vector<ClusterRange>& ranges)
-{
-    std::vector<uint8_t> result;
-    uint64_t bytesPerCluster = boot.bytesPerSector * boot.sectorsPerCluster;
-    uint64_t sectorSize = boot.bytesPerSector;
-    uint64_t sectorsPerCluster = bytesPerCluster / sectorSize;
-
-    // Limit total read to avoid excessive memory (~400MB at 4KB clusters).
-    uint64_t clustersRead = 0;
-
-    for (const auto& range : ranges) {
-        if (clustersRead >= Constants::NTFS::MAX_CLUSTER_CHAIN_READ) {
-            break;
-        }
-
-        uint64_t clustersToRead = std::min(range.count, Constants::NTFS::MAX_CLUSTER_CHAIN_READ - clustersRead);
-        
-        // Read each cluster in the range.
-        for (uint64_t i = 0; i < clustersToRead; i++) {
-            uint64_t cluster = range.start + i;
-            uint64_t sector = cluster * sectorsPerCluster;
-
-            auto data = disk.ReadSectors(sector, sectorsPerCluster, sectorSize);
-            result.insert(result.end(), data.begin(), data.end());
-            clustersRead++;
-        }
-    }
-
-    return result;
-}
-
-// Parse USN records from raw buffer data.
-std::vector<UsnRecord> UsnJournalScanner::ParseRecordsFromBuffer(
-    const std::vector<uint8_t>& buffer)
+// Parse USN records in place from one stream chunk.
+size_t UsnJournalScanner::ParseRecordsFromChunk(
+    const uint8_t* data,
+    size_t size,
+    uint64_t& budget,
+    const RecordVisitor& visitor,
+    bool& stop)
 {
-    std::vector<UsnRecord> records;
+    constexpr size_t minRecordSize = 60;
     size_t offset = 0;
 
-    while (offset + 60 < buffer.size()) {
-        // Read record length (first 4 bytes).
-        uint32_t recordLength = 0;
-        for (int i = 0; i < 4; i++) {
-            recordLength |= static_cast<uint32_t>(buffer[offset + i]) << (i * 8);
+    while (offset + minRecordSize <= size) {
+        uint32_t recordLength = ReadLE32(data + offset);
+
+        // Zero padding (page tails and whole zeroed pages): skip 8 bytes at a time
+        if (recordLength == 0) {
+            offset += 8;
+            while (offset + 8 <= size && ReadLE64(data + offset) == 0) {
+                offset += 8;
+            }
+            continue;
         }
 
         // Validate record length.
-        if (recordLength < 60 || recordLength > 65536 || 
-            offset + recordLength > buffer.size()) {
+        if (recordLength < minRecordSize || recordLength > Constants::NTFS::USN_MAX_RECORD_SIZE) {
             offset += 8; // Try to skip ahead
             continue;
         }
 
-        // Parse USN_RECORD_V2 structure.
-        UsnRecord rec;
-        rec.recordLength = recordLength;
-        
-        // Major version (bytes 4-5).
-        rec.majorVersion = static_cast<uint16_t>(buffer[offset + 4]) | 
-                          (static_cast<uint16_t>(buffer[offset + 5]) << 8);
-        // Minor version (bytes 6-7).
-        rec.minorVersion = static_cast<uint16_t>(buffer[offset + 6]) | 
-                          (static_cast<uint16_t>(buffer[offset + 7]) << 8);
-
-        // File reference number (bytes 8-15).
-        rec.fileReferenceNumber = 0;
-        for (int i = 0; i < 8; i++) {
-            rec.fileReferenceNumber |= static_cast<uint64_t>(buffer[offset + 8 + i]) << (i * 8);
-        }
-
-        // Parent file reference number (bytes 16-23).
-        rec.parentFileReferenceNumber = 0;
-        for (int i = 0; i < 8; i++) {
-            rec.parentFileReferenceNumber |= static_cast<uint64_t>(buffer[offset + 16 + i]) << (i * 8);
-        }
-
-        // USN (Update Sequence Number, bytes 24-31).
-        rec.usn = 0;
-        for (int i = 0; i < 8; i++) {
-            rec.usn |= static_cast<int64_t>(buffer[offset + 24 + i]) << (i * 8);
-        }
-
-        // Timestamp (FILETIME format, bytes 32-39).
-        uint64_t filetime = 0;
-        for (int i = 0; i < 8; i++) {
-            filetime |= static_cast<uint64_t>(buffer[offset + 32 + i]) << (i * 8);
-        }
-        
-        // Convert FILETIME to system_clock (simplified conversion).
-        auto ticks = static_cast<int64_t>(filetime - 116444736000000000ULL) / 10000000;
-        rec.timestamp = std::chrono::system_clock::from_time_t(ticks);
-
-        // Reason flags (bytes 40-43).
-        rec.reason = 0;
-        for (int i = 0; i < 4; i++) {
-            rec.reason |= static_cast<uint32_t>(buffer[offset + 40 + i]) << (i * 8);
-        }
-
-        // Source info (bytes 44-47).
-        rec.sourceInfo = 0;
-        for (int i = 0; i < 4; i++) {
-            rec.sourceInfo |= static_cast<uint32_t>(buffer[offset + 44 + i]) << (i * 8);
+        // Record continues in the next chunk.
+        if (offset + recordLength > size) {
+            return offset;
         }
 
-        // Security ID (bytes 48-51).
-        rec.securityId = 0;
-        for (int i = 0; i < 4; i++) {
-            rec.securityId |= static_cast<uint32_t>(buffer[offset + 48 + i]) << (i * 8);
-        }
-
-        // File attributes (bytes 52-55).
-        rec.fileAttributes = 0;
-        for (int i = 0; i < 4; i++) {
-            rec.fileAttributes |= static_cast<uint32_t>(buffer[offset + 52 + i]) << (i * 8);
+        // Parse USN_RECORD_V2 structure.
+        const uint8_t* rec = data + offset;
+        UsnRecordView view;
+        view.recordLength = recordLength;
+        view.majorVersion = ReadLE16(rec + 4);
+        view.minorVersion = ReadLE16(rec + 6);
+        view.fileReferenceNumber = ReadLE64(rec + 8);
+        view.parentFileReferenceNumber = ReadLE64(rec + 16);
+        view.usn = static_cast<int64_t>(ReadLE64(rec + 24));
+        view.filetime = ReadLE64(rec + 32);
+        view.reason = ReadLE32(rec + 40);
+        view.sourceInfo = ReadLE32(rec + 44);
+        view.securityId = ReadLE32(rec + 48);
+        view.fileAttributes = ReadLE32(rec + 52);
+
+        // Filename length and offset (bytes 56-59), kept as a raw span.
+        uint16_t filenameLength = ReadLE16(rec + 56);
+        uint16_t filenameOffset = ReadLE16(rec + 58);
+        if (filenameOffset > 0 && filenameLength > 0 &&
+            static_cast<size_t>(filenameOffset) + filenameLength <= recordLength) {
+            view.filenameBytes = std::span<const uint8_t>(rec + filenameOffset, filenameLength);
         }
 
-        // Filename length and offset (bytes 56-59).
-        uint16_t filenameLength = static_cast<uint16_t>(buffer[offset + 56]) | 
-                                 (static_cast<uint16_t>(buffer[offset + 57]) << 8);
-        uint16_t filenameOffset = static_cast<uint16_t>(buffer[offset + 58]) | 
-                                 (static_cast<uint16_t>(buffer[offset + 59]) << 8);
-
-        // Read filename (UTF-16 LE).
-        if (filenameOffset > 0 && filenameLength > 0 && 
-            offset + filenameOffset + filenameLength <= buffer.size()) {
-            
-            size_t nameChars = filenameLength / 2;
-            for (size_t i = 0; i < nameChars; i++) {
-                wchar_t c = static_cast<wchar_t>(buffer[offset + filenameOffset + i * 2]) |
-                           (static_cast<wchar_t>(buffer[offset + filenameOffset + i * 2 + 1]) << 8);
-                rec.filename += c;
-            }
+        if (!visitor(view) || --budget == 0) {
+            stop = true;
+            return offset + recordLength;
         }
 
-        records.push_back(rec);
-        
         offset += recordLength;
-        
+
         // Align to 8-byte boundary for next record.
         offset = (offset + 7) & ~7ULL;
     }
 
-    return records;
+    return std::min(offset, size);
 }
 
 // ============================================================================
@@ -461,4 +521,63 @@ uint16_t UsnRecord::SequenceNumber() const {
     return static_cast<uint16_t>((fileReferenceNumber >> 48) & 0xFFFF);
 }
 
+// ============================================================================
+// UsnRecordView Helper Methods
+// ============================================================================
+
+bool UsnRecordView::IsDeletion() const {
+    return (reason & USN_REASON_FILE_DELETE) != 0;
+}
+
+bool UsnRecordView::IsDirectory() const {
+    return (fileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+}
+
+// Only these reasons carry a name worth keeping
+bool UsnRecordView::IsDeletionOrRename() const {
+    return (reason & (USN_REASON_FILE_DELETE | USN_REASON_RENAME_OLD_NAME | USN_REASON_RENAME_NEW_NAME)) != 0;
+}
+
+uint64_t UsnRecordView::MftRecordNumber() const {
+    return fileReferenceNumber & 0x0000FFFFFFFFFFFFULL;
+}
+
+uint16_t UsnRecordView::SequenceNumber() const {
+    return static_cast<uint16_t>((fileReferenceNumber >> 48) & 0xFFFF);
+}
+
+// Decode the UTF-16 LE filename
+std::wstring UsnRecordView::DecodeFilename() const {
+    std::wstring name;
+    size_t nameChars = filenameBytes.size() / 2;
+    name.reserve(nameChars);
+    for (size_t i = 0; i < nameChars; i++) {
+        name += static_cast<wchar_t>(ReadLE16(filenameBytes.data() + i * 2));
+    }
+    return name;
+}
+
+UsnRecord UsnRecordView::ToRecord() const {
+    UsnRecord rec;
+    rec.recordLength = recordLength;
+    rec.majorVersion = majorVersion;
+    rec.minorVersion = minorVersion;
+    rec.fileReferenceNumber = fileReferenceNumber;
+    rec.parentFileReferenceNumber = parentFileReferenceNumber;
+    rec.usn = usn;
+
+    // Convert FILETIME to system_clock (simplified conversion).
+    auto ticks = static_cast<int64_t>(filetime - 116444736000000000ULL) / 10000000;
+    rec.timestamp = std::chrono::system_clock::from_time_t(ticks);
+
+    rec.reason = reason;
+    rec.sourceInfo = sourceInfo;
+    rec.securityId = securityId;
+    rec.fileAttributes = fileAttributes;
+    if (IsDeletionOrRename()) {
+        rec.filename = DecodeFilename();
+    }
+    return rec;
+}
+
 } // namespace KVC
\ No newline at end of file
@@ -2,6 +2,7 @@
 // UsnJournalScanner.h - NTFS USN Journal Analyzer
 // ============================================================================
 // Parses the NTFS Change Journal to detect file deletion events.
+// $J is streamed run by run in bounded chunks; sparse runs are never read.
 // ============================================================================
 
 #pragma once
@@ -13,6 +14,9 @@
 #include <map>
 #include <vector>
 #include <chrono>
+#include <functional>
+#include <optional>
+#include <span>
 
 namespace KVC {
 
@@ -37,11 +41,65 @@ struct UsnRecord {
     uint16_t SequenceNumber() const;
 };
 
+// Borrowed view of one USN_RECORD_V2 inside the stream buffer.
+// Valid only for the duration of the visitor call.
+struct UsnRecordView {
+    uint32_t recordLength;
+    uint16_t majorVersion;
+    uint16_t minorVersion;
+    uint64_t fileReferenceNumber;
+    uint64_t parentFileReferenceNumber;
+    int64_t usn;
+    uint64_t filetime;
+    uint32_t reason;
+    uint32_t sourceInfo;
+    uint32_t securityId;
+    uint32_t fileAttributes;
+    std::span<const uint8_t> filenameBytes;  // UTF-16 LE, undecoded
+
+    bool IsDeletion() const;
+    bool IsDirectory() const;
+    bool IsDeletionOrRename() const;
+    uint64_t MftRecordNumber() const;
+    uint16_t SequenceNumber() const;
+
+    std::wstring DecodeFilename() const;
+
+    // Owned copy; the filename is only decoded for deletion or rename reasons
+    UsnRecord ToRecord() const;
+};
+
+// Identity and extent of the journal, from $UsnJrnl's $Max and $J
+// attributes; no records are read
+struct UsnJournalState {
+    uint64_t journalId = 0;         // Changes whenever the journal is recreated
+    int64_t lowestValidUsn = 0;     // Records below this were purged
+    int64_t nextUsn = 0;            // USN the next record will get ($J size)
+};
+
 class UsnJournalScanner {
 public:
+    // Return false to stop the scan
+    using RecordVisitor = std::function<bool(const UsnRecordView&)>;
+
     UsnJournalScanner();
     ~UsnJournalScanner();
 
+    // Stream $J and call visitor for at most maxRecords records. A USN is
+    // the record's offset in $J, so fromUsn skips the stream before it; the
+    // visitor may still see a few earlier records from the same page.
+    // Returns the number of records visited.
+    uint64_t ScanJournal(
+        DiskHandle& disk,
+        uint64_t maxRecords,
+        const RecordVisitor& visitor,
+        DiskHandle::ReadMode mode = DiskHandle::ReadMode::Cached,
+        int64_t fromUsn = 0
+    );
+
+    // nullopt if the volume has no readable journal
+    std::optional<UsnJournalState> ReadJournalState(DiskHandle& disk);
+
     std::map<uint64_t, std::vector<UsnRecord>> ParseJournal(
         DiskHandle& disk,
         uint64_t maxRecords
@@ -55,13 +113,27 @@ private:
         int8_t clustersPerMFTRecord;
     };
 
+    // $J extent in stream order; sparse runs keep their length but have no LCN
+    struct JournalRun {
+        uint64_t lcn;
+        uint64_t count;
+        bool sparse;
+    };
+
     NtfsBootSector ReadBootSector(DiskHandle& disk);
     std::vector<uint8_t> ReadMFTRecord(DiskHandle& disk, const NtfsBootSector& boot, uint64_t recordNum);
-    std::vector<ClusterRange> ParseJStreamLocation(const std::vector<uint8_t>& mftData);
-    std::vector<ClusterRange> ParseDataRuns(const uint8_t* attrData, size_t attrLength);
-    std::vector<uint8_t> ReadClusters(DiskHandle& disk, const NtfsBootSector& boot, 
-                                      const std::vector<ClusterRange>& ranges);
-    std::vector<UsnRecord> ParseRecordsFromBuffer(const std::vector<uint8_t>& buffer);
+    std::vector<JournalRun> ParseJStreamLocation(const std::vector<uint8_t>& mftData);
+
+    // The $DATA attribute called name, or nullptr; length receives its size
+    static const uint8_t* FindNamedData(const std::vector<uint8_t>& mftData, const wchar_t* name,
+                                        uint32_t& length);
+
+    std::vector<JournalRun> ParseDataRuns(const uint8_t* attrData, size_t attrLength);
+
+    // Visit every complete record in data[0, size). Returns the bytes consumed;
+    // a record cut off by the chunk end is left for the next chunk.
+    size_t ParseRecordsFromChunk(const uint8_t* data, size_t size, uint64_t& budget,
+                                 const RecordVisitor& visitor, bool& stop);
 };
 
 } // namespace KVC
\ No newline at end of file
@@ -15,16 +15,10 @@ namespace KVC {
 VolumeReader::VolumeReader(DiskHandle& disk, const VolumeGeometry& geometry)
     : m_disk(disk)
     , m_geometry(geometry)
-    , m_mappedStartLCN(0)
-    , m_mappedClusterCount(0)
 {
 }
 
-VolumeReader::~VolumeReader() {
-    if (m_currentMapping.IsValid()) {
-        m_disk.UnmapRegion(m_currentMapping);
-    }
-}
+VolumeReader::~VolumeReader() = default;
 
 std::vector<uint8_t> VolumeReader::ReadClusters(uint64_t startLCN, uint64_t count) {
     if (count == 0) {
@@ -68,6 +62,43 @@ std::vector<uint8_t> VolumeReader::ReadClusters(uint64_t startLCN, uint64_t coun
     return data;
 }
 
+size_t VolumeReader::ReadClustersInto(uint64_t startLCN, uint64_t count, uint8_t* buffer,
+                                      size_t bufferSize, size_t queueDepth,
+                                      DiskHandle::ReadMode mode) {
+    if (count == 0) {
+        return 0;
+    }
+
+    if (!m_geometry.IsValidLCN(startLCN)) {
+        throw ClusterOutOfBoundsError(startLCN, m_geometry.totalClusters);
+    }
+
+    if (!m_geometry.IsValidLCN(startLCN + count - 1)) {
+        throw ClusterOutOfBoundsError(startLCN + count - 1, m_geometry.totalClusters);
+    }
+
+    if (count > UINT64_MAX / m_geometry.bytesPerCluster) {
+        throw std::overflow_error("Cluster count too large");
+    }
+
+    uint64_t bytesToRead = count * m_geometry.bytesPerCluster;
+    if (bytesToRead > bufferSize) {
+        throw std::invalid_argument("Destination buffer too small");
+    }
+
+    uint64_t physicalOffset = m_geometry.LCNToPhysicalOffset(startLCN);
+
+    size_t bytesRead = m_disk.ReadQueued(physicalOffset, buffer,
+                                         static_cast<size_t>(bytesToRead), queueDepth, mode);
+
+    if (bytesRead == 0) {
+        uint64_t startSector = physicalOffset / m_geometry.sectorSize;
+        throw DiskReadError(startSector, bytesToRead / m_geometry.sectorSize, GetLastError());
+    }
+
+    return bytesRead;
+}
+
 std::vector<uint8_t> VolumeReader::ReadClusterRun(const ClusterRun& run) {
     if (!run.IsValid()) {
         return {};
@@ -78,71 +109,38 @@ std::vector<uint8_t> VolumeReader::ReadClusterRun(const ClusterRun& run) {
 
 VolumeReader::MappedView VolumeReader::MapClusters(uint64_t startLCN, uint64_t count) {
     MappedView view;
-    view.valid = false;
     view.data = nullptr;
     view.size = 0;
     view.startLCN = startLCN;
-    
+    view.valid = false;
+
     if (count == 0) {
         return view;
     }
-    
+
     // Validate bounds
-    if (!m_geometry.IsValidLCN(startLCN) || 
+    if (!m_geometry.IsValidLCN(startLCN) ||
         !m_geometry.IsValidLCN(startLCN + count - 1)) {
         return view;
     }
-    
-    // Check if already mapped (sliding window reuse)
-    if (m_currentMapping.IsValid() &&
-        startLCN >= m_mappedStartLCN &&
-        startLCN + count <= m_mappedStartLCN + m_mappedClusterCount) {
-        
-        uint64_t offsetInMapping = (startLCN - m_mappedStartLCN) * m_geometry.bytesPerCluster;
-        view.data = m_currentMapping.data + offsetInMapping;
-        view.size = count * m_geometry.bytesPerCluster;
-        view.startLCN = startLCN;
-        view.valid = true;
-        return view;
-    }
-    
-    // Unmap previous region
-    if (m_currentMapping.IsValid()) {
-        m_disk.UnmapRegion(m_currentMapping);
-        m_currentMapping = DiskHandle::MappedRegion();
-    }
-    
-    // Calculate mapping size
-    uint64_t bytesToMap = count * m_geometry.bytesPerCluster;
-    
-    // Limit to MAX_MAPPING_SIZE
-    if (bytesToMap > Limits::MAX_MAPPING_SIZE) {
-        bytesToMap = Limits::MAX_MAPPING_SIZE;
-        count = bytesToMap / m_geometry.bytesPerCluster;
-    }
-    
-    // Convert LCN to physical offset
+
+    // Views pin a window of the handle's shared cache, so readers with
+    // interleaved ranges (or on other threads) no longer evict each other
     uint64_t physicalOffset = m_geometry.LCNToPhysicalOffset(startLCN);
-    
-    // Try to map
-    m_currentMapping = m_disk.MapDiskRegion(physicalOffset, bytesToMap);
-    
-    if (m_currentMapping.IsValid()) {
-        m_mappedStartLCN = startLCN;
-        m_mappedClusterCount = bytesToMap / m_geometry.bytesPerCluster;
-        
-        view.data = m_currentMapping.data;
-        view.size = m_currentMapping.size;
-        view.startLCN = startLCN;
+    DiskHandle::MappedRegion region = m_disk.MapDiskRegion(physicalOffset, count * m_geometry.bytesPerCluster);
+
+    if (region.IsValid()) {
+        view.data = region.data;
+        view.size = region.size;
         view.valid = true;
+        view.window = std::move(region.window);
     }
-    
+
     return view;
 }
 
 void VolumeReader::UnmapView(MappedView& view) {
-    // Actual unmapping happens in destructor or on next MapClusters
-    // Just invalidate the view struct
+    view.window.reset();
     view.valid = false;
     view.data = nullptr;
     view.size = 0;
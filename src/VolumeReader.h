@@ -26,14 +26,23 @@ public:
     // Read clusters by LCN (Logical Cluster Number)
     std::vector<uint8_t> ReadClusters(uint64_t startLCN, uint64_t count);
     std::vector<uint8_t> ReadClusterRun(const ClusterRun& run);
+
+    // Read clusters into caller memory (no allocation). queueDepth > 1 keeps
+    // several overlapped requests in flight; ReadMode::Unbuffered streams past
+    // the system cache for whole-volume passes. Returns bytes read; throws like
+    // ReadClusters on bounds errors or when nothing could be read.
+    size_t ReadClustersInto(uint64_t startLCN, uint64_t count, uint8_t* buffer,
+                            size_t bufferSize, size_t queueDepth = 1,
+                            DiskHandle::ReadMode mode = DiskHandle::ReadMode::Cached);
     
-    // Memory-mapped read
+    // Read-only view pinned in the disk's shared window cache
     struct MappedView {
         const uint8_t* data;
         uint64_t size;
         uint64_t startLCN;
         bool valid;
-        
+        WindowCache::Pin window;    // Released by UnmapView
+
         bool IsValid() const { return valid && data != nullptr; }
     };
     
@@ -44,9 +53,6 @@ public:
 private:
     DiskHandle& m_disk;
     VolumeGeometry m_geometry;
-    DiskHandle::MappedRegion m_currentMapping;
-    uint64_t m_mappedStartLCN;
-    uint64_t m_mappedClusterCount;
 };
 
 } // namespace KVC
\ No newline at end of file
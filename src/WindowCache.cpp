@@ -0,0 +1,121 @@
+// ============================================================================
+// WindowCache.cpp - Shared Volume Read Windows
+// ============================================================================
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "WindowCache.h"
+#include "DiskHandle.h"
+#include "Constants.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <cstring>
+
+namespace KVC {
+
+WindowCache::WindowCache(DiskHandle& disk, uint64_t budgetBytes)
+    : m_disk(disk)
+    , m_budgetBytes(budgetBytes)
+{}
+
+WindowCache::Pin WindowCache::Acquire(uint64_t offset, uint64_t size) {
+    if (size == 0) {
+        return nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_windows.begin(); it != m_windows.end(); ++it) {
+            if ((*it)->Contains(offset, size)) {
+                m_windows.splice(m_windows.begin(), m_windows, it);
+                m_stats.hits++;
+                Perf::Add(Perf::Counter::WindowCacheHits);
+                return m_windows.front();
+            }
+        }
+        m_stats.misses++;
+    }
+    Perf::Add(Perf::Counter::WindowCacheMisses);
+
+    // Read outside the lock so a slow miss never blocks other readers
+    return Load(offset, size);
+}
+
+WindowCache::Pin WindowCache::Load(uint64_t offset, uint64_t size) {
+    const uint64_t granularity = Constants::Cache::WINDOW_GRANULARITY;
+    uint64_t start = offset / granularity * granularity;
+    uint64_t end = (offset + size + granularity - 1) / granularity * granularity;
+
+    auto window = std::make_shared<Window>();
+    window->offset = start;
+    window->buffer = AlignedBuffer(static_cast<size_t>(end - start));
+    if (!window->buffer.IsValid()) {
+        return nullptr;
+    }
+
+    // Short reads near the volume end still serve any range they cover
+    window->size = m_disk.ReadInto(start, window->buffer.Data(), window->buffer.Size());
+    if (!window->Contains(offset, size)) {
+        return nullptr;
+    }
+
+    Pin pin = window;
+    if (window->size > m_budgetBytes) {
+        return pin;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Another thread may have loaded the same range meanwhile
+    for (auto it = m_windows.begin(); it != m_windows.end(); ++it) {
+        if ((*it)->Contains(offset, size)) {
+            m_windows.splice(m_windows.begin(), m_windows, it);
+            return m_windows.front();
+        }
+    }
+
+    m_windows.push_front(pin);
+    m_stats.residentBytes += pin->size;
+    while (m_stats.residentBytes > m_budgetBytes && m_windows.size() > 1) {
+        m_stats.residentBytes -= m_windows.back()->size;
+        m_stats.evictions++;
+        m_windows.pop_back();
+    }
+    return pin;
+}
+
+size_t WindowCache::Read(uint64_t offset, uint8_t* dest, size_t size) {
+    const uint64_t granularity = Constants::Cache::WINDOW_GRANULARITY;
+    size_t copied = 0;
+
+    while (copied < size) {
+        uint64_t position = offset + copied;
+        uint64_t chunk = std::min<uint64_t>(size - copied, granularity - position % granularity);
+
+        Pin window = Acquire(position, chunk);
+        if (!window) {
+            // Unreadable or past the end: let the disk report what it can
+            return copied + m_disk.ReadInto(position, dest + copied, size - copied);
+        }
+
+        memcpy(dest + copied, window->Data() + (position - window->offset), static_cast<size_t>(chunk));
+        copied += static_cast<size_t>(chunk);
+    }
+
+    return copied;
+}
+
+WindowCache::Stats WindowCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void WindowCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_windows.clear();
+    m_stats.residentBytes = 0;
+}
+
+} // namespace KVC
@@ -0,0 +1,71 @@
+// ============================================================================
+// WindowCache.h - Shared Volume Read Windows
+// ============================================================================
+// Small LRU of read-only volume windows shared by every reader of one
+// DiskHandle (carver batches, end-parser lookahead, recovery runs). Windows
+// are aligned to WINDOW_GRANULARITY and pinned by shared_ptr, so a view stays
+// valid after eviction until its last holder lets go. Safe for concurrent use.
+// ============================================================================
+
+#pragma once
+
+#include "AlignedBufferPool.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+
+namespace KVC {
+
+class DiskHandle;
+
+class WindowCache {
+public:
+    struct Window {
+        uint64_t offset = 0;        // Volume byte offset of Data()[0]
+        size_t size = 0;            // Bytes actually read
+        AlignedBuffer buffer;
+
+        const uint8_t* Data() const { return buffer.Data(); }
+        bool Contains(uint64_t start, uint64_t length) const {
+            return start >= offset && start + length <= offset + size;
+        }
+    };
+
+    using Pin = std::shared_ptr<const Window>;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t residentBytes = 0;
+    };
+
+    WindowCache(DiskHandle& disk, uint64_t budgetBytes);
+
+    WindowCache(const WindowCache&) = delete;
+    WindowCache& operator=(const WindowCache&) = delete;
+
+    // Window covering [offset, offset + size), or nullptr if it can't be read
+    Pin Acquire(uint64_t offset, uint64_t size);
+
+    // Copy through the cache; returns bytes copied (short at EOF or on error)
+    size_t Read(uint64_t offset, uint8_t* dest, size_t size);
+
+    Stats GetStats() const;
+
+    // Drop every window (pinned ones live on until released)
+    void Clear();
+
+private:
+    Pin Load(uint64_t offset, uint64_t size);
+
+    DiskHandle& m_disk;
+    uint64_t m_budgetBytes;
+
+    mutable std::mutex m_mutex;
+    std::list<Pin> m_windows;       // Most recently used first
+    Stats m_stats;
+};
+
+} // namespace KVC
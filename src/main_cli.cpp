@@ -9,6 +9,8 @@
 #include "DiskForensicsCore.h"
 #include "RecoveryEngine.h"
 #include "FileCarver.h"
+#include "PerfCounters.h"
+#include "ResultStream.h"
 #include "StringUtils.h"
 
 #include <climits>
@@ -17,8 +19,10 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <iomanip>
+#include <map>
 #include <io.h>
 #include <fcntl.h>
 
@@ -30,30 +34,64 @@ void PrintDiagnostics(const CarvingStatistics& stats);
 // CLI configuration parsed from command-line arguments
 struct CLIConfig {
     wchar_t driveLetter;
+    std::vector<wchar_t> driveLetters;  // --drives: scanned concurrently
+    bool allDrives;                     // --drives all, resolved once the engine is up
+    std::wstring imagePath;             // Scan an image/physical disk instead of a drive
+    uint64_t partitionOffset;
+    uint64_t bandwidthLimit;            // Bytes/s across every read, 0 = unlimited
+    size_t threadBudget;                // 0 = one per hardware thread
+    bool unbuffered;                    // Full-volume passes bypass the file cache
     std::wstring folderFilter;
     std::wstring filenameFilter;
     std::wstring outputFolder;
-    std::wstring csvPath;
+    std::wstring csvPath;               // Streamed while scanning, "-" = stdout
+    std::wstring ndjsonPath;            // Streamed while scanning, "-" = stdout
+    std::wstring checkpointFolder;
+    std::wstring perfJsonPath;          // "-" = stdout
+    bool perfEtw;
     bool enableMft;
     bool enableUsn;
     bool enableCarving;
+    bool overlapStages;
+    bool prescreen;
+    bool gapCarving;
+    bool freeSpaceOnly;
+    bool incrementalRescan;
     bool enableRecovery;
+    bool retainResults;                 // false: results are only streamed, never held
     bool enableDiagnostics;
     bool showHelp;
     
     CLIConfig() 
         : driveLetter(L'\0')
+        , allDrives(false)
+        , partitionOffset(0)
+        , bandwidthLimit(0)
+        , threadBudget(0)
+        , unbuffered(false)
+        , perfEtw(false)
         , enableMft(false)
         , enableUsn(false)
         , enableCarving(false)
+        , overlapStages(false)
+        , prescreen(true)
+        , gapCarving(true)
+        , freeSpaceOnly(false)
+        , incrementalRescan(false)
         , enableRecovery(false)
+        , retainResults(true)
         , enableDiagnostics(false)
         , showHelp(false)
     {}
 };
 
-// Storage for discovered files
+// Storage for discovered files (only filled when results are retained)
 std::vector<DeletedFileEntry> g_foundFiles;
+std::map<wchar_t, std::vector<DeletedFileEntry>> g_foundByDrive;  // --drives results
+std::atomic<uint64_t> g_filesFound{ 0 };
+bool g_retainResults = true;
+ResultStreamWriter g_csvStream;
+ResultStreamWriter g_ndjsonStream;
 CarvingStatistics g_carvingStats;
 
 // Display usage information
@@ -62,24 +100,53 @@ void PrintHelp() {
     wprintf(L"KVC File Recovery Tool - Command-Line Interface\n");
     wprintf(L"===============================================\n\n");
     wprintf(L"USAGE:\n");
-    wprintf(L"  kvc_recovery.exe --cli --drive <LETTER> [OPTIONS]\n\n");
+    wprintf(L"  kvc_recovery.exe --cli --drive <LETTER> [OPTIONS]\n");
+    wprintf(L"  kvc_recovery.exe --cli --drives <C,D,...|all> [OPTIONS]\n");
+    wprintf(L"  kvc_recovery.exe --cli --image <PATH> [--offset <BYTES>] [OPTIONS]\n\n");
     wprintf(L"REQUIRED:\n");
     wprintf(L"  --cli              Enable command-line mode\n");
-    wprintf(L"  --drive <LETTER>   Drive letter to scan (e.g., C, D, E)\n\n");
+    wprintf(L"  --drive <LETTER>   Drive letter to scan (e.g., C, D, E)\n");
+    wprintf(L"  --drives <LIST>    Or: scan several drives at once (C,D,E or all fixed\n");
+    wprintf(L"                     drives); drives sharing a disk take turns\n");
+    wprintf(L"  --image <PATH>     Or: raw .dd/.img file or \\\\.\\PhysicalDriveN\n");
+    wprintf(L"  --offset <BYTES>   Partition start inside --image (default 0)\n\n");
     wprintf(L"SCAN MODES (at least one required):\n");
     wprintf(L"  --mft              Scan Master File Table (ultra fast)\n");
     wprintf(L"  --usn              Scan USN Journal (fast)\n");
-    wprintf(L"  --carving          Scan free space for file signatures (slow)\n");
-    wprintf(L"  --all              Enable all scan modes\n\n");
+    wprintf(L"  --carving          Scan the volume for file signatures (slow)\n");
+    wprintf(L"  --all              Enable all scan modes\n");
+    wprintf(L"  --overlap          NTFS: carve while MFT/USN run (faster first results)\n");
+    wprintf(L"  --no-prescreen     Carving: probe zero/uniform clusters and keep two-byte\n");
+    wprintf(L"                     signature hits inside high-entropy data\n");
+    wprintf(L"  --no-gap-carving   Carving: report broken JPEG/ZIP files as found instead\n");
+    wprintf(L"                     of searching for their second fragment\n");
+    wprintf(L"  --free-space-only  NTFS carving: skip clusters in use by live files\n");
+    wprintf(L"  --incremental      NTFS: update the scan index in the checkpoint folder from\n");
+    wprintf(L"                     the USN journal instead of scanning everything\n\n");
     wprintf(L"FILTERS:\n");
     wprintf(L"  --folder <PATH>    Filter by folder path (case-insensitive)\n");
     wprintf(L"  --filename <NAME>  Filter by filename (case-insensitive, wildcards)\n\n");
     wprintf(L"RECOVERY:\n");
     wprintf(L"  --recover          Save recovered files to disk\n");
-    wprintf(L"  --output <PATH>    Output folder (required with --recover)\n\n");
+    wprintf(L"  --output <PATH>    Output folder (required with --recover)\n");
+    wprintf(L"  --checkpoint <DIR> Checkpoint and scan index folder (default: --output\n");
+    wprintf(L"                     folder); an interrupted carving pass resumes from it\n");
+    wprintf(L"                     and an NTFS rescan only reads what changed since\n\n");
     wprintf(L"REPORTING:\n");
-    wprintf(L"  --diagnostics      Show fragmentation statistics\n");
-    wprintf(L"  --csv <FILE>       Export results to CSV file\n\n");
+    wprintf(L"  --diagnostics      Show fragmentation statistics and performance counters\n");
+    wprintf(L"  --csv <FILE>       Stream results to a CSV file as they are found (- = stdout)\n");
+    wprintf(L"  --ndjson <FILE>    Stream results as one JSON object per line (- = stdout)\n");
+    wprintf(L"  --no-retain        Keep no results in memory, only stream them\n");
+    wprintf(L"                     (for huge volumes; cannot be used with --recover;\n");
+    wprintf(L"                     carving saves no checkpoints and cannot resume)\n");
+    wprintf(L"  --perf-json <FILE> Write performance counters as JSON (- = stdout)\n");
+    wprintf(L"  --perf-etw         Emit performance counters as ETW events (KVC.FileRecovery)\n\n");
+    wprintf(L"THROUGHPUT:\n");
+    wprintf(L"  --bandwidth <MB/s> Cap disk reads of the whole scan (default: unlimited)\n");
+    wprintf(L"  --threads <N>      Worker threads shared by --drives volumes\n");
+    wprintf(L"                     (default: one per processor)\n");
+    wprintf(L"  --unbuffered       Read MFT and carving passes around the file cache\n");
+    wprintf(L"                     (slower on small volumes, spares the cache on big ones)\n\n");
     wprintf(L"EXAMPLES:\n");
     wprintf(L"  Quick MFT scan:\n");
     wprintf(L"    kvc_recovery.exe --cli --drive C --mft\n\n");
@@ -87,8 +154,14 @@ void PrintHelp() {
     wprintf(L"    kvc_recovery.exe --cli --drive D --all --recover --output E:\\recovered\n\n");
     wprintf(L"  Filtered scan with diagnostics:\n");
     wprintf(L"    kvc_recovery.exe --cli --drive C --carving --filename *.jpg --diagnostics\n\n");
+    wprintf(L"  Carve a partition inside a disk image:\n");
+    wprintf(L"    kvc_recovery.exe --cli --image D:\\case\\disk.dd --offset 1048576 --carving\n\n");
     wprintf(L"  Export to CSV:\n");
     wprintf(L"    kvc_recovery.exe --cli --drive E --mft --csv results.csv\n\n");
+    wprintf(L"  Stream a full carve to another tool:\n");
+    wprintf(L"    kvc_recovery.exe --cli --drive E --carving --no-retain --ndjson - > hits.ndjson\n\n");
+    wprintf(L"  Every fixed drive at once, reading at most 200 MB/s:\n");
+    wprintf(L"    kvc_recovery.exe --cli --drives all --mft --usn --bandwidth 200 --csv all.csv\n\n");
     wprintf(L"EXIT CODES:\n");
     wprintf(L"  0 = Success (files found)\n");
     wprintf(L"  1 = No files found\n");
@@ -101,6 +174,7 @@ void PrintHelp() {
 bool ParseArguments(int argc, LPWSTR* argv, CLIConfig& config) {
     bool hasCliFlag = false;
     bool hasDrive = false;
+    bool hasDrives = false;
     
     for (int i = 1; i < argc; i++) {
         std::wstring arg = argv[i];
@@ -117,6 +191,33 @@ bool ParseArguments(int argc, LPWSTR* argv, CLIConfig& config) {
             config.driveLetter = towupper(argv[++i][0]);
             hasDrive = true;
         }
+        else if (arg == L"--drives" && i + 1 < argc) {
+            std::wstring list = argv[++i];
+            std::transform(list.begin(), list.end(), list.begin(), ::towlower);
+            if (list == L"all") {
+                config.allDrives = true;
+            } else {
+                for (wchar_t c : list) {
+                    if (iswalpha(c)) config.driveLetters.push_back(towupper(c));
+                }
+            }
+            hasDrives = true;
+        }
+        else if (arg == L"--bandwidth" && i + 1 < argc) {
+            config.bandwidthLimit = static_cast<uint64_t>(_wtof(argv[++i]) * 1024.0 * 1024.0);
+        }
+        else if (arg == L"--threads" && i + 1 < argc) {
+            config.threadBudget = static_cast<size_t>(_wtoi(argv[++i]));
+        }
+        else if (arg == L"--unbuffered") {
+            config.unbuffered = true;
+        }
+        else if (arg == L"--image" && i + 1 < argc) {
+            config.imagePath = argv[++i];
+        }
+        else if (arg == L"--offset" && i + 1 < argc) {
+            config.partitionOffset = _wcstoui64(argv[++i], nullptr, 0);
+        }
         else if (arg == L"--mft") {
             config.enableMft = true;
         }
@@ -131,6 +232,24 @@ bool ParseArguments(int argc, LPWSTR* argv, CLIConfig& config) {
             config.enableUsn = true;
             config.enableCarving = true;
         }
+        else if (arg == L"--overlap") {
+            config.overlapStages = true;
+        }
+        else if (arg == L"--no-prescreen") {
+            config.prescreen = false;
+        }
+        else if (arg == L"--no-gap-carving") {
+            config.gapCarving = false;
+        }
+        else if (arg == L"--free-space-only") {
+            config.freeSpaceOnly = true;
+        }
+        else if (arg == L"--incremental") {
+            config.incrementalRescan = true;
+        }
+        else if (arg == L"--full-rescan") {
+            config.incrementalRescan = false;   // The default; kept for existing scripts
+        }
         else if (arg == L"--folder" && i + 1 < argc) {
             config.folderFilter = argv[++i];
         }
@@ -143,12 +262,27 @@ bool ParseArguments(int argc, LPWSTR* argv, CLIConfig& config) {
         else if (arg == L"--output" && i + 1 < argc) {
             config.outputFolder = argv[++i];
         }
+        else if (arg == L"--checkpoint" && i + 1 < argc) {
+            config.checkpointFolder = argv[++i];
+        }
         else if (arg == L"--diagnostics") {
             config.enableDiagnostics = true;
         }
         else if (arg == L"--csv" && i + 1 < argc) {
             config.csvPath = argv[++i];
         }
+        else if (arg == L"--ndjson" && i + 1 < argc) {
+            config.ndjsonPath = argv[++i];
+        }
+        else if (arg == L"--no-retain") {
+            config.retainResults = false;
+        }
+        else if (arg == L"--perf-json" && i + 1 < argc) {
+            config.perfJsonPath = argv[++i];
+        }
+        else if (arg == L"--perf-etw") {
+            config.perfEtw = true;
+        }
         else {
             wprintf(L"[ERROR] Unknown argument: %s\n", argv[i]);
             return false;
@@ -159,8 +293,13 @@ bool ParseArguments(int argc, LPWSTR* argv, CLIConfig& config) {
         return false; // Not CLI mode
     }
     
-    if (!hasDrive) {
-        wprintf(L"[ERROR] Missing required argument: --drive\n");
+    if (hasDrive + hasDrives + !config.imagePath.empty() != 1) {
+        wprintf(L"[ERROR] Specify exactly one of --drive, --drives or --image\n");
+        return false;
+    }
+
+    if (hasDrives && !config.allDrives && config.driveLetters.empty()) {
+        wprintf(L"[ERROR] --drives needs drive letters (e.g. C,D) or all\n");
         return false;
     }
     
@@ -173,10 +312,29 @@ bool ParseArguments(int argc, LPWSTR* argv, CLIConfig& config) {
         wprintf(L"[ERROR] --output required when using --recover\n");
         return false;
     }
+
+    if (config.enableRecovery && !config.retainResults) {
+        wprintf(L"[ERROR] --recover needs the results in memory; drop --no-retain\n");
+        return false;
+    }
+
+    if (config.csvPath == L"-" && config.ndjsonPath == L"-") {
+        wprintf(L"[ERROR] Only one of --csv and --ndjson can stream to stdout\n");
+        return false;
+    }
     
     return true;
 }
 
+const wchar_t* FilesystemName(FilesystemType fsType) {
+    switch (fsType) {
+        case FilesystemType::NTFS: return L"NTFS";
+        case FilesystemType::ExFAT: return L"exFAT";
+        case FilesystemType::FAT32: return L"FAT32";
+        default: return L"Unknown";
+    }
+}
+
 // Progress callback for console output
 void OnProgress(const std::wstring& message, float progress) {
     if (progress >= 0.0f && progress <= 1.0f) {
@@ -187,52 +345,72 @@ void OnProgress(const std::wstring& message, float progress) {
     }
 }
 
-// File found callback for collecting results
+// File found callback: stream first, then keep if results are retained
 void OnFileFound(const DeletedFileEntry& file) {
-    g_foundFiles.push_back(file);
+    g_filesFound++;
+    g_csvStream.Write(file);
+    g_ndjsonStream.Write(file);
+    if (g_retainResults) {
+        g_foundFiles.push_back(file);
+    }
 }
 
-// Export results to CSV file
-bool ExportToCSV(const std::wstring& csvPath, const std::vector<DeletedFileEntry>& files) {
-    std::wofstream csv(csvPath);
-    if (!csv.is_open()) {
-        wprintf(L"[ERROR] Failed to create CSV file: %s\n", csvPath.c_str());
-        return false;
+void OnVolumeProgress(wchar_t driveLetter, const std::wstring& message, float progress) {
+    OnProgress(std::wstring(1, driveLetter) + L": " + message, progress);
+}
+
+// --drives callback (already serialized); paths gain their drive so rows
+// from different volumes stay apart
+void OnVolumeFileFound(wchar_t driveLetter, const DeletedFileEntry& file) {
+    DeletedFileEntry entry = file;
+    entry.path = std::wstring(1, driveLetter) + L":\\" + file.path;
+
+    g_filesFound++;
+    g_csvStream.Write(entry);
+    g_ndjsonStream.Write(entry);
+    if (g_retainResults) {
+        g_foundByDrive[driveLetter].push_back(std::move(entry));
     }
-    
-    // Write CSV header
-    csv << L"Name,Path,Size,Size_Formatted,Filesystem,Recoverable,Has_Deleted_Time,Deleted_Time\n";
-    
-    // Write file entries
-    for (const auto& file : files) {
-        // Escape commas in strings
-        std::wstring cleanName = file.name;
-        std::wstring cleanPath = file.path;
-        std::replace(cleanName.begin(), cleanName.end(), L',', L'_');
-        std::replace(cleanPath.begin(), cleanPath.end(), L',', L'_');
-        
-        csv << cleanName << L","
-            << cleanPath << L","
-            << file.size << L","
-            << file.sizeFormatted << L","
-            << file.filesystemType << L","
-            << (file.isRecoverable ? L"Yes" : L"No") << L","
-            << (file.hasDeletedTime ? L"Yes" : L"No") << L",";
-        
-		if (file.hasDeletedTime && file.deletedTime.has_value()) {
-            auto time_t_val = std::chrono::system_clock::to_time_t(file.deletedTime.value());
-            std::tm tm_val;
-            localtime_s(&tm_val, &time_t_val);
-            wchar_t timeStr[64];
-            wcsftime(timeStr, 64, L"%Y-%m-%d %H:%M:%S", &tm_val);
-            csv << timeStr;
+}
+
+// Start a result stream; "-" writes to the stdout the process was given,
+// so a redirected or piped stdout receives only results, not progress lines
+bool OpenResultStream(ResultStreamWriter& stream, const std::wstring& path,
+                      ResultStreamWriter::Format format, HANDLE inheritedStdout) {
+    if (path.empty()) {
+        return true;
+    }
+
+    bool opened = false;
+    if (path == L"-") {
+        HANDLE target = inheritedStdout;
+        if (target == nullptr || target == INVALID_HANDLE_VALUE) {
+            target = GetStdHandle(STD_OUTPUT_HANDLE);
         }
-        
-        csv << L"\n";
+        opened = stream.Attach(target, format);
+    } else {
+        opened = stream.Open(path, format);
+    }
+
+    if (!opened) {
+        wprintf(L"[ERROR] Failed to create result stream: %s\n", path.c_str());
+    }
+    return opened;
+}
+
+// Drain a result stream after the scan; false if any write failed
+bool CloseResultStream(ResultStreamWriter& stream, const std::wstring& path) {
+    if (path.empty()) {
+        return true;
+    }
+
+    if (!stream.Close()) {
+        wprintf(L"[ERROR] Writing results failed: %s\n", path.c_str());
+        return false;
+    }
+    if (path != L"-") {
+        wprintf(L"[INFO] Streamed %llu files to: %s\n", stream.Written(), path.c_str());
     }
-    
-    csv.close();
-    wprintf(L"[INFO] Exported %zu files to CSV: %s\n", files.size(), csvPath.c_str());
     return true;
 }
 
@@ -260,8 +438,22 @@ void PrintDiagnostics(const CarvingStatistics& stats) {
         wprintf(L"\n");
     }
     
+    wprintf(L"Bifragments rejoined:       %llu\n", stats.bifragmentsRecovered);
     wprintf(L"Severely fragmented:        %llu\n", stats.severelyFragmented);
     wprintf(L"Unknown size (no header):   %llu\n", stats.unknownSize);
+
+    uint64_t screened = stats.zeroClusters + stats.uniformClusters + stats.highEntropyClusters;
+    if (screened > 0) {
+        wprintf(L"Prescreen zero / uniform:   %llu / %llu clusters\n", stats.zeroClusters, stats.uniformClusters);
+        wprintf(L"Prescreen high-entropy:     %llu clusters (%llu weak hits dropped)\n",
+                stats.highEntropyClusters, stats.weakHitsSuppressed);
+    }
+
+    uint64_t cacheLookups = stats.windowCacheHits + stats.windowCacheMisses;
+    if (cacheLookups > 0) {
+        wprintf(L"Read window cache hits:     %llu / %llu (%.1f%%)\n",
+                stats.windowCacheHits, cacheLookups, (100.0f * stats.windowCacheHits) / cacheLookups);
+    }
     
 	if (!stats.byFormat.empty()) {
 		wprintf(L"\nBy format:\n");
@@ -289,13 +481,72 @@ void PrintDiagnostics(const CarvingStatistics& stats) {
         } else if (fragPct < 30.0f) {
             wprintf(L"RECOMMENDATION: Moderate fragmentation (%.1f%%) - consider size-based carving\n", fragPct);
         } else {
-            wprintf(L"RECOMMENDATION: High fragmentation (%.1f%%) - bifragment gap carving recommended\n", fragPct);
+            wprintf(L"RECOMMENDATION: High fragmentation (%.1f%%) - recover from MFT/USN where possible\n", fragPct);
         }
     }
     
     wprintf(L"\n");
 }
 
+// Print per-stage performance counters
+void PrintPerfCounters(const Perf::Snapshot& perf) {
+    wprintf(L"=== PERFORMANCE COUNTERS ===\n");
+    wprintf(L"Reads:                      %llu (%.1f MB)\n", perf.Get(Perf::Counter::ReadCalls),
+            perf.Get(Perf::Counter::BytesRead) / (1024.0 * 1024.0));
+    if (perf.Get(Perf::Counter::ReadCalls) > 0) {
+        wprintf(L"Read latency p50 / p99:     < %llu us / < %llu us\n",
+                perf.ReadLatencyPercentile(0.50), perf.ReadLatencyPercentile(0.99));
+    }
+    wprintf(L"MFT records parsed:         %llu\n", perf.Get(Perf::Counter::MftRecordsParsed));
+    wprintf(L"USN records parsed:         %llu\n", perf.Get(Perf::Counter::UsnRecordsParsed));
+    wprintf(L"Paths built / disk lookups: %llu / %llu\n", perf.Get(Perf::Counter::PathsBuilt),
+            perf.Get(Perf::Counter::PathRecordsFetched));
+    wprintf(L"Signature hits / carved:    %llu / %llu\n", perf.Get(Perf::Counter::SignatureHits),
+            perf.Get(Perf::Counter::FilesCarved));
+
+    uint64_t cacheLookups = perf.Get(Perf::Counter::WindowCacheHits) + perf.Get(Perf::Counter::WindowCacheMisses);
+    if (cacheLookups > 0) {
+        wprintf(L"Window cache hit rate:      %.1f%%\n",
+                (100.0f * perf.Get(Perf::Counter::WindowCacheHits)) / cacheLookups);
+    }
+
+    wprintf(L"\nTime by stage:\n");
+    for (size_t i = 0; i < static_cast<size_t>(Perf::Timer::Count); i++) {
+        const auto& totals = perf.timers[i];
+        if (totals.calls == 0) continue;
+        std::string name = Perf::TimerName(static_cast<Perf::Timer>(i));
+        std::wstring wideName(name.begin(), name.end());
+        wprintf(L"  %-15s %10.3f s  (%llu calls)\n", wideName.c_str(), totals.nanoseconds / 1e9, totals.calls);
+    }
+    wprintf(L"\n");
+}
+
+// Export counters as requested; stdout JSON goes on a line of its own
+bool ExportPerfCounters(const CLIConfig& config, const Perf::Snapshot& perf) {
+    if (config.perfEtw && !Perf::WriteEtwEvents(perf)) {
+        wprintf(L"[WARNING] ETW provider registration failed\n");
+    }
+
+    if (config.perfJsonPath.empty()) {
+        return true;
+    }
+
+    std::string json = Perf::ToJson(perf);
+    if (config.perfJsonPath == L"-") {
+        printf("%s\n", json.c_str());
+        return true;
+    }
+
+    std::ofstream out(config.perfJsonPath);
+    if (!out.is_open()) {
+        wprintf(L"[ERROR] Failed to create perf file: %s\n", config.perfJsonPath.c_str());
+        return false;
+    }
+    out << json << "\n";
+    wprintf(L"[INFO] Performance counters written to: %s\n", config.perfJsonPath.c_str());
+    return true;
+}
+
 // Perform recovery of found files
 int RecoverFiles(const CLIConfig& config, const std::vector<DeletedFileEntry>& files) {
     if (files.empty()) {
@@ -308,28 +559,37 @@ int RecoverFiles(const CLIConfig& config, const std::vector<DeletedFileEntry>& f
     
     RecoveryEngine engine;
     
-    // Validate destination
-    if (!engine.ValidateDestination(config.driveLetter, config.outputFolder)) {
+    // Validate destination (an image is read-only here, so any folder works)
+    if (config.imagePath.empty() && !engine.ValidateDestination(config.driveLetter, config.outputFolder)) {
         wprintf(L"[ERROR] Cannot recover to source drive - choose different destination\n");
         fflush(stdout);
         return 4;
     }
     
     auto startTime = std::chrono::steady_clock::now();
-    
-    bool success = engine.RecoverMultipleFiles(
-        files,
-        config.driveLetter,
-        config.outputFolder,
-        [](const std::wstring& msg, float progress) {
-            if (progress >= 0.0f && progress <= 1.0f) {
-                int percent = static_cast<int>(progress * 100);
-                wprintf(L"[RECOVERY] %s [%d%%]\n", msg.c_str(), percent);
-            } else {
-                wprintf(L"[RECOVERY] %s\n", msg.c_str());
-            }
+
+    auto onRecoveryProgress = [](const std::wstring& msg, float progress) {
+        if (progress >= 0.0f && progress <= 1.0f) {
+            int percent = static_cast<int>(progress * 100);
+            wprintf(L"[RECOVERY] %s [%d%%]\n", msg.c_str(), percent);
+        } else {
+            wprintf(L"[RECOVERY] %s\n", msg.c_str());
+        }
+    };
+
+    bool success = false;
+    if (config.imagePath.empty()) {
+        success = engine.RecoverMultipleFiles(files, config.driveLetter, config.outputFolder,
+                                              onRecoveryProgress);
+    } else {
+        DiskHandle image(config.imagePath, config.partitionOffset);
+        if (!image.Open()) {
+            wprintf(L"[ERROR] Cannot open image: %s\n", config.imagePath.c_str());
+            fflush(stdout);
+            return 3;
         }
-    );
+        success = engine.RecoverMultipleFiles(files, image, config.outputFolder, onRecoveryProgress);
+    }
     
     auto endTime = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
@@ -345,8 +605,44 @@ int RecoverFiles(const CLIConfig& config, const std::vector<DeletedFileEntry>& f
     }
 }
 
+// Recover every --drives volume into its own subfolder of the output
+int RecoverVolumes(const CLIConfig& config) {
+    bool anyRecovered = false;
+    int failure = 0;
+
+    for (const auto& [driveLetter, files] : g_foundByDrive) {
+        CLIConfig volumeConfig = config;
+        volumeConfig.driveLetter = driveLetter;
+        volumeConfig.outputFolder = config.outputFolder;
+        if (volumeConfig.outputFolder.back() != L'\\' && volumeConfig.outputFolder.back() != L'/') {
+            volumeConfig.outputFolder += L'\\';
+        }
+        volumeConfig.outputFolder += driveLetter;
+        CreateDirectoryW(volumeConfig.outputFolder.c_str(), nullptr);
+
+        int result = RecoverFiles(volumeConfig, files);
+        if (result == 0) {
+            anyRecovered = true;
+        } else if (result > 1) {
+            failure = std::max(failure, result);
+        }
+    }
+
+    if (failure != 0) return failure;
+    if (!anyRecovered) {
+        wprintf(L"[INFO] No files to recover\n");
+        fflush(stdout);
+        return 1;
+    }
+    return 0;
+}
+
 // Main CLI execution
 int RunCLI(int argc, LPWSTR* argv) {
+    // Whatever stdout the parent handed over (a pipe or file when redirected);
+    // console output below is reopened on CONOUT$ and no longer reaches it
+    HANDLE inheritedStdout = GetStdHandle(STD_OUTPUT_HANDLE);
+
     // Attach to parent console for CLI output (required for GUI subsystem)
     if (!AttachConsole(ATTACH_PARENT_PROCESS)) {
         AllocConsole();  // Create new console if no parent
@@ -377,10 +673,40 @@ int RunCLI(int argc, LPWSTR* argv) {
         return 0;
     }
     
+    // Initialize forensics core
+    DiskForensicsCore forensics;
+    forensics.SetOverlapStages(config.overlapStages);
+    forensics.SetRetainCarvedFiles(config.retainResults);
+    forensics.SetCarvingPrescreen(config.prescreen);
+    forensics.SetCarvingGapSearch(config.gapCarving);
+    forensics.SetCarvingUnallocatedOnly(config.freeSpaceOnly);
+    forensics.SetIncrementalRescan(config.incrementalRescan);
+    forensics.SetBandwidthLimit(config.bandwidthLimit);
+    forensics.SetThreadBudget(config.threadBudget);
+    forensics.SetUnbufferedStreaming(config.unbuffered);
+
+    if (config.allDrives) {
+        config.driveLetters = forensics.ListScannableVolumes();
+        if (config.driveLetters.empty()) {
+            wprintf(L"[ERROR] No scannable fixed drives found\n");
+            fflush(stdout);
+            return 3;
+        }
+    }
+    const bool multiVolume = !config.driveLetters.empty();
+
     // Display scan configuration
     wprintf(L"\n");
     wprintf(L"=== KVC File Recovery - CLI Mode ===\n");
-    wprintf(L"Drive:         %c:\n", config.driveLetter);
+    if (multiVolume) {
+        wprintf(L"Drives:        ");
+        for (wchar_t letter : config.driveLetters) wprintf(L"%c: ", letter);
+        wprintf(L"\n");
+    } else if (config.imagePath.empty()) {
+        wprintf(L"Drive:         %c:\n", config.driveLetter);
+    } else {
+        wprintf(L"Image:         %s (offset %llu)\n", config.imagePath.c_str(), config.partitionOffset);
+    }
     wprintf(L"Scan modes:    ");
     if (config.enableMft) wprintf(L"MFT ");
     if (config.enableUsn) wprintf(L"USN ");
@@ -393,86 +719,167 @@ int RunCLI(int argc, LPWSTR* argv) {
     if (!config.filenameFilter.empty()) {
         wprintf(L"File filter:   %s\n", config.filenameFilter.c_str());
     }
+    if (config.bandwidthLimit != 0) {
+        wprintf(L"Bandwidth:     %.1f MB/s\n", config.bandwidthLimit / (1024.0 * 1024.0));
+    }
     if (config.enableRecovery) {
         wprintf(L"Output:        %s\n", config.outputFolder.c_str());
     }
     wprintf(L"\n");
-    
-    // Initialize forensics core
-    DiskForensicsCore forensics;
-    
-    // Detect filesystem
-    FilesystemType fsType = forensics.DetectFilesystem(config.driveLetter);
-    const wchar_t* fsName = L"Unknown";
-    switch (fsType) {
-        case FilesystemType::NTFS: fsName = L"NTFS"; break;
-        case FilesystemType::ExFAT: fsName = L"exFAT"; break;
-        case FilesystemType::FAT32: fsName = L"FAT32"; break;
-        default: break;
+
+    // Checkpoints and scan indexes live next to the output and, like it,
+    // never on the scanned drive (--drives skips just the drive holding it)
+    std::wstring checkpointFolder = config.checkpointFolder.empty()
+        ? config.outputFolder : config.checkpointFolder;
+    if (!checkpointFolder.empty()) {
+        RecoveryEngine engine;
+        if (!config.imagePath.empty() || multiVolume ||
+            engine.ValidateDestination(config.driveLetter, checkpointFolder)) {
+            forensics.SetCheckpointFolder(checkpointFolder);
+            wprintf(L"[INFO] Checkpoints and scan index: %s\n", checkpointFolder.c_str());
+        } else {
+            wprintf(L"[WARNING] Checkpoint folder is on the scanned drive - checkpoints disabled\n");
+        }
     }
-    wprintf(L"[INFO] Filesystem: %s\n", fsName);
     
-    if (fsType == FilesystemType::Unknown) {
-        wprintf(L"[ERROR] Unsupported or unreadable filesystem\n");
-        fflush(stdout);
-        return 3;
+    // Detect filesystem (each --drives volume reports its own)
+    if (!multiVolume) {
+        FilesystemType fsType = FilesystemType::Unknown;
+        if (config.imagePath.empty()) {
+            fsType = forensics.DetectFilesystem(config.driveLetter);
+        } else {
+            DiskHandle image(config.imagePath, config.partitionOffset);
+            if (image.Open()) {
+                fsType = forensics.DetectFilesystem(image);
+            }
+        }
+        wprintf(L"[INFO] Filesystem: %s\n", FilesystemName(fsType));
+
+        if (fsType == FilesystemType::Unknown) {
+            wprintf(L"[ERROR] Unsupported or unreadable filesystem\n");
+            fflush(stdout);
+            return 3;
+        }
     }
     
     // Clear global state
     g_foundFiles.clear();
+    g_foundByDrive.clear();
+    g_filesFound = 0;
+    g_retainResults = config.retainResults;
     g_carvingStats = CreateCarvingDiagnostics();
+
+    Perf::Reset();
+    Perf::Enable(config.enableDiagnostics || config.perfEtw || !config.perfJsonPath.empty());
+    
+    if (!OpenResultStream(g_csvStream, config.csvPath, ResultStreamWriter::Format::Csv, inheritedStdout) ||
+        !OpenResultStream(g_ndjsonStream, config.ndjsonPath, ResultStreamWriter::Format::Ndjson, inheritedStdout)) {
+        g_csvStream.Close();
+        fflush(stdout);
+        return 4;
+    }
     
     // Start scan
     auto startTime = std::chrono::steady_clock::now();
     bool shouldStop = false;
-    
-    bool scanSuccess = forensics.StartScan(
-        config.driveLetter,
-        config.folderFilter,
-        config.filenameFilter,
-        OnFileFound,
-        OnProgress,
-        shouldStop,
-        config.enableMft,
-        config.enableUsn,
-        config.enableCarving
-    );
+
+    std::vector<VolumeScanSummary> volumes;
+    bool scanSuccess = false;
+    if (multiVolume) {
+        volumes = forensics.StartMultiVolumeScan(
+            config.driveLetters,
+            config.folderFilter,
+            config.filenameFilter,
+            OnVolumeFileFound,
+            OnVolumeProgress,
+            shouldStop,
+            config.enableMft,
+            config.enableUsn,
+            config.enableCarving);
+        scanSuccess = std::all_of(volumes.begin(), volumes.end(),
+                                  [](const VolumeScanSummary& volume) { return volume.success; });
+    } else {
+        scanSuccess = config.imagePath.empty()
+            ? forensics.StartScan(
+                config.driveLetter,
+                config.folderFilter,
+                config.filenameFilter,
+                OnFileFound,
+                OnProgress,
+                shouldStop,
+                config.enableMft,
+                config.enableUsn,
+                config.enableCarving)
+            : forensics.StartImageScan(
+                config.imagePath,
+                config.partitionOffset,
+                config.folderFilter,
+                config.filenameFilter,
+                OnFileFound,
+                OnProgress,
+                shouldStop,
+                config.enableMft,
+                config.enableUsn,
+                config.enableCarving);
+    }
     
     auto endTime = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
+
+    bool streamsOk = CloseResultStream(g_csvStream, config.csvPath);
+    streamsOk = CloseResultStream(g_ndjsonStream, config.ndjsonPath) && streamsOk;
     
     // Report results
     wprintf(L"\n");
     wprintf(L"=== SCAN COMPLETE ===\n");
-    wprintf(L"Files found:   %zu\n", g_foundFiles.size());
+    wprintf(L"Files found:   %llu\n", g_filesFound.load());
     wprintf(L"Scan time:     %lld seconds\n", duration.count());
     wprintf(L"\n");
+
+    for (const VolumeScanSummary& volume : volumes) {
+        std::wstring disk = volume.physicalDisk == UINT32_MAX ? L"?" : std::to_wstring(volume.physicalDisk);
+        wprintf(L"  %c:  disk %-3s %-8s %8llu files  %8.1f s%s\n", volume.driveLetter, disk.c_str(),
+                FilesystemName(volume.fsType), volume.filesFound, volume.seconds,
+                volume.success ? L"" : L"  (errors)");
+    }
+    if (!volumes.empty()) {
+        wprintf(L"\n");
+    }
     
     if (!scanSuccess) {
         wprintf(L"[WARNING] Scan completed with errors\n");
     }
     
-    // Print diagnostics if requested
-    if (config.enableDiagnostics && config.enableCarving) {
+    g_carvingStats = forensics.LastCarvingStatistics();
+    const Perf::Snapshot perf = Perf::Capture();
+
+    // Print diagnostics if requested (carving statistics are per volume, so
+    // a --drives scan only has the shared counters)
+    if (config.enableDiagnostics && config.enableCarving && !multiVolume) {
         PrintDiagnostics(g_carvingStats);
     }
+    if (config.enableDiagnostics) {
+        PrintPerfCounters(perf);
+    }
+
+    if (!ExportPerfCounters(config, perf)) {
+        fflush(stdout);
+        return 4;
+    }
     
-    // Export to CSV if requested
-    if (!config.csvPath.empty()) {
-        if (!ExportToCSV(config.csvPath, g_foundFiles)) {
-            fflush(stdout);
-            return 4;
-        }
+    if (!streamsOk) {
+        fflush(stdout);
+        return 4;
     }
     
     // Perform recovery if requested
     if (config.enableRecovery) {
-        int recoveryResult = RecoverFiles(config, g_foundFiles);
+        int recoveryResult = multiVolume ? RecoverVolumes(config) : RecoverFiles(config, g_foundFiles);
         return recoveryResult;
     }
     
     // Return appropriate exit code
-    if (g_foundFiles.empty()) {
+    if (g_filesFound == 0) {
         wprintf(L"[INFO] No deleted files found\n");
         fflush(stdout);
         return 1;